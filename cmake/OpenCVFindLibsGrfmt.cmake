@@ -272,4 +272,9 @@ if(WITH_IMGCODEC_PFM)
   set(HAVE_IMGCODEC_PFM ON)
 elseif(DEFINED WITH_IMGCODEC_PFM)
   set(HAVE_IMGCODEC_PFM OFF)
+endif()
+if(WITH_IMGCODEC_QLI)
+  set(HAVE_IMGCODEC_QLI ON)
+elseif(DEFINED WITH_IMGCODEC_QLI)
+  set(HAVE_IMGCODEC_QLI OFF)
 endif()
\ No newline at end of file
@@ -883,6 +883,23 @@ CV__DNN_INLINE_NS_BEGIN
                                    const Scalar& mean = Scalar(), bool swapRB=false, bool crop=false,
                                    int ddepth=CV_32F);
 
+    /** @brief Writes preprocessed image into a single slot of preallocated 4-dimensional blob.
+     *  @param image input image (with 1-, 3- or 4-channels).
+     *  @param blob preallocated continuous blob with NCHW dimensions order and CV_32F or CV_8U depth.
+     *  Number of channels and spatial size of the slot are taken from it.
+     *  @param batchIdx index of the slot in the batch (first blob dimension).
+     *  @param scalefactor multiplier for @p image values.
+     *  @param mean scalar with mean values which are subtracted from channels.
+     *  @param swapRB flag which indicates that swap first and last channels
+     *  in 3-channel image is necessary.
+     *  @param crop flag which indicates whether image will be cropped after resize or not.
+     *  @details Has the same semantics as blobFromImage() but doesn't allocate the blob, so
+     *  a batch can be filled image by image (e.g. as frames arrive).
+     */
+    CV_EXPORTS void blobFromImageToBatch(InputArray image, Mat& blob, int batchIdx,
+                                         double scalefactor=1.0, const Scalar& mean = Scalar(),
+                                         bool swapRB=false, bool crop=false);
+
     /** @brief Parse a 4D blob and output the images it contains as 2D arrays through a simpler data structure
      *  (std::vector<cv::Mat>).
      *  @param[in] blob_ 4 dimensional array (images, channels, height, width) in floating point precision (CV_32F) from
@@ -126,95 +126,229 @@ Mat blobFromImages(InputArrayOfArrays images, double scalefactor, Size size,
     return blob;
 }
 
-void blobFromImages(InputArrayOfArrays images_, OutputArray blob_, double scalefactor,
-                    Size size, const Scalar& mean_, bool swapRB, bool crop, int ddepth)
+static void checkBlobParams(int ddepth, double scalefactor, const Scalar& mean)
 {
-    CV_TRACE_FUNCTION();
     CV_CheckType(ddepth, ddepth == CV_32F || ddepth == CV_8U, "Blob depth should be CV_32F or CV_8U");
     if (ddepth == CV_8U)
     {
         CV_CheckEQ(scalefactor, 1.0, "Scaling is not supported for CV_8U blob depth");
-        CV_Assert(mean_ == Scalar() && "Mean subtraction is not supported for CV_8U blob depth");
+        CV_Assert(mean == Scalar() && "Mean subtraction is not supported for CV_8U blob depth");
     }
+}
 
-    std::vector<Mat> images;
-    images_.getMatVector(images);
-    CV_Assert(!images.empty());
-    for (int i = 0; i < images.size(); i++)
+// Writes an interleaved image into the planes of a single NCHW blob slot.
+// Depth conversion, mean subtraction, scaling and channels swap are done
+// in a single pass over the source pixels.
+class BlobFromImageInvoker : public ParallelLoopBody
+{
+public:
+    BlobFromImageInvoker(const Mat& src_, Mat& blob, int batchIdx,
+                         double scalefactor, const Scalar& mean_, bool swapRB)
+        : src(src_), cn(src_.channels()), ddepth(blob.depth()), scale((float)scalefactor)
     {
-        Size imgSize = images[i].size();
-        if (size == Size())
-            size = imgSize;
-        if (size != imgSize)
-        {
-            if(crop)
-            {
-              float resizeFactor = std::max(size.width / (float)imgSize.width,
-                                            size.height / (float)imgSize.height);
-              resize(images[i], images[i], Size(), resizeFactor, resizeFactor, INTER_LINEAR);
-              Rect crop(Point(0.5 * (images[i].cols - size.width),
-                              0.5 * (images[i].rows - size.height)),
-                        size);
-              images[i] = images[i](crop);
-            }
-            else
-              resize(images[i], images[i], size, 0, 0, INTER_LINEAR);
-        }
-        if(images[i].depth() == CV_8U && ddepth == CV_32F)
-            images[i].convertTo(images[i], CV_32F);
         Scalar mean = mean_;
         if (swapRB)
             std::swap(mean[0], mean[2]);
+        for (int p = 0; p < cn; p++)
+        {
+            int c = (swapRB && cn >= 3 && p != 1 && p != 3) ? 2 - p : p;
+            srcChannel[p] = c;
+            meanVal[p] = (float)mean[c];
+            planes[p] = blob.ptr(batchIdx, p);
+        }
+    }
 
-        images[i] -= mean;
-        images[i] *= scalefactor;
+    void operator()(const Range& r) const CV_OVERRIDE
+    {
+        for (int y = r.start; y < r.end; y++)
+        {
+            if (src.depth() == CV_32F)
+                processRow(src.ptr<float>(y), y);
+            else if (ddepth == CV_32F)
+                processRow(src.ptr<uchar>(y), y);
+            else
+                copyRow(src.ptr<uchar>(y), y);
+        }
     }
 
-    size_t i, nimages = images.size();
-    Mat image0 = images[0];
-    int nch = image0.channels();
-    CV_Assert(image0.dims == 2);
-    Mat image;
-    if (nch == 3 || nch == 4)
+private:
+    // CV_8U or CV_32F source into CV_32F planes
+    template<typename T>
+    void processRow(const T* sptr, int y) const
+    {
+        const int width = src.cols;
+        float* dst[4];
+        for (int p = 0; p < cn; p++)
+            dst[p] = (float*)planes[p] + (size_t)y * width;
+
+        int x = 0;
+#if CV_SIMD128
+        x = processRowSIMD(sptr, dst);
+#endif
+        for (; x < width; x++)
+        {
+            const T* px = sptr + x * cn;
+            for (int p = 0; p < cn; p++)
+                dst[p][x] = ((float)px[srcChannel[p]] - meanVal[p]) * scale;
+        }
+    }
+
+    // CV_8U source into CV_8U planes
+    void copyRow(const uchar* sptr, int y) const
     {
-        int sz[] = { (int)nimages, nch, image0.rows, image0.cols };
-        blob_.create(4, sz, ddepth);
-        Mat blob = blob_.getMat();
-        Mat ch[4];
+        const int width = src.cols;
+        uchar* dst[4];
+        for (int p = 0; p < cn; p++)
+            dst[p] = planes[p] + (size_t)y * width;
 
-        for( i = 0; i < nimages; i++ )
+        int x = 0;
+#if CV_SIMD128
+        for (; x <= width - 16; x += 16)
         {
-            image = images[i];
-            CV_Assert(image.depth() == blob_.depth());
-            nch = image.channels();
-            CV_Assert(image.dims == 2 && (nch == 3 || nch == 4));
-            CV_Assert(image.size() == image0.size());
+            v_uint8x16 v[4];
+            loadChannels(sptr + x * cn, v);
+            for (int p = 0; p < cn; p++)
+                v_store(dst[p] + x, v[srcChannel[p]]);
+        }
+#endif
+        for (; x < width; x++)
+        {
+            for (int p = 0; p < cn; p++)
+                dst[p][x] = sptr[x * cn + srcChannel[p]];
+        }
+    }
+
+#if CV_SIMD128
+    void loadChannels(const uchar* ptr, v_uint8x16* v) const
+    {
+        if (cn == 1)
+            v[0] = v_load(ptr);
+        else if (cn == 3)
+            v_load_deinterleave(ptr, v[0], v[1], v[2]);
+        else
+            v_load_deinterleave(ptr, v[0], v[1], v[2], v[3]);
+    }
+
+    void loadChannels(const float* ptr, v_float32x4* v) const
+    {
+        if (cn == 1)
+            v[0] = v_load(ptr);
+        else if (cn == 3)
+            v_load_deinterleave(ptr, v[0], v[1], v[2]);
+        else
+            v_load_deinterleave(ptr, v[0], v[1], v[2], v[3]);
+    }
 
-            for( int j = 0; j < nch; j++ )
-                ch[j] = Mat(image.rows, image.cols, ddepth, blob.ptr((int)i, j));
-            if(swapRB)
-                std::swap(ch[0], ch[2]);
-            split(image, ch);
+    int processRowSIMD(const uchar* sptr, float** dst) const
+    {
+        const int width = src.cols;
+        const v_float32x4 vscale = v_setall_f32(scale);
+        int x = 0;
+        for (; x <= width - 16; x += 16)
+        {
+            v_uint8x16 v[4];
+            loadChannels(sptr + x * cn, v);
+            for (int p = 0; p < cn; p++)
+            {
+                const v_float32x4 vmean = v_setall_f32(meanVal[p]);
+                v_uint16x8 w0, w1;
+                v_expand(v[srcChannel[p]], w0, w1);
+                v_uint32x4 d[4];
+                v_expand(w0, d[0], d[1]);
+                v_expand(w1, d[2], d[3]);
+                for (int k = 0; k < 4; k++)
+                {
+                    v_float32x4 f = v_cvt_f32(v_reinterpret_as_s32(d[k]));
+                    v_store(dst[p] + x + k * 4, (f - vmean) * vscale);
+                }
+            }
         }
+        return x;
     }
-    else
+
+    int processRowSIMD(const float* sptr, float** dst) const
     {
-       CV_Assert(nch == 1);
-       int sz[] = { (int)nimages, 1, image0.rows, image0.cols };
-       blob_.create(4, sz, ddepth);
-       Mat blob = blob_.getMat();
+        const int width = src.cols;
+        const v_float32x4 vscale = v_setall_f32(scale);
+        int x = 0;
+        for (; x <= width - 4; x += 4)
+        {
+            v_float32x4 v[4];
+            loadChannels(sptr + x * cn, v);
+            for (int p = 0; p < cn; p++)
+                v_store(dst[p] + x, (v[srcChannel[p]] - v_setall_f32(meanVal[p])) * vscale);
+        }
+        return x;
+    }
+#endif
 
-       for( i = 0; i < nimages; i++ )
-       {
-           Mat image = images[i];
-           CV_Assert(image.depth() == blob_.depth());
-           nch = image.channels();
-           CV_Assert(image.dims == 2 && (nch == 1));
-           CV_Assert(image.size() == image0.size());
+    const Mat& src;
+    int cn;
+    int ddepth;
+    int srcChannel[4];
+    float meanVal[4];
+    float scale;
+    uchar* planes[4];
+};
 
-           image.copyTo(Mat(image.rows, image.cols, ddepth, blob.ptr((int)i, 0)));
-       }
+void blobFromImages(InputArrayOfArrays images_, OutputArray blob_, double scalefactor,
+                    Size size, const Scalar& mean_, bool swapRB, bool crop, int ddepth)
+{
+    CV_TRACE_FUNCTION();
+    checkBlobParams(ddepth, scalefactor, mean_);
+
+    std::vector<Mat> images;
+    images_.getMatVector(images);
+    CV_Assert(!images.empty());
+
+    Mat image0 = images[0];
+    int nch = image0.channels();
+    CV_Assert(image0.dims == 2 && (nch == 1 || nch == 3 || nch == 4));
+    if (size == Size())
+        size = image0.size();
+
+    int sz[] = { (int)images.size(), nch, size.height, size.width };
+    blob_.create(4, sz, ddepth);
+    Mat blob = blob_.getMat();
+    for (size_t i = 0; i < images.size(); i++)
+        blobFromImageToBatch(images[i], blob, (int)i, scalefactor, mean_, swapRB, crop);
+}
+
+void blobFromImageToBatch(InputArray image, Mat& blob, int batchIdx, double scalefactor,
+                          const Scalar& mean, bool swapRB, bool crop)
+{
+    CV_TRACE_FUNCTION();
+    CV_Assert(blob.dims == 4 && blob.isContinuous());
+    CV_Assert(0 <= batchIdx && batchIdx < blob.size[0]);
+    const int ddepth = blob.depth();
+    checkBlobParams(ddepth, scalefactor, mean);
+
+    Mat img = image.getMat();
+    const int nch = img.channels();
+    CV_Assert(img.dims == 2 && (nch == 1 || nch == 3 || nch == 4));
+    CV_Assert(nch == blob.size[1]);
+    CV_Assert(img.depth() == ddepth || (img.depth() == CV_8U && ddepth == CV_32F));
+
+    Size size(blob.size[3], blob.size[2]);
+    Size imgSize = img.size();
+    if (size != imgSize)
+    {
+        if (crop)
+        {
+            float resizeFactor = std::max(size.width / (float)imgSize.width,
+                                          size.height / (float)imgSize.height);
+            resize(img, img, Size(), resizeFactor, resizeFactor, INTER_LINEAR);
+            Rect crop(Point(0.5 * (img.cols - size.width),
+                            0.5 * (img.rows - size.height)),
+                      size);
+            img = img(crop);
+        }
+        else
+            resize(img, img, size, 0, 0, INTER_LINEAR);
     }
+
+    BlobFromImageInvoker body(img, blob, batchIdx, scalefactor, mean, swapRB);
+    parallel_for_(Range(0, img.rows), body, img.total() / (double)(1 << 16));
 }
 
 void imagesFromBlob(const cv::Mat& blob_, OutputArrayOfArrays images_)
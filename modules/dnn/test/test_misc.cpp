@@ -60,6 +60,66 @@ TEST(imagesFromBlob, Regression)
     }
 }
 
+typedef testing::TestWithParam<tuple<int, int, bool> > blobFromImage_fused;
+TEST_P(blobFromImage_fused, Accuracy)
+{
+    const int type   = get<0>(GetParam());
+    const int ddepth = get<1>(GetParam());
+    const bool swapRB = get<2>(GetParam());
+    const int nch = CV_MAT_CN(type);
+    const bool normalize = ddepth == CV_32F;
+    const double scale = normalize ? 1.0 / 127.5 : 1.0;
+    const Scalar mean = normalize ? Scalar(10, 50, 140, 20) : Scalar();
+
+    Mat img(37, 53, type);  // non-multiple of vector width
+    randu(img, 0, 255);
+    if (CV_MAT_DEPTH(type) == CV_32F && ddepth == CV_8U)
+    {
+        ASSERT_ANY_THROW(blobFromImage(img, scale, Size(), mean, swapRB, false, ddepth));
+        return;
+    }
+    Mat blob = blobFromImage(img, scale, Size(), mean, swapRB, false, ddepth);
+
+    // Reference: per-channel arithmetic on a converted copy
+    Mat src;
+    img.convertTo(src, ddepth);
+    std::vector<Mat> ch;
+    split(src, ch);
+    ASSERT_EQ(blob.size[1], nch);
+    for (int c = 0; c < nch; c++)
+    {
+        const int srcC = (swapRB && nch >= 3 && (c == 0 || c == 2)) ? 2 - c : c;
+        const int meanC = (swapRB && (srcC == 0 || srcC == 2)) ? 2 - srcC : srcC;
+        Mat ref = ch[srcC];
+        if (normalize)
+            ref = (ref - mean[meanC]) * scale;
+        Mat plane(img.rows, img.cols, ddepth, blob.ptr(0, c));
+        normAssert(ref, plane, "", 1e-5, 1e-5);
+    }
+}
+
+INSTANTIATE_TEST_CASE_P(/**/, blobFromImage_fused, Combine(
+    Values(CV_8UC1, CV_8UC3, CV_8UC4, CV_32FC1, CV_32FC3, CV_32FC4),
+    Values(CV_32F, CV_8U),
+    testing::Bool()
+));
+
+TEST(blobFromImageToBatch, Regression)
+{
+    Mat img1(20, 30, CV_8UC3), img2(20, 30, CV_8UC3);
+    randu(img1, 0, 255);
+    randu(img2, 0, 255);
+    Mat ref = blobFromImages(std::vector<Mat>{img1, img2}, 0.5, Size(16, 16), Scalar(1, 2, 3), true, true);
+
+    int sz[] = {2, 3, 16, 16};
+    Mat blob(4, sz, CV_32F, Scalar(-1));
+    void* blobData = blob.data;
+    blobFromImageToBatch(img2, blob, 1, 0.5, Scalar(1, 2, 3), true, true);
+    blobFromImageToBatch(img1, blob, 0, 0.5, Scalar(1, 2, 3), true, true);
+    ASSERT_EQ(blobData, blob.data);
+    normAssert(ref, blob);
+}
+
 TEST(readNet, Regression)
 {
     Net net = readNet(findDataFile("dnn/squeezenet_v1.1.prototxt", false),
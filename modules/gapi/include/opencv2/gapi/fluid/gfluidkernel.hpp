@@ -87,12 +87,27 @@ struct GFluidOutputRois
     std::vector<cv::gapi::own::Rect> rois;
 };
 
+// Enables tiled execution of Fluid islands: images are processed in
+// vertical strips of tileWidth output pixels, so line buffers stay small
+// regardless of image width. Every strip is extended with a halo derived
+// from kernel windows, so results are the same as in the regular mode.
+// Islands with Resize kernels are always processed in full width.
+struct GFluidTiling
+{
+    int tileWidth;
+};
+
 namespace detail
 {
 template<> struct CompileArgTag<GFluidOutputRois>
 {
     static const char* tag() { return "gapi.fluid.outputRois"; }
 };
+
+template<> struct CompileArgTag<GFluidTiling>
+{
+    static const char* tag() { return "gapi.fluid.tiling"; }
+};
 } // namespace detail
 
 namespace detail
@@ -66,6 +66,12 @@ public:
         return util::any_cast<typename std::remove_reference<T>::type>(value);
     }
 
+    // Returns nullptr if the value is not of type T
+    template<typename T> inline const T* get_if() const
+    {
+        return util::any_cast<typename std::remove_reference<T>::type>(&value);
+    }
+
     template<typename T> inline T& unsafe_get()
     {
         return util::unsafe_any_cast<typename std::remove_reference<T>::type>(value);
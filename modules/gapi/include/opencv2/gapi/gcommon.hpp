@@ -92,12 +92,38 @@ struct graph_dump_path
     std::string m_dump_path;
 };
 
+// Makes GComputation::compile() (and so apply()) look up a process-wide
+// cache of compiled objects first. The cache is keyed on the graph
+// structure, input metadata and compile arguments, so computations built
+// the same way in the same thread share the same GCompiled (other threads
+// get their own objects, as GCompiled is not reentrant).
+// See cv::gapi::compile_cache_stats() and friends for cache control.
+struct use_compile_cache
+{
+};
+
+// Enables run-time instrumentation of the compiled graph: execution time
+// of every island and operation, number of lines produced by Fluid
+// kernels and size of intermediate buffers are accumulated over all runs.
+// See GCompiled::profile() and GCompiled::dumpProfile().
+struct graph_profiling
+{
+};
+
 namespace detail
 {
     template<> struct CompileArgTag<cv::graph_dump_path>
     {
         static const char* tag() { return "gapi.graph_dump_path"; }
     };
+    template<> struct CompileArgTag<cv::use_compile_cache>
+    {
+        static const char* tag() { return "gapi.use_compile_cache"; }
+    };
+    template<> struct CompileArgTag<cv::graph_profiling>
+    {
+        static const char* tag() { return "gapi.graph_profiling"; }
+    };
 }
 
 } // namespace cv
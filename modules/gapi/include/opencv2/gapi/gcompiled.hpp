@@ -8,6 +8,7 @@
 #ifndef OPENCV_GAPI_GCOMPILED_HPP
 #define OPENCV_GAPI_GCOMPILED_HPP
 
+#include <string>
 #include <vector>
 
 #include "opencv2/gapi/opencv_includes.hpp"
@@ -16,6 +17,27 @@
 
 namespace cv {
 
+namespace gapi
+{
+    // Profiling data of a single island or operation, see cv::graph_profiling
+    struct GProfileEntry
+    {
+        std::string name;              // Island name or kernel id
+        std::size_t calls        = 0u; // Number of executions
+        double      total_ms     = 0.; // Accumulated execution time
+        std::size_t lines        = 0u; // Accumulated number of lines (Fluid only)
+        std::size_t buffer_bytes = 0u; // Memory allocated for internal data
+    };
+
+    struct GProfileReport
+    {
+        std::vector<GProfileEntry> islands;
+        std::vector<GProfileEntry> operations;  // In topological order
+        std::size_t executor_buffer_bytes = 0u; // Data passed between islands
+        std::size_t islands_buffer_bytes  = 0u; // Data internal to islands
+    };
+} // namespace gapi
+
 // This class represents a compiled computation.
 // In theory (and ideally), it can be used w/o the rest of APIs.
 // In theory (and ideally), it can be serialized/deserialized.
@@ -50,6 +72,13 @@ public:
     const GMetaArgs& metas() const; // Meta passed to compile()
     const GMetaArgs& outMetas() const; // Inferred output metadata
 
+    // Profiling data accumulated so far. Empty if the object was not
+    // compiled with cv::graph_profiling
+    gapi::GProfileReport profile() const;
+
+    // Writes the graph in .dot format, annotated with profiling data
+    void dumpProfile(const std::string &path) const;
+
 protected:
     std::shared_ptr<Priv> m_priv;
 };
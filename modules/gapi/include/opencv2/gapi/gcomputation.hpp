@@ -133,6 +133,26 @@ namespace gapi
     void GAPI_EXPORTS island(const std::string &name,
                            GProtoInputArgs  &&ins,
                            GProtoOutputArgs &&outs);
+
+    // Counters of the process-wide compile cache (see cv::use_compile_cache)
+    struct GCompileCacheStats
+    {
+        std::size_t hits      = 0u; // compile() calls served from the cache
+        std::size_t misses    = 0u; // compile() calls which stored a new object
+        std::size_t bypasses  = 0u; // compile() calls on graphs which can't be keyed, or with capacity 0
+        std::size_t evictions = 0u; // objects dropped due to the LRU limit
+        std::size_t size      = 0u; // number of objects currently cached
+        std::size_t capacity  = 0u; // LRU limit
+    };
+
+    GCompileCacheStats GAPI_EXPORTS compile_cache_stats();
+
+    // Sets the maximum number of cached objects. Least recently used
+    // objects are evicted first; 0 disables caching at all.
+    void GAPI_EXPORTS set_compile_cache_capacity(std::size_t capacity);
+
+    // Drops all cached objects and resets the counters
+    void GAPI_EXPORTS clear_compile_cache();
 } // namespace gapi
 
 } // namespace cv
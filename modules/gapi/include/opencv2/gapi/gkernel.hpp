@@ -45,12 +45,22 @@ struct GAPI_EXPORTS GKernel
 struct GAPI_EXPORTS GKernelImpl
 {
     util::any         opaque;    // backend-specific opaque info
+    const void*       impl_id;   // identifies implementation type, see detail::impl_id()
 };
 
 template<typename, typename> class GKernelTypeM;
 
 namespace detail
 {
+    // Returns an address which is unique for every kernel implementation
+    // type (so implementations of the same API by the same backend can be
+    // told apart at run-time, e.g. by the compile cache)
+    template<typename KImpl> const void* impl_id()
+    {
+        static const char id = 0;
+        return &id;
+    }
+
     ////////////////////////////////////////////////////////////////////////////
     // yield() is used in graph construction time as a generic method to obtain
     // lazy "return value" of G-API operations
@@ -358,13 +368,17 @@ namespace gapi {
         {
             auto backend     = KImpl::backend();
             auto kernel_id   = KImpl::API::id();
-            auto kernel_impl = GKernelImpl{KImpl::kernel()};
+            auto kernel_impl = GKernelImpl{KImpl::kernel(), detail::impl_id<KImpl>()};
             m_backend_kernels[backend][kernel_id] = std::move(kernel_impl);
         }
 
         // Lists all backends which are included into package
         std::vector<GBackend> backends() const;
 
+        // Lists ids of all kernel APIs implemented by the given backend
+        // in this package
+        std::vector<std::string> ids(const GBackend &backend) const;
+
         friend GAPI_EXPORTS GKernelPackage combine(const GKernelPackage  &,
                                                  const GKernelPackage  &,
                                                  const cv::unite_policy);
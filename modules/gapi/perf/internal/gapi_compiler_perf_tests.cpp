@@ -39,6 +39,34 @@ PERF_TEST_P_(CompilerPerfTest, TestPerformance)
   SANITY_CHECK_NOTHING();
 }
 
+PERF_TEST_P_(CompilerPerfTest, TestPerformanceCached)
+{
+  const auto params = GetParam();
+  Size sz = get<0>(params);
+  MatType type = get<1>(params);
+
+  initMatsRandU(type, sz, type, false);
+
+  // G-API code ////////////////////////////////////////////////////////////
+  // Graph is re-created on every iteration, as a service would do per request
+  cv::gapi::clear_compile_cache();
+  TEST_CYCLE()
+  {
+      cv::GMat in;
+      auto splitted = cv::gapi::split3(in);
+      auto add1 = cv::gapi::addC({1}, std::get<0>(splitted));
+      auto add2 = cv::gapi::addC({2}, std::get<1>(splitted));
+      auto add3 = cv::gapi::addC({3}, std::get<2>(splitted));
+      auto out = cv::gapi::merge3(add1, add2, add3);
+
+      cv::GComputation c(in, out);
+      c.apply(in_mat1, out_mat_gapi, cv::compile_args(cv::gapi::core::fluid::kernels(),
+                                                      cv::use_compile_cache{}));
+  }
+
+  SANITY_CHECK_NOTHING();
+}
+
 INSTANTIATE_TEST_CASE_P(CompilerPerfTest, CompilerPerfTest,
                         Combine(Values(szSmall128, szVGA, sz720p, sz1080p),
                                 Values(CV_8UC3)));
@@ -21,6 +21,9 @@
 
 #include "compiler/gmodelbuilder.hpp"
 #include "compiler/gcompiler.hpp"
+#include "compiler/gcompilecache.hpp"
+
+#include "backends/common/gbackend.hpp" // getCompileArg
 
 // cv::GComputation private implementation /////////////////////////////////////
 // <none>
@@ -71,7 +74,12 @@ cv::GComputation::GComputation(cv::GProtoInputArgs &&ins,
 
 cv::GCompiled cv::GComputation::compile(GMetaArgs &&metas, GCompileArgs &&args)
 {
-    // FIXME: Cache gcompiled per parameters here?
+    if (cv::gimpl::getCompileArg<cv::use_compile_cache>(args).has_value())
+    {
+        return cv::gimpl::GCompileCache::instance().compile(*this,
+                                                            std::move(metas),
+                                                            std::move(args));
+    }
     cv::gimpl::GCompiler comp(*this, std::move(metas), std::move(args));
     return comp.compile();
 }
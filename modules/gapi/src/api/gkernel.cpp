@@ -139,3 +139,14 @@ std::vector<cv::gapi::GBackend> cv::gapi::GKernelPackage::backends() const
     for (const auto &p : m_backend_kernels) result.emplace_back(p.first);
     return result;
 }
+
+std::vector<std::string> cv::gapi::GKernelPackage::ids(const GBackend &backend) const
+{
+    std::vector<std::string> result;
+    const auto set_iter = m_backend_kernels.find(backend);
+    if (set_iter != m_backend_kernels.end())
+    {
+        for (const auto &p : set_iter->second) result.emplace_back(p.first);
+    }
+    return result;
+}
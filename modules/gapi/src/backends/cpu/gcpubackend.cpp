@@ -81,6 +81,11 @@ cv::gimpl::GCPUExecutable::GCPUExecutable(const ade::Graph &g,
                                           const std::vector<ade::NodeHandle> &nodes)
     : m_g(g), m_gm(m_g)
 {
+    if (m_gm.metadata().contains<Profiling>())
+    {
+        m_profiler = m_gm.metadata().get<Profiling>().profiler;
+    }
+
     // Convert list of operations (which is topologically sorted already)
     // into an execution script.
     for (auto &nh : nodes)
@@ -98,17 +103,38 @@ cv::gimpl::GCPUExecutable::GCPUExecutable(const ade::Graph &g,
                 magazine::bindInArg(m_res, rc, m_gm.metadata(nh).get<ConstValue>().arg);
             }
             //preallocate internal Mats in advance
-            if (desc.storage == Data::Storage::INTERNAL && desc.shape == GShape::GMAT)
+            if (desc.storage == Data::Storage::INTERNAL && desc.shape == GShape::GMAT
+                && !m_gm.metadata(nh).contains<DataAlias>())
             {
                 const auto mat_desc = util::get<cv::GMatDesc>(desc.meta);
                 const auto type = CV_MAKETYPE(mat_desc.depth, mat_desc.chan);
                 m_res.slot<cv::gapi::own::Mat>()[desc.rc].create(mat_desc.size, type);
+                if (m_profiler)
+                {
+                    m_profiler->islandBuffer(nh, mat_desc.size.width * mat_desc.size.height
+                                                 * CV_ELEM_SIZE(type));
+                }
             }
             break;
         }
         default: util::throw_error(std::logic_error("Unsupported NodeType type"));
         }
     }
+
+    // Internal Mats which were decided to share memory with other ones
+    // (see passes::reuseBuffers) just refer to their owners' buffers.
+    // Done in a separate loop since an owner may follow its alias in the list.
+    for (auto &nh : m_dataNodes)
+    {
+        if (m_gm.metadata(nh).contains<DataAlias>())
+        {
+            const auto &owner   = m_gm.metadata(nh).get<DataAlias>().owner;
+            const auto  rc       = m_gm.metadata(nh).get<Data>().rc;
+            const auto  owner_rc = m_gm.metadata(owner).get<Data>().rc;
+            auto &mag_mat = m_res.slot<cv::gapi::own::Mat>();
+            mag_mat[rc] = mag_mat[owner_rc];
+        }
+    }
 }
 
 // FIXME: Document what it does
@@ -202,7 +228,15 @@ void cv::gimpl::GCPUExecutable::run(std::vector<InObj>  &&input_objs,
         }
 
         // Now trigger the executable unit
-        k.apply(context);
+        if (m_profiler)
+        {
+            auto &entry = m_profiler->op(op_info.nh);
+            const auto start = GProfiler::Clock::now();
+            k.apply(context);
+            entry.addTime(start);
+            entry.calls++;
+        }
+        else k.apply(context);
 
         //As Kernels are forbidden to allocate memory for (Mat) outputs,
         //this code seems redundant, at least for Mats
@@ -21,6 +21,7 @@
 #include "api/gapi_priv.hpp"
 #include "backends/common/gbackend.hpp"
 #include "compiler/gislandmodel.hpp"
+#include "executor/gprofiler.hpp"
 
 namespace cv { namespace gimpl {
 
@@ -50,6 +51,8 @@ class GCPUExecutable final: public GIslandExecutable
     Mag m_res;
     GArg packArg(const GArg &arg);
 
+    std::shared_ptr<GProfiler> m_profiler; // Set only if profiling is enabled
+
 public:
     GCPUExecutable(const ade::Graph                   &graph,
                    const std::vector<ade::NodeHandle> &nodes);
@@ -77,7 +77,8 @@ namespace
                              const std::vector<ade::NodeHandle> &nodes) const override
         {
             const auto out_rois = cv::gimpl::getCompileArg<cv::GFluidOutputRois>(args).value_or(cv::GFluidOutputRois());
-            return EPtr{new cv::gimpl::GFluidExecutable(graph, nodes, out_rois.rois)};
+            const auto tiling   = cv::gimpl::getCompileArg<cv::GFluidTiling>(args).value_or(cv::GFluidTiling{0});
+            return EPtr{new cv::gimpl::GFluidExecutable(graph, nodes, out_rois.rois, tiling.tileWidth)};
         }
 
         virtual void addBackendPasses(ade::ExecutionEngineSetupContext &ectx) override;
@@ -418,11 +419,17 @@ void cv::gimpl::FluidAgent::debug(std::ostream &os)
 // GCPUExcecutable implementation //////////////////////////////////////////////
 cv::gimpl::GFluidExecutable::GFluidExecutable(const ade::Graph &g,
                                               const std::vector<ade::NodeHandle> &nodes,
-                                              const std::vector<cv::gapi::own::Rect> &outputRois)
+                                              const std::vector<cv::gapi::own::Rect> &outputRois,
+                                              int tileWidth)
     : m_g(g), m_gm(m_g), m_outputRois(outputRois)
 {
     GConstFluidModel fg(m_g);
 
+    if (m_gm.metadata().contains<Profiling>())
+    {
+        m_profiler = m_gm.metadata().get<Profiling>().profiler;
+    }
+
     // Initialize vector of data buffers, build list of operations
     // FIXME: There _must_ be a better way to [query] count number of DATA nodes
     std::size_t mat_count = 0;
@@ -523,6 +530,10 @@ cv::gimpl::GFluidExecutable::GFluidExecutable(const ade::Graph &g,
         m_outputRois.resize(proto.outputs.size());
     }
 
+    // Decide if island is executed in vertical strips. If so, all buffers
+    // are allocated for a strip (see bufferMeta())
+    initTiling(all_gmat_ids, tileWidth);
+
     // First, initialize rois for output nodes, add them to traversal stack
     for (const auto& it : ade::util::indexed(proto.out_nhs))
     {
@@ -539,11 +550,17 @@ cv::gimpl::GFluidExecutable::GFluidExecutable(const ade::Graph &g,
 
         if (d.shape == GShape::GMAT)
         {
-            auto desc = util::get<GMatDesc>(d.meta);
+            auto desc = bufferMeta(util::get<GMatDesc>(d.meta));
             if (m_outputRois[idx] == cv::gapi::own::Rect{})
             {
                 m_outputRois[idx] = cv::gapi::own::Rect{0, 0, desc.size.width, desc.size.height};
             }
+            if (m_tiling.width > 0)
+            {
+                // Columns are handled by strips, every strip is computed in full
+                m_outputRois[idx].x     = 0;
+                m_outputRois[idx].width = desc.size.width;
+            }
 
             // Only slices are supported at the moment
             GAPI_Assert(m_outputRois[idx].x == 0);
@@ -657,7 +674,7 @@ cv::gimpl::GFluidExecutable::GFluidExecutable(const ade::Graph &g,
         auto nh = it.second;
         const auto & d  = m_gm.metadata(nh).get<Data>();
         const auto &fd  = fg.metadata(nh).get<FluidData>();
-        const auto meta = cv::util::get<GMatDesc>(d.meta);
+        const auto meta = bufferMeta(cv::util::get<GMatDesc>(d.meta));
 
         // FIXME: Only continuous set...
         m_buffers[id].priv().init(meta, fd.max_consumption, fd.border_size, fd.skew, fd.lpi_write, readStarts[id], rois[id]);
@@ -736,7 +753,9 @@ cv::gimpl::GFluidExecutable::GFluidExecutable(const ade::Graph &g,
             for (auto eh : agent->op_handle->inEdges())
             {
                 const auto& in_data = m_gm.metadata(eh->srcNode()).get<Data>();
-                in_metas[m_gm.metadata(eh).get<Input>().port] = in_data.meta;
+                in_metas[m_gm.metadata(eh).get<Input>().port] = in_data.shape == GShape::GMAT
+                    ? GMetaArg(bufferMeta(util::get<GMatDesc>(in_data.meta)))
+                    : in_data.meta;
             }
 
             // Trigger Scratch buffer initialization method
@@ -766,10 +785,119 @@ cv::gimpl::GFluidExecutable::GFluidExecutable(const ade::Graph &g,
         // Buffers which will be bound to real images may have size of 0 at this moment
         // (There can be non-zero sized const border buffer allocated in such buffers)
         total_size += b.priv().size();
+
+        if (m_profiler && b.priv().size() > 0)
+        {
+            // Scratch buffers are accounted to their operations
+            const auto &nh = idx < m_num_int_buffers
+                ? all_gmat_ids[idx]
+                : m_agents.at(m_scratch_users.at(idx - m_num_int_buffers))->op_handle;
+            m_profiler->islandBuffer(nh, b.priv().size());
+        }
     }
     GAPI_LOG_INFO(NULL, "Internal buffers: " << std::fixed << std::setprecision(2) << static_cast<float>(total_size)/1024 << " KB\n");
 }
 
+void cv::gimpl::GFluidExecutable::initTiling(const std::map<std::size_t, ade::NodeHandle> &all_gmat_ids,
+                                             int tileWidth)
+{
+    GConstFluidModel fg(m_g);
+    const auto &proto = m_gm.metadata().get<Protocol>();
+
+    int  width = -1;
+    bool same_width = true;
+    for (const auto &it : all_gmat_ids)
+    {
+        const auto w = util::get<GMatDesc>(m_gm.metadata(it.second).get<Data>().meta).size.width;
+        if (width < 0) width = w;
+        same_width = same_width && (w == width);
+    }
+
+    // Collect columns requested for island outputs. Strips are shared
+    // by all outputs, so all of them must request the same columns
+    std::set<std::pair<int, int> > columns;
+    bool partial = false;
+    for (const auto& it : ade::util::indexed(proto.out_nhs))
+    {
+        const auto &d   = m_gm.metadata(ade::util::value(it)).get<Data>();
+        const auto &roi = m_outputRois[ade::util::index(it)];
+        if (m_id_map.count(d.rc) == 0 || d.shape != GShape::GMAT)
+            continue;
+
+        // Row ranges of the full width (as with slices) don't need tiling
+        const auto desc = util::get<GMatDesc>(d.meta);
+        const auto cols = roi == cv::gapi::own::Rect{}
+                        ? std::make_pair(0, desc.size.width)
+                        : std::make_pair(roi.x, roi.x + roi.width);
+        partial = partial || cols != std::make_pair(0, desc.size.width);
+        columns.insert(cols);
+    }
+
+    if (!partial && tileWidth <= 0)
+        return;
+
+    const bool has_resize = std::any_of(m_agents.begin(), m_agents.end(),
+                                        [](const std::unique_ptr<FluidAgent> &agent) {
+                                            return agent->k.m_kind == GFluidKernel::Kind::Resize;
+                                        });
+    if (has_resize || !same_width)
+    {
+        // Only slices are supported at the moment
+        GAPI_Assert(!partial);
+        GAPI_LOG_INFO(NULL, "Fluid island can't be tiled, processing in full width\n");
+        return;
+    }
+    GAPI_Assert(columns.size() == 1u);
+
+    // Every Filter widens the area it reads by its border size, so the halo
+    // of a strip is the maximum total border size along a path through island
+    std::unordered_set<ade::NodeHandle, ade::HandleHasher<ade::Node> > ops;
+    for (const auto &agent : m_agents) ops.insert(agent->op_handle);
+
+    std::unordered_map<ade::NodeHandle, int, ade::HandleHasher<ade::Node> > halos;
+    for (const auto &nh : m_gm.metadata().get<ade::passes::TopologicalSortData>().nodes())
+    {
+        if (ops.count(nh) == 0)
+            continue;
+
+        int in_halo = 0;
+        for (const auto &in_nh : nh->inNodes())
+        {
+            auto it = halos.find(in_nh);
+            if (it != halos.end()) in_halo = std::max(in_halo, it->second);
+        }
+        const int out_halo = in_halo + fg.metadata(nh).get<FluidUnit>().border_size;
+        for (const auto &out_nh : nh->outNodes()) halos[out_nh] = out_halo;
+        m_tiling.halo = std::max(m_tiling.halo, out_halo);
+    }
+
+    m_tiling.x0 = columns.begin()->first;
+    m_tiling.x1 = columns.begin()->second;
+    m_tiling.full_width = width;
+
+    const int tile = tileWidth > 0 ? tileWidth : m_tiling.x1 - m_tiling.x0;
+    m_tiling.width = std::min(width, tile + 2*m_tiling.halo);
+    if (!partial && m_tiling.width == width)
+    {
+        // A single strip, nothing to do
+        m_tiling.width = 0;
+        return;
+    }
+
+    GAPI_LOG_INFO(NULL, "Fluid island is processed in strips of " << m_tiling.width
+                  << " pixels (halo: " << m_tiling.halo << ")\n");
+}
+
+cv::GMatDesc cv::gimpl::GFluidExecutable::bufferMeta(const cv::GMatDesc &desc) const
+{
+    if (m_tiling.width == 0)
+        return desc;
+
+    cv::GMatDesc strip_desc = desc;
+    strip_desc.size.width = m_tiling.width;
+    return strip_desc;
+}
+
 // FIXME: Document what it does
 void cv::gimpl::GFluidExecutable::bindInArg(const cv::gimpl::RcDesc &rc, const GRunArg &arg)
 {
@@ -817,10 +945,82 @@ void cv::gimpl::GFluidExecutable::packArg(cv::GArg &in_arg, const cv::GArg &op_a
 void cv::gimpl::GFluidExecutable::run(std::vector<InObj>  &&input_objs,
                                       std::vector<OutObj> &&output_objs)
 {
+    if (m_tiling.width > 0)
+    {
+        runTiled(std::move(input_objs), std::move(output_objs));
+        return;
+    }
+
     // Bind input buffers from parameters
     for (auto& it : input_objs)  bindInArg(it.first, it.second);
     for (auto& it : output_objs) bindOutArg(it.first, it.second);
 
+    runAgents();
+}
+
+void cv::gimpl::GFluidExecutable::runTiled(std::vector<InObj>  &&input_objs,
+                                           std::vector<OutObj> &&output_objs)
+{
+    // Strips are computed into temporary images first, then their valid
+    // columns are copied to the real outputs
+    for (auto& it : output_objs)
+    {
+        const auto &rc = it.first;
+        if (rc.shape != GShape::GMAT)
+            util::throw_error(std::logic_error("Unsupported return GShape type"));
+
+        auto &buffer = m_buffers[m_id_map.at(rc.id)];
+        auto  desc   = buffer.meta();
+        auto &outMat = *util::get<cv::gapi::own::Mat*>(it.second);
+        desc.size.width = m_tiling.full_width;
+        GAPI_Assert(outMat.data != nullptr);
+        GAPI_Assert(descr_of(outMat) == desc && "Output argument was not preallocated as it should be ?");
+
+        auto &strip = m_tile_outs[rc.id];
+        strip.create(desc.size.height, m_tiling.width, outMat.type());
+        buffer.priv().bindTo(strip, false);
+    }
+
+    int x = m_tiling.x0;
+    while (x < m_tiling.x1)
+    {
+        // Strip starts a halo before the first column to compute and is
+        // kept within the image. Columns within a halo from the strip edge
+        // are valid only if the edge is also the image edge.
+        const int sx = std::max(0, std::min(x - m_tiling.halo, m_tiling.full_width - m_tiling.width));
+        const int valid_end = (sx + m_tiling.width == m_tiling.full_width)
+            ? m_tiling.full_width
+            : sx + m_tiling.width - m_tiling.halo;
+        const int end = std::min(m_tiling.x1, valid_end);
+        GAPI_Assert(end > x);
+
+        for (auto& it : input_objs)
+        {
+            if (it.first.shape == GShape::GMAT)
+            {
+                const auto &mat = util::get<cv::gapi::own::Mat>(it.second);
+                m_buffers[m_id_map.at(it.first.id)].priv()
+                    .bindTo(mat(cv::gapi::own::Rect{sx, 0, m_tiling.width, mat.rows}), true);
+            }
+            else bindInArg(it.first, it.second);
+        }
+
+        runAgents();
+
+        for (auto& it : output_objs)
+        {
+            const auto &buffer = m_buffers[m_id_map.at(it.first.id)].priv();
+            const cv::gapi::own::Rect src{x - sx, buffer.writeStart(), end - x, buffer.outputLines()};
+            const cv::gapi::own::Rect dst{x,      buffer.writeStart(), end - x, buffer.outputLines()};
+            auto out = (*util::get<cv::gapi::own::Mat*>(it.second))(dst);
+            m_tile_outs.at(it.first.id)(src).copyTo(out);
+        }
+        x = end;
+    }
+}
+
+void cv::gimpl::GFluidExecutable::runAgents()
+{
     // Reset Buffers and Agents state before we go
     for (auto &buffer : m_buffers)
         buffer.priv().reset();
@@ -837,6 +1037,11 @@ void cv::gimpl::GFluidExecutable::run(std::vector<InObj>  &&input_objs,
         }
     }
 
+    if (m_profiler)
+    {
+        for (auto &agent : m_agents) m_profiler->op(agent->op_handle).calls++;
+    }
+
     // Explicitly reset Scratch buffers, if any
     for (auto scratch_i : m_scratch_users)
     {
@@ -868,7 +1073,16 @@ void cv::gimpl::GFluidExecutable::run(std::vector<InObj>  &&input_objs,
             {
                 if (agent->canWork())
                 {
-                    agent->doWork(); work_done=true;
+                    if (m_profiler)
+                    {
+                        auto &entry = m_profiler->op(agent->op_handle);
+                        const auto start = GProfiler::Clock::now();
+                        agent->doWork();
+                        entry.addTime(start);
+                        entry.lines += static_cast<std::size_t>(agent->k.m_lpi);
+                    }
+                    else agent->doWork();
+                    work_done=true;
                 }
                 if (!agent->done())   complete = false;
             }
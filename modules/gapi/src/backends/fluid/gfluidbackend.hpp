@@ -16,6 +16,7 @@
 // PRIVATE STUFF!
 #include "backends/common/gbackend.hpp"
 #include "compiler/gislandmodel.hpp"
+#include "executor/gprofiler.hpp"
 
 namespace cv { namespace gimpl {
 
@@ -110,14 +111,37 @@ class GFluidExecutable final: public GIslandExecutable
 
     std::unordered_map<int, std::size_t> m_id_map; // GMat id -> buffer idx map
 
+    std::shared_ptr<GProfiler> m_profiler; // Set only if profiling is enabled
+
+    // Tiled execution (see GFluidTiling). All buffers are allocated for
+    // a strip of "width" pixels (halo included), island is executed for
+    // every strip covering [x0, x1) output columns.
+    struct Tiling
+    {
+        int width = 0; // 0 means island is processed in full width
+        int halo  = 0; // columns required by kernel windows at each side
+        int x0    = 0;
+        int x1    = 0;
+        int full_width = 0;
+    } m_tiling;
+    std::unordered_map<int, cv::gapi::own::Mat> m_tile_outs; // GMat id -> strip output
+
+    void initTiling(const std::map<std::size_t, ade::NodeHandle> &all_gmat_ids, int tileWidth);
+    cv::GMatDesc bufferMeta(const cv::GMatDesc &desc) const;
+
     void bindInArg (const RcDesc &rc, const GRunArg &arg);
     void bindOutArg(const RcDesc &rc, const GRunArgP &arg);
     void packArg   (GArg &in_arg, const GArg &op_arg);
 
+    void runAgents();
+    void runTiled(std::vector<InObj>  &&input_objs,
+                  std::vector<OutObj> &&output_objs);
+
 public:
     GFluidExecutable(const ade::Graph &g,
                      const std::vector<ade::NodeHandle> &nodes,
-                     const std::vector<cv::gapi::own::Rect> &outputRois);
+                     const std::vector<cv::gapi::own::Rect> &outputRois,
+                     int tileWidth = 0);
 
     virtual void run(std::vector<InObj>  &&input_objs,
                      std::vector<OutObj> &&output_objs) override;
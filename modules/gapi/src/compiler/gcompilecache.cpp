@@ -0,0 +1,460 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+//
+// Copyright (C) 2018 Intel Corporation
+
+
+#include "precomp.hpp"
+
+#include <algorithm>     // sort
+#include <cstdint>       // uintptr_t
+#include <thread>        // this_thread
+#include <type_traits>   // is_arithmetic
+#include <unordered_map> // unordered_map
+#include <utility>       // pair
+
+#include "opencv2/gapi/fluid/gfluidkernel.hpp" // GFluidOutputRois, GFluidTiling
+
+#include "api/gcomputation_priv.hpp"
+#include "api/gnode_priv.hpp"
+#include "api/gcall_priv.hpp"
+#include "api/gproto_priv.hpp"
+#include "api/gapi_priv.hpp"
+
+#include "compiler/gcompiler.hpp"
+#include "compiler/gcompilecache.hpp"
+
+#include "logger.hpp"
+
+namespace
+{
+    // Appends values to the key in a binary form. Every variable-length
+    // entry is prefixed with its size, so the result is unambiguous.
+    class KeyWriter
+    {
+        std::string &m_key;
+
+    public:
+        explicit KeyWriter(std::string &key) : m_key(key) {}
+
+        template<typename T> void pod(const T &t)
+        {
+            static_assert(std::is_arithmetic<T>::value, "Only arithmetic types are written as-is");
+            m_key.append(reinterpret_cast<const char*>(&t), sizeof(T));
+        }
+
+        void tag(char c) { m_key.push_back(c); }
+
+        void str(const std::string &s)
+        {
+            pod(s.size());
+            m_key.append(s);
+        }
+
+        void bytes(const void *data, std::size_t size)
+        {
+            pod(size);
+            m_key.append(static_cast<const char*>(data), size);
+        }
+    };
+
+    void put(KeyWriter &w, int v)    { w.tag('i'); w.pod(v); }
+    void put(KeyWriter &w, double v) { w.tag('d'); w.pod(v); }
+    void put(KeyWriter &w, float v)  { w.tag('f'); w.pod(v); }
+    void put(KeyWriter &w, bool v)   { w.tag('b'); w.pod(v); }
+
+    void put(KeyWriter &w, const cv::gapi::own::Size &sz)
+    {
+        w.tag('S'); w.pod(sz.width); w.pod(sz.height);
+    }
+    void put(KeyWriter &w, const cv::gapi::own::Point &pt)
+    {
+        w.tag('P'); w.pod(pt.x); w.pod(pt.y);
+    }
+    void put(KeyWriter &w, const cv::gapi::own::Rect &rc)
+    {
+        w.tag('R'); w.pod(rc.x); w.pod(rc.y); w.pod(rc.width); w.pod(rc.height);
+    }
+    void put(KeyWriter &w, const cv::gapi::own::Scalar &s)
+    {
+        w.tag('V'); for (int i = 0; i < 4; i++) w.pod(s[i]);
+    }
+
+#if !defined(GAPI_STANDALONE)
+    void put(KeyWriter &w, const cv::Size &sz)
+    {
+        w.tag('s'); w.pod(sz.width); w.pod(sz.height);
+    }
+    void put(KeyWriter &w, const cv::Point &pt)
+    {
+        w.tag('p'); w.pod(pt.x); w.pod(pt.y);
+    }
+    void put(KeyWriter &w, const cv::Rect &rc)
+    {
+        w.tag('r'); w.pod(rc.x); w.pod(rc.y); w.pod(rc.width); w.pod(rc.height);
+    }
+    void put(KeyWriter &w, const cv::Scalar &s)
+    {
+        w.tag('v'); for (int i = 0; i < 4; i++) w.pod(s[i]);
+    }
+    void put(KeyWriter &w, const cv::Mat &m)
+    {
+        // Static matrices (e.g. filter kernels) are small, so put the data
+        // into the key as well
+        w.tag('m'); w.pod(m.type()); w.pod(m.dims);
+        for (int i = 0; i < m.dims; i++) w.pod(m.size[i]);
+        const cv::Mat cont = m.isContinuous() ? m : m.clone();
+        w.bytes(cont.data, cont.total() * cont.elemSize());
+    }
+#endif // !defined(GAPI_STANDALONE)
+
+    template<typename T> bool tryPut(KeyWriter &w, const cv::GArg &arg)
+    {
+        const T* p = arg.get_if<T>();
+        if (p) put(w, *p);
+        return p != nullptr;
+    }
+
+    // Static (non-G-type) operation parameters
+    bool putStatic(KeyWriter &w, const cv::GArg &arg)
+    {
+        return tryPut<int>(w, arg)
+            || tryPut<double>(w, arg)
+            || tryPut<float>(w, arg)
+            || tryPut<bool>(w, arg)
+            || tryPut<cv::gapi::own::Size>(w, arg)
+            || tryPut<cv::gapi::own::Point>(w, arg)
+            || tryPut<cv::gapi::own::Rect>(w, arg)
+            || tryPut<cv::gapi::own::Scalar>(w, arg)
+#if !defined(GAPI_STANDALONE)
+            || tryPut<cv::Size>(w, arg)
+            || tryPut<cv::Point>(w, arg)
+            || tryPut<cv::Rect>(w, arg)
+            || tryPut<cv::Scalar>(w, arg)
+            || tryPut<cv::Mat>(w, arg)
+#endif // !defined(GAPI_STANDALONE)
+            ;
+    }
+
+    // Serializes expression graph in a canonical order: starting from
+    // the protocol outputs, every data object and operation is written
+    // once (operations - after all their arguments), and every subsequent
+    // reference to the same object is written as its ordinal number.
+    class GraphKeyWriter
+    {
+        KeyWriter &m_w;
+        cv::GOriginMap<std::size_t> m_ins;  // Protocol inputs -> index
+        cv::GOriginMap<std::size_t> m_data; // Visited data objects -> ordinal
+        std::unordered_map<const cv::GNode::Priv*, std::size_t> m_ops;
+
+        bool putOp(const cv::GNode &node)
+        {
+            if (m_ops.count(&node.priv()) > 0)
+                return true;
+
+            const cv::GCall::Priv &call_p = node.call().priv();
+            for (const auto &arg : call_p.m_args)
+            {
+                const bool ok = cv::gimpl::proto::is_dynamic(arg)
+                    ? putData(cv::gimpl::proto::origin_of(arg))
+                    : putStatic(m_w, arg);
+                if (!ok) return false;
+            }
+            m_w.tag('K');
+            m_w.str(call_p.m_k.name);
+            m_w.str(node.priv().m_island);
+            m_w.pod(call_p.m_args.size());
+            m_ops.emplace(&node.priv(), m_ops.size());
+            return true;
+        }
+
+        bool putData(const cv::GOrigin &origin)
+        {
+            const auto data_it = m_data.find(origin);
+            if (data_it != m_data.end())
+            {
+                m_w.tag('D'); m_w.pod(data_it->second);
+                return true;
+            }
+
+            const auto in_it = m_ins.find(origin);
+            if (in_it != m_ins.end())
+            {
+                m_w.tag('I'); m_w.pod(in_it->second);
+            }
+            else
+            {
+                switch (origin.node.shape())
+                {
+                case cv::GNode::NodeShape::CALL:
+                    if (!putOp(origin.node)) return false;
+                    m_w.tag('O');
+                    m_w.pod(m_ops.at(&origin.node.priv()));
+                    m_w.pod(origin.port);
+                    break;
+
+                case cv::GNode::NodeShape::CONST_BOUNDED:
+                    if (!cv::util::holds_alternative<cv::gapi::own::Scalar>(origin.value))
+                        return false;
+                    m_w.tag('C');
+                    put(m_w, cv::util::get<cv::gapi::own::Scalar>(origin.value));
+                    break;
+
+                default:
+                    // Invalid protocol - let the compiler report it
+                    return false;
+                }
+            }
+            m_w.pod(static_cast<int>(origin.shape));
+            m_data.emplace(origin, m_data.size());
+            return true;
+        }
+
+    public:
+        explicit GraphKeyWriter(KeyWriter &w) : m_w(w) {}
+
+        bool write(const cv::GProtoArgs &ins, const cv::GProtoArgs &outs)
+        {
+            for (const auto &in : ins)
+            {
+                m_ins.emplace(cv::gimpl::proto::origin_of(in), m_ins.size());
+            }
+            m_w.pod(ins.size());
+            m_w.pod(outs.size());
+            for (const auto &out : outs)
+            {
+                if (!putData(cv::gimpl::proto::origin_of(out))) return false;
+            }
+            return true;
+        }
+    };
+
+    void putMetas(KeyWriter &w, const cv::GMetaArgs &metas)
+    {
+        w.pod(metas.size());
+        for (const auto &meta : metas)
+        {
+            w.pod(meta.index());
+            if (cv::util::holds_alternative<cv::GMatDesc>(meta))
+            {
+                const auto &desc = cv::util::get<cv::GMatDesc>(meta);
+                w.pod(desc.depth);
+                w.pod(desc.chan);
+                put(w, desc.size);
+            }
+            // GScalarDesc and GArrayDesc carry no information yet
+        }
+    }
+
+    bool putCompileArgs(KeyWriter &w, const cv::GCompileArgs &args)
+    {
+        using cv::detail::CompileArgTag;
+        for (const auto &arg : args)
+        {
+            if (arg.tag == CompileArgTag<cv::use_compile_cache>::tag())
+                continue;
+
+            w.str(arg.tag);
+            if (arg.tag == CompileArgTag<cv::gapi::GKernelPackage>::tag())
+            {
+                // Kernel packages are identified by (backend, kernel ids)
+                // pairs, where every kernel API id comes with its
+                // implementation id (a package may bring its own
+                // implementation of a standard API). Sort everything to not
+                // depend on hash tables order.
+                const auto &pkg = arg.get<cv::gapi::GKernelPackage>();
+                using Kernel = std::pair<std::string, std::uintptr_t>;
+                std::vector<std::pair<std::size_t, std::vector<Kernel> > > kernels;
+                for (const auto &b : pkg.backends())
+                {
+                    std::vector<Kernel> impls;
+                    for (const auto &id : pkg.ids(b))
+                    {
+                        const auto impl = pkg.lookup(id, cv::gapi::lookup_order({b})).second;
+                        impls.emplace_back(id, reinterpret_cast<std::uintptr_t>(impl.impl_id));
+                    }
+                    std::sort(impls.begin(), impls.end());
+                    kernels.emplace_back(b.hash(), std::move(impls));
+                }
+                std::sort(kernels.begin(), kernels.end());
+                w.pod(kernels.size());
+                for (const auto &k : kernels)
+                {
+                    w.pod(k.first);
+                    w.pod(k.second.size());
+                    for (const auto &impl : k.second)
+                    {
+                        w.str(impl.first);
+                        w.pod(impl.second);
+                    }
+                }
+            }
+            else if (arg.tag == CompileArgTag<cv::gapi::GLookupOrder>::tag())
+            {
+                const auto &order = arg.get<cv::gapi::GLookupOrder>();
+                w.pod(order.size());
+                for (const auto &b : order) w.pod(b.hash());
+            }
+            else if (arg.tag == CompileArgTag<cv::graph_dump_path>::tag())
+            {
+                w.str(arg.get<cv::graph_dump_path>().m_dump_path);
+            }
+            else if (arg.tag == CompileArgTag<cv::GFluidOutputRois>::tag())
+            {
+                const auto &rois = arg.get<cv::GFluidOutputRois>().rois;
+                w.pod(rois.size());
+                for (const auto &rc : rois) put(w, rc);
+            }
+            else if (arg.tag == CompileArgTag<cv::GFluidTiling>::tag())
+            {
+                w.pod(arg.get<cv::GFluidTiling>().tileWidth);
+            }
+            else
+            {
+                // Unknown argument, can't tell how it affects compilation
+                return false;
+            }
+        }
+        return true;
+    }
+} // anonymous namespace
+
+// GCompileCache implementation ////////////////////////////////////////////////
+
+cv::gimpl::GCompileCache::GCompileCache()
+{
+    m_stats.capacity = 64u;
+}
+
+cv::gimpl::GCompileCache& cv::gimpl::GCompileCache::instance()
+{
+    static GCompileCache cache;
+    return cache;
+}
+
+bool cv::gimpl::GCompileCache::makeKey(const cv::GComputation &c,
+                                       const cv::GMetaArgs    &metas,
+                                       const cv::GCompileArgs &args,
+                                       std::string            &key)
+{
+    key.clear();
+    KeyWriter w(key);
+    GraphKeyWriter gw(w);
+    if (!gw.write(c.priv().m_ins, c.priv().m_outs))
+        return false;
+    putMetas(w, metas);
+    return putCompileArgs(w, args);
+}
+
+cv::GCompiled cv::gimpl::GCompileCache::compile(const cv::GComputation &c,
+                                                cv::GMetaArgs    &&metas,
+                                                cv::GCompileArgs &&args)
+{
+    // GCompiled is not reentrant, so objects are shared only by
+    // computations running in the same thread: the key starts with
+    // the thread id. Entries of finished threads are evicted as usual.
+    std::string key;
+    bool cacheable = false;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        cacheable = m_stats.capacity > 0u;
+    }
+    if (cacheable)
+    {
+        const std::thread::id tid = std::this_thread::get_id();
+        KeyWriter(key).bytes(&tid, sizeof(tid));
+        std::string graph_key;
+        cacheable = makeKey(c, metas, args, graph_key);
+        key += graph_key;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!cacheable)
+        {
+            m_stats.bypasses++;
+        }
+        else
+        {
+            const auto it = m_index.find(key);
+            if (it != m_index.end())
+            {
+                m_lru.splice(m_lru.begin(), m_lru, it->second);
+                m_stats.hits++;
+                return it->second->second;
+            }
+            m_stats.misses++;
+        }
+    }
+
+    // Compile outside of the lock, so different graphs are compiled
+    // in parallel. If the same graph is compiled concurrently, the first
+    // stored object wins.
+    GCompiler comp(c, std::move(metas), std::move(args));
+    GCompiled compiled = comp.compile();
+    if (cacheable)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_stats.capacity > 0u && m_index.count(key) == 0u)
+        {
+            m_lru.emplace_front(key, compiled);
+            m_index.emplace(std::move(key), m_lru.begin());
+            evict();
+            GAPI_LOG_INFO(NULL, "Compile cache: stored a new object, "
+                          << m_lru.size() << " objects in total");
+        }
+    }
+    return compiled;
+}
+
+void cv::gimpl::GCompileCache::evict()
+{
+    while (m_lru.size() > m_stats.capacity)
+    {
+        m_index.erase(m_lru.back().first);
+        m_lru.pop_back();
+        m_stats.evictions++;
+    }
+}
+
+void cv::gimpl::GCompileCache::setCapacity(std::size_t capacity)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stats.capacity = capacity;
+    evict();
+}
+
+void cv::gimpl::GCompileCache::clear()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const auto capacity = m_stats.capacity;
+    m_lru.clear();
+    m_index.clear();
+    m_stats = cv::gapi::GCompileCacheStats();
+    m_stats.capacity = capacity;
+}
+
+cv::gapi::GCompileCacheStats cv::gimpl::GCompileCache::stats() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto result = m_stats;
+    result.size = m_lru.size();
+    return result;
+}
+
+// Public API //////////////////////////////////////////////////////////////////
+
+cv::gapi::GCompileCacheStats cv::gapi::compile_cache_stats()
+{
+    return cv::gimpl::GCompileCache::instance().stats();
+}
+
+void cv::gapi::set_compile_cache_capacity(std::size_t capacity)
+{
+    cv::gimpl::GCompileCache::instance().setCapacity(capacity);
+}
+
+void cv::gapi::clear_compile_cache()
+{
+    cv::gimpl::GCompileCache::instance().clear();
+}
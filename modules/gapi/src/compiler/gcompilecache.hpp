@@ -0,0 +1,70 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+//
+// Copyright (C) 2018 Intel Corporation
+
+
+#ifndef OPENCV_GAPI_GCOMPILECACHE_HPP
+#define OPENCV_GAPI_GCOMPILECACHE_HPP
+
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "opencv2/gapi/gcommon.hpp"
+#include "opencv2/gapi/gcompiled.hpp"
+#include "opencv2/gapi/gcomputation.hpp"
+
+namespace cv { namespace gimpl {
+
+// Process-wide LRU cache of GCompiled objects, see cv::use_compile_cache.
+//
+// A cache key is a binary string which describes the computation
+// unambiguously: graph structure (operations, their static parameters,
+// island names and data links), input metadata and compile arguments.
+// Every graph is serialized in a canonical (traversal) order, so the key
+// doesn't depend on where in memory the graph objects live - it only
+// depends on how the graph has been built.
+//
+// GCompiled objects are not reentrant, so every thread gets its own
+// objects: compile() prefixes the key with the calling thread id.
+//
+// Graphs which can't be keyed (e.g. operations with static parameters of
+// user-defined types, or unknown compile arguments) are compiled as usual
+// and are not stored, as well as all graphs when the capacity is 0.
+// FIXME: exported for internal tests only!
+class GAPI_EXPORTS GCompileCache
+{
+public:
+    static GCompileCache& instance();
+
+    // Returns false if this computation can't be represented by a key
+    static bool makeKey(const GComputation &c,
+                        const GMetaArgs    &metas,
+                        const GCompileArgs &args,
+                        std::string        &key);
+
+    GCompiled compile(const GComputation &c,
+                      GMetaArgs    &&metas,
+                      GCompileArgs &&args);
+
+    void setCapacity(std::size_t capacity);
+    void clear();
+    cv::gapi::GCompileCacheStats stats() const;
+
+private:
+    GCompileCache();
+    void evict(); // NB: must be called under lock
+
+    using Entry = std::pair<std::string, GCompiled>;
+    std::list<Entry> m_lru; // Most recently used objects go first
+    std::unordered_map<std::string, std::list<Entry>::iterator> m_index;
+    cv::gapi::GCompileCacheStats m_stats;
+    mutable std::mutex m_mutex;
+};
+
+}}
+
+#endif // OPENCV_GAPI_GCOMPILECACHE_HPP
@@ -7,6 +7,8 @@
 
 #include "precomp.hpp"
 
+#include <fstream>
+
 #include <ade/graph.hpp>
 
 #include "opencv2/gapi/gproto.hpp" // descr_of
@@ -65,6 +67,23 @@ const cv::gimpl::GModel::Graph& cv::GCompiled::Priv::model() const
     return m_exec->model();
 }
 
+cv::gapi::GProfileReport cv::GCompiled::Priv::profile() const
+{
+    GAPI_Assert(nullptr != m_exec);
+    return m_exec->profile();
+}
+
+void cv::GCompiled::Priv::dumpProfile(const std::string &path) const
+{
+    GAPI_Assert(nullptr != m_exec);
+    std::ofstream dump_file(path);
+    if (!dump_file.is_open())
+    {
+        util::throw_error(std::runtime_error("Can't open " + path + " for writing"));
+    }
+    m_exec->dumpProfile(dump_file);
+}
+
 // GCompiled public implementation /////////////////////////////////////////////
 cv::GCompiled::GCompiled()
     : m_priv(new Priv())
@@ -129,6 +148,16 @@ const cv::GMetaArgs& cv::GCompiled::outMetas() const
     return m_priv->outMetas();
 }
 
+cv::gapi::GProfileReport cv::GCompiled::profile() const
+{
+    return m_priv->profile();
+}
+
+void cv::GCompiled::dumpProfile(const std::string &path) const
+{
+    m_priv->dumpProfile(path);
+}
+
 
 cv::GCompiled::Priv& cv::GCompiled::priv()
 {
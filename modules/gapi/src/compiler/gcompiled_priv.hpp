@@ -51,6 +51,9 @@ public:
     const GMetaArgs& outMetas() const;
 
     const cv::gimpl::GModel::Graph& model() const;
+
+    cv::gapi::GProfileReport profile() const;
+    void dumpProfile(const std::string &path) const;
 };
 
 }
@@ -31,6 +31,7 @@
 #include "compiler/passes/passes.hpp"
 
 #include "executor/gexecutor.hpp"
+#include "executor/gprofiler.hpp"
 #include "backends/common/gbackend.hpp"
 
 // <FIXME:>
@@ -123,6 +124,7 @@ cv::gimpl::GCompiler::GCompiler(const cv::GComputation &c,
     m_e.addPassStage("exec");
     m_e.addPass("exec", "fuse_islands",     passes::fuseIslands);
     m_e.addPass("exec", "sync_islands",     passes::syncIslandTags);
+    m_e.addPass("exec", "reuse_buffers",    passes::reuseBuffers);
 
     if (dump_path.has_value())
     {
@@ -220,6 +222,12 @@ cv::gimpl::GCompiler::GPtr cv::gimpl::GCompiler::generateGraph()
     std::tie(p.inputs, p.outputs, p.in_nhs, p.out_nhs) = proto_slots;
     gm.metadata().set(p);
 
+    // Executables will find the profiling data collector here
+    if (getCompileArg<cv::graph_profiling>(m_args).has_value())
+    {
+        gm.metadata().set(Profiling{std::make_shared<GProfiler>()});
+    }
+
     return pG;
 }
 
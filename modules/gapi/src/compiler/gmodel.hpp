@@ -33,6 +33,8 @@
 
 namespace cv { namespace gimpl {
 
+class GProfiler;
+
 // TODO: Document all metadata types
 
 struct NodeType
@@ -149,6 +151,25 @@ struct IslandModel
     std::shared_ptr<ade::Graph> model;
 };
 
+// Set by the "reuse_buffers" pass to island-internal GMat objects which
+// don't need a buffer of their own. Such object can be stored in the
+// memory allocated for the "owner" data object (the owner is the first
+// object which used that buffer and has no DataAlias by itself).
+// Backends which don't preallocate internal data may ignore it.
+struct DataAlias
+{
+    static const char *name() { return "DataAlias"; }
+    ade::NodeHandle owner;
+};
+
+// Run-time profiling data collector, is set only if the graph is
+// compiled with cv::graph_profiling
+struct Profiling
+{
+    static const char *name() { return "Profiling"; }
+    std::shared_ptr<GProfiler> profiler;
+};
+
 // List of backends selected for current graph execution
 struct ActiveBackends
 {
@@ -174,6 +195,8 @@ namespace GModel
         , Layout
         , IslandModel
         , ActiveBackends
+        , DataAlias
+        , Profiling
         >;
 
     // FIXME: How to define it based on GModel???
@@ -193,6 +216,8 @@ namespace GModel
         , Layout
         , IslandModel
         , ActiveBackends
+        , DataAlias
+        , Profiling
         >;
 
     // User should initialize graph before using it
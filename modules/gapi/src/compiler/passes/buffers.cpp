@@ -0,0 +1,211 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+//
+// Copyright (C) 2018 Intel Corporation
+
+
+#include "precomp.hpp"
+
+#include <algorithm>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include <ade/util/algorithm.hpp>
+#include <ade/graph.hpp>
+
+#include "compiler/gmodel.hpp"
+#include "compiler/gislandmodel.hpp"
+#include "compiler/passes/passes.hpp"
+
+namespace
+{
+    using namespace cv::gimpl;
+
+    using NodeSet = std::unordered_set<ade::NodeHandle, ade::HandleHasher<ade::Node>>;
+    template<typename T>
+    using NodeMap = std::unordered_map<ade::NodeHandle, T, ade::HandleHasher<ade::Node>>;
+
+    // Operations which compute every output pixel from the input pixels
+    // at the same position only, so their output may safely overwrite
+    // an input (given that formats are the same).
+    // FIXME: This should be a property of a kernel implementation,
+    // not of a kernel API.
+    bool is_inplace_safe(const std::string &id)
+    {
+        static const std::unordered_set<std::string> ids =
+        {
+            "org.opencv.core.math.add",
+            "org.opencv.core.math.addC",
+            "org.opencv.core.math.sub",
+            "org.opencv.core.math.subC",
+            "org.opencv.core.math.subRC",
+            "org.opencv.core.math.mul",
+            "org.opencv.core.math.mulCOld",
+            "org.opencv.core.math.mulC",
+            "org.opencv.core.math.div",
+            "org.opencv.core.math.divC",
+            "org.opencv.core.math.divRC",
+            "org.opencv.core.pixelwise.bitwise_and",
+            "org.opencv.core.pixelwise.bitwise_andS",
+            "org.opencv.core.pixelwise.bitwise_or",
+            "org.opencv.core.pixelwise.bitwise_orS",
+            "org.opencv.core.pixelwise.bitwise_xor",
+            "org.opencv.core.pixelwise.bitwise_xorS",
+            "org.opencv.core.pixelwise.bitwise_not",
+            "org.opencv.core.matrixop.absdiff",
+            "org.opencv.core.matrixop.absdiffC",
+            "org.opencv.core.matrixop.addweighted",
+            "org.opencv.core.matrixop.threshold",
+        };
+        return ids.count(id) > 0u;
+    }
+
+    // Assigns buffers to data objects within a single Island.
+    // Operations are visited in the execution order; every candidate data
+    // object is alive from its producer till its last consumer. Once an
+    // object is dead, its buffer returns to the pool and may be taken by
+    // any object of the same format which is produced later.
+    void reuseIslandBuffers(GModel::Graph                      &g,
+                            const std::vector<ade::NodeHandle> &ops,
+                            const NodeSet                      &candidates)
+    {
+        // Lifetimes, in terms of operation indices
+        NodeMap<std::size_t> last_use;
+        for (std::size_t i = 0u; i < ops.size(); i++)
+        {
+            for (auto nh : ops[i]->outNodes()) if (candidates.count(nh)) last_use[nh] = i;
+            for (auto nh : ops[i]->inNodes())  if (candidates.count(nh)) last_use[nh] = i;
+        }
+
+        NodeMap<ade::NodeHandle> buffer_of; // data object -> buffer owner
+        std::vector<ade::NodeHandle> free_buffers;
+
+        auto desc_of = [&](const ade::NodeHandle &nh) {
+            return cv::util::get<cv::GMatDesc>(g.metadata(nh).get<Data>().meta);
+        };
+        auto assign = [&](const ade::NodeHandle &nh, const ade::NodeHandle &owner) {
+            buffer_of[nh] = owner;
+            if (nh != owner) g.metadata(nh).set(DataAlias{owner});
+        };
+
+        for (std::size_t i = 0u; i < ops.size(); i++)
+        {
+            const auto &op_nh = ops[i];
+            const bool inplace = is_inplace_safe(g.metadata(op_nh).get<Op>().k.name);
+
+            NodeSet dying; // inputs which are read for the last time here
+            for (auto in_nh : op_nh->inNodes())
+            {
+                if (candidates.count(in_nh) && last_use.at(in_nh) == i) dying.insert(in_nh);
+            }
+
+            for (auto out_nh : op_nh->outNodes())
+            {
+                if (!candidates.count(out_nh)) continue;
+                const auto desc = desc_of(out_nh);
+
+                // 1. Try to write the result in place of a dying input
+                if (inplace)
+                {
+                    auto it = std::find_if(dying.begin(), dying.end(), [&](const ade::NodeHandle &in_nh) {
+                        return desc_of(in_nh) == desc;
+                    });
+                    if (it != dying.end())
+                    {
+                        assign(out_nh, buffer_of.at(*it));
+                        dying.erase(it);
+                        continue;
+                    }
+                }
+
+                // 2. Try to take a free buffer of the same format
+                auto it = std::find_if(free_buffers.begin(), free_buffers.end(), [&](const ade::NodeHandle &owner) {
+                    return desc_of(owner) == desc;
+                });
+                if (it != free_buffers.end())
+                {
+                    assign(out_nh, *it);
+                    free_buffers.erase(it);
+                    continue;
+                }
+
+                // 3. Allocate a new buffer
+                assign(out_nh, out_nh);
+            }
+
+            // Inputs are released only after all outputs are assigned,
+            // so an output never shares memory with an input of the same
+            // operation unless it is explicitly allowed
+            for (auto in_nh : dying) free_buffers.push_back(buffer_of.at(in_nh));
+
+            // Outputs which are never read are dead immediately
+            for (auto out_nh : op_nh->outNodes())
+            {
+                if (candidates.count(out_nh) && last_use.at(out_nh) == i)
+                {
+                    free_buffers.push_back(buffer_of.at(out_nh));
+                }
+            }
+        }
+    }
+} // anonymous namespace
+
+// Analyze lifetimes of Island-internal GMat objects and let objects with
+// non-overlapping lifetimes share their storage. Elementwise operations
+// may also produce their result in place of an input which is not read
+// anymore.
+//
+// Only objects which are completely hidden inside an Island are
+// considered: Island inputs and outputs (i.e. data slots) are allocated
+// and bound by the executor so are never touched here.
+void cv::gimpl::passes::reuseBuffers(ade::passes::PassContext &ctx)
+{
+    GModel::Graph g(ctx.graph);
+    if (!g.metadata().contains<IslandModel>())
+        return;
+
+    auto isl_graph = g.metadata().get<IslandModel>().model;
+    GIslandModel::Graph gim(*isl_graph);
+
+    NodeSet slots;
+    for (auto nh : gim.nodes())
+    {
+        if (gim.metadata(nh).get<NodeKind>().k == NodeKind::SLOT)
+            slots.insert(gim.metadata(nh).get<DataSlot>().original_data_node);
+    }
+
+    const auto sorted = g.metadata().get<ade::passes::TopologicalSortData>().nodes();
+    for (auto nh : gim.nodes())
+    {
+        if (gim.metadata(nh).get<NodeKind>().k != NodeKind::ISLAND)
+            continue;
+
+        const auto &contents = gim.metadata(nh).get<FusedIsland>().object->contents();
+
+        std::vector<ade::NodeHandle> ops;
+        NodeSet candidates;
+        for (auto orig_nh : sorted)
+        {
+            if (!ade::util::contains(contents, orig_nh))
+                continue;
+
+            if (g.metadata(orig_nh).get<NodeType>().t == NodeType::OP)
+            {
+                ops.push_back(orig_nh);
+                continue;
+            }
+
+            const auto &data = g.metadata(orig_nh).get<Data>();
+            if (   data.shape   == GShape::GMAT
+                && data.storage == Data::Storage::INTERNAL
+                && !slots.count(orig_nh))
+            {
+                candidates.insert(orig_nh);
+            }
+        }
+        reuseIslandBuffers(g, ops, candidates);
+    }
+}
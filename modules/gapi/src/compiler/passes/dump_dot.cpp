@@ -17,6 +17,7 @@
 #include "compiler/gmodel.hpp"
 #include "compiler/gislandmodel.hpp"
 #include "compiler/passes/passes.hpp"
+#include "executor/gprofiler.hpp"
 
 namespace cv { namespace gimpl { namespace passes {
 
@@ -70,6 +71,44 @@ void dumpDot(const ade::Graph &g, std::ostream& os)
         return ss.str();
     };
 
+    // If the graph was compiled with cv::graph_profiling and has been run,
+    // annotate nodes with the collected data. Operations which take a
+    // significant share of total time are highlighted.
+    std::shared_ptr<GProfiler> profiler;
+    double total_op_ms = 0.;
+    if (gr.metadata().contains<Profiling>())
+    {
+        profiler = gr.metadata().get<Profiling>().profiler;
+        for (const auto &e : profiler->report(g).operations) total_op_ms += e.total_ms;
+    }
+
+    auto format_op_prof = [&profiler](ade::NodeHandle nh) -> std::string {
+        const auto *e = profiler ? profiler->findOp(nh) : nullptr;
+        if (!e) return "";
+
+        std::stringstream ss;
+        ss << "\n" << e->total_ms << " ms / " << e->calls << " calls";
+        if (e->lines > 0u) { ss << " / " << e->lines << " lines"; }
+        return ss.str();
+    };
+
+    auto format_op_style = [&profiler, total_op_ms](ade::NodeHandle nh) -> std::string {
+        const auto *e = profiler ? profiler->findOp(nh) : nullptr;
+        const double share = (e && total_op_ms > 0.) ? e->total_ms / total_op_ms : 0.;
+        if (share >= 0.25) return ", style=filled, fillcolor=red";
+        if (share >= 0.10) return ", style=filled, fillcolor=orange";
+        return "";
+    };
+
+    auto format_data_prof = [&profiler](ade::NodeHandle nh) -> std::string {
+        const std::size_t bytes = profiler ? profiler->bufferBytes(nh) : 0u;
+        if (bytes == 0u) return "";
+
+        std::stringstream ss;
+        ss << "\n" << bytes << " bytes";
+        return ss.str();
+    };
+
     auto sorted = gr.metadata().get<ade::passes::TopologicalSortData>();
 
     os << "digraph GAPI_Computation {\n";
@@ -86,7 +125,8 @@ void dumpDot(const ade::Graph &g, std::ostream& os)
             const auto obj_data = gr.metadata(nh).get<Data>();
             const auto obj_name = format_obj(nh);
 
-            os << obj_name << " [label=\"" << obj_name << "\n" << obj_data.meta << "\"";
+            os << obj_name << " [label=\"" << obj_name << "\n" << obj_data.meta
+               << format_data_prof(nh) << "\"";
             if (gr.metadata(nh).contains<Journal>()) { os << ", " << format_log(nh, obj_name); }
             os << " ]\n";
 
@@ -98,7 +138,8 @@ void dumpDot(const ade::Graph &g, std::ostream& os)
             const auto obj_name       = format_op(nh);
             const auto obj_name_label = format_op_label(nh);
 
-            os << obj_name << " [label=\"" << obj_name_label << "\"";
+            os << obj_name << " [label=\"" << obj_name_label << format_op_prof(nh) << "\""
+               << format_op_style(nh);
             if (gr.metadata(nh).contains<Journal>()) { os << ", " << format_log(nh, obj_name_label); }
             os << " ]\n";
 
@@ -162,6 +203,12 @@ void dumpDot(const ade::Graph &g, std::ostream& os)
             {
                 const auto island   = gim.metadata(nh).get<FusedIsland>().object;
                 const auto isl_name = "\"" + island->name() + "\"";
+                const auto *isl_prof = profiler ? profiler->findIsland(nh) : nullptr;
+                if (isl_prof)
+                {
+                    os << isl_name << " [label=\"" << island->name() << "\n"
+                       << isl_prof->total_ms << " ms / " << isl_prof->calls << " calls\"]\n";
+                }
                 for (auto out_nh : nh->outNodes())
                 {
                     os << isl_name << " -> \"slot:"
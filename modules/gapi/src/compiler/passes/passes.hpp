@@ -51,6 +51,8 @@ void resolveKernels(ade::passes::PassContext       &ctx,
 void fuseIslands(ade::passes::PassContext &ctx);
 void syncIslandTags(ade::passes::PassContext &ctx);
 
+void reuseBuffers(ade::passes::PassContext &ctx);
+
 }} // namespace gimpl::passes
 
 } // namespace cv
@@ -13,6 +13,7 @@
 
 #include "opencv2/gapi/opencv_includes.hpp"
 #include "executor/gexecutor.hpp"
+#include "compiler/passes/passes.hpp" // dumpDot
 
 cv::gimpl::GExecutor::GExecutor(std::unique_ptr<ade::Graph> &&g_model)
     : m_orig_graph(std::move(g_model))
@@ -21,6 +22,11 @@ cv::gimpl::GExecutor::GExecutor(std::unique_ptr<ade::Graph> &&g_model)
     , m_gm(*m_orig_graph)
     , m_gim(*m_island_graph)
 {
+    if (m_gm.metadata().contains<Profiling>())
+    {
+        m_profiler = m_gm.metadata().get<Profiling>().profiler;
+    }
+
     // NB: Right now GIslandModel is acyclic, so for a naive execution,
     // simple unrolling to a list of triggers is enough
 
@@ -61,7 +67,8 @@ cv::gimpl::GExecutor::GExecutor(std::unique_ptr<ade::Graph> &&g_model)
                 for (auto out_slot_nh : nh->outNodes()) xtract(out_slot_nh, output_rcs);
                 m_ops.emplace_back(OpDesc{ std::move(input_rcs)
                                          , std::move(output_rcs)
-                                         , m_gim.metadata(nh).get<IslandExec>().object});
+                                         , m_gim.metadata(nh).get<IslandExec>().object
+                                         , nh});
             }
             break;
 
@@ -100,6 +107,11 @@ void cv::gimpl::GExecutor::initResource(const ade::NodeHandle &orig_nh)
             const auto desc = util::get<cv::GMatDesc>(d.meta);
             const auto type = CV_MAKETYPE(desc.depth, desc.chan);
             m_res.slot<cv::gapi::own::Mat>()[d.rc].create(desc.size, type);
+            if (m_profiler)
+            {
+                m_profiler->executorBuffer(orig_nh, desc.size.width * desc.size.height
+                                                    * CV_ELEM_SIZE(type));
+            }
         }
         break;
 
@@ -209,7 +221,15 @@ void cv::gimpl::GExecutor::run(cv::gimpl::GRuntimeArgs &&args)
         }
 
         // (6)
-        op.isl_exec->run(std::move(in_objs), std::move(out_objs));
+        if (m_profiler)
+        {
+            auto &entry = m_profiler->island(op.isl_nh);
+            const auto start = GProfiler::Clock::now();
+            op.isl_exec->run(std::move(in_objs), std::move(out_objs));
+            entry.addTime(start);
+            entry.calls++;
+        }
+        else op.isl_exec->run(std::move(in_objs), std::move(out_objs));
     }
 
     // (7)
@@ -224,3 +244,13 @@ const cv::gimpl::GModel::Graph& cv::gimpl::GExecutor::model() const
 {
     return m_gm;
 }
+
+cv::gapi::GProfileReport cv::gimpl::GExecutor::profile() const
+{
+    return m_profiler ? m_profiler->report(*m_orig_graph) : cv::gapi::GProfileReport{};
+}
+
+void cv::gimpl::GExecutor::dumpProfile(std::ostream &os) const
+{
+    passes::dumpDot(*m_orig_graph, os);
+}
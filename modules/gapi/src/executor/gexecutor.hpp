@@ -13,9 +13,12 @@
 #include <utility> // tuple, required by magazine
 #include <unordered_map> // required by magazine
 
+#include <ostream>
+
 #include <ade/graph.hpp>
 
 #include "backends/common/gbackend.hpp"
+#include "executor/gprofiler.hpp"
 
 namespace cv {
 namespace gimpl {
@@ -67,6 +70,7 @@ protected:
         std::vector<RcDesc> in_objects;
         std::vector<RcDesc> out_objects;
         std::shared_ptr<GIslandExecutable> isl_exec;
+        ade::NodeHandle isl_nh;
     };
     std::vector<OpDesc> m_ops;
 
@@ -79,6 +83,8 @@ protected:
 
     Mag m_res;
 
+    std::shared_ptr<GProfiler> m_profiler; // Set only if profiling is enabled
+
     void initResource(const ade::NodeHandle &orig_nh); // FIXME: shouldn't it be RcDesc?
 
 public:
@@ -86,6 +92,9 @@ public:
     void run(cv::gimpl::GRuntimeArgs &&args);
 
     const GModel::Graph& model() const; // FIXME: make it ConstGraph?
+
+    cv::gapi::GProfileReport profile() const;
+    void dumpProfile(std::ostream &os) const;
 };
 
 } // namespace gimpl
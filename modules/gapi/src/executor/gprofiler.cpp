@@ -0,0 +1,92 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+//
+// Copyright (C) 2018 Intel Corporation
+
+
+#include "precomp.hpp"
+
+#include <ade/typed_graph.hpp>
+
+#include "compiler/gmodel.hpp"
+#include "compiler/gislandmodel.hpp"
+#include "executor/gprofiler.hpp"
+
+namespace
+{
+    template<typename M>
+    const typename M::mapped_type* find_in(const M &m, const ade::NodeHandle &nh)
+    {
+        auto it = m.find(nh);
+        return it != m.end() ? &it->second : nullptr;
+    }
+} // anonymous namespace
+
+const cv::gimpl::GProfiler::Entry* cv::gimpl::GProfiler::findOp(const ade::NodeHandle &op_nh) const
+{
+    return find_in(m_ops, op_nh);
+}
+
+const cv::gimpl::GProfiler::Entry* cv::gimpl::GProfiler::findIsland(const ade::NodeHandle &isl_nh) const
+{
+    return find_in(m_islands, isl_nh);
+}
+
+std::size_t cv::gimpl::GProfiler::bufferBytes(const ade::NodeHandle &nh) const
+{
+    const auto *isl_bytes  = find_in(m_isl_bytes,  nh);
+    const auto *exec_bytes = find_in(m_exec_bytes, nh);
+    return (isl_bytes  ? *isl_bytes  : 0u)
+         + (exec_bytes ? *exec_bytes : 0u);
+}
+
+cv::gapi::GProfileReport cv::gimpl::GProfiler::report(const ade::Graph &g) const
+{
+    GModel::ConstGraph gm(g);
+    cv::gapi::GProfileReport rep;
+
+    auto fill = [](cv::gapi::GProfileEntry &dst, const Entry *src) {
+        if (src)
+        {
+            dst.calls    = src->calls;
+            dst.total_ms = src->total_ms;
+            dst.lines    = src->lines;
+        }
+    };
+
+    for (auto nh : gm.metadata().get<ade::passes::TopologicalSortData>().nodes())
+    {
+        if (gm.metadata(nh).get<NodeType>().t != NodeType::OP)
+            continue;
+
+        cv::gapi::GProfileEntry e;
+        e.name = gm.metadata(nh).get<Op>().k.name;
+        fill(e, findOp(nh));
+        const auto *bytes = find_in(m_isl_bytes, nh);
+        e.buffer_bytes = bytes ? *bytes : 0u;
+        rep.operations.push_back(std::move(e));
+    }
+
+    GIslandModel::ConstGraph gim(*gm.metadata().get<IslandModel>().model);
+    for (auto nh : gim.nodes())
+    {
+        if (gim.metadata(nh).get<NodeKind>().k != NodeKind::ISLAND)
+            continue;
+
+        const auto &island = gim.metadata(nh).get<FusedIsland>().object;
+        cv::gapi::GProfileEntry e;
+        e.name = island->name();
+        fill(e, findIsland(nh));
+        for (const auto &orig_nh : island->contents())
+        {
+            const auto *bytes = find_in(m_isl_bytes, orig_nh);
+            e.buffer_bytes += bytes ? *bytes : 0u;
+        }
+        rep.islands.push_back(std::move(e));
+    }
+
+    for (const auto &it : m_isl_bytes)  rep.islands_buffer_bytes  += it.second;
+    for (const auto &it : m_exec_bytes) rep.executor_buffer_bytes += it.second;
+    return rep;
+}
@@ -0,0 +1,74 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+//
+// Copyright (C) 2018 Intel Corporation
+
+
+#ifndef OPENCV_GAPI_GPROFILER_HPP
+#define OPENCV_GAPI_GPROFILER_HPP
+
+#include <chrono>
+#include <memory>
+#include <unordered_map>
+
+#include <ade/graph.hpp>
+
+#include "opencv2/gapi/gcompiled.hpp" // GProfileReport
+
+namespace cv { namespace gimpl {
+
+// Run-time profiling data collector (see cv::graph_profiling).
+//
+// An instance is created by the compiler and is stored in GModel metadata
+// (see Profiling), so GExecutor and backend executables can find it
+// there. Operations and data objects are identified by their GModel node
+// handles, islands - by their GIslandModel node handles.
+//
+// Note the collector is not thread-safe (so as GCompiled).
+class GProfiler
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Entry
+    {
+        std::size_t calls    = 0u;
+        double      total_ms = 0.;
+        std::size_t lines    = 0u;
+
+        void addTime(Clock::time_point since)
+        {
+            total_ms += std::chrono::duration<double, std::milli>(Clock::now() - since).count();
+        }
+    };
+
+    Entry& op    (const ade::NodeHandle &op_nh)  { return m_ops[op_nh];      }
+    Entry& island(const ade::NodeHandle &isl_nh) { return m_islands[isl_nh]; }
+
+    // Memory allocated by island executables (for internal data objects,
+    // or for operations themselves, e.g. Fluid scratch buffers)
+    void islandBuffer  (const ade::NodeHandle &nh, std::size_t bytes) { m_isl_bytes[nh]  += bytes; }
+    // Memory allocated by GExecutor for data passed between islands
+    void executorBuffer(const ade::NodeHandle &nh, std::size_t bytes) { m_exec_bytes[nh] += bytes; }
+
+    const Entry* findOp    (const ade::NodeHandle &op_nh)  const;
+    const Entry* findIsland(const ade::NodeHandle &isl_nh) const;
+    std::size_t  bufferBytes(const ade::NodeHandle &nh) const; // by both islands and executor
+
+    // Summarizes everything collected so far. g is a GModel graph
+    cv::gapi::GProfileReport report(const ade::Graph &g) const;
+
+private:
+    template<typename T>
+    using NodeMap = std::unordered_map<ade::NodeHandle, T, ade::HandleHasher<ade::Node>>;
+
+    NodeMap<Entry>       m_ops;
+    NodeMap<Entry>       m_islands;
+    NodeMap<std::size_t> m_isl_bytes;
+    NodeMap<std::size_t> m_exec_bytes;
+};
+
+}} // namespace cv::gimpl
+
+#endif // OPENCV_GAPI_GPROFILER_HPP
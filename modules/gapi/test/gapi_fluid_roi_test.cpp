@@ -194,4 +194,86 @@ INSTANTIATE_TEST_CASE_P(FluidRoi, TwoBlursRoiTest,
                                 testing::Bool(), // Read from input directly or place a copy node at start
                                 Values(cv::Rect{0,0,320,240}, cv::Rect{0,64,320,128}, cv::Rect{0,128,320,112})));
 
+struct TiledSequenceOfBlursTest : public TestWithParam <std::tuple<int, int, cv::Rect>> {};
+TEST_P(TiledSequenceOfBlursTest, Test)
+{
+    cv::Size sz_in = { 320, 240 };
+
+    int borderType = 0, tileWidth = 0;
+    cv::Rect roi;
+    std::tie(borderType, tileWidth, roi) = GetParam();
+    cv::Mat in_mat(sz_in, CV_8UC1);
+    cv::Scalar mean   = cv::Scalar(127.0f);
+    cv::Scalar stddev = cv::Scalar(40.f);
+
+    cv::randn(in_mat, mean, stddev);
+
+    cv::Point anchor = {-1, -1};
+    cv::Scalar borderValue(0);
+
+    GMat in;
+    auto mid1 = TBlur3x3::on(in,   borderType, borderValue);
+    auto mid2 = TAddCSimple::on(mid1, 1);
+    auto out  = TBlur5x5::on(mid2, borderType, borderValue);
+
+    Mat out_mat_gapi = Mat::zeros(sz_in, CV_8UC1);
+
+    GComputation c(GIn(in), GOut(out));
+    auto cc = c.compile(descr_of(in_mat), cv::compile_args(fluidTestPackage,
+                                                           GFluidOutputRois{{to_own(roi)}},
+                                                           GFluidTiling{tileWidth}));
+    cc(gin(in_mat), gout(out_mat_gapi));
+
+    cv::Mat mid_mat_ocv, out_mat_full;
+    cv::blur(in_mat, mid_mat_ocv, {3,3}, anchor, borderType);
+    mid_mat_ocv += 1;
+    cv::blur(mid_mat_ocv, out_mat_full, {5,5}, anchor, borderType);
+
+    if (roi == cv::Rect{})
+    {
+        roi = cv::Rect{0, 0, sz_in.width, sz_in.height};
+    }
+
+    // Only requested area is computed, the rest of output is kept intact
+    cv::Mat out_mat_ocv = Mat::zeros(sz_in, CV_8UC1);
+    out_mat_full(roi).copyTo(out_mat_ocv(roi));
+
+    EXPECT_EQ(0, countNonZero(out_mat_ocv != out_mat_gapi));
+}
+
+INSTANTIATE_TEST_CASE_P(FluidTiling, TiledSequenceOfBlursTest,
+                        Combine(Values(BORDER_CONSTANT, BORDER_REPLICATE, BORDER_REFLECT_101),
+                                Values(0, 1, 16, 100, 400),
+                                Values(cv::Rect{}, cv::Rect{10,20,100,80}, cv::Rect{200,0,120,240},
+                                       cv::Rect{0,64,7,128}, cv::Rect{313,0,7,240})));
+
+struct TiledTwoOutputsTest : public TestWithParam <int> {};
+TEST_P(TiledTwoOutputsTest, Test)
+{
+    cv::Size sz_in = { 320, 240 };
+    const int tileWidth = GetParam();
+
+    cv::Mat in_mat(sz_in, CV_8UC1);
+    cv::randn(in_mat, cv::Scalar(127.0f), cv::Scalar(40.f));
+
+    GMat in;
+    auto mid  = TAddCSimple::on(in, 0);
+    auto out1 = TBlur3x3::on(mid, cv::BORDER_REPLICATE, {});
+    auto out2 = TBlur5x5::on(mid, cv::BORDER_REFLECT_101, {});
+
+    Mat out_mat_gapi1, out_mat_gapi2;
+    GComputation c(GIn(in), GOut(out1, out2));
+    c.apply(gin(in_mat), gout(out_mat_gapi1, out_mat_gapi2),
+            cv::compile_args(fluidTestPackage, GFluidTiling{tileWidth}));
+
+    cv::Mat out_mat_ocv1, out_mat_ocv2;
+    cv::blur(in_mat, out_mat_ocv1, {3,3}, {-1,-1}, cv::BORDER_REPLICATE);
+    cv::blur(in_mat, out_mat_ocv2, {5,5}, {-1,-1}, cv::BORDER_REFLECT_101);
+
+    EXPECT_EQ(0, countNonZero(out_mat_ocv1 != out_mat_gapi1));
+    EXPECT_EQ(0, countNonZero(out_mat_ocv2 != out_mat_gapi2));
+}
+
+INSTANTIATE_TEST_CASE_P(FluidTiling, TiledTwoOutputsTest, Values(8, 64, 313));
+
 } // namespace opencv_test
@@ -0,0 +1,146 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+//
+// Copyright (C) 2018 Intel Corporation
+
+
+#include "test_precomp.hpp"
+
+#include "compiler/gmodel.hpp"
+#include "compiler/gcompiler.hpp"
+
+namespace opencv_test
+{
+
+namespace
+{
+    cv::gimpl::GCompiler::GPtr compileGraph(cv::GComputation &cc, const cv::GMatDesc &desc)
+    {
+        cv::gimpl::GCompiler compiler(cc, {cv::GMetaArg(desc)}, cv::compile_args());
+        cv::gimpl::GCompiler::GPtr graph = compiler.generateGraph();
+        compiler.runPasses(*graph);
+        return graph;
+    }
+
+    int rcOf(const cv::gimpl::GModel::ConstGraph &gm, const ade::NodeHandle &nh)
+    {
+        return gm.metadata(nh).get<cv::gimpl::Data>().rc;
+    }
+
+    int storageOf(const cv::gimpl::GModel::ConstGraph &gm, const cv::GMat &m)
+    {
+        const auto nh = cv::gimpl::GModel::dataNodeOf(gm, m);
+        return gm.metadata(nh).contains<cv::gimpl::DataAlias>()
+            ? rcOf(gm, gm.metadata(nh).get<cv::gimpl::DataAlias>().owner)
+            : rcOf(gm, nh);
+    }
+} // anonymous namespace
+
+TEST(BufferReuse, ElementwiseChainIsInPlace)
+{
+    //   (in) -> AddC -> (tmp0) -> MulC -> (tmp1) -> SubC -> (tmp2) -> Not -> (out)
+    cv::GMat in;
+    cv::GMat tmp0 = cv::gapi::addC(in, 1.0);
+    cv::GMat tmp1 = cv::gapi::mulC(tmp0, 2.0);
+    cv::GMat tmp2 = cv::gapi::subC(tmp1, 3.0);
+    cv::GMat out  = cv::gapi::bitwise_not(tmp2);
+    cv::GComputation cc(in, out);
+
+    auto graph = compileGraph(cc, cv::GMatDesc{CV_8U,1,cv::gapi::own::Size(32,32)});
+    cv::gimpl::GModel::ConstGraph gm(*graph);
+
+    // All intermediate results live in the same buffer
+    EXPECT_EQ(storageOf(gm, tmp0), storageOf(gm, tmp1));
+    EXPECT_EQ(storageOf(gm, tmp0), storageOf(gm, tmp2));
+
+    // Computation inputs & outputs are never aliased
+    EXPECT_FALSE(gm.metadata(cv::gimpl::GModel::dataNodeOf(gm, in))
+                 .contains<cv::gimpl::DataAlias>());
+    EXPECT_FALSE(gm.metadata(cv::gimpl::GModel::dataNodeOf(gm, out))
+                 .contains<cv::gimpl::DataAlias>());
+}
+
+TEST(BufferReuse, LiveObjectsAreNotShared)
+{
+    //   (in) -> AddC -> (tmp0) -> MulC -> (tmp1) -> Add -> (out)
+    //                     :                          ^
+    //                     '--------------------------'
+    cv::GMat in;
+    cv::GMat tmp0 = cv::gapi::addC(in, 1.0);
+    cv::GMat tmp1 = cv::gapi::mulC(tmp0, 2.0);
+    cv::GMat out  = cv::gapi::add(tmp0, tmp1);
+    cv::GComputation cc(in, out);
+
+    auto graph = compileGraph(cc, cv::GMatDesc{CV_8U,1,cv::gapi::own::Size(32,32)});
+    cv::gimpl::GModel::ConstGraph gm(*graph);
+
+    EXPECT_NE(storageOf(gm, tmp0), storageOf(gm, tmp1));
+}
+
+TEST(BufferReuse, DifferentFormatsAreNotShared)
+{
+    cv::GMat in;
+    cv::GMat tmp0 = cv::gapi::addC(in, 1.0);
+    cv::GMat tmp1 = cv::gapi::convertTo(tmp0, CV_32F);
+    cv::GMat tmp2 = cv::gapi::mulC(tmp1, 2.0);
+    cv::GMat out  = cv::gapi::convertTo(tmp2, CV_8U);
+    cv::GComputation cc(in, out);
+
+    auto graph = compileGraph(cc, cv::GMatDesc{CV_8U,1,cv::gapi::own::Size(32,32)});
+    cv::gimpl::GModel::ConstGraph gm(*graph);
+
+    EXPECT_NE(storageOf(gm, tmp0), storageOf(gm, tmp1));
+    EXPECT_EQ(storageOf(gm, tmp1), storageOf(gm, tmp2));
+}
+
+TEST(BufferReuse, NotInPlaceKernelsReuseDeadBuffers)
+{
+    //   (in) -> Blur -> (tmp0) -> Blur -> (tmp1) -> Blur -> (tmp2) -> Blur -> (out)
+    cv::GMat in;
+    cv::GMat tmp0 = cv::gapi::boxFilter(in,   -1, cv::Size(3,3));
+    cv::GMat tmp1 = cv::gapi::boxFilter(tmp0, -1, cv::Size(3,3));
+    cv::GMat tmp2 = cv::gapi::boxFilter(tmp1, -1, cv::Size(3,3));
+    cv::GMat out  = cv::gapi::boxFilter(tmp2, -1, cv::Size(3,3));
+    cv::GComputation cc(in, out);
+
+    auto graph = compileGraph(cc, cv::GMatDesc{CV_8U,1,cv::gapi::own::Size(32,32)});
+    cv::gimpl::GModel::ConstGraph gm(*graph);
+
+    // Filter can't write in place, but tmp0 is dead when tmp2 is produced
+    EXPECT_NE(storageOf(gm, tmp0), storageOf(gm, tmp1));
+    EXPECT_NE(storageOf(gm, tmp1), storageOf(gm, tmp2));
+    EXPECT_EQ(storageOf(gm, tmp0), storageOf(gm, tmp2));
+}
+
+TEST(BufferReuse, LongPipelineAccuracy)
+{
+    cv::GMat in;
+    cv::GMat tmp0 = cv::gapi::addC(in, 1.0);
+    cv::GMat tmp1 = cv::gapi::boxFilter(tmp0, -1, cv::Size(3,3));
+    cv::GMat tmp2 = cv::gapi::mulC(tmp1, 2.0);
+    cv::GMat tmp3 = cv::gapi::absDiff(tmp2, tmp0);
+    cv::GMat tmp4 = cv::gapi::boxFilter(tmp3, -1, cv::Size(5,5));
+    cv::GMat out  = cv::gapi::add(tmp4, tmp1);
+    cv::GComputation cc(in, out);
+
+    cv::Mat in_mat(64, 64, CV_8UC1);
+    cv::randu(in_mat, cv::Scalar::all(0), cv::Scalar::all(100));
+    cv::Mat out_gapi;
+    cc.apply(in_mat, out_gapi);
+    cc.apply(in_mat, out_gapi); // second run reuses internal buffers
+
+    cv::Mat out_ocv;
+    {
+        cv::Mat t0, t1, t2, t3, t4;
+        cv::add(in_mat, cv::Scalar(1.0), t0);
+        cv::boxFilter(t0, t1, -1, cv::Size(3,3));
+        cv::multiply(t1, cv::Scalar(2.0), t2);
+        cv::absdiff(t2, t0, t3);
+        cv::boxFilter(t3, t4, -1, cv::Size(5,5));
+        cv::add(t4, t1, out_ocv);
+    }
+    EXPECT_EQ(0, cv::countNonZero(out_gapi != out_ocv));
+}
+
+} // opencv_test
@@ -0,0 +1,193 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+//
+// Copyright (C) 2018 Intel Corporation
+
+
+#include "test_precomp.hpp"
+#include "api/gcomputation_priv.hpp"
+#include "compiler/gcompilecache.hpp"
+#include "opencv2/gapi/cpu/core.hpp"
+#include "opencv2/gapi/cpu/gcpukernel.hpp"
+
+#include <thread>
+
+namespace opencv_test
+{
+
+namespace
+{
+    cv::GComputation makeComputation(double scale)
+    {
+        cv::GMat in;
+        cv::GMat out = cv::gapi::addC(cv::gapi::mulC(in, scale), 1.0);
+        return cv::GComputation(in, out);
+    }
+
+    G_TYPED_KERNEL(GCacheTestInc, <cv::GMat(cv::GMat)>, "org.opencv.test.cache_inc")
+    {
+        static cv::GMatDesc outMeta(cv::GMatDesc in) { return in; }
+    };
+
+    GAPI_OCV_KERNEL(GOCVCacheTestIncByOne, GCacheTestInc)
+    {
+        static void run(const cv::Mat& in, cv::Mat &out) { out = in + 1; }
+    };
+
+    GAPI_OCV_KERNEL(GOCVCacheTestIncByTwo, GCacheTestInc)
+    {
+        static void run(const cv::Mat& in, cv::Mat &out) { out = in + 2; }
+    };
+
+    struct GCompileCacheTest: public ::testing::Test
+    {
+        GCompileCacheTest()  { cv::gapi::clear_compile_cache(); }
+        ~GCompileCacheTest() { cv::gapi::clear_compile_cache();
+                               cv::gapi::set_compile_cache_capacity(64u); }
+    };
+} // anonymous namespace
+
+TEST_F(GCompileCacheTest, SameGraphDifferentObjectsShareCompiled)
+{
+    cv::Mat in_mat = cv::Mat::eye(32, 32, CV_8UC1);
+    cv::Mat out_mat1, out_mat2;
+
+    auto cc1 = makeComputation(2.0);
+    auto cc2 = makeComputation(2.0);
+    cc1.apply(in_mat, out_mat1, cv::compile_args(cv::use_compile_cache{}));
+    cc2.apply(in_mat, out_mat2, cv::compile_args(cv::use_compile_cache{}));
+
+    EXPECT_EQ(&cc1.priv().m_lastCompiled.priv(), &cc2.priv().m_lastCompiled.priv());
+    EXPECT_EQ(0, cv::countNonZero(out_mat1 != out_mat2));
+
+    const auto stats = cv::gapi::compile_cache_stats();
+    EXPECT_EQ(1u, stats.misses);
+    EXPECT_EQ(1u, stats.hits);
+    EXPECT_EQ(1u, stats.size);
+}
+
+TEST_F(GCompileCacheTest, DifferentStaticParamsAreNotShared)
+{
+    cv::Mat in_mat = cv::Mat::eye(32, 32, CV_8UC1);
+    cv::Mat out_mat1, out_mat2;
+
+    auto cc1 = makeComputation(2.0);
+    auto cc2 = makeComputation(3.0);
+    cc1.apply(in_mat, out_mat1, cv::compile_args(cv::use_compile_cache{}));
+    cc2.apply(in_mat, out_mat2, cv::compile_args(cv::use_compile_cache{}));
+
+    EXPECT_NE(&cc1.priv().m_lastCompiled.priv(), &cc2.priv().m_lastCompiled.priv());
+    EXPECT_EQ(4, out_mat2.at<uchar>(0, 0));
+    EXPECT_EQ(2u, cv::gapi::compile_cache_stats().misses);
+}
+
+TEST_F(GCompileCacheTest, DifferentMetaAreNotShared)
+{
+    auto cc = makeComputation(2.0);
+    const cv::GMetaArgs metas1{cv::GMetaArg(cv::descr_of(cv::Mat(32, 32, CV_8UC1)))};
+    const cv::GMetaArgs metas2{cv::GMetaArg(cv::descr_of(cv::Mat(64, 32, CV_8UC1)))};
+    std::string key1, key2;
+    ASSERT_TRUE(cv::gimpl::GCompileCache::makeKey(cc, metas1, {}, key1));
+    ASSERT_TRUE(cv::gimpl::GCompileCache::makeKey(cc, metas2, {}, key2));
+    EXPECT_NE(key1, key2);
+}
+
+TEST_F(GCompileCacheTest, KeyDependsOnCompileArgs)
+{
+    auto cc = makeComputation(2.0);
+    const cv::GMetaArgs metas{cv::GMetaArg(cv::descr_of(cv::Mat(32, 32, CV_8UC1)))};
+    std::string key1, key2;
+    ASSERT_TRUE(cv::gimpl::GCompileCache::makeKey(cc, metas, {}, key1));
+    ASSERT_TRUE(cv::gimpl::GCompileCache::makeKey(cc, metas,
+                                                  cv::compile_args(cv::gapi::core::cpu::kernels()),
+                                                  key2));
+    EXPECT_NE(key1, key2);
+}
+
+TEST_F(GCompileCacheTest, DifferentKernelImplementationsAreNotShared)
+{
+    cv::Mat in_mat = cv::Mat::zeros(8, 8, CV_8UC1);
+    cv::Mat out_mat1, out_mat2;
+
+    auto make = []() {
+        cv::GMat in;
+        return cv::GComputation(in, GCacheTestInc::on(in));
+    };
+    make().apply(in_mat, out_mat1, cv::compile_args(cv::gapi::kernels<GOCVCacheTestIncByOne>(),
+                                                    cv::use_compile_cache{}));
+    make().apply(in_mat, out_mat2, cv::compile_args(cv::gapi::kernels<GOCVCacheTestIncByTwo>(),
+                                                    cv::use_compile_cache{}));
+
+    EXPECT_EQ(1, out_mat1.at<uchar>(0, 0));
+    EXPECT_EQ(2, out_mat2.at<uchar>(0, 0));
+    EXPECT_EQ(2u, cv::gapi::compile_cache_stats().misses);
+    EXPECT_EQ(0u, cv::gapi::compile_cache_stats().hits);
+}
+
+TEST_F(GCompileCacheTest, ThreadsDontShareCompiled)
+{
+    cv::Mat in_mat = cv::Mat::eye(32, 32, CV_8UC1);
+    cv::Mat out_mat1, out_mat2;
+
+    auto cc1 = makeComputation(2.0);
+    auto cc2 = makeComputation(2.0);
+    cc1.apply(in_mat, out_mat1, cv::compile_args(cv::use_compile_cache{}));
+    std::thread t([&]() {
+        cc2.apply(in_mat, out_mat2, cv::compile_args(cv::use_compile_cache{}));
+    });
+    t.join();
+
+    EXPECT_NE(&cc1.priv().m_lastCompiled.priv(), &cc2.priv().m_lastCompiled.priv());
+    EXPECT_EQ(0, cv::countNonZero(out_mat1 != out_mat2));
+    EXPECT_EQ(2u, cv::gapi::compile_cache_stats().misses);
+}
+
+TEST_F(GCompileCacheTest, ZeroCapacityBypassesCache)
+{
+    cv::gapi::set_compile_cache_capacity(0u);
+
+    cv::Mat in_mat = cv::Mat::eye(32, 32, CV_8UC1);
+    cv::Mat out_mat;
+
+    makeComputation(2.0).apply(in_mat, out_mat, cv::compile_args(cv::use_compile_cache{}));
+    makeComputation(2.0).apply(in_mat, out_mat, cv::compile_args(cv::use_compile_cache{}));
+
+    const auto stats = cv::gapi::compile_cache_stats();
+    EXPECT_EQ(0u, stats.hits);
+    EXPECT_EQ(0u, stats.misses);
+    EXPECT_EQ(2u, stats.bypasses);
+    EXPECT_EQ(0u, stats.size);
+}
+
+TEST_F(GCompileCacheTest, LRUEviction)
+{
+    cv::gapi::set_compile_cache_capacity(1u);
+
+    cv::Mat in_mat = cv::Mat::eye(32, 32, CV_8UC1);
+    cv::Mat out_mat;
+
+    makeComputation(2.0).apply(in_mat, out_mat, cv::compile_args(cv::use_compile_cache{}));
+    makeComputation(3.0).apply(in_mat, out_mat, cv::compile_args(cv::use_compile_cache{}));
+    makeComputation(2.0).apply(in_mat, out_mat, cv::compile_args(cv::use_compile_cache{}));
+
+    const auto stats = cv::gapi::compile_cache_stats();
+    EXPECT_EQ(0u, stats.hits);
+    EXPECT_EQ(3u, stats.misses);
+    EXPECT_EQ(2u, stats.evictions);
+    EXPECT_EQ(1u, stats.size);
+}
+
+TEST_F(GCompileCacheTest, NotUsedByDefault)
+{
+    cv::Mat in_mat = cv::Mat::eye(32, 32, CV_8UC1);
+    cv::Mat out_mat;
+
+    makeComputation(2.0).apply(in_mat, out_mat);
+
+    const auto stats = cv::gapi::compile_cache_stats();
+    EXPECT_EQ(0u, stats.misses);
+    EXPECT_EQ(0u, stats.size);
+}
+
+} // opencv_test
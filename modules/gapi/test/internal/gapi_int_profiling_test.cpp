@@ -0,0 +1,110 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+//
+// Copyright (C) 2018 Intel Corporation
+
+
+#include "test_precomp.hpp"
+
+#include <fstream>
+
+#include "backends/fluid/gfluidcore.hpp"
+
+namespace opencv_test
+{
+
+namespace
+{
+    cv::GComputation makeComputation()
+    {
+        //   (in) -> AddC -> (tmp) -> Not -> (out)
+        cv::GMat in;
+        cv::GMat tmp = cv::gapi::addC(in, 1.0);
+        cv::GMat out = cv::gapi::bitwise_not(tmp);
+        return cv::GComputation(in, out);
+    }
+
+    const cv::gapi::GProfileEntry& findOp(const cv::gapi::GProfileReport &rep,
+                                          const std::string &name)
+    {
+        auto it = std::find_if(rep.operations.begin(), rep.operations.end(),
+                               [&](const cv::gapi::GProfileEntry &e) { return e.name == name; });
+        if (it == rep.operations.end())
+            throw std::logic_error("Operation " + name + " is not found in the report");
+        return *it;
+    }
+} // anonymous namespace
+
+TEST(GraphProfiling, DisabledByDefault)
+{
+    cv::Mat in_mat = cv::Mat::eye(32, 32, CV_8UC1), out_mat;
+    auto cc = makeComputation().compile(cv::descr_of(in_mat));
+    cc(in_mat, out_mat);
+
+    const auto rep = cc.profile();
+    EXPECT_TRUE(rep.operations.empty());
+    EXPECT_TRUE(rep.islands.empty());
+}
+
+TEST(GraphProfiling, CountsCallsPerOperationAndIsland)
+{
+    cv::Mat in_mat = cv::Mat::eye(32, 32, CV_8UC1), out_mat;
+    auto cc = makeComputation().compile(cv::descr_of(in_mat),
+                                        cv::compile_args(cv::graph_profiling{}));
+    const int runs = 3;
+    for (int i = 0; i < runs; i++) cc(in_mat, out_mat);
+
+    const auto rep = cc.profile();
+    ASSERT_EQ(2u, rep.operations.size());
+    EXPECT_EQ(static_cast<std::size_t>(runs), findOp(rep, "org.opencv.core.math.addC").calls);
+    EXPECT_EQ(static_cast<std::size_t>(runs), findOp(rep, "org.opencv.core.pixelwise.bitwise_not").calls);
+
+    ASSERT_EQ(1u, rep.islands.size());
+    EXPECT_EQ(static_cast<std::size_t>(runs), rep.islands[0].calls);
+    EXPECT_LE(0., rep.islands[0].total_ms);
+
+    // Internal (tmp) object is allocated by CPU island once
+    EXPECT_EQ(in_mat.total() * in_mat.elemSize(), rep.islands_buffer_bytes);
+}
+
+TEST(GraphProfiling, FluidCountsLines)
+{
+    cv::Mat in_mat = cv::Mat::eye(32, 16, CV_8UC1), out_mat;
+    auto cc = makeComputation().compile(cv::descr_of(in_mat),
+                                        cv::compile_args(cv::gapi::core::fluid::kernels(),
+                                                         cv::graph_profiling{}));
+    cc(in_mat, out_mat);
+    cc(in_mat, out_mat);
+
+    const auto rep = cc.profile();
+    ASSERT_EQ(2u, rep.operations.size());
+    for (const auto &e : rep.operations)
+    {
+        EXPECT_EQ(2u, e.calls) << e.name;
+        EXPECT_EQ(2u * in_mat.rows, e.lines) << e.name;
+    }
+    EXPECT_LT(0u, rep.islands_buffer_bytes);
+}
+
+TEST(GraphProfiling, DumpProfileWritesDot)
+{
+    cv::Mat in_mat = cv::Mat::eye(32, 32, CV_8UC1), out_mat;
+    auto cc = makeComputation().compile(cv::descr_of(in_mat),
+                                        cv::compile_args(cv::graph_profiling{}));
+    cc(in_mat, out_mat);
+
+    const std::string path = cv::tempfile(".dot");
+    cc.dumpProfile(path);
+
+    std::ifstream ifs(path);
+    ASSERT_TRUE(ifs.is_open());
+    const std::string dot((std::istreambuf_iterator<char>(ifs)),
+                           std::istreambuf_iterator<char>());
+    EXPECT_NE(std::string::npos, dot.find("digraph"));
+    EXPECT_NE(std::string::npos, dot.find(" ms / 1 calls"));
+    ifs.close();
+    std::remove(path.c_str());
+}
+
+} // opencv_test
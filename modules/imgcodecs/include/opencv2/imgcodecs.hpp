@@ -74,7 +74,8 @@ enum ImreadModes {
        IMREAD_REDUCED_COLOR_4      = 33, //!< If set, always convert image to the 3 channel BGR color image and the image size reduced 1/4.
        IMREAD_REDUCED_GRAYSCALE_8  = 64, //!< If set, always convert image to the single channel grayscale image and the image size reduced 1/8.
        IMREAD_REDUCED_COLOR_8      = 65, //!< If set, always convert image to the 3 channel BGR color image and the image size reduced 1/8.
-       IMREAD_IGNORE_ORIENTATION   = 128 //!< If set, do not rotate the image according to EXIF's orientation flag.
+       IMREAD_IGNORE_ORIENTATION   = 128, //!< If set, do not rotate the image according to EXIF's orientation flag.
+       IMREAD_MMAP                 = 256  //!< If set, map the file into memory and decode it from the mapping, without copying it, when the decoder can read memory buffers. Not applied with IMREAD_UNCHANGED.
      };
 
 //! Imwrite flags
@@ -94,7 +95,8 @@ enum ImwriteFlags {
        IMWRITE_PAM_TUPLETYPE       = 128,//!< For PAM, sets the TUPLETYPE field to the corresponding string value that is defined for the format
        IMWRITE_TIFF_RESUNIT = 256,//!< For TIFF, use to specify which DPI resolution unit to set; see libtiff documentation for valid values
        IMWRITE_TIFF_XDPI = 257,//!< For TIFF, use to specify the X direction DPI
-       IMWRITE_TIFF_YDPI = 258 //!< For TIFF, use to specify the Y direction DPI
+       IMWRITE_TIFF_YDPI = 258, //!< For TIFF, use to specify the Y direction DPI
+       IMWRITE_THREADS = 512 //!< For PNG, TIFF and QLI, the number of threads compressing parts of the image in parallel. Default value is 1 (cv::getNumThreads() for QLI), a value <= 0 means cv::getNumThreads(). The PNG bilevel and 2-channel images and the TIFF JPEG-compressed images are always written by one thread.
      };
 
 enum ImwriteEXRTypeFlags {
@@ -149,6 +151,7 @@ Currently, the following file formats are supported:
 -   TIFF files - \*.tiff, \*.tif (see the *Notes* section)
 -   OpenEXR Image files - \*.exr (see the *Notes* section)
 -   Radiance HDR - \*.hdr, \*.pic (always supported)
+-   Quick lossless image - \*.qli (always supported)
 -   Raster and Vector geospatial data supported by Gdal (see the *Notes* section)
 
 @note
@@ -183,15 +186,35 @@ The function imreadmulti loads a multi-page image from the specified file into a
 @param filename Name of file to be loaded.
 @param flags Flag that can take values of cv::ImreadModes, default with cv::IMREAD_ANYCOLOR.
 @param mats A vector of Mat objects holding each page, if more than one.
-@sa cv::imread
+@sa cv::imread, cv::ImageCollection
 */
 CV_EXPORTS_W bool imreadmulti(const String& filename, CV_OUT std::vector<Mat>& mats, int flags = IMREAD_ANYCOLOR);
 
+/** @brief Loads a region of an image from a file.
+
+The function is equivalent to cropping the result of cv::imread, but JPEG and TIFF images are
+decoded partially: JPEG decoding stops after the last row of the region (and, with libjpeg-turbo,
+skips the rows above it and the MCU columns outside of it), only the TIFF strips or tiles
+intersecting the region are read. Other formats, as well as TIFF images stored bottom-up,
+are decoded fully and then cropped.
+
+The region can be combined with the cv::IMREAD_REDUCED_* modes, then the result is the
+corresponding (reduced) region of the reduced image.
+
+@param filename Name of file to be loaded.
+@param roi Region of the image in pixels of the full-resolution image, as it is stored in the
+file (before the EXIF orientation is applied). It is clipped to the image bounds.
+@param flags Flag that can take values of cv::ImreadModes
+@return The region of the image, empty matrix if the file can't be read or the region lies
+outside of the image.
+*/
+CV_EXPORTS_W Mat imreadRegion( const String& filename, const Rect& roi, int flags = IMREAD_COLOR );
+
 /** @brief Saves an image to a specified file.
 
 The function imwrite saves the image to the specified file. The image format is chosen based on the
 filename extension (see cv::imread for the list of extensions). Only 8-bit (or 16-bit unsigned (CV_16U)
-in case of PNG, JPEG 2000, and TIFF) single-channel or 3-channel (with 'BGR' channel order) images
+in case of PNG, JPEG 2000, TIFF and QLI) single-channel or 3-channel (with 'BGR' channel order) images
 can be saved using this function. If the format, depth or channel order is different, use
 Mat::convertTo , and cv::cvtColor to convert it before saving. Or, use the universal FileStorage I/O
 functions to save the image to XML or YAML format.
@@ -231,6 +254,76 @@ reallocations when the function is called repeatedly for images of the same size
 */
 CV_EXPORTS Mat imdecode( InputArray buf, int flags, Mat* dst);
 
+/** @brief Reads a region of an image from a buffer in memory.
+
+See cv::imreadRegion for details. The cv::IMREAD_REDUCED_* modes are not supported (as by cv::imdecode).
+
+@param buf Input array or vector of bytes.
+@param roi Region of the image in pixels. It is clipped to the image bounds.
+@param flags The same flags as in cv::imread, see cv::ImreadModes.
+*/
+CV_EXPORTS_W Mat imdecodeRegion( InputArray buf, const Rect& roi, int flags );
+
+/** @brief Loads several images from files in parallel.
+
+The function is equivalent to calling cv::imread for every file, but images are decoded concurrently
+using the OpenCV thread pool (see cv::setNumThreads). Decoder objects (e.g. for JPEG and PNG) are
+reused for all images processed by the same thread.
+
+@param filenames Names of files to be loaded.
+@param flags The same flags as in cv::imread, see cv::ImreadModes.
+@param dst Output images, resized to filenames.size(). Existing matrices are reused if their size
+and type match the decoded images, so the same vector can be passed to consecutive calls to avoid
+reallocations. Images which can't be read are left empty.
+@return Number of successfully loaded images.
+*/
+CV_EXPORTS_W int imreadMany( const std::vector<String>& filenames, int flags, CV_OUT std::vector<Mat>& dst );
+
+/** @brief Reads several images from buffers in memory in parallel.
+
+The function is equivalent to calling cv::imdecode for every buffer, see cv::imreadMany for details.
+
+@param bufs Input arrays or vectors of bytes.
+@param flags The same flags as in cv::imread, see cv::ImreadModes.
+@param dst Output images, resized to the number of buffers. Existing matrices are reused if their
+size and type match the decoded images. Images which can't be decoded are left empty.
+@return Number of successfully decoded images.
+*/
+CV_EXPORTS_W int imdecodeMany( InputArrayOfArrays bufs, int flags, CV_OUT std::vector<Mat>& dst );
+
+/** @brief Image properties read from the header of an image file by cv::imreadHeader.
+*/
+struct CV_EXPORTS ImageHeader
+{
+    ImageHeader();
+
+    Size size;       //!< Size of the image as stored, before any EXIF rotation
+    int type;        //!< Type of the image as read with cv::IMREAD_UNCHANGED, e.g. CV_8UC3 or CV_16UC1
+    int pages;       //!< Number of images in the file, see cv::imreadmulti
+    int orientation; //!< Value of the EXIF Orientation tag, from 1 (normal) to 8, or 1 if the image has none. Orientations 5 to 8 swap the width and height of the image returned by cv::imread.
+};
+
+/** @brief Reads the properties of an image without decoding it.
+
+The function selects the decoder by the content of the file like cv::imread, but reads only the
+header of the image, and the EXIF data if any. No pixel data is read or allocated, so it is
+much cheaper than loading the image.
+
+@param filename Name of the file.
+@param header Output image properties.
+@return true if the file is an image that can be read by cv::imread, false otherwise.
+*/
+CV_EXPORTS bool imreadHeader( const String& filename, ImageHeader& header );
+
+/** @brief Reads the properties of an image in a memory buffer without decoding it.
+
+See cv::imreadHeader for details.
+
+@param buf Input array or vector of bytes.
+@param header Output image properties.
+*/
+CV_EXPORTS bool imdecodeHeader( InputArray buf, ImageHeader& header );
+
 /** @brief Encodes an image into a memory buffer.
 
 The function imencode compresses the image and stores it in the memory buffer that is resized to fit the
@@ -245,6 +338,175 @@ CV_EXPORTS_W bool imencode( const String& ext, InputArray img,
                             CV_OUT std::vector<uchar>& buf,
                             const std::vector<int>& params = std::vector<int>());
 
+/** @brief Reads an image by horizontal bands of rows.
+
+The reader decodes only the rows requested by the consecutive read() calls, so the top of an image can
+be processed while the rest of it is not decoded yet, and only the encoded image and the current band
+have to be kept in memory. The decoder advances only when the next band is requested, so a consumer
+running slower than the decoder never makes the decoded data accumulate.
+
+JPEG, non-interlaced PNG, TIFF and PBM/PGM/PPM/PNM images are decoded incrementally. Other formats,
+interlaced PNG, floating-point and bottom-up TIFF images are decoded at once when the reader is
+opened and then returned by bands. TIFF images are decoded by whole strips or rows of tiles, a strip
+crossing the end of a band is kept decoded for the next bands.
+
+@code
+    ImageRowReader reader("huge.jpg");
+    Mat band;
+    while (reader.read(band, 64))
+        process(band, reader.nextRow() - band.rows);
+@endcode
+*/
+class CV_EXPORTS ImageRowReader
+{
+public:
+    ImageRowReader();
+
+    /** @overload
+    @param filename Name of file to be loaded.
+    @param flags See ImageRowReader::open.
+    */
+    ImageRowReader( const String& filename, int flags = IMREAD_COLOR );
+
+    ~ImageRowReader();
+
+    /** @brief Opens an image file and reads its header.
+
+    @param filename Name of file to be loaded.
+    @param flags The same flags as in cv::imread, see cv::ImreadModes. The cv::IMREAD_REDUCED_* modes
+    are not supported, the EXIF orientation is not applied.
+    @return true if the image can be read.
+    */
+    bool open( const String& filename, int flags = IMREAD_COLOR );
+
+    /** @brief Opens an image in a memory buffer and reads its header.
+
+    The buffer is not copied, it must not be modified or released until the reader is released.
+
+    @param buf Input array or vector of bytes.
+    @param flags See ImageRowReader::open.
+    @return true if the image can be read.
+    */
+    bool openBuffer( InputArray buf, int flags = IMREAD_COLOR );
+
+    /** @brief Returns true if an image is opened and its decoding has not failed. */
+    bool isOpened() const;
+
+    /** @brief Closes the image. */
+    void release();
+
+    /** @brief Returns the size of the image. */
+    Size size() const;
+
+    /** @brief Returns the type of the bands. */
+    int type() const;
+
+    /** @brief Returns the index of the image row the next read() starts from. */
+    int nextRow() const;
+
+    /** @brief Decodes the next band of rows.
+
+    @param band Output band of size() width and at most rows height (less for the last band).
+    @param rows Number of rows to read.
+    @return false if there are no more rows to read, or the image can't be decoded.
+    */
+    bool read( OutputArray band, int rows );
+
+protected:
+    struct Impl;
+    Ptr<Impl> p;
+};
+
+/** @brief Reads the pages of a multi-page image on demand.
+
+Unlike cv::imreadmulti, which decodes all the pages at once, the collection decodes a page only when
+it is accessed, and doesn't keep it, so the memory use doesn't depend on the number of pages. Pages
+are read fastest in increasing order; going back to a previous page reopens the file and skips the
+pages before it without decoding them.
+
+@code
+    ImageCollection pages("scan.tiff");
+    for (ImageCollection::iterator it = pages.begin(); it != pages.end(); ++it)
+        process(*it);
+    Mat last = pages[(int)pages.size() - 1];
+@endcode
+*/
+class CV_EXPORTS ImageCollection
+{
+public:
+    /** @brief Input iterator over the pages, decoding the page when dereferenced. */
+    class CV_EXPORTS iterator
+    {
+    public:
+        typedef std::input_iterator_tag iterator_category;
+        typedef Mat value_type;
+        typedef ptrdiff_t difference_type;
+        typedef const Mat* pointer;
+        typedef Mat reference;
+
+        iterator();
+        iterator( ImageCollection* collection, int index );
+
+        Mat operator*() const;
+        iterator& operator++();
+        iterator operator++(int);
+        bool operator==( const iterator& other ) const;
+        bool operator!=( const iterator& other ) const;
+
+    private:
+        ImageCollection* collection;
+        int index;
+    };
+
+    ImageCollection();
+
+    /** @overload
+    @param filename Name of file to be loaded.
+    @param flags See ImageCollection::open.
+    */
+    ImageCollection( const String& filename, int flags = IMREAD_ANYCOLOR );
+
+    ~ImageCollection();
+
+    /** @brief Opens a multi-page image file and reads the header of its first page.
+
+    @param filename Name of file to be loaded.
+    @param flags The same flags as in cv::imreadmulti, see cv::ImreadModes. The cv::IMREAD_REDUCED_*
+    modes are not supported.
+    @return true if the image can be read.
+    */
+    bool open( const String& filename, int flags = IMREAD_ANYCOLOR );
+
+    /** @brief Returns true if an image is opened. */
+    bool isOpened() const;
+
+    /** @brief Closes the image. */
+    void release();
+
+    /** @brief Returns the number of pages.
+
+    The pages are counted from their headers when the function is called for the first time.
+    */
+    size_t size() const;
+
+    /** @brief Decodes a page.
+
+    @param index Index of the page, from 0 to size() - 1.
+    @return The decoded page, empty if it can't be decoded.
+    */
+    Mat at( int index );
+
+    /** @overload */
+    Mat operator[]( int index ) { return at(index); }
+
+    iterator begin();
+    iterator end();
+
+protected:
+    struct Impl;
+    Ptr<Impl> p;
+};
+
 //! @} imgcodecs
 
 } // cv
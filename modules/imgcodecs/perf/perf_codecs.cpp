@@ -0,0 +1,220 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html
+#include "perf_precomp.hpp"
+
+#ifdef HAVE_TIFF
+// these defines are used to resolve conflict between tiff.h and opencv2/core/types_c.h
+#define uint64 uint64_hack_
+#define int64 int64_hack_
+#include "tiff.h"
+#undef uint64
+#undef int64
+#endif
+
+namespace opencv_test
+{
+using namespace perf;
+
+struct CodecConfig
+{
+    const char* name;  // test parameter
+    const char* ext;
+    int depth;
+    int cn;
+    int nparams;
+    int params[4];     // imwrite parameters
+};
+
+static const CodecConfig configs[] = {
+#ifdef HAVE_JPEG
+    { "jpg_q50",         ".jpg",  CV_8U,  3, 2, { IMWRITE_JPEG_QUALITY, 50 } },
+    { "jpg_q95",         ".jpg",  CV_8U,  3, 2, { IMWRITE_JPEG_QUALITY, 95 } },
+    { "jpg_q95_gray",    ".jpg",  CV_8U,  1, 2, { IMWRITE_JPEG_QUALITY, 95 } },
+    { "jpg_progressive", ".jpg",  CV_8U,  3, 2, { IMWRITE_JPEG_PROGRESSIVE, 1 } },
+    { "jpg_optimize",    ".jpg",  CV_8U,  3, 2, { IMWRITE_JPEG_OPTIMIZE, 1 } },
+#endif
+#ifdef HAVE_PNG
+    { "png_c1",          ".png",  CV_8U,  3, 2, { IMWRITE_PNG_COMPRESSION, 1 } },
+    { "png_c3",          ".png",  CV_8U,  3, 2, { IMWRITE_PNG_COMPRESSION, 3 } },
+    { "png_c9",          ".png",  CV_8U,  3, 2, { IMWRITE_PNG_COMPRESSION, 9 } },
+    { "png_c3_rgba",     ".png",  CV_8U,  4, 2, { IMWRITE_PNG_COMPRESSION, 3 } },
+    { "png_c3_16u",      ".png",  CV_16U, 3, 2, { IMWRITE_PNG_COMPRESSION, 3 } },
+    { "png_rle",         ".png",  CV_8U,  3, 2, { IMWRITE_PNG_STRATEGY, IMWRITE_PNG_STRATEGY_RLE } },
+    { "png_huffman",     ".png",  CV_8U,  3, 2, { IMWRITE_PNG_STRATEGY, IMWRITE_PNG_STRATEGY_HUFFMAN_ONLY } },
+    { "png_filtered",    ".png",  CV_8U,  3, 2, { IMWRITE_PNG_STRATEGY, IMWRITE_PNG_STRATEGY_FILTERED } },
+    { "png_c3_threads",  ".png",  CV_8U,  3, 4, { IMWRITE_PNG_COMPRESSION, 3, IMWRITE_THREADS, 0 } },
+#endif
+#ifdef HAVE_TIFF
+    { "tiff_none",       ".tiff", CV_8U,  3, 2, { TIFFTAG_COMPRESSION, COMPRESSION_NONE } },
+    { "tiff_lzw",        ".tiff", CV_8U,  3, 2, { TIFFTAG_COMPRESSION, COMPRESSION_LZW } },
+    { "tiff_deflate",    ".tiff", CV_8U,  3, 2, { TIFFTAG_COMPRESSION, COMPRESSION_ADOBE_DEFLATE } },
+    { "tiff_lzw_16u",    ".tiff", CV_16U, 3, 2, { TIFFTAG_COMPRESSION, COMPRESSION_LZW } },
+    { "tiff_lzw_32f",    ".tiff", CV_32F, 1, 2, { TIFFTAG_COMPRESSION, COMPRESSION_LZW } },
+    { "tiff_lzw_threads",".tiff", CV_8U,  3, 4, { TIFFTAG_COMPRESSION, COMPRESSION_LZW, IMWRITE_THREADS, 0 } },
+    { "tiff_lzw_1strip", ".tiff", CV_8U,  3, 4, { TIFFTAG_COMPRESSION, COMPRESSION_LZW, TIFFTAG_ROWSPERSTRIP, 1 << 16 } },
+#endif
+#ifdef HAVE_WEBP
+    { "webp_q75",        ".webp", CV_8U,  3, 2, { IMWRITE_WEBP_QUALITY, 75 } },
+    { "webp_lossless",   ".webp", CV_8U,  3, 2, { IMWRITE_WEBP_QUALITY, 101 } },
+#endif
+#ifdef HAVE_OPENEXR
+    { "exr_float",       ".exr",  CV_32F, 3, 2, { IMWRITE_EXR_TYPE, IMWRITE_EXR_TYPE_FLOAT } },
+    { "exr_half",        ".exr",  CV_32F, 3, 2, { IMWRITE_EXR_TYPE, IMWRITE_EXR_TYPE_HALF } },
+#endif
+#ifdef HAVE_IMGCODEC_PXM
+    { "ppm",             ".ppm",  CV_8U,  3, 2, { IMWRITE_PXM_BINARY, 1 } },
+    { "ppm_16u",         ".ppm",  CV_16U, 3, 2, { IMWRITE_PXM_BINARY, 1 } },
+    { "pgm",             ".pgm",  CV_8U,  1, 2, { IMWRITE_PXM_BINARY, 1 } },
+    { "pgm_16u",         ".pgm",  CV_16U, 1, 2, { IMWRITE_PXM_BINARY, 1 } },
+#endif
+#ifdef HAVE_IMGCODEC_QLI
+    { "qli",             ".qli",  CV_8U,  3, 2, { IMWRITE_THREADS, 0 } },
+    { "qli_gray",        ".qli",  CV_8U,  1, 2, { IMWRITE_THREADS, 0 } },
+    { "qli_rgba",        ".qli",  CV_8U,  4, 2, { IMWRITE_THREADS, 0 } },
+    { "qli_16u",         ".qli",  CV_16U, 3, 2, { IMWRITE_THREADS, 0 } },
+    { "qli_1thread",     ".qli",  CV_8U,  3, 2, { IMWRITE_THREADS, 1 } },
+#endif
+    { "bmp",             ".bmp",  CV_8U,  3, 0, { 0 } },
+    { "bmp_gray",        ".bmp",  CV_8U,  1, 0, { 0 } },
+    { "bmp_rgba",        ".bmp",  CV_8U,  4, 0, { 0 } },
+};
+
+static std::vector<string> configNames()
+{
+    std::vector<string> names;
+    for (size_t i = 0; i < sizeof(configs) / sizeof(configs[0]); i++)
+        names.push_back(configs[i].name);
+    return names;
+}
+
+static const CodecConfig& getConfig(const string& name)
+{
+    for (size_t i = 0; i < sizeof(configs) / sizeof(configs[0]); i++)
+        if (name == configs[i].name)
+            return configs[i];
+    CV_Error(Error::StsBadArg, "unknown codec configuration: " + name);
+}
+
+// Smooth random image, compressing roughly like a photo
+static Mat makeImage(const CodecConfig& config, const Size& size)
+{
+    const double maxVal = config.depth == CV_8U ? 255 : config.depth == CV_16U ? 65535 : 1;
+    Mat img(size, CV_MAKETYPE(config.depth, config.cn));
+    RNG rng(size.area());
+    rng.fill(img, RNG::UNIFORM, Scalar::all(0), Scalar::all(maxVal));
+    GaussianBlur(img, img, Size(9, 9), 0);
+    return img;
+}
+
+typedef tuple<string, Size> Codec_t;
+
+class Imgcodecs_Codec : public TestBaseWithParam<Codec_t>
+{
+protected:
+    void SetUp() CV_OVERRIDE
+    {
+        TestBaseWithParam<Codec_t>::SetUp();
+        const CodecConfig& config = getConfig(get<0>(GetParam()));
+        ext = config.ext;
+        params.assign(config.params, config.params + config.nparams);
+        img = makeImage(config, get<1>(GetParam()));
+        ASSERT_TRUE(imencode(ext, img, buf, params));
+    }
+
+    //! Prints and records the throughput of the measured cycle in megapixels per second
+    void reportThroughput()
+    {
+        const performance_metrics& m = calcMetrics();
+        if (m.median <= 0)
+            return;
+        const double mpix = img.total() * 1e-6 / (m.median / m.frequency);
+        printf("[ PERFSTAT ]    (throughput=%.2f MPix/s   compressed=%.2f bpp)\n",
+               mpix, buf.size() * 8.0 / img.total());
+        RecordProperty("mpix_per_sec", cv::format("%.2f", mpix).c_str());
+        RecordProperty("compressed_size", (int)buf.size());
+    }
+
+    string ext;
+    std::vector<int> params;
+    Mat img;
+    std::vector<uchar> buf;
+};
+
+#define CODEC_PARAMS testing::Combine(testing::ValuesIn(configNames()), testing::Values(szVGA, sz1080p))
+
+PERF_TEST_P(Imgcodecs_Codec, imdecode, CODEC_PARAMS)
+{
+    Mat dst;
+    TEST_CYCLE() imdecode(buf, IMREAD_UNCHANGED, &dst);
+
+    ASSERT_EQ(img.size(), dst.size());
+    reportThroughput();
+    SANITY_CHECK_NOTHING();
+}
+
+// Decoding into the other color layout goes through the color conversions of the decoders
+PERF_TEST_P(Imgcodecs_Codec, imdecode_convert, CODEC_PARAMS)
+{
+    const int flags = (img.channels() == 1 ? IMREAD_COLOR : IMREAD_GRAYSCALE) | IMREAD_ANYDEPTH;
+    Mat dst;
+    TEST_CYCLE() imdecode(buf, flags, &dst);
+
+    ASSERT_EQ(img.size(), dst.size());
+    reportThroughput();
+    SANITY_CHECK_NOTHING();
+}
+
+// Row by row, the incremental decoders must not decode more than imdecode does
+PERF_TEST_P(Imgcodecs_Codec, read_rows, CODEC_PARAMS)
+{
+    Mat row;
+    TEST_CYCLE()
+    {
+        ImageRowReader reader;
+        ASSERT_TRUE(reader.openBuffer(buf, IMREAD_UNCHANGED));
+        while (reader.read(row, 1))
+            ;
+        ASSERT_EQ(img.rows, reader.nextRow());
+    }
+
+    reportThroughput();
+    SANITY_CHECK_NOTHING();
+}
+
+PERF_TEST_P(Imgcodecs_Codec, imread, CODEC_PARAMS)
+{
+    const string filename = cv::tempfile(ext.c_str());
+    ASSERT_TRUE(imwrite(filename, img, params));
+
+    Mat dst;
+    TEST_CYCLE() dst = imread(filename, IMREAD_UNCHANGED);
+
+    EXPECT_EQ(0, remove(filename.c_str()));
+    ASSERT_EQ(img.size(), dst.size());
+    reportThroughput();
+    SANITY_CHECK_NOTHING();
+}
+
+PERF_TEST_P(Imgcodecs_Codec, imencode, CODEC_PARAMS)
+{
+    std::vector<uchar> dst;
+    TEST_CYCLE() imencode(ext, img, dst, params);
+
+    ASSERT_EQ(buf.size(), dst.size());
+    reportThroughput();
+    SANITY_CHECK_NOTHING();
+}
+
+PERF_TEST_P(Imgcodecs_Codec, imwrite, CODEC_PARAMS)
+{
+    const string filename = cv::tempfile(ext.c_str());
+
+    TEST_CYCLE() imwrite(filename, img, params);
+
+    EXPECT_EQ(0, remove(filename.c_str()));
+    reportThroughput();
+    SANITY_CHECK_NOTHING();
+}
+
+} // namespace
@@ -53,6 +53,7 @@ BaseImageDecoder::BaseImageDecoder()
     m_type = -1;
     m_buf_supported = false;
     m_scale_denom = 1;
+    m_row = 0;
 }
 
 bool BaseImageDecoder::setSource( const String& filename )
@@ -89,6 +90,28 @@ int BaseImageDecoder::setScale( const int& scale_denom )
     return temp;
 }
 
+bool BaseImageDecoder::startRows( int type )
+{
+    m_row = 0;
+    m_rows.create( m_height, m_width, type );
+    if( !readData( m_rows ) )
+    {
+        m_rows.release();
+        return false;
+    }
+    return true;
+}
+
+int BaseImageDecoder::readRows( Mat& rows )
+{
+    int count = std::min( rows.rows, m_rows.rows - m_row );
+    if( m_rows.empty() || count <= 0 )
+        return 0;
+    m_rows.rowRange( m_row, m_row + count ).copyTo( rows.rowRange( 0, count ) );
+    m_row += count;
+    return count;
+}
+
 ImageDecoder BaseImageDecoder::newDecoder() const
 {
     return ImageDecoder();
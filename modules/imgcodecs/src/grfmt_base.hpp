@@ -71,9 +71,26 @@ public:
     virtual bool readHeader() = 0;
     virtual bool readData( Mat& img ) = 0;
 
+    /// Restricts readData to a region of the image, in the coordinates of the image described
+    /// by readHeader (so it is called after readHeader). readData then gets a Mat of roi size.
+    /// Returns false if the decoder can read the whole image only.
+    virtual bool setROI( const Rect& /*roi*/ ) { return false; }
+
+    /// Row-by-row decoding, an alternative to readData. startRows is called once after readHeader,
+    /// then every readRows call decodes the next rows of the image into the first rows of the Mat
+    /// of width() columns and returns their number (0 after the last row or on failure).
+    /// The region set by setROI, if any, is ignored.
+    /// The default implementation decodes the whole image with readData in startRows.
+    virtual bool startRows( int type );
+    virtual int readRows( Mat& rows );
+
     /// Called after readData to advance to the next page, if any.
     virtual bool nextPage() { return false; }
 
+    /// Returns true if the decoder object can read several images one after another,
+    /// i.e. setSource() and readHeader() reset all the state left from the previous image.
+    virtual bool isReusable() const { return false; }
+
     virtual size_t signatureLength() const;
     virtual bool checkSignature( const String& signature ) const;
     virtual ImageDecoder newDecoder() const;
@@ -87,6 +104,8 @@ protected:
     String m_signature;
     Mat m_buf;
     bool m_buf_supported;
+    Mat m_rows; // the whole image decoded by the default startRows
+    int m_row;  // next row returned by readRows
 };
 
 
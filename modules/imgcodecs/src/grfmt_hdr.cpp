@@ -42,7 +42,6 @@
 
 #include "precomp.hpp"
 #include "grfmt_hdr.hpp"
-#include "rgbe.hpp"
 
 #ifdef HAVE_IMGCODEC_HDR
 
@@ -53,12 +52,22 @@ HdrDecoder::HdrDecoder()
 {
     m_signature = "#?RGBE";
     m_signature_alt = "#?RADIANCE";
-    file = NULL;
+    memset(&m_input, 0, sizeof(m_input));
     m_type = CV_32FC3;
+    m_buf_supported = true;
 }
 
 HdrDecoder::~HdrDecoder()
 {
+    close();
+}
+
+void HdrDecoder::close()
+{
+    if(m_input.fp) {
+        fclose(m_input.fp);
+    }
+    memset(&m_input, 0, sizeof(m_input));
 }
 
 size_t HdrDecoder::signatureLength() const
@@ -69,14 +78,19 @@ size_t HdrDecoder::signatureLength() const
 
 bool  HdrDecoder::readHeader()
 {
-    file = fopen(m_filename.c_str(), "rb");
-    if(!file) {
-        return false;
+    close();
+    if(!m_buf.empty()) {
+        m_input.data = m_buf.ptr();
+        m_input.size = m_buf.total() * m_buf.elemSize();
+    } else {
+        m_input.fp = fopen(m_filename.c_str(), "rb");
+        if(!m_input.fp) {
+            return false;
+        }
     }
-    RGBE_ReadHeader(file, &m_width, &m_height, NULL);
+    RGBE_ReadHeader(&m_input, &m_width, &m_height, NULL);
     if(m_width <= 0 || m_height <= 0) {
-        fclose(file);
-        file = NULL;
+        close();
         return false;
     }
     return true;
@@ -85,13 +99,13 @@ bool  HdrDecoder::readHeader()
 bool HdrDecoder::readData(Mat& _img)
 {
     Mat img(m_height, m_width, CV_32FC3);
-    if(!file) {
+    if(!m_input.fp && !m_input.data) {
         if(!readHeader()) {
             return false;
         }
     }
-    RGBE_ReadPixels_RLE(file, const_cast<float*>(img.ptr<float>()), img.cols, img.rows);
-    fclose(file); file = NULL;
+    RGBE_ReadPixels_RLE(&m_input, const_cast<float*>(img.ptr<float>()), img.cols, img.rows);
+    close();
 
     if(_img.depth() == img.depth()) {
         img.convertTo(_img, _img.type());
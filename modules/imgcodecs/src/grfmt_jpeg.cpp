@@ -75,6 +75,11 @@ extern "C" {
 #include "jpeglib.h"
 }
 
+// libjpeg-turbo 1.5+ can skip whole rows and decode a range of MCU columns only
+#if defined(LIBJPEG_TURBO_VERSION_NUMBER) && LIBJPEG_TURBO_VERSION_NUMBER >= 1005000
+#define JPEG_HAVE_PARTIAL_DECODING 1
+#endif
+
 namespace cv
 {
 
@@ -95,6 +100,9 @@ struct JpegState
     jpeg_decompress_struct cinfo; // IJG JPEG codec structure
     JpegErrorMgr jerr; // error processing manager state
     JpegSource source; // memory buffer source
+    JSAMPARRAY buffer; // decoded row, allocated by startRows and released after the last row
+    int xofs; // position of the first column to read in the decoded row
+    int rows_left; // rows still to be read by readRows
 };
 
 /////////////////////// Error processing /////////////////////
@@ -197,6 +205,15 @@ void  JpegDecoder::close()
 
     m_width = m_height = 0;
     m_type = -1;
+    m_roi = Rect();
+}
+
+bool  JpegDecoder::setROI( const Rect& roi )
+{
+    if( !m_state || (roi & Rect(0, 0, m_width, m_height)) != roi || roi.empty() )
+        return false;
+    m_roi = roi;
+    return true;
 }
 
 ImageDecoder JpegDecoder::newDecoder() const
@@ -211,6 +228,7 @@ bool  JpegDecoder::readHeader()
 
     JpegState* state = new JpegState;
     m_state = state;
+    state->buffer = 0;
     state->cinfo.err = jpeg_std_error(&state->jerr.pub);
     state->jerr.pub.error_exit = error_exit;
 
@@ -387,17 +405,27 @@ int my_jpeg_load_dht (struct jpeg_decompress_struct *info, unsigned char *dht,
  ***************************************************************************/
 
 bool  JpegDecoder::readData( Mat& img )
+{
+    bool result = startRows( img.type() ) && readRows( img ) == img.rows;
+    close();
+    return result;
+}
+
+bool  JpegDecoder::startRows( int type )
 {
     volatile bool result = false;
-    size_t step = img.step;
-    bool color = img.channels() > 1;
+    bool color = CV_MAT_CN(type) > 1;
 
+    m_rows.release();
+    m_row = 0;
     if( m_state && m_width && m_height )
     {
-        jpeg_decompress_struct* cinfo = &((JpegState*)m_state)->cinfo;
-        JpegErrorMgr* jerr = &((JpegState*)m_state)->jerr;
+        JpegState* state = (JpegState*)m_state;
+        jpeg_decompress_struct* cinfo = &state->cinfo;
+        JpegErrorMgr* jerr = &state->jerr;
         JSAMPARRAY buffer = 0;
 
+        state->buffer = 0;
         if( setjmp( jerr->setjmp_buffer ) == 0 )
         {
             /* check if this is a mjpeg image format */
@@ -446,33 +474,107 @@ bool  JpegDecoder::readData( Mat& img )
             buffer = (*cinfo->mem->alloc_sarray)((j_common_ptr)cinfo,
                                               JPOOL_IMAGE, m_width*4, 1 );
 
-            uchar* data = img.ptr();
-            for( ; m_height--; data += step )
+            Rect roi = m_roi.empty() ? Rect(0, 0, m_width, m_height) : m_roi;
+            int xofs = 0; // position of roi.x in the decoded row
+            int skip = 0;  // rows skipped without decoding
+#ifdef JPEG_HAVE_PARTIAL_DECODING
+            // Chroma upsampling of the pixels near the edges of a cropped or skipped part
+            // differs from the full decoding, so one iMCU of context is kept around the region
+#if JPEG_LIB_VERSION >= 70
+            const int imcu_width = cinfo->max_h_samp_factor * cinfo->min_DCT_h_scaled_size;
+            const int imcu_height = cinfo->max_v_samp_factor * cinfo->min_DCT_v_scaled_size;
+#else
+            const int imcu_width = cinfo->max_h_samp_factor * cinfo->min_DCT_scaled_size;
+            const int imcu_height = cinfo->max_v_samp_factor * cinfo->min_DCT_scaled_size;
+#endif
+            const int crop_x0 = std::max(roi.x - imcu_width, 0);
+            const int crop_x1 = std::min(roi.x + roi.width + imcu_width, m_width);
+            if( crop_x1 - crop_x0 < m_width )
             {
+                // the range is extended to the iMCU boundaries
+                JDIMENSION crop_x = crop_x0, crop_width = crop_x1 - crop_x0;
+                jpeg_crop_scanline( cinfo, &crop_x, &crop_width );
+                xofs = roi.x - (int)crop_x;
+            }
+            else
+                xofs = roi.x;
+            skip = std::max(roi.y - imcu_height, 0);
+            if( skip > 0 )
+                jpeg_skip_scanlines( cinfo, skip );
+#else
+            xofs = roi.x;
+#endif
+            for( int y = skip; y < roi.y; y++ )
                 jpeg_read_scanlines( cinfo, buffer, 1 );
+
+            state->buffer = buffer;
+            state->xofs = xofs;
+            state->rows_left = roi.height;
+            result = true;
+        }
+    }
+
+    return result;
+}
+
+int  JpegDecoder::readRows( Mat& rows )
+{
+    volatile int count = 0;
+    JpegState* state = (JpegState*)m_state;
+
+    if( state && state->buffer )
+    {
+        jpeg_decompress_struct* cinfo = &state->cinfo;
+        JpegErrorMgr* jerr = &state->jerr;
+
+        if( setjmp( jerr->setjmp_buffer ) == 0 )
+        {
+            const int n = std::min( rows.rows, state->rows_left );
+            const bool color = rows.channels() > 1;
+            const int width = rows.cols;
+            const uchar* src = state->buffer[0] + state->xofs*cinfo->out_color_components;
+
+            for( int y = 0; y < n; y++ )
+            {
+                uchar* data = rows.ptr(y);
+                jpeg_read_scanlines( cinfo, state->buffer, 1 );
                 if( color )
                 {
                     if( cinfo->out_color_components == 3 )
-                        icvCvt_RGB2BGR_8u_C3R( buffer[0], 0, data, 0, cvSize(m_width,1) );
+                        icvCvt_RGB2BGR_8u_C3R( src, 0, data, 0, cvSize(width,1) );
                     else
-                        icvCvt_CMYK2BGR_8u_C4C3R( buffer[0], 0, data, 0, cvSize(m_width,1) );
+                        icvCvt_CMYK2BGR_8u_C4C3R( src, 0, data, 0, cvSize(width,1) );
                 }
                 else
                 {
                     if( cinfo->out_color_components == 1 )
-                        memcpy( data, buffer[0], m_width );
+                        memcpy( data, src, width );
                     else
-                        icvCvt_CMYK2Gray_8u_C4C1R( buffer[0], 0, data, 0, cvSize(m_width,1) );
+                        icvCvt_CMYK2Gray_8u_C4C1R( src, 0, data, 0, cvSize(width,1) );
                 }
             }
 
-            result = true;
-            jpeg_finish_decompress( cinfo );
+            state->rows_left -= n;
+            m_row += n;
+            count = n;
+            if( state->rows_left == 0 )
+            {
+                // the rest of the rows is not needed
+                state->buffer = 0;
+                if( cinfo->output_scanline < cinfo->output_height )
+                    jpeg_abort_decompress( cinfo );
+                else
+                    jpeg_finish_decompress( cinfo );
+            }
+        }
+        else
+        {
+            state->buffer = 0;
+            count = 0;
         }
     }
 
-    close();
-    return result;
+    return count;
 }
 
 
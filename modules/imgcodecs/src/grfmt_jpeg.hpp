@@ -64,12 +64,17 @@ public:
     bool  readHeader() CV_OVERRIDE;
     void  close();
 
+    bool  setROI( const Rect& roi ) CV_OVERRIDE;
+    bool  startRows( int type ) CV_OVERRIDE;
+    int   readRows( Mat& rows ) CV_OVERRIDE;
+    bool  isReusable() const CV_OVERRIDE { return true; }
     ImageDecoder newDecoder() const CV_OVERRIDE;
 
 protected:
 
     FILE* m_f;
     void* m_state;
+    Rect  m_roi; // empty if the whole image is read
 
 private:
     JpegDecoder(const JpegDecoder &); // copy disabled
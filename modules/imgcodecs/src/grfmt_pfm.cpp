@@ -82,6 +82,7 @@ PFMDecoder::~PFMDecoder()
 PFMDecoder::PFMDecoder()
 {
   m_strm.close();
+  m_buf_supported = true;
 }
 
 bool PFMDecoder::readHeader()
@@ -221,15 +221,60 @@ bool  PngDecoder::readHeader()
 }
 
 
+void  PngDecoder::setTransforms( int type )
+{
+    png_structp png_ptr = (png_structp)m_png_ptr;
+    png_infop info_ptr = (png_infop)m_info_ptr;
+    bool color = CV_MAT_CN(type) > 1;
+
+    if( CV_MAT_DEPTH(type) == CV_8U && m_bit_depth == 16 )
+        png_set_strip_16( png_ptr );
+    else if( !isBigEndian() )
+        png_set_swap( png_ptr );
+
+    if(CV_MAT_CN(type) < 4)
+    {
+        /* observation: png_read_image() writes 400 bytes beyond
+         * end of data when reading a 400x118 color png
+         * "mpplus_sand.png".  OpenCV crashes even with demo
+         * programs.  Looking at the loaded image I'd say we get 4
+         * bytes per pixel instead of 3 bytes per pixel.  Test
+         * indicate that it is a good idea to always ask for
+         * stripping alpha..  18.11.2004 Axel Walthelm
+         */
+         png_set_strip_alpha( png_ptr );
+    } else
+        png_set_tRNS_to_alpha( png_ptr );
+
+    if( m_color_type == PNG_COLOR_TYPE_PALETTE )
+        png_set_palette_to_rgb( png_ptr );
+
+    if( (m_color_type & PNG_COLOR_MASK_COLOR) == 0 && m_bit_depth < 8 )
+#if (PNG_LIBPNG_VER_MAJOR*10000 + PNG_LIBPNG_VER_MINOR*100 + PNG_LIBPNG_VER_RELEASE >= 10209) || \
+    (PNG_LIBPNG_VER_MAJOR == 1 && PNG_LIBPNG_VER_MINOR == 0 && PNG_LIBPNG_VER_RELEASE >= 18)
+        png_set_expand_gray_1_2_4_to_8( png_ptr );
+#else
+        png_set_gray_1_2_4_to_8( png_ptr );
+#endif
+
+    if( (m_color_type & PNG_COLOR_MASK_COLOR) && color )
+        png_set_bgr( png_ptr ); // convert RGB to BGR
+    else if( color )
+        png_set_gray_to_rgb( png_ptr ); // Gray->RGB
+    else
+        png_set_rgb_to_gray( png_ptr, 1, 0.299, 0.587 ); // RGB->Gray
+
+    png_set_interlace_handling( png_ptr );
+    png_read_update_info( png_ptr, info_ptr );
+}
+
 bool  PngDecoder::readData( Mat& img )
 {
     volatile bool result = false;
     AutoBuffer<uchar*> _buffer(m_height);
     uchar** buffer = _buffer.data();
-    bool color = img.channels() > 1;
 
     png_structp png_ptr = (png_structp)m_png_ptr;
-    png_infop info_ptr = (png_infop)m_info_ptr;
     png_infop end_info = (png_infop)m_end_info;
 
     if( m_png_ptr && m_info_ptr && m_end_info && m_width && m_height )
@@ -238,45 +283,7 @@ bool  PngDecoder::readData( Mat& img )
         {
             int y;
 
-            if( img.depth() == CV_8U && m_bit_depth == 16 )
-                png_set_strip_16( png_ptr );
-            else if( !isBigEndian() )
-                png_set_swap( png_ptr );
-
-            if(img.channels() < 4)
-            {
-                /* observation: png_read_image() writes 400 bytes beyond
-                 * end of data when reading a 400x118 color png
-                 * "mpplus_sand.png".  OpenCV crashes even with demo
-                 * programs.  Looking at the loaded image I'd say we get 4
-                 * bytes per pixel instead of 3 bytes per pixel.  Test
-                 * indicate that it is a good idea to always ask for
-                 * stripping alpha..  18.11.2004 Axel Walthelm
-                 */
-                 png_set_strip_alpha( png_ptr );
-            } else
-                png_set_tRNS_to_alpha( png_ptr );
-
-            if( m_color_type == PNG_COLOR_TYPE_PALETTE )
-                png_set_palette_to_rgb( png_ptr );
-
-            if( (m_color_type & PNG_COLOR_MASK_COLOR) == 0 && m_bit_depth < 8 )
-#if (PNG_LIBPNG_VER_MAJOR*10000 + PNG_LIBPNG_VER_MINOR*100 + PNG_LIBPNG_VER_RELEASE >= 10209) || \
-    (PNG_LIBPNG_VER_MAJOR == 1 && PNG_LIBPNG_VER_MINOR == 0 && PNG_LIBPNG_VER_RELEASE >= 18)
-                png_set_expand_gray_1_2_4_to_8( png_ptr );
-#else
-                png_set_gray_1_2_4_to_8( png_ptr );
-#endif
-
-            if( (m_color_type & PNG_COLOR_MASK_COLOR) && color )
-                png_set_bgr( png_ptr ); // convert RGB to BGR
-            else if( color )
-                png_set_gray_to_rgb( png_ptr ); // Gray->RGB
-            else
-                png_set_rgb_to_gray( png_ptr, 1, 0.299, 0.587 ); // RGB->Gray
-
-            png_set_interlace_handling( png_ptr );
-            png_read_update_info( png_ptr, info_ptr );
+            setTransforms( img.type() );
 
             for( y = 0; y < m_height; y++ )
                 buffer[y] = img.data + y*img.step;
@@ -292,6 +299,292 @@ bool  PngDecoder::readData( Mat& img )
     return result;
 }
 
+bool  PngDecoder::startRows( int type )
+{
+    volatile bool result = false;
+    png_structp png_ptr = (png_structp)m_png_ptr;
+    png_infop info_ptr = (png_infop)m_info_ptr;
+
+    m_rows.release();
+    m_row = 0;
+    if( m_png_ptr && m_info_ptr && m_end_info && m_width && m_height )
+    {
+        // the rows of interlaced images are complete after the last pass only
+        if( png_get_interlace_type( png_ptr, info_ptr ) != PNG_INTERLACE_NONE )
+            return BaseImageDecoder::startRows( type );
+
+        if( setjmp( png_jmpbuf ( png_ptr ) ) == 0 )
+        {
+            setTransforms( type );
+            result = true;
+        }
+    }
+
+    return result;
+}
+
+int  PngDecoder::readRows( Mat& rows )
+{
+    if( !m_rows.empty() )
+        return BaseImageDecoder::readRows( rows );
+
+    volatile int count = 0;
+    png_structp png_ptr = (png_structp)m_png_ptr;
+    png_infop end_info = (png_infop)m_end_info;
+
+    if( m_png_ptr && m_info_ptr && m_end_info && m_row < m_height )
+    {
+        if( setjmp( png_jmpbuf ( png_ptr ) ) == 0 )
+        {
+            const int n = std::min( rows.rows, m_height - m_row );
+            for( int y = 0; y < n; y++ )
+                png_read_row( png_ptr, rows.ptr(y), NULL );
+
+            m_row += n;
+            count = n;
+            if( m_row == m_height )
+                png_read_end( png_ptr, end_info );
+        }
+        else
+            m_row = m_height;
+    }
+
+    return count;
+}
+
+
+/////////////////////// parallel compression ///////////////////
+//
+// The filtered rows are split into chunks compressed concurrently into raw deflate
+// streams. Every chunk but the last one ends with a sync flush, so the streams can be
+// concatenated, and starts with the dictionary of the preceding 32K of data, so the
+// compression ratio stays close to the one of a single stream (see pigz).
+
+// Converts an image row to the PNG sample order: RGB(A), 16-bit samples in big endian
+static void pngPrepareRow( const Mat& img, int y, uchar* dst )
+{
+    const int width = img.cols;
+    switch( img.channels() )
+    {
+    case 3:
+        if( img.depth() == CV_8U )
+            icvCvt_BGR2RGB_8u_C3R( img.ptr(y), 0, dst, 0, cvSize(width,1) );
+        else
+            icvCvt_BGR2RGB_16u_C3R( img.ptr<ushort>(y), 0, (ushort*)dst, 0, cvSize(width,1) );
+        break;
+    case 4:
+        if( img.depth() == CV_8U )
+            icvCvt_BGRA2RGBA_8u_C4R( img.ptr(y), 0, dst, 0, cvSize(width,1) );
+        else
+            icvCvt_BGRA2RGBA_16u_C4R( img.ptr<ushort>(y), 0, (ushort*)dst, 0, cvSize(width,1) );
+        break;
+    default:
+        memcpy( dst, img.ptr(y), width*img.elemSize() );
+    }
+
+    if( img.depth() == CV_16U && !isBigEndian() )
+    {
+        for( size_t i = 0, len = width*img.elemSize(); i < len; i += 2 )
+            std::swap( dst[i], dst[i+1] );
+    }
+}
+
+static inline int pngPaeth( int a, int b, int c )
+{
+    int p = a + b - c, pa = std::abs(p - a), pb = std::abs(p - b), pc = std::abs(p - c);
+    return pa <= pb && pa <= pc ? a : pb <= pc ? b : c;
+}
+
+// Applies a PNG filter to a row, dst[0] receives the filter type
+static void pngFilterRow( int filter, const uchar* row, const uchar* prev, int len, int bpp, uchar* dst )
+{
+    int i;
+    *dst++ = (uchar)filter;
+    switch( filter )
+    {
+    case PNG_FILTER_VALUE_SUB:
+        for( i = 0; i < bpp; i++ )
+            dst[i] = row[i];
+        for( ; i < len; i++ )
+            dst[i] = (uchar)(row[i] - row[i - bpp]);
+        break;
+    case PNG_FILTER_VALUE_UP:
+        for( i = 0; i < len; i++ )
+            dst[i] = (uchar)(row[i] - prev[i]);
+        break;
+    case PNG_FILTER_VALUE_AVG:
+        for( i = 0; i < bpp; i++ )
+            dst[i] = (uchar)(row[i] - (prev[i] >> 1));
+        for( ; i < len; i++ )
+            dst[i] = (uchar)(row[i] - ((row[i - bpp] + prev[i]) >> 1));
+        break;
+    case PNG_FILTER_VALUE_PAETH:
+        for( i = 0; i < bpp; i++ )
+            dst[i] = (uchar)(row[i] - prev[i]);
+        for( ; i < len; i++ )
+            dst[i] = (uchar)(row[i] - pngPaeth(row[i - bpp], prev[i], prev[i - bpp]));
+        break;
+    default:
+        memcpy( dst, row, len );
+    }
+}
+
+// Sum of the absolute values of the filtered bytes, the heuristic of libpng for choosing the filter
+static int pngFilterCost( const uchar* data, int len )
+{
+    int cost = 0;
+    for( int i = 0; i < len; i++ )
+        cost += std::abs((int)(schar)data[i]);
+    return cost;
+}
+
+class PngFilterInvoker CV_FINAL : public ParallelLoopBody
+{
+public:
+    PngFilterInvoker( const Mat& img, bool adaptive, uchar* filtered )
+        : img_(img), adaptive_(adaptive), filtered_(filtered) {}
+
+    void operator()( const Range& range ) const CV_OVERRIDE
+    {
+        const int len = (int)(img_.cols*img_.elemSize()), bpp = (int)img_.elemSize();
+        AutoBuffer<uchar> _buf(len*2 + len + 1);
+        uchar *prev = _buf.data(), *row = prev + len, *tmp = row + len;
+
+        if( range.start > 0 )
+            pngPrepareRow( img_, range.start - 1, prev );
+        else
+            memset( prev, 0, len );
+
+        for( int y = range.start; y < range.end; y++ )
+        {
+            uchar* dst = filtered_ + (size_t)y*(len + 1);
+            pngPrepareRow( img_, y, row );
+            if( !adaptive_ )
+                pngFilterRow( PNG_FILTER_VALUE_SUB, row, prev, len, bpp, dst );
+            else
+            {
+                int best_cost = INT_MAX;
+                for( int filter = PNG_FILTER_VALUE_NONE; filter <= PNG_FILTER_VALUE_PAETH; filter++ )
+                {
+                    pngFilterRow( filter, row, prev, len, bpp, tmp );
+                    int cost = pngFilterCost( tmp + 1, len );
+                    if( cost < best_cost )
+                    {
+                        best_cost = cost;
+                        memcpy( dst, tmp, len + 1 );
+                    }
+                }
+            }
+            std::swap( prev, row );
+        }
+    }
+
+private:
+    const Mat& img_;
+    bool adaptive_;
+    uchar* filtered_;
+};
+
+class PngDeflateInvoker CV_FINAL : public ParallelLoopBody
+{
+public:
+    PngDeflateInvoker( const uchar* data, size_t size, size_t chunk_size, int level, int strategy,
+                       std::vector<std::vector<uchar> >& chunks, std::vector<uLong>& adlers )
+        : data_(data), size_(size), chunk_size_(chunk_size), level_(level), strategy_(strategy),
+          chunks_(chunks), adlers_(adlers) {}
+
+    void operator()( const Range& range ) const CV_OVERRIDE
+    {
+        for( int i = range.start; i < range.end; i++ )
+        {
+            const size_t begin = i*chunk_size_, end = std::min(begin + chunk_size_, size_);
+            const bool last = end == size_;
+            std::vector<uchar>& dst = chunks_[i];
+            z_stream strm;
+
+            memset( &strm, 0, sizeof(strm) );
+            if( deflateInit2( &strm, level_, Z_DEFLATED, -MAX_WBITS, 8, strategy_ ) != Z_OK )
+                continue; // the chunk is left empty
+            if( begin > 0 )
+            {
+                const size_t dict_size = std::min(begin, (size_t)1 << MAX_WBITS);
+                deflateSetDictionary( &strm, data_ + begin - dict_size, (uInt)dict_size );
+            }
+
+            // the bound doesn't include the empty block of the sync flush
+            dst.resize( deflateBound( &strm, (uLong)(end - begin) ) + 16 );
+            strm.next_in = (Bytef*)(data_ + begin);
+            strm.avail_in = (uInt)(end - begin);
+            strm.next_out = &dst[0];
+            strm.avail_out = (uInt)dst.size();
+            const int code = deflate( &strm, last ? Z_FINISH : Z_SYNC_FLUSH );
+            if( (last ? code == Z_STREAM_END : code == Z_OK) && strm.avail_in == 0 && strm.avail_out > 0 )
+                dst.resize( dst.size() - strm.avail_out );
+            else
+                dst.clear();
+            deflateEnd( &strm );
+
+            adlers_[i] = adler32( adler32( 0L, Z_NULL, 0 ), data_ + begin, (uInt)(end - begin) );
+        }
+    }
+
+private:
+    const uchar* data_;
+    size_t size_, chunk_size_;
+    int level_, strategy_;
+    std::vector<std::vector<uchar> >& chunks_;
+    std::vector<uLong>& adlers_;
+};
+
+/**
+ * Compress the image data in parallel
+ *
+ * @param[in] img Image
+ * @param[in] level,strategy zlib compression parameters
+ * @param[in] adaptive Choose the filter of every row as libpng does, use the Sub filter otherwise
+ * @param[in] threads Number of chunks compressed concurrently
+ * @param[out] chunks Compressed chunks forming a zlib stream together, the first one
+ *                    starts with the zlib header, the last one ends with the checksum
+ * @return false if the image is too small to be split or compression fails
+*/
+static bool pngCompressParallel( const Mat& img, int level, int strategy, bool adaptive, int threads,
+                                 std::vector<std::vector<uchar> >& chunks )
+{
+    const size_t row_size = img.cols*img.elemSize() + 1, size = row_size*img.rows;
+    const size_t min_chunk_size = (size_t)1 << MAX_WBITS, max_chunk_size = (size_t)1 << 26;
+    const size_t chunk_size = std::min(std::max((size + threads - 1) / threads, min_chunk_size), max_chunk_size);
+    const size_t nchunks = (size + chunk_size - 1) / chunk_size;
+    if( nchunks < 2 || nchunks > (size_t)INT_MAX )
+        return false;
+
+    std::vector<uchar> filtered(size);
+    parallel_for_( Range(0, img.rows), PngFilterInvoker(img, adaptive, &filtered[0]), threads );
+
+    std::vector<uLong> adlers(nchunks);
+    chunks.assign( nchunks, std::vector<uchar>() );
+    parallel_for_( Range(0, (int)nchunks),
+                   PngDeflateInvoker(&filtered[0], size, chunk_size, level, strategy, chunks, adlers),
+                   threads );
+
+    uLong adler = adlers[0];
+    for( size_t i = 0; i < nchunks; i++ )
+    {
+        if( chunks[i].empty() )
+            return false;
+        if( i > 0 )
+            adler = adler32_combine( adler, adlers[i], (z_off_t)(std::min(chunk_size, size - i*chunk_size)) );
+    }
+
+    // zlib header (RFC 1950): deflate with 32K window, the level class, and the check bits
+    const int cmf = 0x78;
+    int flg = (level < 0 || level == 6 ? 2 : level < 2 ? 0 : level < 6 ? 1 : 3) << 6;
+    flg += 31 - ((cmf << 8) + flg) % 31;
+    chunks.front().insert( chunks.front().begin(), (uchar)cmf );
+    chunks.front().insert( chunks.front().begin() + 1, (uchar)flg );
+    for( int i = 3; i >= 0; i-- )
+        chunks.back().push_back( (uchar)(adler >> (i*8)) );
+    return true;
+}
 
 /////////////////////// PngEncoder ///////////////////
 
@@ -345,6 +638,7 @@ bool  PngEncoder::write( const Mat& img, const std::vector<int>& params )
     int depth = img.depth(), channels = img.channels();
     volatile bool result = false;
     AutoBuffer<uchar*> buffer;
+    std::vector<std::vector<uchar> > chunks; // compressed in parallel, outside of setjmp scope
 
     if( depth != CV_8U && depth != CV_16U )
         return false;
@@ -372,6 +666,7 @@ bool  PngEncoder::write( const Mat& img, const std::vector<int>& params )
                 int compression_level = -1; // Invalid value to allow setting 0-9 as valid
                 int compression_strategy = IMWRITE_PNG_STRATEGY_RLE; // Default strategy
                 bool isBilevel = false;
+                int threads = 1;
 
                 for( size_t i = 0; i < params.size(); i += 2 )
                 {
@@ -390,6 +685,10 @@ bool  PngEncoder::write( const Mat& img, const std::vector<int>& params )
                     {
                         isBilevel = params[i+1] != 0;
                     }
+                    if( params[i] == IMWRITE_THREADS )
+                    {
+                        threads = params[i+1] > 0 ? params[i+1] : getNumThreads();
+                    }
                 }
 
                 if( m_buf || f )
@@ -418,16 +717,30 @@ bool  PngEncoder::write( const Mat& img, const std::vector<int>& params )
                     if (isBilevel)
                         png_set_packing(png_ptr);
 
-                    png_set_bgr( png_ptr );
-                    if( !isBigEndian() )
-                        png_set_swap( png_ptr );
+                    if( threads > 1 && !isBilevel && channels != 2 &&
+                        pngCompressParallel( img, compression_level >= 0 ? compression_level : Z_BEST_SPEED,
+                                             compression_strategy, compression_level >= 0, threads, chunks ) )
+                    {
+                        static png_byte idat_name[5] = { 'I', 'D', 'A', 'T', '\0' };
+                        static png_byte iend_name[5] = { 'I', 'E', 'N', 'D', '\0' };
 
-                    buffer.allocate(height);
-                    for( y = 0; y < height; y++ )
-                        buffer[y] = img.data + y*img.step;
+                        for( size_t i = 0; i < chunks.size(); i++ )
+                            png_write_chunk( png_ptr, idat_name, &chunks[i][0], chunks[i].size() );
+                        png_write_chunk( png_ptr, iend_name, NULL, 0 );
+                    }
+                    else
+                    {
+                        png_set_bgr( png_ptr );
+                        if( !isBigEndian() )
+                            png_set_swap( png_ptr );
+
+                        buffer.allocate(height);
+                        for( y = 0; y < height; y++ )
+                            buffer[y] = img.data + y*img.step;
 
-                    png_write_image( png_ptr, buffer.data() );
-                    png_write_end( png_ptr, info_ptr );
+                        png_write_image( png_ptr, buffer.data() );
+                        png_write_end( png_ptr, info_ptr );
+                    }
 
                     result = true;
                 }
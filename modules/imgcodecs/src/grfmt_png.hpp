@@ -62,11 +62,15 @@ public:
     bool  readHeader() CV_OVERRIDE;
     void  close();
 
+    bool  startRows( int type ) CV_OVERRIDE;
+    int   readRows( Mat& rows ) CV_OVERRIDE;
+    bool  isReusable() const CV_OVERRIDE { return true; }
     ImageDecoder newDecoder() const CV_OVERRIDE;
 
 protected:
 
     static void readDataFromBuf(void* png_ptr, uchar* dst, size_t size);
+    void  setTransforms( int type ); // sets up the conversion of the decoded rows to type
 
     int   m_bit_depth;
     void* m_png_ptr;  // pointer to decompression structure
@@ -207,18 +207,35 @@ bool PxMDecoder::readHeader()
 
 
 bool PxMDecoder::readData( Mat& img )
+{
+    return startRows( img.type() ) && readRows( img ) == m_height;
+}
+
+bool PxMDecoder::startRows( int )
+{
+    m_rows.release();
+    m_row = 0;
+    if( m_offset < 0 || !m_strm.isOpened() )
+        return false;
+
+    m_strm.setPos( m_offset );
+    return true;
+}
+
+int PxMDecoder::readRows( Mat& img )
 {
     bool color = img.channels() > 1;
     uchar* data = img.ptr();
     PaletteEntry palette[256];
-    bool   result = false;
+    int    result = 0;
     const int bit_depth = CV_ELEM_SIZE1(m_type)*8;
     const int src_pitch = divUp(m_width*m_bpp*(bit_depth/8), 8);
     int  nch = CV_MAT_CN(m_type);
     int  width3 = m_width*nch;
+    const int count = std::min( img.rows, m_height - m_row );
 
-    if( m_offset < 0 || !m_strm.isOpened())
-        return false;
+    if( m_offset < 0 || !m_strm.isOpened() || count <= 0 )
+        return 0;
 
     uchar gray_palette[256] = {0};
 
@@ -235,8 +252,6 @@ bool PxMDecoder::readData( Mat& img )
 
     CV_TRY
     {
-        m_strm.setPos( m_offset );
-
         switch( m_bpp )
         {
         ////////////////////////// 1 BPP /////////////////////////
@@ -247,7 +262,7 @@ bool PxMDecoder::readData( Mat& img )
                 AutoBuffer<uchar> _src(m_width);
                 uchar* src = _src.data();
 
-                for (int y = 0; y < m_height; y++, data += img.step)
+                for (int y = 0; y < count; y++, data += img.step)
                 {
                     for (int x = 0; x < m_width; x++)
                         src[x] = ReadNumber(m_strm, 1) != 0;
@@ -263,7 +278,7 @@ bool PxMDecoder::readData( Mat& img )
                 AutoBuffer<uchar> _src(src_pitch);
                 uchar* src = _src.data();
 
-                for (int y = 0; y < m_height; y++, data += img.step)
+                for (int y = 0; y < count; y++, data += img.step)
                 {
                     m_strm.getBytes( src, src_pitch );
 
@@ -273,7 +288,7 @@ bool PxMDecoder::readData( Mat& img )
                         FillGrayRow1( data, src, m_width, gray_palette );
                 }
             }
-            result = true;
+            result = count;
             break;
 
         ////////////////////////// 8 BPP /////////////////////////
@@ -283,7 +298,7 @@ bool PxMDecoder::readData( Mat& img )
             AutoBuffer<uchar> _src(std::max<size_t>(width3*2, src_pitch));
             uchar* src = _src.data();
 
-            for (int y = 0; y < m_height; y++, data += img.step)
+            for (int y = 0; y < count; y++, data += img.step)
             {
                 if( !m_binary )
                 {
@@ -301,14 +316,7 @@ bool PxMDecoder::readData( Mat& img )
                 {
                     m_strm.getBytes( src, src_pitch );
                     if( bit_depth == 16 && !isBigEndian() )
-                    {
-                        for (int x = 0; x < width3; x++)
-                        {
-                            uchar v = src[x * 2];
-                            src[x * 2] = src[x * 2 + 1];
-                            src[x * 2 + 1] = v;
-                        }
-                    }
+                        icvCvt_SwapBytes_16u_C1R( (ushort *)src, 0, (ushort *)src, 0, cvSize(width3,1) );
                 }
 
                 if( img.depth() == CV_8U && bit_depth == 16 )
@@ -324,15 +332,10 @@ bool PxMDecoder::readData( Mat& img )
                 {
                     if( color )
                     {
-                        if( img.depth() == CV_8U ) {
-                            uchar *d = data, *s = src, *end = src + m_width;
-                            for( ; s < end; d += 3, s++)
-                                d[0] = d[1] = d[2] = *s;
-                        } else {
-                            ushort *d = (ushort *)data, *s = (ushort *)src, *end = ((ushort *)src) + m_width;
-                            for( ; s < end; s++, d += 3)
-                                d[0] = d[1] = d[2] = *s;
-                        }
+                        if( img.depth() == CV_8U )
+                            icvCvt_Gray2BGR_8u_C1C3R( src, 0, data, 0, cvSize(m_width,1) );
+                        else
+                            icvCvt_Gray2BGR_16u_C1C3R( (ushort *)src, 0, (ushort *)data, 0, cvSize(m_width,1) );
                     }
                     else
                         memcpy(data, src, img.elemSize1()*m_width);
@@ -352,7 +355,7 @@ bool PxMDecoder::readData( Mat& img )
                         icvCvt_BGRA2Gray_16u_CnC1R( (ushort *)src, 0, (ushort *)data, 0, cvSize(m_width,1), 3, 2 );
                 }
             }
-            result = true;
+            result = count;
             break;
         }
         default:
@@ -366,10 +369,11 @@ bool PxMDecoder::readData( Mat& img )
     }
     CV_CATCH_ALL
     {
-        std::cerr << "PXM::readData(): unknown exception" << std::endl << std::flush;
+        std::cerr << "PXM::readRows(): unknown exception" << std::endl << std::flush;
         CV_RETHROW();
     }
 
+    m_row += result;
     return result;
 }
 
@@ -530,16 +534,8 @@ bool PxMEncoder::write(const Mat& img, const std::vector<int>& params)
 
             // swap endianness if necessary
             if( depth == 16 && !isBigEndian() )
-            {
-                if( _channels == 1 )
-                    memcpy( buffer, data, fileStep );
-                for( x = 0; x < width*channels*2; x += 2 )
-                {
-                    uchar v = buffer[x];
-                    buffer[x] = buffer[x + 1];
-                    buffer[x + 1] = v;
-                }
-            }
+                icvCvt_SwapBytes_16u_C1R( _channels == 1 ? (const ushort*)data : (const ushort*)buffer, 0,
+                                          (ushort*)buffer, 0, cvSize(width*channels,1) );
 
             strm.putBytes( (channels > 1 || depth > 8) ? buffer : (const char*)data, fileStep);
         }
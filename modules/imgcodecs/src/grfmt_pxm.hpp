@@ -70,6 +70,9 @@ public:
     bool  readHeader() CV_OVERRIDE;
     void  close();
 
+    bool  startRows( int type ) CV_OVERRIDE;
+    int   readRows( Mat& img ) CV_OVERRIDE;
+
     size_t signatureLength() const CV_OVERRIDE;
     bool checkSignature( const String& signature ) const CV_OVERRIDE;
     ImageDecoder newDecoder() const CV_OVERRIDE;
@@ -0,0 +1,642 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#include "precomp.hpp"
+#include "utils.hpp"
+#include "grfmt_qli.hpp"
+
+#ifdef HAVE_IMGCODEC_QLI
+
+namespace cv
+{
+
+static const char qliSignature[] = "qlif";
+static const int qliHeaderSize = 20;
+
+enum
+{
+    QLI_OP_INDEX = 0x00,
+    QLI_OP_DIFF  = 0x40,
+    QLI_OP_LUMA  = 0x80,
+    QLI_OP_RUN   = 0xc0,
+    QLI_OP_COLOR = 0xfe,
+    QLI_OP_FULL  = 0xff,
+    QLI_MAX_RUN  = 62
+};
+
+// Groups of roughly this many samples are coded independently
+static const int qliGroupSamples = 1 << 18;
+
+template<typename T> struct QliSigned;
+template<> struct QliSigned<uchar> { typedef schar type; };
+template<> struct QliSigned<ushort> { typedef short type; };
+
+template<int cn> static inline int qliHash( const int* p )
+{
+    static const int k[] = { 3, 5, 7, 11 };
+    int h = 0;
+    for( int c = 0; c < cn; c++ )
+        h += p[c]*k[c];
+    return h & 63;
+}
+
+template<typename T> static inline uchar* qliPutSample( uchar* d, int v )
+{
+    if( sizeof(T) == 2 )
+        *d++ = (uchar)(v >> 8);
+    *d++ = (uchar)v;
+    return d;
+}
+
+template<typename T> static inline int qliGetSample( const uchar*& s )
+{
+    int v = *s++;
+    if( sizeof(T) == 2 )
+        v = (v << 8) | *s++;
+    return v;
+}
+
+// The differences d of the channels to the previous pixel, wrapped to the sample type,
+// are packed as follows (the payload of QLI_OP_LUMA has n = 14 bits in 2 bytes for 8-bit
+// samples and 1-channel images, n = 22 bits in 3 bytes otherwise):
+//   channels | QLI_OP_DIFF              | QLI_OP_LUMA
+//   1        | d0 + 32                  | d0 in n bits
+//   2        | d0 + 4, d1 + 4 in 3 bits | d0, d1 in n/2 bits
+//   3, 4     | d0..d2 + 2 in 2 bits     | d1 in n - 2*m bits, d0 - d1, d2 - d1 in m bits,
+//            |                          | m = 4 for 8-bit and 5 for 16-bit samples
+// The LUMA fields are stored with the bias of a half of their range.
+// For 4-channel pixels both require the last channel unchanged.
+template<typename T, int cn> struct QliLuma
+{
+    enum
+    {
+        bits = sizeof(T) == 1 || cn == 1 ? 14 : 22,   // payload bits
+        rbits = sizeof(T) == 1 ? 4 : 5,    // bits of d0 - d1 and d2 - d1
+        gbits = bits - 2*rbits             // bits of d1
+    };
+};
+
+static inline bool qliFits( int d, int bits )
+{
+    return (unsigned)(d + (1 << (bits - 1))) < (1u << bits);
+}
+
+template<typename T, int cn> static inline uchar* qliPutLuma( uchar* d, int v )
+{
+    *d++ = (uchar)(QLI_OP_LUMA | (v >> (QliLuma<T, cn>::bits - 6)));
+    if( QliLuma<T, cn>::bits > 14 )
+        *d++ = (uchar)(v >> 8);
+    *d++ = (uchar)v;
+    return d;
+}
+
+template<typename T, int cn> static uchar* qliPutPixel( uchar* d, const int* p, const int* prev )
+{
+    typedef typename QliSigned<T>::type ST;
+    typedef QliLuma<T, cn> L;
+    int dv[4] = { 0, 0, 0, 0 };
+    for( int c = 0; c < cn; c++ )
+        dv[c] = (ST)(p[c] - prev[c]);
+
+    if( cn == 1 )
+    {
+        if( qliFits( dv[0], 6 ) )
+        {
+            *d++ = (uchar)(QLI_OP_DIFF | (dv[0] + 32));
+            return d;
+        }
+        if( qliFits( dv[0], L::bits ) )
+            return qliPutLuma<T, cn>( d, dv[0] + (1 << (L::bits - 1)) );
+    }
+    else if( cn == 2 )
+    {
+        if( qliFits( dv[0], 3 ) && qliFits( dv[1], 3 ) )
+        {
+            *d++ = (uchar)(QLI_OP_DIFF | ((dv[0] + 4) << 3) | (dv[1] + 4));
+            return d;
+        }
+        const int h = L::bits/2;
+        if( qliFits( dv[0], h ) && qliFits( dv[1], h ) )
+            return qliPutLuma<T, cn>( d, ((dv[0] + (1 << (h - 1))) << h) | (dv[1] + (1 << (h - 1))) );
+    }
+    else if( dv[3] == 0 )
+    {
+        if( qliFits( dv[0], 2 ) && qliFits( dv[1], 2 ) && qliFits( dv[2], 2 ) )
+        {
+            *d++ = (uchar)(QLI_OP_DIFF | ((dv[0] + 2) << 4) | ((dv[1] + 2) << 2) | (dv[2] + 2));
+            return d;
+        }
+        int d0 = dv[0] - dv[1], d2 = dv[2] - dv[1];
+        if( qliFits( dv[1], L::gbits ) && qliFits( d0, L::rbits ) && qliFits( d2, L::rbits ) )
+            return qliPutLuma<T, cn>( d, ((dv[1] + (1 << (L::gbits - 1))) << (2*L::rbits)) |
+                                     ((d0 + (1 << (L::rbits - 1))) << L::rbits) |
+                                     (d2 + (1 << (L::rbits - 1))) );
+        if( cn == 4 )
+        {
+            *d++ = (uchar)QLI_OP_COLOR;
+            for( int c = 0; c < 3; c++ )
+                d = qliPutSample<T>( d, p[c] );
+            return d;
+        }
+    }
+
+    *d++ = (uchar)QLI_OP_FULL;
+    for( int c = 0; c < cn; c++ )
+        d = qliPutSample<T>( d, p[c] );
+    return d;
+}
+
+template<typename T, int cn>
+static void qliEncodeGroup( const Mat& img, int y0, int y1, std::vector<uchar>& out )
+{
+    const int width = img.cols;
+    out.resize( (size_t)(y1 - y0)*width*(1 + cn*sizeof(T)) );
+    uchar* d = out.empty() ? 0 : &out[0];
+
+    int prev[4] = { 0, 0, 0, 0 }, p[4] = { 0, 0, 0, 0 };
+    int index[64][4];
+    memset( index, 0, sizeof(index) );
+    int run = 0;
+
+    for( int y = y0; y < y1; y++ )
+    {
+        const T* row = img.ptr<T>(y);
+        const bool lastRow = y == y1 - 1;
+        for( int x = 0; x < width; x++, row += cn )
+        {
+            bool same = true;
+            for( int c = 0; c < cn; c++ )
+            {
+                p[c] = row[c];
+                same &= p[c] == prev[c];
+            }
+
+            if( same )
+            {
+                if( ++run == QLI_MAX_RUN || (lastRow && x == width - 1) )
+                {
+                    *d++ = (uchar)(QLI_OP_RUN | (run - 1));
+                    run = 0;
+                }
+                continue;
+            }
+
+            if( run > 0 )
+            {
+                *d++ = (uchar)(QLI_OP_RUN | (run - 1));
+                run = 0;
+            }
+
+            int h = qliHash<cn>( p );
+            int* entry = index[h];
+            bool found = true;
+            for( int c = 0; c < cn; c++ )
+                found &= entry[c] == p[c];
+
+            if( found )
+                *d++ = (uchar)(QLI_OP_INDEX | h);
+            else
+            {
+                for( int c = 0; c < cn; c++ )
+                    entry[c] = p[c];
+                d = qliPutPixel<T, cn>( d, p, prev );
+            }
+
+            for( int c = 0; c < cn; c++ )
+                prev[c] = p[c];
+        }
+    }
+
+    out.resize( d - (out.empty() ? d : &out[0]) );
+}
+
+// Decodes a group into the rows y0..y1 of img; returns false if the data is corrupted
+template<typename T, int cn>
+static bool qliDecodeGroup( const uchar* s, const uchar* end, Mat& img, int y0, int y1 )
+{
+    typedef QliLuma<T, cn> L;
+    const int width = img.cols;
+    int p[4] = { 0, 0, 0, 0 };
+    int index[64][4];
+    memset( index, 0, sizeof(index) );
+    int run = 0;
+
+    for( int y = y0; y < y1; y++ )
+    {
+        T* row = img.ptr<T>(y);
+        for( int x = 0; x < width; x++, row += cn )
+        {
+            if( run > 0 )
+                run--;
+            else
+            {
+                if( s >= end )
+                    return false;
+                int op = *s++;
+                if( op == QLI_OP_FULL || op == QLI_OP_COLOR )
+                {
+                    int n = op == QLI_OP_FULL ? cn : 3;
+                    if( (op == QLI_OP_COLOR && cn != 4) || end - s < (ptrdiff_t)(n*sizeof(T)) )
+                        return false;
+                    for( int c = 0; c < n; c++ )
+                        p[c] = qliGetSample<T>( s );
+                }
+                else if( op >= QLI_OP_RUN )
+                    run = op - QLI_OP_RUN;
+                else if( op < QLI_OP_DIFF )
+                {
+                    for( int c = 0; c < cn; c++ )
+                        p[c] = index[op][c];
+                }
+                else if( op < QLI_OP_LUMA )
+                {
+                    if( cn == 1 )
+                        p[0] = (T)(p[0] + (op & 63) - 32);
+                    else if( cn == 2 )
+                    {
+                        p[0] = (T)(p[0] + ((op >> 3) & 7) - 4);
+                        p[1] = (T)(p[1] + (op & 7) - 4);
+                    }
+                    else
+                    {
+                        p[0] = (T)(p[0] + ((op >> 4) & 3) - 2);
+                        p[1] = (T)(p[1] + ((op >> 2) & 3) - 2);
+                        p[2] = (T)(p[2] + (op & 3) - 2);
+                    }
+                }
+                else
+                {
+                    const int n = (L::bits - 6)/8;
+                    if( end - s < n )
+                        return false;
+                    int v = op & 63;
+                    for( int i = 0; i < n; i++ )
+                        v = (v << 8) | *s++;
+                    if( cn == 1 )
+                        p[0] = (T)(p[0] + v - (1 << (L::bits - 1)));
+                    else if( cn == 2 )
+                    {
+                        const int h = L::bits/2;
+                        p[0] = (T)(p[0] + (v >> h) - (1 << (h - 1)));
+                        p[1] = (T)(p[1] + (v & ((1 << h) - 1)) - (1 << (h - 1)));
+                    }
+                    else
+                    {
+                        const int rmask = (1 << L::rbits) - 1, rbias = 1 << (L::rbits - 1);
+                        int dg = (v >> (2*L::rbits)) - (1 << (L::gbits - 1));
+                        p[0] = (T)(p[0] + dg + ((v >> L::rbits) & rmask) - rbias);
+                        p[1] = (T)(p[1] + dg);
+                        p[2] = (T)(p[2] + dg + (v & rmask) - rbias);
+                    }
+                }
+
+                int* entry = index[qliHash<cn>( p )];
+                for( int c = 0; c < cn; c++ )
+                    entry[c] = p[c];
+            }
+
+            for( int c = 0; c < cn; c++ )
+                row[c] = (T)p[c];
+        }
+    }
+    return run == 0;
+}
+
+typedef void (*QliEncodeFunc)( const Mat& img, int y0, int y1, std::vector<uchar>& out );
+typedef bool (*QliDecodeFunc)( const uchar* s, const uchar* end, Mat& img, int y0, int y1 );
+
+static QliEncodeFunc getEncodeFunc( int type )
+{
+    static const QliEncodeFunc funcs[2][4] =
+    {
+        { qliEncodeGroup<uchar, 1>, qliEncodeGroup<uchar, 2>, qliEncodeGroup<uchar, 3>, qliEncodeGroup<uchar, 4> },
+        { qliEncodeGroup<ushort, 1>, qliEncodeGroup<ushort, 2>, qliEncodeGroup<ushort, 3>, qliEncodeGroup<ushort, 4> }
+    };
+    return funcs[CV_MAT_DEPTH(type) == CV_16U][CV_MAT_CN(type) - 1];
+}
+
+static QliDecodeFunc getDecodeFunc( int type )
+{
+    static const QliDecodeFunc funcs[2][4] =
+    {
+        { qliDecodeGroup<uchar, 1>, qliDecodeGroup<uchar, 2>, qliDecodeGroup<uchar, 3>, qliDecodeGroup<uchar, 4> },
+        { qliDecodeGroup<ushort, 1>, qliDecodeGroup<ushort, 2>, qliDecodeGroup<ushort, 3>, qliDecodeGroup<ushort, 4> }
+    };
+    return funcs[CV_MAT_DEPTH(type) == CV_16U][CV_MAT_CN(type) - 1];
+}
+
+class QliEncodeInvoker CV_FINAL : public ParallelLoopBody
+{
+public:
+    QliEncodeInvoker( const Mat& img, int rowsPerGroup, std::vector<std::vector<uchar> >& groups )
+        : img_(img), rowsPerGroup_(rowsPerGroup), groups_(groups), func_(getEncodeFunc(img.type())) {}
+
+    void operator()( const Range& range ) const CV_OVERRIDE
+    {
+        for( int g = range.start; g < range.end; g++ )
+        {
+            int y0 = g*rowsPerGroup_;
+            func_( img_, y0, std::min(y0 + rowsPerGroup_, img_.rows), groups_[g] );
+        }
+    }
+
+private:
+    const Mat& img_;
+    int rowsPerGroup_;
+    std::vector<std::vector<uchar> >& groups_;
+    QliEncodeFunc func_;
+};
+
+class QliDecodeInvoker CV_FINAL : public ParallelLoopBody
+{
+public:
+    QliDecodeInvoker( const uchar* data, const std::vector<size_t>& offsets, Mat& img, int rowsPerGroup,
+                      std::vector<uchar>& groupOk )
+        : data_(data), offsets_(offsets), img_(img), rowsPerGroup_(rowsPerGroup), groupOk_(groupOk),
+          func_(getDecodeFunc(img.type())) {}
+
+    void operator()( const Range& range ) const CV_OVERRIDE
+    {
+        for( int g = range.start; g < range.end; g++ )
+        {
+            int y0 = g*rowsPerGroup_;
+            groupOk_[g] = func_( data_ + offsets_[g], data_ + offsets_[g + 1], img_, y0,
+                                 std::min(y0 + rowsPerGroup_, img_.rows) );
+        }
+    }
+
+private:
+    const uchar* data_;
+    const std::vector<size_t>& offsets_;
+    Mat& img_;
+    int rowsPerGroup_;
+    std::vector<uchar>& groupOk_;   // written by the thread decoding the group only
+    QliDecodeFunc func_;
+};
+
+/////////////////////// QliDecoder ///////////////////
+
+QliDecoder::QliDecoder()
+{
+    m_signature = qliSignature;
+    m_buf_supported = true;
+    m_rows_per_group = 0;
+}
+
+
+QliDecoder::~QliDecoder()
+{
+    close();
+}
+
+
+void QliDecoder::close()
+{
+    m_strm.close();
+}
+
+
+size_t QliDecoder::signatureLength() const
+{
+    return 4;
+}
+
+
+bool QliDecoder::checkSignature( const String& signature ) const
+{
+    return signature.size() >= 4 && memcmp( signature.c_str(), qliSignature, 4 ) == 0;
+}
+
+
+bool QliDecoder::readHeader()
+{
+    bool result = false;
+
+    if( !m_buf.empty() )
+    {
+        if( !m_strm.open( m_buf ) )
+            return false;
+    }
+    else if( !m_strm.open( m_filename ) )
+        return false;
+
+    CV_TRY
+    {
+        char signature[4];
+        m_strm.getBytes( signature, 4 );
+        m_width = m_strm.getDWord();
+        m_height = m_strm.getDWord();
+        int channels = m_strm.getByte();
+        int bits = m_strm.getByte();
+        m_strm.skip( 2 );
+        m_rows_per_group = m_strm.getDWord();
+
+        if( checkSignature( String(signature, 4) ) && m_width > 0 && m_height > 0 &&
+            1 <= channels && channels <= 4 && (bits == 8 || bits == 16) && m_rows_per_group > 0 )
+        {
+            m_type = CV_MAKETYPE( bits == 8 ? CV_8U : CV_16U, channels );
+            // a single group for the larger values, the group count computation can't overflow
+            m_rows_per_group = std::min( m_rows_per_group, m_height );
+            result = true;
+        }
+    }
+    CV_CATCH_ALL
+    {
+    }
+
+    if( !result )
+    {
+        m_width = m_height = -1;
+        close();
+    }
+    return result;
+}
+
+
+static size_t fileSize( const String& filename )
+{
+    FILE* f = fopen( filename.c_str(), "rb" );
+    if( !f )
+        return 0;
+    fseek( f, 0, SEEK_END );
+    long size = ftell( f );
+    fclose( f );
+    return size > 0 ? (size_t)size : 0;
+}
+
+
+bool QliDecoder::decode( Mat& img )
+{
+    const int ngroups = (m_height + m_rows_per_group - 1) / m_rows_per_group;
+    std::vector<size_t> offsets( ngroups + 1, 0 );
+    for( int g = 0; g < ngroups; g++ )
+    {
+        offsets[g + 1] = offsets[g] + (unsigned)m_strm.getDWord();
+        if( offsets[g + 1] < offsets[g] )
+            return false;
+    }
+
+    const uchar* data;
+    std::vector<uchar> payload;
+    if( !m_buf.empty() )
+    {
+        size_t pos = m_strm.getPos();
+        if( m_buf.total()*m_buf.elemSize() < pos + offsets[ngroups] )
+            return false;
+        data = m_buf.ptr() + pos;
+    }
+    else
+    {
+        // the sizes of the header are checked before allocating the payload
+        if( fileSize( m_filename ) < (size_t)m_strm.getPos() + offsets[ngroups] )
+            return false;
+        payload.resize( offsets[ngroups] );
+        for( size_t pos = 0; pos < payload.size(); )
+        {
+            int count = (int)std::min( payload.size() - pos, (size_t)INT_MAX );
+            if( m_strm.getBytes( &payload[pos], count ) != count )
+                return false;
+            pos += count;
+        }
+        data = payload.empty() ? 0 : &payload[0];
+    }
+
+    std::vector<uchar> groupOk( ngroups, 0 );
+    parallel_for_( Range(0, ngroups), QliDecodeInvoker( data, offsets, img, m_rows_per_group, groupOk ) );
+    return std::find( groupOk.begin(), groupOk.end(), 0 ) == groupOk.end();
+}
+
+
+bool QliDecoder::readData( Mat& img )
+{
+    bool result = false;
+    CV_Assert( m_strm.isOpened() );
+
+    CV_TRY
+    {
+        if( img.type() == m_type )
+            result = decode( img );
+        else
+        {
+            Mat native( m_height, m_width, m_type );
+            result = decode( native );
+            if( result )
+            {
+                // the 2-channel images are gray with alpha
+                if( native.channels() == 2 )
+                    extractChannel( native, native, 0 );
+                if( native.depth() != img.depth() )
+                    native.convertTo( native, img.depth(), img.depth() == CV_8U ? 1./256 : 256 );
+
+                static const int codes[5][5] =
+                {
+                    { -1, -1, -1, -1, -1 },
+                    { -1, -1, -1, COLOR_GRAY2BGR, COLOR_GRAY2BGRA },
+                    { -1, -1, -1, -1, -1 },
+                    { -1, COLOR_BGR2GRAY, -1, -1, COLOR_BGR2BGRA },
+                    { -1, COLOR_BGRA2GRAY, -1, COLOR_BGRA2BGR, -1 }
+                };
+                int code = codes[native.channels()][img.channels()];
+                if( code >= 0 )
+                    cvtColor( native, img, code );
+                else
+                    native.copyTo( img );
+            }
+        }
+    }
+    CV_CATCH_ALL
+    {
+        result = false;
+    }
+
+    close();
+    return result;
+}
+
+
+//////////////////////// QliEncoder ///////////////////
+
+QliEncoder::QliEncoder()
+{
+    m_description = "QLI - quick lossless image (*.qli)";
+    m_buf_supported = true;
+}
+
+
+QliEncoder::~QliEncoder()
+{
+}
+
+
+bool QliEncoder::isFormatSupported( int depth ) const
+{
+    return depth == CV_8U || depth == CV_16U;
+}
+
+
+static void putDWordBE( std::vector<uchar>& buf, unsigned v )
+{
+    buf.push_back( (uchar)(v >> 24) );
+    buf.push_back( (uchar)(v >> 16) );
+    buf.push_back( (uchar)(v >> 8) );
+    buf.push_back( (uchar)v );
+}
+
+
+bool QliEncoder::write( const Mat& img, const std::vector<int>& params )
+{
+    const int width = img.cols, height = img.rows, channels = img.channels();
+    CV_Assert( isFormatSupported( img.depth() ) && 1 <= channels && channels <= 4 );
+
+    int threads = 0;
+    for( size_t i = 0; i + 1 < params.size(); i += 2 )
+        if( params[i] == IMWRITE_THREADS )
+            threads = params[i+1];
+    if( threads <= 0 )
+        threads = getNumThreads();
+
+    // the grouping only depends on the image, so the output does not depend on the threads
+    const int rowsPerGroup = std::max( qliGroupSamples / (width*channels), 1 );
+    const int ngroups = (height + rowsPerGroup - 1) / rowsPerGroup;
+    std::vector<std::vector<uchar> > groups( ngroups );
+    parallel_for_( Range(0, ngroups), QliEncodeInvoker( img, rowsPerGroup, groups ), threads );
+
+    std::vector<uchar> header;
+    header.insert( header.end(), qliSignature, qliSignature + 4 );
+    putDWordBE( header, width );
+    putDWordBE( header, height );
+    header.push_back( (uchar)channels );
+    header.push_back( (uchar)(img.depth() == CV_8U ? 8 : 16) );
+    header.push_back( 0 );
+    header.push_back( 0 );
+    putDWordBE( header, rowsPerGroup );
+    CV_Assert( header.size() == (size_t)qliHeaderSize );
+    size_t total = header.size();
+    for( int g = 0; g < ngroups; g++ )
+    {
+        putDWordBE( header, (unsigned)groups[g].size() );
+        total += 4 + groups[g].size();
+    }
+
+    WLByteStream strm;
+    if( m_buf )
+    {
+        if( !strm.open( *m_buf ) )
+            return false;
+        m_buf->reserve( total );
+    }
+    else if( !strm.open( m_filename ) )
+        return false;
+
+    strm.putBytes( &header[0], (int)header.size() );
+    for( int g = 0; g < ngroups; g++ )
+        if( !groups[g].empty() )
+            strm.putBytes( &groups[g][0], (int)groups[g].size() );
+    strm.close();
+    return true;
+}
+
+}
+
+#endif // HAVE_IMGCODEC_QLI
@@ -0,0 +1,80 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#ifndef _GRFMT_QLI_H_
+#define _GRFMT_QLI_H_
+
+#include "grfmt_base.hpp"
+#include "bitstrm.hpp"
+
+#ifdef HAVE_IMGCODEC_QLI
+namespace cv
+{
+
+// QLI (quick lossless image) is a simple lossless format in the spirit of QOI, made for
+// images which are written and read again soon, e.g. between the stages of a pipeline.
+// The rows are split into groups which are coded independently of each other, so both
+// the encoder and the decoder process the groups in parallel.
+//
+// The file starts with a big-endian header:
+//   "qlif", uint32 width, uint32 height, uint8 channels (1..4), uint8 bits per sample
+//   (8 or 16), uint16 reserved (0), uint32 rows per group,
+//   uint32 byte size of every group (ceil(height / rows per group) values).
+// Then the groups follow each other. A group is a sequence of pixel operations, like in QOI:
+//   00iiiiii            - the pixel at index i of the table of the 64 recently seen pixels
+//   01dddddd            - small differences of the color channels to the previous pixel
+//   10dddddd d...       - larger differences of the color channels to the previous pixel,
+//                         with 1 more byte for 8-bit samples and 1-channel images and
+//                         2 more bytes otherwise
+//   11rrrrrr            - the previous pixel repeated r + 1 times (r < 62)
+//   11111110 s s s      - the color channels of a 4-channel pixel, the last channel unchanged
+//   11111111 s ...      - all the channels of the pixel
+// The samples s are stored big-endian. The previous pixel and the table start zeroed in
+// every group. See grfmt_qli.cpp for the exact packing of the differences.
+class QliDecoder CV_FINAL : public BaseImageDecoder
+{
+public:
+    QliDecoder();
+    virtual ~QliDecoder() CV_OVERRIDE;
+
+    bool  readData( Mat& img ) CV_OVERRIDE;
+    bool  readHeader() CV_OVERRIDE;
+    void  close();
+
+    bool isReusable() const CV_OVERRIDE { return true; }
+
+    size_t signatureLength() const CV_OVERRIDE;
+    bool checkSignature( const String& signature ) const CV_OVERRIDE;
+    ImageDecoder newDecoder() const CV_OVERRIDE
+    {
+        return makePtr<QliDecoder>();
+    }
+
+private:
+    bool  decode( Mat& img );
+
+    RMByteStream m_strm;
+    int m_rows_per_group;
+};
+
+class QliEncoder CV_FINAL : public BaseImageEncoder
+{
+public:
+    QliEncoder();
+    virtual ~QliEncoder() CV_OVERRIDE;
+
+    bool  isFormatSupported( int depth ) const CV_OVERRIDE;
+    bool  write( const Mat& img, const std::vector<int>& params ) CV_OVERRIDE;
+
+    ImageEncoder newEncoder() const CV_OVERRIDE
+    {
+        return makePtr<QliEncoder>();
+    }
+};
+
+}
+
+#endif // HAVE_IMGCODEC_QLI
+
+#endif/*_GRFMT_QLI_H_*/
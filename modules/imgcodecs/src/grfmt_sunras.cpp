@@ -60,6 +60,7 @@ SunRasterDecoder::SunRasterDecoder()
     m_encoding = RAS_STANDARD;
     m_maptype = RMT_NONE;
     m_maplength = 0;
+    m_buf_supported = true;
 }
 
 
@@ -82,7 +83,13 @@ bool  SunRasterDecoder::readHeader()
 {
     bool result = false;
 
-    if( !m_strm.open( m_filename )) return false;
+    if( !m_buf.empty() )
+    {
+        if( !m_strm.open( m_buf ) )
+            return false;
+    }
+    else if( !m_strm.open( m_filename ))
+        return false;
 
     CV_TRY
     {
@@ -81,6 +81,8 @@ TiffDecoder::TiffDecoder()
     m_hdr = false;
     m_buf_supported = true;
     m_buf_pos = 0;
+    m_strip_rows = 0;
+    m_strip_y = 0;
 }
 
 
@@ -200,6 +202,7 @@ public:
 bool TiffDecoder::readHeader()
 {
     bool result = false;
+    m_roi = Rect();
 
     TIFF* tif = static_cast<TIFF*>(m_tif);
     if (!m_tif)
@@ -279,6 +282,92 @@ bool TiffDecoder::readHeader()
     return result;
 }
 
+bool TiffDecoder::setROI( const Rect& roi )
+{
+    TIFF* tif = (TIFF*)m_tif;
+    if( !tif || (roi & Rect(0, 0, m_width, m_height)) != roi || roi.empty() )
+        return false;
+
+    // Bottom-up images are not supported, rows of the strips are placed into the image directly
+    uint16 img_orientation = ORIENTATION_TOPLEFT;
+    TIFFGetField( tif, TIFFTAG_ORIENTATION, &img_orientation );
+    if( img_orientation != ORIENTATION_TOPLEFT && img_orientation != ORIENTATION_TOPRIGHT &&
+        img_orientation != ORIENTATION_LEFTTOP && img_orientation != ORIENTATION_RIGHTTOP )
+        return false;
+
+    m_roi = roi;
+    return true;
+}
+
+bool TiffDecoder::startRows( int type )
+{
+    m_rows.release();
+    m_strip.release();
+    m_row = 0;
+    m_strip_y = 0;
+    // the floating-point images are read at once, as well as the bottom-up images
+    // which can't be read by regions
+    if( type == CV_32FC1 || (m_hdr && type == CV_32FC3) || !setROI( Rect(0, 0, m_width, m_height) ) )
+        return BaseImageDecoder::startRows( type );
+
+    TIFF* tif = (TIFF*)m_tif;
+    uint32 strip_rows = 0;
+    if( TIFFIsTiled(tif) )
+        TIFFGetField( tif, TIFFTAG_TILELENGTH, &strip_rows );
+    else
+        TIFFGetField( tif, TIFFTAG_ROWSPERSTRIP, &strip_rows );
+    m_strip_rows = strip_rows == 0 || strip_rows > (uint32)m_height ? m_height : (int)strip_rows;
+    return true;
+}
+
+int TiffDecoder::readRows( Mat& rows )
+{
+    if( !m_rows.empty() )
+        return BaseImageDecoder::readRows( rows );
+
+    // The whole strips (or rows of tiles) of the band are decoded into it directly. The strip
+    // crossing the end of the band is decoded into m_strip, and the next bands take their first
+    // rows from there, so every strip is decoded once whatever the band height is.
+    const int count = std::min( rows.rows, m_height - m_row );
+    int done = 0;
+    while( done < count )
+    {
+        if( m_row >= m_strip_y && m_row < m_strip_y + m_strip.rows )
+        {
+            const int n = std::min( count - done, m_strip_y + m_strip.rows - m_row );
+            m_strip.rowRange( m_row - m_strip_y, m_row - m_strip_y + n ).copyTo( rows.rowRange( done, done + n ) );
+            done += n;
+            m_row += n;
+            continue;
+        }
+
+        // m_row is at a strip boundary here, the last strip may be shorter
+        int n = m_row + count - done == m_height ? count - done : (count - done) / m_strip_rows * m_strip_rows;
+        Mat dst;
+        if( n > 0 )
+            dst = rows.rowRange( done, done + n );
+        else
+        {
+            n = std::min( m_strip_rows, m_height - m_row );
+            m_strip.create( n, m_width, rows.type() );
+            m_strip_y = m_row;
+            dst = m_strip;
+        }
+        if( !setROI( Rect(0, m_row, m_width, n) ) || !readData( dst ) )
+        {
+            m_strip.release();
+            m_row = m_height;
+            return 0;
+        }
+        if( dst.data != m_strip.data )
+        {
+            done += n;
+            m_row += n;
+        }
+    }
+    return count;
+}
+
 bool TiffDecoder::nextPage()
 {
     // Prepare the next page, if any.
@@ -358,24 +447,35 @@ bool  TiffDecoder::readData( Mat& img )
             ushort* buffer16 = (ushort*)buffer;
             float* buffer32 = (float*)buffer;
             double* buffer64 = (double*)buffer;
-            int tileidx = 0;
 
-            for( y = 0; y < m_height; y += tile_height0 )
+            // Only the strips/tiles intersecting the region are read, and only the rows
+            // and columns of the region are converted into the image.
+            const Rect roi = m_roi.empty() ? Rect(0, 0, m_width, m_height) : m_roi;
+            const int tiles_per_row = (m_width + tile_width0 - 1) / tile_width0;
+
+            for( y = roi.y - roi.y % tile_height0; y < roi.y + roi.height; y += tile_height0 )
             {
                 int tile_height = tile_height0;
 
                 if( y + tile_height > m_height )
                     tile_height = m_height - y;
 
-                uchar* data = img.ptr(vert_flip ? m_height - y - tile_height : y);
+                // image row of the first tile row
+                const int dst_y = vert_flip ? m_height - y - tile_height : y - roi.y;
 
-                for( x = 0; x < m_width; x += tile_width0, tileidx++ )
+                for( x = roi.x - roi.x % tile_width0; x < roi.x + roi.width; x += tile_width0 )
                 {
                     int tile_width = tile_width0, ok;
+                    const int tileidx = (y / tile_height0) * tiles_per_row + x / tile_width0;
 
                     if( x + tile_width > m_width )
                         tile_width = m_width - x;
 
+                    // part of the tile inside the region
+                    const Rect r = Rect(x, y, tile_width, tile_height) & roi;
+                    const int sx = r.x - x, dx = r.x - roi.x;
+                    const int i0 = r.y - y, i1 = r.y + r.height - y;
+
                     switch(dst_bpp)
                     {
                         case 8:
@@ -396,25 +496,29 @@ bool  TiffDecoder::readData( Mat& img )
                             }
 
                             for( i = 0; i < tile_height; i++ )
+                            {
+                                const int ti = tile_height - i - 1; // the buffer rows are bottom-up
+                                if( ti < i0 || ti >= i1 )
+                                    continue;
+                                const uchar* src = bstart + (i*tile_width0 + sx)*4;
+                                uchar* dst = img.ptr(dst_y + ti);
                                 if( color )
                                 {
                                     if (wanted_channels == 4)
                                     {
-                                        icvCvt_BGRA2RGBA_8u_C4R( bstart + i*tile_width0*4, 0,
-                                                             data + x*4 + img.step*(tile_height - i - 1), 0,
-                                                             cvSize(tile_width,1) );
+                                        icvCvt_BGRA2RGBA_8u_C4R( src, 0, dst + dx*4, 0,
+                                                             cvSize(r.width,1) );
                                     }
                                     else
                                     {
-                                        icvCvt_BGRA2BGR_8u_C4C3R( bstart + i*tile_width0*4, 0,
-                                                             data + x*3 + img.step*(tile_height - i - 1), 0,
-                                                             cvSize(tile_width,1), 2 );
+                                        icvCvt_BGRA2BGR_8u_C4C3R( src, 0, dst + dx*3, 0,
+                                                             cvSize(r.width,1), 2 );
                                     }
                                 }
                                 else
-                                    icvCvt_BGRA2Gray_8u_C4C1R( bstart + i*tile_width0*4, 0,
-                                                              data + x + img.step*(tile_height - i - 1), 0,
-                                                              cvSize(tile_width,1), 2 );
+                                    icvCvt_BGRA2Gray_8u_C4C1R( src, 0, dst + dx, 0,
+                                                              cvSize(r.width,1), 2 );
+                            }
                             break;
                         }
 
@@ -431,57 +535,51 @@ bool  TiffDecoder::readData( Mat& img )
                                 return false;
                             }
 
-                            for( i = 0; i < tile_height; i++ )
+                            for( i = i0; i < i1; i++ )
                             {
+                                const ushort* src = buffer16 + (i*tile_width0 + sx)*ncn;
+                                ushort* dst = img.ptr<ushort>(dst_y + i);
                                 if( color )
                                 {
                                     if( ncn == 1 )
                                     {
-                                        icvCvt_Gray2BGR_16u_C1C3R(buffer16 + i*tile_width0*ncn, 0,
-                                                                  (ushort*)(data + img.step*i) + x*3, 0,
-                                                                  cvSize(tile_width,1) );
+                                        icvCvt_Gray2BGR_16u_C1C3R(src, 0, dst + dx*3, 0,
+                                                                  cvSize(r.width,1) );
                                     }
                                     else if( ncn == 3 )
                                     {
-                                        icvCvt_RGB2BGR_16u_C3R(buffer16 + i*tile_width0*ncn, 0,
-                                                               (ushort*)(data + img.step*i) + x*3, 0,
-                                                               cvSize(tile_width,1) );
+                                        icvCvt_RGB2BGR_16u_C3R(src, 0, dst + dx*3, 0,
+                                                               cvSize(r.width,1) );
                                     }
                                     else if (ncn == 4)
                                     {
                                         if (wanted_channels == 4)
                                         {
-                                            icvCvt_BGRA2RGBA_16u_C4R(buffer16 + i*tile_width0*ncn, 0,
-                                                (ushort*)(data + img.step*i) + x * 4, 0,
-                                                cvSize(tile_width, 1));
+                                            icvCvt_BGRA2RGBA_16u_C4R(src, 0, dst + dx * 4, 0,
+                                                cvSize(r.width, 1));
                                         }
                                         else
                                         {
-                                            icvCvt_BGRA2BGR_16u_C4C3R(buffer16 + i*tile_width0*ncn, 0,
-                                                (ushort*)(data + img.step*i) + x * 3, 0,
-                                                cvSize(tile_width, 1), 2);
+                                            icvCvt_BGRA2BGR_16u_C4C3R(src, 0, dst + dx * 3, 0,
+                                                cvSize(r.width, 1), 2);
                                         }
                                     }
                                     else
                                     {
-                                        icvCvt_BGRA2BGR_16u_C4C3R(buffer16 + i*tile_width0*ncn, 0,
-                                                               (ushort*)(data + img.step*i) + x*3, 0,
-                                                               cvSize(tile_width,1), 2 );
+                                        icvCvt_BGRA2BGR_16u_C4C3R(src, 0, dst + dx*3, 0,
+                                                               cvSize(r.width,1), 2 );
                                     }
                                 }
                                 else
                                 {
                                     if( ncn == 1 )
                                     {
-                                        memcpy((ushort*)(data + img.step*i)+x,
-                                               buffer16 + i*tile_width0*ncn,
-                                               tile_width*sizeof(buffer16[0]));
+                                        memcpy(dst + dx, src, r.width*sizeof(buffer16[0]));
                                     }
                                     else
                                     {
-                                        icvCvt_BGRA2Gray_16u_CnC1R(buffer16 + i*tile_width0*ncn, 0,
-                                                               (ushort*)(data + img.step*i) + x, 0,
-                                                               cvSize(tile_width,1), ncn, 2 );
+                                        icvCvt_BGRA2Gray_16u_CnC1R(src, 0, dst + dx, 0,
+                                                               cvSize(r.width,1), ncn, 2 );
                                     }
                                 }
                             }
@@ -502,19 +600,19 @@ bool  TiffDecoder::readData( Mat& img )
                                 return false;
                             }
 
-                            for( i = 0; i < tile_height; i++ )
+                            for( i = i0; i < i1; i++ )
                             {
                                 if(dst_bpp == 32)
                                 {
-                                    memcpy((float*)(data + img.step*i)+x,
-                                           buffer32 + i*tile_width0*ncn,
-                                           tile_width*sizeof(buffer32[0]));
+                                    memcpy(img.ptr<float>(dst_y + i) + dx,
+                                           buffer32 + i*tile_width0*ncn + sx,
+                                           r.width*sizeof(buffer32[0]));
                                 }
                                 else
                                 {
-                                    memcpy((double*)(data + img.step*i)+x,
-                                         buffer64 + i*tile_width0*ncn,
-                                         tile_width*sizeof(buffer64[0]));
+                                    memcpy(img.ptr<double>(dst_y + i) + dx,
+                                         buffer64 + i*tile_width0*ncn + sx,
+                                         r.width*sizeof(buffer64[0]));
                                 }
                             }
 
@@ -547,13 +645,33 @@ bool TiffDecoder::readData_32FC3(Mat& img)
     TIFFGetField(tif, TIFFTAG_ROWSPERSTRIP, &rows_per_strip);
     TIFFGetField( tif, TIFFTAG_PHOTOMETRIC, &photometric );
     TIFFSetField(tif, TIFFTAG_SGILOGDATAFMT, SGILOGDATAFMT_FLOAT);
-    int size = 3 * m_width * m_height * sizeof (float);
-    tstrip_t strip_size = 3 * m_width * rows_per_strip;
-    float *ptr = img.ptr<float>();
-    for (tstrip_t i = 0; i < TIFFNumberOfStrips(tif); i++, ptr += strip_size)
+    if (m_roi.empty())
+    {
+        int size = 3 * m_width * m_height * sizeof (float);
+        tstrip_t strip_size = 3 * m_width * rows_per_strip;
+        float *ptr = img.ptr<float>();
+        for (tstrip_t i = 0; i < TIFFNumberOfStrips(tif); i++, ptr += strip_size)
+        {
+            TIFFReadEncodedStrip(tif, i, ptr, size);
+            size -= strip_size * sizeof(float);
+        }
+    }
+    else
     {
-        TIFFReadEncodedStrip(tif, i, ptr, size);
-        size -= strip_size * sizeof(float);
+        // only the strips intersecting the region are decoded
+        if (rows_per_strip <= 0 || rows_per_strip > m_height)
+            rows_per_strip = m_height;
+        Mat strip(rows_per_strip, m_width, CV_32FC3);
+        for (int y = m_roi.y - m_roi.y % rows_per_strip; y < m_roi.y + m_roi.height; y += rows_per_strip)
+        {
+            if (TIFFReadEncodedStrip(tif, y / rows_per_strip, strip.ptr(), strip.total() * strip.elemSize()) < 0)
+            {
+                close();
+                return false;
+            }
+            Rect r = Rect(0, y, m_width, rows_per_strip) & m_roi;
+            strip(r - Point(0, y)).copyTo(img(r - m_roi.tl()));
+        }
     }
     close();
     if(photometric == PHOTOMETRIC_LOGLUV)
@@ -578,7 +696,8 @@ bool TiffDecoder::readData_32FC1(Mat& img)
     uint32 img_width, img_height;
     TIFFGetField(tif,TIFFTAG_IMAGEWIDTH, &img_width);
     TIFFGetField(tif,TIFFTAG_IMAGELENGTH, &img_height);
-    if(img.size() != Size(img_width,img_height))
+    const Rect roi = m_roi.empty() ? Rect(0, 0, (int)img_width, (int)img_height) : m_roi;
+    if(img.size() != roi.size())
     {
         close();
         return false;
@@ -587,18 +706,16 @@ bool TiffDecoder::readData_32FC1(Mat& img)
     tdata_t buf = _TIFFmalloc(scanlength);
     float* data;
     bool result = true;
-    for (uint32 row = 0; row < img_height; row++)
+    // libtiff decodes only the strips containing the requested rows
+    for (int row = roi.y; row < roi.y + roi.height; row++)
     {
-        if (TIFFReadScanline(tif, buf, row) != 1)
+        if (TIFFReadScanline(tif, buf, (uint32)row) != 1)
         {
             result = false;
             break;
         }
         data=(float*)buf;
-        for (uint32 i=0; i<img_width; i++)
-        {
-            img.at<float>(row,i) = data[i];
-        }
+        memcpy(img.ptr<float>(row - roi.y), data + roi.x, roi.width * sizeof(float));
     }
     _TIFFfree(buf);
     close();
@@ -723,6 +840,122 @@ static void readParam(const std::vector<int>& params, int key, int& value)
         }
 }
 
+// Converts a row of the image to the TIFF sample order
+static bool prepareRow(const Mat& img, int y, uchar* buffer, size_t scanlineSize)
+{
+    const int width = img.cols;
+    switch (img.channels())
+    {
+        case 1:
+        {
+            memcpy(buffer, img.ptr(y), scanlineSize);
+            return true;
+        }
+
+        case 3:
+        {
+            if (img.depth() == CV_8U)
+                icvCvt_BGR2RGB_8u_C3R( img.ptr(y), 0, buffer, 0, cvSize(width, 1));
+            else
+                icvCvt_BGR2RGB_16u_C3R( img.ptr<ushort>(y), 0, (ushort*)buffer, 0, cvSize(width, 1));
+            return true;
+        }
+
+        case 4:
+        {
+            if (img.depth() == CV_8U)
+                icvCvt_BGRA2RGBA_8u_C4R( img.ptr(y), 0, buffer, 0, cvSize(width, 1));
+            else
+                icvCvt_BGRA2RGBA_16u_C4R( img.ptr<ushort>(y), 0, (ushort*)buffer, 0, cvSize(width, 1));
+            return true;
+        }
+
+        default:
+            return false;
+    }
+}
+
+// The compression schemes whose strips don't depend on the tags shared by the whole image
+// (unlike JPEG tables), so they can be encoded separately
+static bool isParallelCompression(int compression)
+{
+    return compression == COMPRESSION_NONE || compression == COMPRESSION_LZW ||
+           compression == COMPRESSION_ADOBE_DEFLATE || compression == COMPRESSION_DEFLATE ||
+           compression == COMPRESSION_PACKBITS;
+}
+
+// Compresses strips of an image. Every strip is written by libtiff as the only strip of
+// a temporary image in memory, the compressed data is then read back with TIFFReadRawStrip.
+class TiffStripEncodeInvoker CV_FINAL : public ParallelLoopBody
+{
+public:
+    TiffStripEncodeInvoker(const Mat& img, int rowsPerStrip, int bitsPerChannel, int compression, int predictor,
+                           std::vector<std::vector<uchar> >& strips)
+        : img_(img), rowsPerStrip_(rowsPerStrip), bitsPerChannel_(bitsPerChannel),
+          compression_(compression), predictor_(predictor), strips_(strips) {}
+
+    void operator()(const Range& range) const CV_OVERRIDE
+    {
+        for (int s = range.start; s < range.end; s++)
+            encodeStrip(s);
+    }
+
+private:
+    void encodeStrip(int s) const
+    {
+        const int y0 = s * rowsPerStrip_, rows = std::min(rowsPerStrip_, img_.rows - y0);
+        const int channels = img_.channels();
+        const size_t scanlineSize = img_.cols * img_.elemSize();
+
+        std::vector<uchar> encoded;
+        TiffEncoderBufHelper buf_helper(&encoded);
+        TIFF* tif = buf_helper.open();
+        if (!tif)
+            return;
+
+        AutoBuffer<uchar> _buffer(scanlineSize * rows);
+        uchar* buffer = _buffer.data();
+        bool ok = TIFFSetField(tif, TIFFTAG_IMAGEWIDTH, img_.cols)
+            && TIFFSetField(tif, TIFFTAG_IMAGELENGTH, rows)
+            && TIFFSetField(tif, TIFFTAG_BITSPERSAMPLE, bitsPerChannel_)
+            && TIFFSetField(tif, TIFFTAG_COMPRESSION, compression_)
+            && TIFFSetField(tif, TIFFTAG_PHOTOMETRIC, channels > 1 ? PHOTOMETRIC_RGB : PHOTOMETRIC_MINISBLACK)
+            && TIFFSetField(tif, TIFFTAG_SAMPLESPERPIXEL, channels)
+            && TIFFSetField(tif, TIFFTAG_PLANARCONFIG, PLANARCONFIG_CONTIG)
+            && TIFFSetField(tif, TIFFTAG_ROWSPERSTRIP, rows)
+            && (compression_ == COMPRESSION_NONE || TIFFSetField(tif, TIFFTAG_PREDICTOR, predictor_));
+        for (int y = 0; ok && y < rows; y++)
+            ok = prepareRow(img_, y0 + y, buffer + y * scanlineSize, scanlineSize);
+        ok = ok && TIFFWriteEncodedStrip(tif, 0, buffer, scanlineSize * rows) >= 0;
+        TIFFClose(tif);
+        if (!ok)
+            return;
+
+        Mat encoded_mat(1, (int)encoded.size(), CV_8U, &encoded[0]);
+        size_t encoded_pos = 0;
+        tif = TIFFClientOpen( "", "r", reinterpret_cast<thandle_t>(new TiffDecoderBufHelper(encoded_mat, encoded_pos)),
+                              &TiffDecoderBufHelper::read, &TiffDecoderBufHelper::write,
+                              &TiffDecoderBufHelper::seek, &TiffDecoderBufHelper::close,
+                              &TiffDecoderBufHelper::size, &TiffDecoderBufHelper::map, /*unmap=*/0 );
+        if (!tif)
+            return;
+
+        std::vector<uchar>& strip = strips_[s];
+        tmsize_t size = TIFFRawStripSize(tif, 0);
+        if (size > 0)
+        {
+            strip.resize((size_t)size);
+            if (TIFFReadRawStrip(tif, 0, &strip[0], size) != size)
+                strip.clear();
+        }
+        TIFFClose(tif);
+    }
+
+    const Mat& img_;
+    int rowsPerStrip_, bitsPerChannel_, compression_, predictor_;
+    std::vector<std::vector<uchar> >& strips_;
+};
+
 bool TiffEncoder::writeLibTiff( const std::vector<Mat>& img_vec, const std::vector<int>& params)
 {
     // do NOT put "wb" as the mode, because the b means "big endian" mode, not "binary" mode.
@@ -748,12 +981,16 @@ bool TiffEncoder::writeLibTiff( const std::vector<Mat>& img_vec, const std::vect
     int compression = COMPRESSION_LZW;
     int predictor = PREDICTOR_HORIZONTAL;
     int resUnit = -1, dpiX = -1, dpiY = -1;
+    int threads = 1;
 
     readParam(params, TIFFTAG_COMPRESSION, compression);
     readParam(params, TIFFTAG_PREDICTOR, predictor);
     readParam(params, IMWRITE_TIFF_RESUNIT, resUnit);
     readParam(params, IMWRITE_TIFF_XDPI, dpiX);
     readParam(params, IMWRITE_TIFF_YDPI, dpiY);
+    readParam(params, IMWRITE_THREADS, threads);
+    if (threads <= 0)
+        threads = getNumThreads();
 
     //Iterate through each image in the vector and write them out as Tiff directories
     for (size_t page = 0; page < img_vec.size(); page++)
@@ -840,47 +1077,40 @@ bool TiffEncoder::writeLibTiff( const std::vector<Mat>& img_vec, const std::vect
             return false;
         }
 
-        for (int y = 0; y < height; ++y)
+        const int nstrips = (height + rowsPerStrip - 1) / rowsPerStrip;
+        if (threads > 1 && nstrips > 1 && isParallelCompression(compression))
         {
-            switch (channels)
+            // the strips are compressed concurrently and written as they are
+            std::vector<std::vector<uchar> > strips(nstrips);
+            parallel_for_(Range(0, nstrips),
+                          TiffStripEncodeInvoker(img, rowsPerStrip, bitsPerChannel, compression, predictor, strips),
+                          threads);
+            for (int s = 0; s < nstrips; s++)
             {
-                case 1:
+                if (strips[s].empty() || TIFFWriteRawStrip(pTiffHandle, s, &strips[s][0], strips[s].size()) < 0)
                 {
-                    memcpy(buffer, img.ptr(y), scanlineSize);
-                    break;
-                }
-
-                case 3:
-                {
-                    if (depth == CV_8U)
-                        icvCvt_BGR2RGB_8u_C3R( img.ptr(y), 0, buffer, 0, cvSize(width, 1));
-                    else
-                        icvCvt_BGR2RGB_16u_C3R( img.ptr<ushort>(y), 0, (ushort*)buffer, 0, cvSize(width, 1));
-                    break;
+                    TIFFClose(pTiffHandle);
+                    return false;
                 }
-
-                case 4:
+            }
+        }
+        else
+        {
+            for (int y = 0; y < height; ++y)
+            {
+                if (!prepareRow(img, y, buffer, scanlineSize))
                 {
-                    if (depth == CV_8U)
-                        icvCvt_BGRA2RGBA_8u_C4R( img.ptr(y), 0, buffer, 0, cvSize(width, 1));
-                    else
-                        icvCvt_BGRA2RGBA_16u_C4R( img.ptr<ushort>(y), 0, (ushort*)buffer, 0, cvSize(width, 1));
-                    break;
+                    TIFFClose(pTiffHandle);
+                    return false;
                 }
 
-                default:
+                int writeResult = TIFFWriteScanline(pTiffHandle, buffer, y, 0);
+                if (writeResult != 1)
                 {
                     TIFFClose(pTiffHandle);
                     return false;
                 }
             }
-
-            int writeResult = TIFFWriteScanline(pTiffHandle, buffer, y, 0);
-            if (writeResult != 1)
-            {
-                TIFFClose(pTiffHandle);
-                return false;
-            }
         }
 
         TIFFWriteDirectory(pTiffHandle);
@@ -99,6 +99,9 @@ public:
     bool  readHeader() CV_OVERRIDE;
     bool  readData( Mat& img ) CV_OVERRIDE;
     void  close();
+    bool  setROI( const Rect& roi ) CV_OVERRIDE;
+    bool  startRows( int type ) CV_OVERRIDE;
+    int   readRows( Mat& rows ) CV_OVERRIDE;
     bool  nextPage() CV_OVERRIDE;
 
     size_t signatureLength() const CV_OVERRIDE;
@@ -112,6 +115,10 @@ protected:
     bool readData_32FC1(Mat& img);
     bool m_hdr;
     size_t m_buf_pos;
+    Rect m_roi; // empty if the whole image is read
+    int m_strip_rows; // rows of a strip or of a row of tiles, for readRows
+    Mat m_strip;      // the strip crossing the end of the last band returned by readRows
+    int m_strip_y;    // first image row of m_strip
 
 private:
     TiffDecoder(const TiffDecoder &); // copy disabled
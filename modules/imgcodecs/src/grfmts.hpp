@@ -57,5 +57,6 @@
 #include "grfmt_gdal.hpp"
 #include "grfmt_gdcm.hpp"
 #include "grfmt_pam.hpp"
+#include "grfmt_qli.hpp"
 
 #endif/*_GRFMTS_H_*/
@@ -51,6 +51,12 @@
 #undef max
 #include <iostream>
 #include <fstream>
+#if !defined _WIN32 && (defined __unix__ || defined __APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 /****************************************************************************************\
 *                                      Image Codecs                                      *
@@ -160,6 +166,10 @@ struct ImageCodecInitializer
         decoders.push_back( makePtr<PFMDecoder>() );
         encoders.push_back( makePtr<PFMEncoder>() );
     #endif
+    #ifdef HAVE_IMGCODEC_QLI
+        decoders.push_back( makePtr<QliDecoder>() );
+        encoders.push_back( makePtr<QliEncoder>() );
+    #endif
     #ifdef HAVE_TIFF
         decoders.push_back( makePtr<TiffDecoder>() );
         encoders.push_back( makePtr<TiffEncoder>() );
@@ -192,73 +202,96 @@ struct ImageCodecInitializer
 
 static ImageCodecInitializer codecs;
 
-/**
- * Find the decoders
- *
- * @param[in] filename File to search
- *
- * @return Image decoder to parse image file.
-*/
-static ImageDecoder findDecoder( const String& filename ) {
-
-    size_t i, maxlen = 0;
+static size_t maxSignatureLength()
+{
+    size_t maxlen = 0;
 
     /// iterate through list of registered codecs
-    for( i = 0; i < codecs.decoders.size(); i++ )
+    for( size_t i = 0; i < codecs.decoders.size(); i++ )
     {
         size_t len = codecs.decoders[i]->signatureLength();
         maxlen = std::max(maxlen, len);
     }
+    return maxlen;
+}
+
+/**
+ * Find the index of the registered decoder which accepts the signature
+ *
+ * @param[in] signature First bytes of the image data
+ *
+ * @return Index in codecs.decoders or -1 if no decoder was found.
+*/
+static int findDecoderIdx( const String& signature )
+{
+    /// compare signature against all decoders
+    for( size_t i = 0; i < codecs.decoders.size(); i++ )
+    {
+        if( codecs.decoders[i]->checkSignature(signature) )
+            return (int)i;
+    }
+    return -1;
+}
+
+static bool readSignature( const String& filename, String& signature )
+{
+    size_t maxlen = maxSignatureLength();
 
     /// Open the file
     FILE* f= fopen( filename.c_str(), "rb" );
-
-    /// in the event of a failure, return an empty image decoder
     if( !f )
-        return ImageDecoder();
+        return false;
 
     // read the file signature
-    String signature(maxlen, ' ');
+    signature.assign(maxlen, ' ');
     maxlen = fread( (void*)signature.c_str(), 1, maxlen, f );
     fclose(f);
     signature = signature.substr(0, maxlen);
-
-    /// compare signature against all decoders
-    for( i = 0; i < codecs.decoders.size(); i++ )
-    {
-        if( codecs.decoders[i]->checkSignature(signature) )
-            return codecs.decoders[i]->newDecoder();
-    }
-
-    /// If no decoder was found, return base type
-    return ImageDecoder();
+    return true;
 }
 
-static ImageDecoder findDecoder( const Mat& buf )
+static bool readSignature( const Mat& buf, String& signature )
 {
-    size_t i, maxlen = 0;
-
     if( buf.rows*buf.cols < 1 || !buf.isContinuous() )
-        return ImageDecoder();
-
-    for( i = 0; i < codecs.decoders.size(); i++ )
-    {
-        size_t len = codecs.decoders[i]->signatureLength();
-        maxlen = std::max(maxlen, len);
-    }
+        return false;
 
-    String signature(maxlen, ' ');
+    size_t maxlen = maxSignatureLength();
+    signature.assign(maxlen, ' ');
     size_t bufSize = buf.rows*buf.cols*buf.elemSize();
     maxlen = std::min(maxlen, bufSize);
     memcpy( (void*)signature.c_str(), buf.data, maxlen );
+    return true;
+}
 
-    for( i = 0; i < codecs.decoders.size(); i++ )
-    {
-        if( codecs.decoders[i]->checkSignature(signature) )
-            return codecs.decoders[i]->newDecoder();
-    }
+/**
+ * Find the decoders
+ *
+ * @param[in] filename File to search
+ *
+ * @return Image decoder to parse image file.
+*/
+static ImageDecoder findDecoder( const String& filename ) {
+
+    String signature;
+
+    /// in the event of a failure, return an empty image decoder
+    if( !readSignature(filename, signature) )
+        return ImageDecoder();
+
+    int idx = findDecoderIdx(signature);
+
+    /// If no decoder was found, return base type
+    return idx >= 0 ? codecs.decoders[idx]->newDecoder() : ImageDecoder();
+}
 
-    return ImageDecoder();
+static ImageDecoder findDecoder( const Mat& buf )
+{
+    String signature;
+    if( !readSignature(buf, signature) )
+        return ImageDecoder();
+
+    int idx = findDecoderIdx(signature);
+    return idx >= 0 ? codecs.decoders[idx]->newDecoder() : ImageDecoder();
 }
 
 static ImageEncoder findEncoder( const String& _ext )
@@ -340,29 +373,36 @@ static void ExifTransform(int orientation, Mat& img)
     }
 }
 
-static void ApplyExifOrientation(const String& filename, Mat& img)
+static int ExifOrientation(std::istream& stream)
 {
     int orientation = IMAGE_ORIENTATION_TL;
 
-    if (filename.size() > 0)
+    ExifReader reader( stream );
+    if( reader.parse() )
     {
-        std::ifstream stream( filename.c_str(), std::ios_base::in | std::ios_base::binary );
-        ExifReader reader( stream );
-        if( reader.parse() )
+        ExifEntry_t entry = reader.getTag( ORIENTATION );
+        if (entry.tag != INVALID_TAG)
         {
-            ExifEntry_t entry = reader.getTag( ORIENTATION );
-            if (entry.tag != INVALID_TAG)
-            {
-                orientation = entry.field_u16; //orientation is unsigned short, so check field_u16
-            }
+            orientation = entry.field_u16; //orientation is unsigned short, so check field_u16
         }
-        stream.close();
     }
+    return orientation;
+}
+
+static int ExifOrientation(const String& filename)
+{
+    int orientation = IMAGE_ORIENTATION_TL;
 
-    ExifTransform(orientation, img);
+    if (filename.size() > 0)
+    {
+        std::ifstream stream( filename.c_str(), std::ios_base::in | std::ios_base::binary );
+        orientation = ExifOrientation(stream);
+        stream.close();
+    }
+    return orientation;
 }
 
-static void ApplyExifOrientation(const Mat& buf, Mat& img)
+static int ExifOrientation(const Mat& buf)
 {
     int orientation = IMAGE_ORIENTATION_TL;
 
@@ -370,60 +410,68 @@ static void ApplyExifOrientation(const Mat& buf, Mat& img)
     {
         ByteStreamBuffer bsb( reinterpret_cast<char*>(buf.data), buf.total() * buf.elemSize() );
         std::istream stream( &bsb );
-        ExifReader reader( stream );
-        if( reader.parse() )
-        {
-            ExifEntry_t entry = reader.getTag( ORIENTATION );
-            if (entry.tag != INVALID_TAG)
-            {
-                orientation = entry.field_u16; //orientation is unsigned short, so check field_u16
-            }
-        }
+        orientation = ExifOrientation(stream);
     }
+    return orientation;
+}
+
+static void ApplyExifOrientation(const String& filename, Mat& img)
+{
+    ExifTransform(ExifOrientation(filename), img);
+}
 
-    ExifTransform(orientation, img);
+static void ApplyExifOrientation(const Mat& buf, Mat& img)
+{
+    ExifTransform(ExifOrientation(buf), img);
 }
 
 /**
- * Read an image into memory and return the information
+ * Compute the part of the decoded image to read for a region of the full-resolution image
  *
- * @param[in] filename File to load
- * @param[in] flags Flags
- * @param[in] hdrtype { LOAD_CVMAT=0,
- *                      LOAD_IMAGE=1,
- *                      LOAD_MAT=2
- *                    }
- * @param[in] mat Reference to C++ Mat object (If LOAD_MAT)
- * @param[in] scale_denom Scale value
+ * @param[in] roi Region in the coordinates of the full-resolution image
+ * @param[in] size Size of the image produced by the decoder
+ * @param[in] dec_denom Scale reduction already applied by the decoder
+ * @param[in] res_denom Scale reduction applied by resize() after decoding, the region is aligned to it
  *
+ * @return The region in the coordinates of the decoded image, empty if roi is outside of the image
 */
-static void*
-imread_( const String& filename, int flags, int hdrtype, Mat* mat=0 )
+static Rect decodedRegion( const Rect& roi, Size size, int dec_denom, int res_denom )
 {
-    CV_Assert(mat || hdrtype != LOAD_MAT); // mat is required in LOAD_MAT case
-
-    IplImage* image = 0;
-    CvMat *matrix = 0;
-    Mat temp, *data = &temp;
-
-    /// Search for the relevant decoder to handle the imagery
-    ImageDecoder decoder;
-
-#ifdef HAVE_GDAL
-    if(flags != IMREAD_UNCHANGED && (flags & IMREAD_LOAD_GDAL) == IMREAD_LOAD_GDAL ){
-        decoder = GdalDecoder().newDecoder();
-    }else{
-#endif
-        decoder = findDecoder( filename );
-#ifdef HAVE_GDAL
-    }
-#endif
+    int x0 = std::max(roi.x, 0) / dec_denom, y0 = std::max(roi.y, 0) / dec_denom;
+    int x1 = (std::max(roi.x + roi.width, 0) + dec_denom - 1) / dec_denom;
+    int y1 = (std::max(roi.y + roi.height, 0) + dec_denom - 1) / dec_denom;
+    x0 -= x0 % res_denom; y0 -= y0 % res_denom;
+    x1 = alignSize(x1, res_denom); y1 = alignSize(y1, res_denom);
+    return Rect(x0, y0, x1 - x0, y1 - y0) & Rect(Point(), size);
+}
 
-    /// if no decoder was found, return nothing.
-    if( !decoder ){
-        return 0;
-    }
+/**
+ * Read the image data or its region
+ *
+ * @param[in] decoder Decoder, readHeader() has succeeded
+ * @param[in] region Region of the image to read, the whole image if empty
+ * @param[out] img Destination of the region size
+ *
+ * If the decoder can't decode a part of the image only, the whole image is decoded
+ * and the region is copied out of it.
+*/
+static bool readRegion( ImageDecoder& decoder, const Rect& region, Mat& img )
+{
+    if( region.empty() || decoder->setROI( region ) )
+        return decoder->readData( img );
+
+    Mat whole( decoder->height(), decoder->width(), img.type() );
+    if( !decoder->readData( whole ) )
+        return false;
+    whole( region ).copyTo( img );
+    return true;
+}
 
+/**
+ * Get the scale reduction requested by the IMREAD_REDUCED_* flags
+*/
+static int reducedScale( int flags )
+{
     int scale_denom = 1;
     if( flags > IMREAD_LOAD_GDAL )
     {
@@ -434,98 +482,344 @@ imread_( const String& filename, int flags, int hdrtype, Mat* mat=0 )
     else if( flags & IMREAD_REDUCED_GRAYSCALE_8 )
         scale_denom = 8;
     }
+    return scale_denom;
+}
 
-    /// set the scale_denom in the driver
-    decoder->setScale( scale_denom );
+/**
+ * Get the type of the image to decode
+ *
+ * @param[in] type Type of the image reported by the decoder
+ * @param[in] flags Flags of imread
+*/
+static int imreadType( int type, int flags )
+{
+    if( (flags & IMREAD_LOAD_GDAL) != IMREAD_LOAD_GDAL && flags != IMREAD_UNCHANGED )
+    {
+        if( (flags & CV_LOAD_IMAGE_ANYDEPTH) == 0 )
+            type = CV_MAKETYPE(CV_8U, CV_MAT_CN(type));
 
-    /// set the filename in the driver
-    decoder->setSource( filename );
+        if( (flags & CV_LOAD_IMAGE_COLOR) != 0 ||
+           ((flags & CV_LOAD_IMAGE_ANYCOLOR) != 0 && CV_MAT_CN(type) > 1) )
+            type = CV_MAKETYPE(CV_MAT_DEPTH(type), 3);
+        else
+            type = CV_MAKETYPE(CV_MAT_DEPTH(type), 1);
+    }
+    return type;
+}
+
+/**
+ * Pass a buffer with an encoded image to the decoder
+ *
+ * @param[in] decoder Decoder
+ * @param[in] buf Encoded image
+ * @param[out] filename Name of a temporary file holding the buffer if the decoder can read files
+ *                      only (remove it with removeTempFile after decoding), empty otherwise
+*/
+static bool setBufferSource( ImageDecoder& decoder, const Mat& buf, String& filename )
+{
+    filename.clear();
+    if( decoder->setSource(buf) )
+        return true;
+
+    filename = tempfile();
+    FILE* f = fopen( filename.c_str(), "wb" );
+    if( !f )
+    {
+        filename.clear();
+        return false;
+    }
+    size_t bufSize = buf.cols*buf.rows*buf.elemSize();
+    if( fwrite( buf.ptr(), 1, bufSize, f ) != bufSize )
+    {
+        fclose( f );
+        CV_Error( CV_StsError, "failed to write image data to temporary file" );
+    }
+    if( fclose(f) != 0 )
+    {
+        CV_Error( CV_StsError, "failed to write image data to temporary file" );
+    }
+    decoder->setSource(filename);
+    return true;
+}
+
+static void removeTempFile( const String& filename )
+{
+    if (!filename.empty())
+    {
+        if (0 != remove(filename.c_str()))
+        {
+            std::cerr << "unable to remove temporary file:" << filename << std::endl << std::flush;
+        }
+    }
+}
+
+/**
+ * Read-only memory mapping of a whole file
+*/
+class FileMapping
+{
+public:
+    FileMapping() : m_data(0), m_size(0) {}
+    ~FileMapping() { close(); }
+
+    bool open( const String& filename );
+    void close();
+
+    //! The mapped file as a row of bytes, that doesn't own the data
+    Mat mat() const { return Mat(1, (int)m_size, CV_8U, m_data); }
+
+private:
+    FileMapping( const FileMapping& ); // = delete
+    FileMapping& operator=( const FileMapping& ); // = delete
+
+    void* m_data;
+    size_t m_size;
+};
+
+bool FileMapping::open( const String& filename )
+{
+    close();
+    void* data = 0;
+    size_t size = 0;
+#if defined _WIN32 && !defined WINRT
+    HANDLE file = CreateFileA( filename.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+                               OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL );
+    if( file == INVALID_HANDLE_VALUE )
+        return false;
+    LARGE_INTEGER fileSize;
+    if( GetFileSizeEx( file, &fileSize ) && fileSize.QuadPart > 0 && fileSize.QuadPart <= INT_MAX )
+    {
+        HANDLE mapping = CreateFileMappingA( file, NULL, PAGE_READONLY, 0, 0, NULL );
+        if( mapping )
+        {
+            // the view keeps the file and the mapping open
+            data = MapViewOfFile( mapping, FILE_MAP_READ, 0, 0, 0 );
+            size = (size_t)fileSize.QuadPart;
+            CloseHandle( mapping );
+        }
+    }
+    CloseHandle( file );
+#elif defined __unix__ || defined __APPLE__
+    int fd = ::open( filename.c_str(), O_RDONLY );
+    if( fd < 0 )
+        return false;
+    struct stat st;
+    if( fstat( fd, &st ) == 0 && S_ISREG(st.st_mode) && st.st_size > 0 && st.st_size <= INT_MAX )
+    {
+        data = mmap( 0, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0 );
+        if( data == MAP_FAILED )
+            data = 0;
+        size = (size_t)st.st_size;
+    }
+    ::close( fd );
+#else
+    CV_UNUSED(filename);
+#endif
+    if( !data )
+        return false;
+    m_data = data;
+    m_size = size;
+    return true;
+}
+
+void FileMapping::close()
+{
+    if( !m_data )
+        return;
+#if defined _WIN32 && !defined WINRT
+    UnmapViewOfFile( m_data );
+#elif defined __unix__ || defined __APPLE__
+    munmap( m_data, m_size );
+#endif
+    m_data = 0;
+    m_size = 0;
+}
+
+/**
+ * Set a file as the source of the decoder
+ *
+ * @param[in] decoder Decoder
+ * @param[in] filename File to read
+ * @param[in] flags Flags of imread, the file is read through mapping if IMREAD_MMAP is set
+ * @param[out] mapping Mapping of the file, to keep until the image is decoded
+*/
+static void setFileSource( ImageDecoder& decoder, const String& filename, int flags, FileMapping& mapping )
+{
+    if( flags != IMREAD_UNCHANGED && (flags & IMREAD_MMAP) != 0 && mapping.open(filename) )
+    {
+        if( decoder->setSource(mapping.mat()) )
+            return;
+        mapping.close();
+    }
+    decoder->setSource(filename);
+}
 
+/**
+ * Read the image header, reporting the errors
+ *
+ * @param[in] decoder Decoder with the source set
+ * @param[in] func,filename Where the image comes from, for error messages
+*/
+static bool readHeader( ImageDecoder& decoder, const char* func, const String& filename )
+{
     CV_TRY
     {
         // read the header to make sure it succeeds
         if( !decoder->readHeader() )
-            return 0;
+            return false;
     }
     CV_CATCH (cv::Exception, e)
     {
-        std::cerr << "imread_('" << filename << "'): can't read header: " << e.what() << std::endl << std::flush;
-        return 0;
+        std::cerr << func << "('" << filename << "'): can't read header: " << e.what() << std::endl << std::flush;
+        return false;
     }
     CV_CATCH_ALL
     {
-        std::cerr << "imread_('" << filename << "'): can't read header: unknown exception" << std::endl << std::flush;
-        return 0;
+        std::cerr << func << "('" << filename << "'): can't read header: unknown exception" << std::endl << std::flush;
+        return false;
     }
+    return true;
+}
+
+/**
+ * Read the image header and data
+ *
+ * @param[in] decoder Decoder with the source set
+ * @param[in] flags Flags of imread
+ * @param[in] scale_denom Scale reduction, see reducedScale
+ * @param[in] roi Region of the full-resolution image to read, whole image if NULL
+ * @param[in] func,filename Where the image comes from, for error messages
+ * @param[in] hdrtype { LOAD_CVMAT=0,
+ *                      LOAD_IMAGE=1,
+ *                      LOAD_MAT=2
+ *                    }
+ * @param[out] img Decoded image if LOAD_MAT (reallocated only if its size or type doesn't match),
+ *                 otherwise the header of the allocated CvMat or IplImage
+ * @param[out] hdr The allocated CvMat or IplImage, or &img if LOAD_MAT
+*/
+static bool readImage( ImageDecoder& decoder, int flags, int scale_denom, const Rect* roi,
+                       const char* func, const String& filename, int hdrtype, Mat& img, void** hdr )
+{
+    /// set the scale_denom in the driver
+    decoder->setScale( scale_denom );
 
+    if( !readHeader( decoder, func, filename ) )
+        return false;
 
     // established the required input image size
     Size size = validateInputImageSize(Size(decoder->width(), decoder->height()));
 
-    // grab the decoded type
-    int type = decoder->type();
-    if( (flags & IMREAD_LOAD_GDAL) != IMREAD_LOAD_GDAL && flags != IMREAD_UNCHANGED )
-    {
-        if( (flags & CV_LOAD_IMAGE_ANYDEPTH) == 0 )
-            type = CV_MAKETYPE(CV_8U, CV_MAT_CN(type));
+    // if decoder is JpegDecoder then decoder->setScale always returns 1
+    const bool scaled = decoder->setScale( scale_denom ) > 1;
 
-        if( (flags & CV_LOAD_IMAGE_COLOR) != 0 ||
-           ((flags & CV_LOAD_IMAGE_ANYCOLOR) != 0 && CV_MAT_CN(type) > 1) )
-            type = CV_MAKETYPE(CV_MAT_DEPTH(type), 3);
-        else
-            type = CV_MAKETYPE(CV_MAT_DEPTH(type), 1);
+    Rect region;
+    if( roi )
+    {
+        region = decodedRegion( *roi, size, scaled ? 1 : scale_denom, scaled ? scale_denom : 1 );
+        if( region.empty() )
+            return false;
+        size = region.size();
     }
 
-    if( hdrtype == LOAD_CVMAT || hdrtype == LOAD_MAT )
+    // grab the decoded type
+    int type = imreadType( decoder->type(), flags );
+
+    IplImage* image = 0;
+    CvMat *matrix = 0;
+    if( hdrtype == LOAD_CVMAT )
     {
-        if( hdrtype == LOAD_CVMAT )
-        {
-            matrix = cvCreateMat( size.height, size.width, type );
-            temp = cvarrToMat( matrix );
-        }
-        else
-        {
-            mat->create( size.height, size.width, type );
-            data = mat;
-        }
+        matrix = cvCreateMat( size.height, size.width, type );
+        img = cvarrToMat( matrix );
+        *hdr = matrix;
     }
-    else
+    else if( hdrtype == LOAD_IMAGE )
     {
         image = cvCreateImage(cvSize(size), cvIplDepth(type), CV_MAT_CN(type));
-        temp = cvarrToMat( image );
+        img = cvarrToMat( image );
+        *hdr = image;
+    }
+    else
+    {
+        img.create( size.height, size.width, type );
+        *hdr = &img;
     }
 
     // read the image data
     bool success = false;
     CV_TRY
     {
-        if (decoder->readData(*data))
+        if (readRegion(decoder, region, img))
             success = true;
     }
     CV_CATCH (cv::Exception, e)
     {
-        std::cerr << "imread_('" << filename << "'): can't read data: " << e.what() << std::endl << std::flush;
+        std::cerr << func << "('" << filename << "'): can't read data: " << e.what() << std::endl << std::flush;
     }
     CV_CATCH_ALL
     {
-        std::cerr << "imread_('" << filename << "'): can't read data: unknown exception" << std::endl << std::flush;
+        std::cerr << func << "('" << filename << "'): can't read data: unknown exception" << std::endl << std::flush;
     }
     if (!success)
     {
         cvReleaseImage( &image );
         cvReleaseMat( &matrix );
-        if( mat )
-            mat->release();
-        return 0;
+        img.release();
+        *hdr = 0;
+        return false;
     }
 
-    if( decoder->setScale( scale_denom ) > 1 ) // if decoder is JpegDecoder then decoder->setScale always returns 1
+    if( scaled && hdrtype == LOAD_MAT )
     {
-        resize( *mat, *mat, Size( size.width / scale_denom, size.height / scale_denom ), 0, 0, INTER_LINEAR_EXACT);
+        resize( img, img, Size( size.width / scale_denom, size.height / scale_denom ), 0, 0, INTER_LINEAR_EXACT);
+    }
+    return true;
+}
+
+/**
+ * Read an image into memory and return the information
+ *
+ * @param[in] filename File to load
+ * @param[in] flags Flags
+ * @param[in] hdrtype { LOAD_CVMAT=0,
+ *                      LOAD_IMAGE=1,
+ *                      LOAD_MAT=2
+ *                    }
+ * @param[in] mat Reference to C++ Mat object (If LOAD_MAT)
+ * @param[in] roi Region of the full-resolution image to read, whole image if NULL
+ *
+*/
+static void*
+imread_( const String& filename, int flags, int hdrtype, Mat* mat=0, const Rect* roi=0 )
+{
+    CV_Assert(mat || hdrtype != LOAD_MAT); // mat is required in LOAD_MAT case
+
+    FileMapping mapping;
+
+    /// Search for the relevant decoder to handle the imagery
+    ImageDecoder decoder;
+
+#ifdef HAVE_GDAL
+    if(flags != IMREAD_UNCHANGED && (flags & IMREAD_LOAD_GDAL) == IMREAD_LOAD_GDAL ){
+        decoder = GdalDecoder().newDecoder();
+    }else{
+#endif
+        decoder = findDecoder( filename );
+#ifdef HAVE_GDAL
+    }
+#endif
+
+    /// if no decoder was found, return nothing.
+    if( !decoder ){
+        return 0;
     }
 
-    return hdrtype == LOAD_CVMAT ? (void*)matrix :
-        hdrtype == LOAD_IMAGE ? (void*)image : (void*)mat;
+    /// set the filename, or its mapping, in the driver
+    setFileSource( decoder, filename, flags, mapping );
+
+    Mat temp;
+    void* hdr = 0;
+    readImage( decoder, flags, reducedScale(flags), roi, "imread_", filename, hdrtype, mat ? *mat : temp, &hdr );
+    return hdr;
 }
 
 
@@ -583,18 +877,7 @@ imreadmulti_(const String& filename, int flags, std::vector<Mat>& mats)
     for (;;)
     {
         // grab the decoded type
-        int type = decoder->type();
-        if( (flags & IMREAD_LOAD_GDAL) != IMREAD_LOAD_GDAL && flags != IMREAD_UNCHANGED )
-        {
-            if ((flags & CV_LOAD_IMAGE_ANYDEPTH) == 0)
-                type = CV_MAKETYPE(CV_8U, CV_MAT_CN(type));
-
-            if ((flags & CV_LOAD_IMAGE_COLOR) != 0 ||
-                ((flags & CV_LOAD_IMAGE_ANYCOLOR) != 0 && CV_MAT_CN(type) > 1))
-                type = CV_MAKETYPE(CV_MAT_DEPTH(type), 3);
-            else
-                type = CV_MAKETYPE(CV_MAT_DEPTH(type), 1);
-        }
+        int type = imreadType( decoder->type(), flags );
 
         // established the required input image size
         Size size = validateInputImageSize(Size(decoder->width(), decoder->height()));
@@ -749,167 +1032,679 @@ bool imwrite( const String& filename, InputArray _img,
 }
 
 static void*
-imdecode_( const Mat& buf, int flags, int hdrtype, Mat* mat=0 )
+imdecode_( const Mat& buf, int flags, int hdrtype, Mat* mat=0, const Rect* roi=0 )
 {
+    CV_Assert(mat || hdrtype != LOAD_MAT); // mat is required in LOAD_MAT case
     CV_Assert(!buf.empty() && buf.isContinuous());
-    IplImage* image = 0;
-    CvMat *matrix = 0;
-    Mat temp, *data = &temp;
     String filename;
 
     ImageDecoder decoder = findDecoder(buf);
     if( !decoder )
         return 0;
 
-    if( !decoder->setSource(buf) )
+    if( !setBufferSource(decoder, buf, filename) )
+        return 0;
+
+    // the reduced modes are not supported by imdecode
+    Mat temp;
+    void* hdr = 0;
+    readImage( decoder, flags, 1, roi, "imdecode_", filename, hdrtype, mat ? *mat : temp, &hdr );
+
+    decoder.release();
+    removeTempFile(filename);
+    return hdr;
+}
+
+
+Mat imdecode( InputArray _buf, int flags )
+{
+    CV_TRACE_FUNCTION();
+
+    Mat buf = _buf.getMat(), img;
+    imdecode_( buf, flags, LOAD_MAT, &img );
+
+    /// optionally rotate the data if EXIF' orientation flag says so
+    if( !img.empty() && (flags & IMREAD_IGNORE_ORIENTATION) == 0 && flags != IMREAD_UNCHANGED )
     {
-        filename = tempfile();
-        FILE* f = fopen( filename.c_str(), "wb" );
-        if( !f )
-            return 0;
-        size_t bufSize = buf.cols*buf.rows*buf.elemSize();
-        if( fwrite( buf.ptr(), 1, bufSize, f ) != bufSize )
-        {
-            fclose( f );
-            CV_Error( CV_StsError, "failed to write image data to temporary file" );
-        }
-        if( fclose(f) != 0 )
-        {
-            CV_Error( CV_StsError, "failed to write image data to temporary file" );
-        }
-        decoder->setSource(filename);
+        ApplyExifOrientation(buf, img);
     }
 
-    bool success = false;
-    CV_TRY
+    return img;
+}
+
+Mat imdecode( InputArray _buf, int flags, Mat* dst )
+{
+    CV_TRACE_FUNCTION();
+
+    Mat buf = _buf.getMat(), img;
+    dst = dst ? dst : &img;
+    imdecode_( buf, flags, LOAD_MAT, dst );
+
+    /// optionally rotate the data if EXIF' orientation flag says so
+    if( !dst->empty() && (flags & IMREAD_IGNORE_ORIENTATION) == 0 && flags != IMREAD_UNCHANGED )
     {
-        if (decoder->readHeader())
-            success = true;
+        ApplyExifOrientation(buf, *dst);
     }
-    CV_CATCH (cv::Exception, e)
+
+    return *dst;
+}
+
+Mat imreadRegion( const String& filename, const Rect& roi, int flags )
+{
+    CV_TRACE_FUNCTION();
+
+    Mat img;
+    imread_( filename, flags, LOAD_MAT, &img, &roi );
+
+    /// optionally rotate the data if EXIF' orientation flag says so
+    if( !img.empty() && (flags & IMREAD_IGNORE_ORIENTATION) == 0 && flags != IMREAD_UNCHANGED )
     {
-        std::cerr << "imdecode_('" << filename << "'): can't read header: " << e.what() << std::endl << std::flush;
+        ApplyExifOrientation(filename, img);
+    }
+
+    return img;
+}
+
+Mat imdecodeRegion( InputArray _buf, const Rect& roi, int flags )
+{
+    CV_TRACE_FUNCTION();
+
+    Mat buf = _buf.getMat(), img;
+    imdecode_( buf, flags, LOAD_MAT, &img, &roi );
+
+    /// optionally rotate the data if EXIF' orientation flag says so
+    if( !img.empty() && (flags & IMREAD_IGNORE_ORIENTATION) == 0 && flags != IMREAD_UNCHANGED )
+    {
+        ApplyExifOrientation(buf, img);
+    }
+
+    return img;
+}
+
+/**
+ * Read the properties of an image from its header
+ *
+ * @param[in] decoder Decoder with the source set
+ * @param[in] func,filename Where the image comes from, for error messages
+ * @param[out] header Image properties, except the EXIF orientation
+*/
+static bool readImageHeader( ImageDecoder& decoder, const char* func, const String& filename, ImageHeader& header )
+{
+    if( !readHeader(decoder, func, filename) )
+        return false;
+
+    header.size = Size(decoder->width(), decoder->height());
+    header.type = decoder->type();
+    header.pages = 1;
+    CV_TRY
+    {
+        while( decoder->nextPage() )
+            header.pages++;
     }
     CV_CATCH_ALL
     {
-        std::cerr << "imdecode_('" << filename << "'): can't read header: unknown exception" << std::endl << std::flush;
+        // count the pages read so far
     }
-    if (!success)
+    return true;
+}
+
+ImageHeader::ImageHeader() : type(-1), pages(0), orientation(IMAGE_ORIENTATION_TL) {}
+
+bool imreadHeader( const String& filename, ImageHeader& header )
+{
+    CV_TRACE_FUNCTION();
+
+    header = ImageHeader();
+    ImageDecoder decoder = findDecoder( filename );
+    if( !decoder )
+        return false;
+
+    decoder->setSource( filename );
+    if( !readImageHeader( decoder, "imreadHeader", filename, header ) )
     {
-        decoder.release();
-        if (!filename.empty())
+        header = ImageHeader();
+        return false;
+    }
+
+    header.orientation = ExifOrientation( filename );
+    return true;
+}
+
+bool imdecodeHeader( InputArray _buf, ImageHeader& header )
+{
+    CV_TRACE_FUNCTION();
+
+    header = ImageHeader();
+    Mat buf = _buf.getMat();
+    CV_Assert(!buf.empty() && buf.isContinuous());
+
+    ImageDecoder decoder = findDecoder( buf );
+    if( !decoder )
+        return false;
+
+    String filename;
+    bool ok = setBufferSource( decoder, buf, filename ) &&
+              readImageHeader( decoder, "imdecodeHeader", filename, header );
+    decoder.release();
+    removeTempFile( filename );
+    if( !ok )
+    {
+        header = ImageHeader();
+        return false;
+    }
+
+    header.orientation = ExifOrientation( buf );
+    return true;
+}
+
+namespace {
+
+/// Decoders owned by a single thread of imreadMany/imdecodeMany.
+/// Decoders which support reading several images are created once per codec.
+struct BatchDecoders
+{
+    std::vector<ImageDecoder> reusable;
+};
+
+class ImreadManyInvoker CV_FINAL : public ParallelLoopBody
+{
+public:
+    ImreadManyInvoker( const std::vector<String>* filenames, const std::vector<Mat>* bufs,
+                       int flags, std::vector<Mat>& dst, std::vector<uchar>& status )
+        : m_filenames(filenames), m_bufs(bufs), m_flags(flags), m_dst(dst), m_status(status)
+    {
+        CV_Assert((m_filenames != 0) != (m_bufs != 0));
+    }
+
+    virtual void operator()( const Range& range ) const CV_OVERRIDE
+    {
+        BatchDecoders& cache = m_cache.getRef();
+        for( int i = range.start; i < range.end; i++ )
         {
-            if (0 != remove(filename.c_str()))
-            {
-                std::cerr << "unable to remove temporary file:" << filename << std::endl << std::flush;
-            }
+            Mat& img = m_dst[i];
+            bool ok = m_filenames ? read(cache, (*m_filenames)[i], img) : decode(cache, (*m_bufs)[i], img);
+            if( !ok )
+                img.release();
+            m_status[i] = ok;
         }
-        return 0;
     }
 
-    // established the required input image size
-    Size size = validateInputImageSize(Size(decoder->width(), decoder->height()));
-
-    int type = decoder->type();
-    if( (flags & IMREAD_LOAD_GDAL) != IMREAD_LOAD_GDAL && flags != IMREAD_UNCHANGED )
+private:
+    ImageDecoder getDecoder( BatchDecoders& cache, const String& signature ) const
     {
-        if( (flags & CV_LOAD_IMAGE_ANYDEPTH) == 0 )
-            type = CV_MAKETYPE(CV_8U, CV_MAT_CN(type));
+        int idx = findDecoderIdx(signature);
+        if( idx < 0 )
+            return ImageDecoder();
+
+        if( !codecs.decoders[idx]->isReusable() )
+            return codecs.decoders[idx]->newDecoder();
+
+        if( cache.reusable.empty() )
+            cache.reusable.resize(codecs.decoders.size());
+        if( !cache.reusable[idx] )
+            cache.reusable[idx] = codecs.decoders[idx]->newDecoder();
+        return cache.reusable[idx];
+    }
 
-        if( (flags & CV_LOAD_IMAGE_COLOR) != 0 ||
-           ((flags & CV_LOAD_IMAGE_ANYCOLOR) != 0 && CV_MAT_CN(type) > 1) )
-            type = CV_MAKETYPE(CV_MAT_DEPTH(type), 3);
+    bool read( BatchDecoders& cache, const String& filename, Mat& img ) const
+    {
+        ImageDecoder decoder;
+#ifdef HAVE_GDAL
+        if( m_flags != IMREAD_UNCHANGED && (m_flags & IMREAD_LOAD_GDAL) == IMREAD_LOAD_GDAL )
+            decoder = GdalDecoder().newDecoder();
         else
-            type = CV_MAKETYPE(CV_MAT_DEPTH(type), 1);
+#endif
+        {
+            String signature;
+            if( readSignature(filename, signature) )
+                decoder = getDecoder(cache, signature);
+        }
+        if( !decoder )
+            return false;
+
+        FileMapping mapping;
+        setFileSource( decoder, filename, m_flags, mapping );
+
+        void* hdr = 0;
+        bool ok = readImage(decoder, m_flags, reducedScale(m_flags), 0, "imreadMany", filename, LOAD_MAT, img, &hdr);
+        decoder->setSource( String() ); // don't keep the mapping in the cached decoder
+        if( !ok )
+            return false;
+
+        if( (m_flags & IMREAD_IGNORE_ORIENTATION) == 0 && m_flags != IMREAD_UNCHANGED )
+            ApplyExifOrientation(filename, img);
+        return true;
     }
 
-    if( hdrtype == LOAD_CVMAT || hdrtype == LOAD_MAT )
+    bool decode( BatchDecoders& cache, const Mat& buf, Mat& img ) const
     {
-        if( hdrtype == LOAD_CVMAT )
+        String signature;
+        ImageDecoder decoder;
+        if( buf.isContinuous() && readSignature(buf, signature) )
+            decoder = getDecoder(cache, signature);
+        if( !decoder )
+            return false;
+
+        String filename;
+        bool ok = false;
+        CV_TRY
         {
-            matrix = cvCreateMat( size.height, size.width, type );
-            temp = cvarrToMat(matrix);
+            void* hdr = 0;
+            ok = setBufferSource(decoder, buf, filename) &&
+                 readImage(decoder, m_flags, 1, 0, "imdecodeMany", filename, LOAD_MAT, img, &hdr);
         }
-        else
+        CV_CATCH (cv::Exception, e)
         {
-            mat->create( size.height, size.width, type );
-            data = mat;
+            std::cerr << "imdecodeMany: " << e.what() << std::endl << std::flush;
         }
+        removeTempFile(filename);
+
+        if( ok && (m_flags & IMREAD_IGNORE_ORIENTATION) == 0 && m_flags != IMREAD_UNCHANGED )
+            ApplyExifOrientation(buf, img);
+        return ok;
     }
-    else
+
+    const std::vector<String>* m_filenames;
+    const std::vector<Mat>* m_bufs;
+    int m_flags;
+    std::vector<Mat>& m_dst;
+    std::vector<uchar>& m_status;
+    mutable TLSData<BatchDecoders> m_cache;
+};
+
+static int imreadMany_( const std::vector<String>* filenames, const std::vector<Mat>* bufs,
+                        int flags, std::vector<Mat>& dst )
+{
+    size_t n = filenames ? filenames->size() : bufs->size();
+    CV_Assert( n <= (size_t)INT_MAX );
+    dst.resize(n);
+    if( n == 0 )
+        return 0;
+
+    std::vector<uchar> status(n, 0);
+    parallel_for_(Range(0, (int)n), ImreadManyInvoker(filenames, bufs, flags, dst, status), (double)n);
+    return countNonZero(status);
+}
+
+} // namespace
+
+int imreadMany( const std::vector<String>& filenames, int flags, std::vector<Mat>& dst )
+{
+    CV_TRACE_FUNCTION();
+
+    return imreadMany_(&filenames, 0, flags, dst);
+}
+
+int imdecodeMany( InputArrayOfArrays _bufs, int flags, std::vector<Mat>& dst )
+{
+    CV_TRACE_FUNCTION();
+
+    std::vector<Mat> bufs;
+    _bufs.getMatVector(bufs);
+    return imreadMany_(0, &bufs, flags, dst);
+}
+
+struct ImageRowReader::Impl
+{
+    Impl() : type(-1), row(0) {}
+    ~Impl()
     {
-        image = cvCreateImage(cvSize(size), cvIplDepth(type), CV_MAT_CN(type));
-        temp = cvarrToMat(image);
+        decoder.release();
+        removeTempFile(filename);
     }
 
-    success = false;
+    bool start( int flags, const char* func, const String& source );
+
+    ImageDecoder decoder;
+    FileMapping mapping; // the file passed to open with IMREAD_MMAP
+    Mat buf;         // the encoded image passed to openBuffer
+    String filename; // temporary copy of buf for the decoders reading files only
+    Size size;
+    int type;
+    int row;
+};
+
+bool ImageRowReader::Impl::start( int flags, const char* func, const String& source )
+{
+    // the rows are returned as they are decoded, so they can't be scaled or rotated
+    CV_Assert( reducedScale(flags) == 1 );
+
+    if( !readHeader( decoder, func, source ) )
+        return false;
+
+    size = validateInputImageSize(Size(decoder->width(), decoder->height()));
+    type = imreadType( decoder->type(), flags );
+
     CV_TRY
     {
-        if (decoder->readData(*data))
-            success = true;
+        if( decoder->startRows( type ) )
+            return true;
     }
     CV_CATCH (cv::Exception, e)
     {
-        std::cerr << "imdecode_('" << filename << "'): can't read data: " << e.what() << std::endl << std::flush;
+        std::cerr << func << "('" << source << "'): can't read data: " << e.what() << std::endl << std::flush;
     }
     CV_CATCH_ALL
     {
-        std::cerr << "imdecode_('" << filename << "'): can't read data: unknown exception" << std::endl << std::flush;
+        std::cerr << func << "('" << source << "'): can't read data: unknown exception" << std::endl << std::flush;
     }
-    decoder.release();
-    if (!filename.empty())
+    return false;
+}
+
+ImageRowReader::ImageRowReader()
+{
+}
+
+ImageRowReader::ImageRowReader( const String& filename, int flags )
+{
+    open( filename, flags );
+}
+
+ImageRowReader::~ImageRowReader()
+{
+}
+
+bool ImageRowReader::open( const String& filename, int flags )
+{
+    CV_TRACE_FUNCTION();
+
+    release();
+    Ptr<Impl> impl = makePtr<Impl>();
+    impl->decoder = findDecoder( filename );
+    if( !impl->decoder )
+        return false;
+
+    setFileSource( impl->decoder, filename, flags, impl->mapping );
+    if( !impl->start( flags, "ImageRowReader::open", filename ) )
+        return false;
+
+    p = impl;
+    return true;
+}
+
+bool ImageRowReader::openBuffer( InputArray _buf, int flags )
+{
+    CV_TRACE_FUNCTION();
+
+    release();
+    Ptr<Impl> impl = makePtr<Impl>();
+    impl->buf = _buf.getMat();
+    CV_Assert(!impl->buf.empty() && impl->buf.isContinuous());
+
+    impl->decoder = findDecoder( impl->buf );
+    if( !impl->decoder || !setBufferSource( impl->decoder, impl->buf, impl->filename ) )
+        return false;
+
+    if( !impl->start( flags, "ImageRowReader::openBuffer", impl->filename ) )
+        return false;
+
+    p = impl;
+    return true;
+}
+
+bool ImageRowReader::isOpened() const
+{
+    return p && p->decoder;
+}
+
+void ImageRowReader::release()
+{
+    p.release();
+}
+
+Size ImageRowReader::size() const
+{
+    return p ? p->size : Size();
+}
+
+int ImageRowReader::type() const
+{
+    return p ? p->type : -1;
+}
+
+int ImageRowReader::nextRow() const
+{
+    return p ? p->row : 0;
+}
+
+bool ImageRowReader::read( OutputArray band, int rows )
+{
+    CV_TRACE_FUNCTION();
+    CV_Assert( rows > 0 );
+
+    const int count = isOpened() ? std::min( rows, p->size.height - p->row ) : 0;
+    if( count <= 0 )
     {
-        if (0 != remove(filename.c_str()))
+        band.release();
+        return false;
+    }
+
+    band.create( count, p->size.width, p->type );
+    Mat dst = band.getMat();
+    int n = 0;
+    CV_TRY
+    {
+        n = p->decoder->readRows( dst );
+    }
+    CV_CATCH (cv::Exception, e)
+    {
+        std::cerr << "ImageRowReader::read: can't read data: " << e.what() << std::endl << std::flush;
+    }
+    CV_CATCH_ALL
+    {
+        std::cerr << "ImageRowReader::read: can't read data: unknown exception" << std::endl << std::flush;
+    }
+
+    if( n != count )
+    {
+        // the image is truncated or corrupted, the rest of it can't be read
+        p->decoder.release();
+        band.release();
+        return false;
+    }
+    p->row += count;
+    return true;
+}
+
+struct ImageCollection::Impl
+{
+    Impl() : flags(IMREAD_ANYCOLOR), page(0), consumed(false), count(-1) {}
+
+    bool rewind();
+    bool seek( int index );
+
+    ImageDecoder decoder; // at the header of page
+    String filename;
+    int flags;
+    int page;             // -1 after a failure, the decoder has to be rewound
+    bool consumed;        // the data of page is read, the decoder can only go to the next page
+    int count;            // number of pages, -1 until counted
+};
+
+bool ImageCollection::Impl::rewind()
+{
+    decoder = decoder->newDecoder();
+    decoder->setSource( filename );
+    page = 0;
+    consumed = false;
+    return readHeader( decoder, "ImageCollection", filename );
+}
+
+bool ImageCollection::Impl::seek( int index )
+{
+    if( page < 0 || index < page || (index == page && consumed) )
+    {
+        if( !rewind() )
         {
-            std::cerr << "unable to remove temporary file:" << filename << std::endl << std::flush;
+            page = -1;
+            return false;
         }
     }
-
-    if (!success)
+    bool success = true;
+    CV_TRY
     {
-        cvReleaseImage( &image );
-        cvReleaseMat( &matrix );
-        if( mat )
-            mat->release();
-        return 0;
+        for( ; success && page < index; page++ )
+        {
+            consumed = false;
+            success = decoder->nextPage();
+        }
+    }
+    CV_CATCH (cv::Exception, e)
+    {
+        std::cerr << "ImageCollection('" << filename << "'): can't read header: " << e.what() << std::endl << std::flush;
+        success = false;
+    }
+    CV_CATCH_ALL
+    {
+        std::cerr << "ImageCollection('" << filename << "'): can't read header: unknown exception" << std::endl << std::flush;
+        success = false;
     }
+    if( !success )
+        page = -1;
+    return success;
+}
+
+ImageCollection::ImageCollection()
+{
+}
 
-    return hdrtype == LOAD_CVMAT ? (void*)matrix :
-        hdrtype == LOAD_IMAGE ? (void*)image : (void*)mat;
+ImageCollection::ImageCollection( const String& filename, int flags )
+{
+    open( filename, flags );
 }
 
+ImageCollection::~ImageCollection()
+{
+}
 
-Mat imdecode( InputArray _buf, int flags )
+bool ImageCollection::open( const String& filename, int flags )
 {
     CV_TRACE_FUNCTION();
+    CV_Assert( reducedScale(flags) == 1 );
 
-    Mat buf = _buf.getMat(), img;
-    imdecode_( buf, flags, LOAD_MAT, &img );
+    release();
+    Ptr<Impl> impl = makePtr<Impl>();
+    impl->filename = filename;
+    impl->flags = flags;
+#ifdef HAVE_GDAL
+    if( flags != IMREAD_UNCHANGED && (flags & IMREAD_LOAD_GDAL) == IMREAD_LOAD_GDAL )
+        impl->decoder = GdalDecoder().newDecoder();
+    else
+#endif
+        impl->decoder = findDecoder( filename );
+    if( !impl->decoder || !impl->rewind() )
+        return false;
 
-    /// optionally rotate the data if EXIF' orientation flag says so
-    if( !img.empty() && (flags & IMREAD_IGNORE_ORIENTATION) == 0 && flags != IMREAD_UNCHANGED )
+    p = impl;
+    return true;
+}
+
+bool ImageCollection::isOpened() const
+{
+    return !p.empty();
+}
+
+void ImageCollection::release()
+{
+    p.release();
+}
+
+size_t ImageCollection::size() const
+{
+    if( !p )
+        return 0;
+    if( p->count < 0 )
     {
-        ApplyExifOrientation(buf, img);
+        ImageHeader header;
+        ImageDecoder decoder = p->decoder->newDecoder();
+        decoder->setSource( p->filename );
+        p->count = readImageHeader( decoder, "ImageCollection", p->filename, header ) ? header.pages : 0;
     }
-
-    return img;
+    return (size_t)p->count;
 }
 
-Mat imdecode( InputArray _buf, int flags, Mat* dst )
+Mat ImageCollection::at( int index )
 {
     CV_TRACE_FUNCTION();
+    CV_Assert( isOpened() && 0 <= index && index < (int)size() );
 
-    Mat buf = _buf.getMat(), img;
-    dst = dst ? dst : &img;
-    imdecode_( buf, flags, LOAD_MAT, dst );
+    Mat mat;
+    if( !p->seek( index ) )
+        return mat;
 
-    /// optionally rotate the data if EXIF' orientation flag says so
-    if( !dst->empty() && (flags & IMREAD_IGNORE_ORIENTATION) == 0 && flags != IMREAD_UNCHANGED )
+    Size size = validateInputImageSize( Size(p->decoder->width(), p->decoder->height()) );
+    mat.create( size.height, size.width, imreadType(p->decoder->type(), p->flags) );
+    p->consumed = true;
+    bool success = false;
+    CV_TRY
     {
-        ApplyExifOrientation(buf, *dst);
+        success = p->decoder->readData( mat );
+    }
+    CV_CATCH (cv::Exception, e)
+    {
+        std::cerr << "ImageCollection('" << p->filename << "'): can't read data: " << e.what() << std::endl << std::flush;
+    }
+    CV_CATCH_ALL
+    {
+        std::cerr << "ImageCollection('" << p->filename << "'): can't read data: unknown exception" << std::endl << std::flush;
+    }
+    if( !success )
+    {
+        p->page = -1;
+        return Mat();
     }
 
-    return *dst;
+    if( (p->flags & IMREAD_IGNORE_ORIENTATION) == 0 && p->flags != IMREAD_UNCHANGED )
+        ApplyExifOrientation( p->filename, mat );
+    return mat;
+}
+
+ImageCollection::iterator ImageCollection::begin()
+{
+    return iterator( this, 0 );
+}
+
+ImageCollection::iterator ImageCollection::end()
+{
+    return iterator( this, (int)size() );
+}
+
+ImageCollection::iterator::iterator() : collection(0), index(0)
+{
+}
+
+ImageCollection::iterator::iterator( ImageCollection* _collection, int _index )
+    : collection(_collection), index(_index)
+{
+}
+
+Mat ImageCollection::iterator::operator*() const
+{
+    CV_Assert( collection );
+    return collection->at( index );
+}
+
+ImageCollection::iterator& ImageCollection::iterator::operator++()
+{
+    index++;
+    return *this;
+}
+
+ImageCollection::iterator ImageCollection::iterator::operator++(int)
+{
+    iterator it = *this;
+    index++;
+    return it;
+}
+
+bool ImageCollection::iterator::operator==( const ImageCollection::iterator& other ) const
+{
+    return collection == other.collection && index == other.index;
+}
+
+bool ImageCollection::iterator::operator!=( const ImageCollection::iterator& other ) const
+{
+    return !(*this == other);
 }
 
 bool imencode( const String& ext, InputArray _image,
@@ -1004,7 +1799,7 @@ cvSaveImage( const char* filename, const CvArr* arr, const int* _params )
         for( ; _params[i] > 0; i += 2 )
             CV_Assert(i < CV_IO_MAX_IMAGE_PARAMS*2); // Limit number of params for security reasons
     }
-    return cv::imwrite_(filename, cv::cvarrToMat(arr),
+    return cv::imwrite_(filename, std::vector<cv::Mat>(1, cv::cvarrToMat(arr)),
         i > 0 ? std::vector<int>(_params, _params+i) : std::vector<int>(),
         CV_IS_IMAGE(arr) && ((const IplImage*)arr)->origin == IPL_ORIGIN_BL );
 }
@@ -101,6 +101,36 @@ static int rgbe_error(int rgbe_error_code, const char *msg)
   }
 }
 
+/* fgets from the input */
+static char *rgbe_gets(char *buf, int n, rgbe_input *in)
+{
+  int i;
+
+  if (in->fp)
+    return fgets(buf,n,in->fp);
+  if (in->pos >= in->size)
+    return NULL;
+  for(i=0;i<n-1 && in->pos < in->size;) {
+    buf[i++] = (char)in->data[in->pos++];
+    if (buf[i-1] == '\n')
+      break;
+  }
+  buf[i] = 0;
+  return buf;
+}
+
+/* read size bytes from the input, returns 1 on success like fread(ptr,size,1,fp) */
+static size_t rgbe_read(void *ptr, size_t size, rgbe_input *in)
+{
+  if (in->fp)
+    return fread(ptr,size,1,in->fp);
+  if (size > in->size - in->pos)
+    return 0;
+  memcpy(ptr,in->data + in->pos,size);
+  in->pos += size;
+  return 1;
+}
+
 /* standard conversion from float pixels to rgbe pixels */
 /* note: you can remove the "inline"s if your compiler complains about it */
 static INLINE void
@@ -168,7 +198,7 @@ int RGBE_WriteHeader(FILE *fp, int width, int height, rgbe_header_info *info)
 }
 
 /* minimal header reading.  modify if you want to parse more information */
-int RGBE_ReadHeader(FILE *fp, int *width, int *height, rgbe_header_info *info)
+int RGBE_ReadHeader(rgbe_input *in, int *width, int *height, rgbe_header_info *info)
 {
   char buf[128];
   float tempf;
@@ -181,7 +211,7 @@ int RGBE_ReadHeader(FILE *fp, int *width, int *height, rgbe_header_info *info)
   }
 
   // 1. read first line
-  if (fgets(buf,sizeof(buf)/sizeof(buf[0]),fp) == NULL)
+  if (rgbe_gets(buf,sizeof(buf)/sizeof(buf[0]),in) == NULL)
     return rgbe_error(rgbe_read_error,NULL);
   if ((buf[0] != '#')||(buf[1] != '?')) {
     /* if you want to require the magic token then uncomment the next line */
@@ -200,7 +230,7 @@ int RGBE_ReadHeader(FILE *fp, int *width, int *height, rgbe_header_info *info)
   // 2. reading other header lines
   bool hasFormat = false;
   for(;;) {
-    if (fgets(buf,sizeof(buf)/sizeof(buf[0]),fp) == 0)
+    if (rgbe_gets(buf,sizeof(buf)/sizeof(buf[0]),in) == 0)
       return rgbe_error(rgbe_read_error,NULL);
     if (buf[0] == '\n') // end of the header
       break;
@@ -224,7 +254,7 @@ int RGBE_ReadHeader(FILE *fp, int *width, int *height, rgbe_header_info *info)
       return rgbe_error(rgbe_format_error, "missing FORMAT specifier");
 
   // 3. reading resolution string
-  if (fgets(buf,sizeof(buf)/sizeof(buf[0]),fp) == 0)
+  if (rgbe_gets(buf,sizeof(buf)/sizeof(buf[0]),in) == 0)
     return rgbe_error(rgbe_read_error,NULL);
   if (sscanf(buf,"-Y %d +X %d",height,width) < 2)
     return rgbe_error(rgbe_format_error,"missing image size specifier");
@@ -249,12 +279,12 @@ int RGBE_WritePixels(FILE *fp, float *data, int numpixels)
 }
 
 /* simple read routine.  will not correctly handle run length encoding */
-int RGBE_ReadPixels(FILE *fp, float *data, int numpixels)
+int RGBE_ReadPixels(rgbe_input *in, float *data, int numpixels)
 {
   unsigned char rgbe[4];
 
   while(numpixels-- > 0) {
-    if (fread(rgbe, sizeof(rgbe), 1, fp) < 1)
+    if (rgbe_read(rgbe, sizeof(rgbe), in) < 1)
       return rgbe_error(rgbe_read_error,NULL);
     rgbe2float(&data[RGBE_DATA_RED],&data[RGBE_DATA_GREEN],
          &data[RGBE_DATA_BLUE],rgbe);
@@ -366,7 +396,7 @@ int RGBE_WritePixels_RLE(FILE *fp, float *data, int scanline_width,
   return RGBE_RETURN_SUCCESS;
 }
 
-int RGBE_ReadPixels_RLE(FILE *fp, float *data, int scanline_width,
+int RGBE_ReadPixels_RLE(rgbe_input *in, float *data, int scanline_width,
       int num_scanlines)
 {
   unsigned char rgbe[4], *scanline_buffer, *ptr, *ptr_end;
@@ -375,11 +405,11 @@ int RGBE_ReadPixels_RLE(FILE *fp, float *data, int scanline_width,
 
   if ((scanline_width < 8)||(scanline_width > 0x7fff))
     /* run length encoding is not allowed so read flat*/
-    return RGBE_ReadPixels(fp,data,scanline_width*num_scanlines);
+    return RGBE_ReadPixels(in,data,scanline_width*num_scanlines);
   scanline_buffer = NULL;
   /* read in each successive scanline */
   while(num_scanlines > 0) {
-    if (fread(rgbe,sizeof(rgbe),1,fp) < 1) {
+    if (rgbe_read(rgbe,sizeof(rgbe),in) < 1) {
       free(scanline_buffer);
       return rgbe_error(rgbe_read_error,NULL);
     }
@@ -388,7 +418,7 @@ int RGBE_ReadPixels_RLE(FILE *fp, float *data, int scanline_width,
       rgbe2float(&data[RGBE_DATA_RED],&data[RGBE_DATA_GREEN],&data[RGBE_DATA_BLUE],rgbe);
       data += RGBE_DATA_SIZE;
       free(scanline_buffer);
-      return RGBE_ReadPixels(fp,data,scanline_width*num_scanlines-1);
+      return RGBE_ReadPixels(in,data,scanline_width*num_scanlines-1);
     }
     if ((((int)rgbe[2])<<8 | rgbe[3]) != scanline_width) {
       free(scanline_buffer);
@@ -405,7 +435,7 @@ int RGBE_ReadPixels_RLE(FILE *fp, float *data, int scanline_width,
     for(i=0;i<4;i++) {
       ptr_end = &scanline_buffer[(i+1)*scanline_width];
       while(ptr < ptr_end) {
-  if (fread(buf,sizeof(buf[0])*2,1,fp) < 1) {
+  if (rgbe_read(buf,sizeof(buf[0])*2,in) < 1) {
     free(scanline_buffer);
     return rgbe_error(rgbe_read_error,NULL);
   }
@@ -428,7 +458,7 @@ int RGBE_ReadPixels_RLE(FILE *fp, float *data, int scanline_width,
     }
     *ptr++ = buf[1];
     if (--count > 0) {
-      if (fread(ptr,sizeof(*ptr)*count,1,fp) < 1) {
+      if (rgbe_read(ptr,sizeof(*ptr)*count,in) < 1) {
         free(scanline_buffer);
         return rgbe_error(rgbe_read_error,NULL);
       }
@@ -41,6 +41,9 @@
 
 #include "precomp.hpp"
 #include "utils.hpp"
+#include "opencv2/core/hal/intrin.hpp"
+
+using namespace cv;
 
 int validateToInt(size_t sz)
 {
@@ -54,6 +57,46 @@ int validateToInt(size_t sz)
 #define  cG  (int)(0.587*(1 << SCALE) + 0.5)
 #define  cB  ((1 << SCALE) - cR - cG)
 
+#if CV_SIMD
+static inline v_uint16 v_bgr2gray( const v_uint16& b, const v_uint16& g, const v_uint16& r )
+{
+    v_uint32 b0, b1, g0, g1, r0, r1;
+    v_mul_expand( b, vx_setall_u16((ushort)cB), b0, b1 );
+    v_mul_expand( g, vx_setall_u16((ushort)cG), g0, g1 );
+    v_mul_expand( r, vx_setall_u16((ushort)cR), r0, r1 );
+    return v_rshr_pack<SCALE>( b0 + g0 + r0, b1 + g1 + r1 );
+}
+
+static inline v_uint8 v_bgr2gray( const v_uint8& b, const v_uint8& g, const v_uint8& r )
+{
+    v_uint16 b0, b1, g0, g1, r0, r1;
+    v_expand( b, b0, b1 );
+    v_expand( g, g0, g1 );
+    v_expand( r, r0, r1 );
+    return v_pack( v_bgr2gray(b0, g0, r0), v_bgr2gray(b1, g1, r1) );
+}
+
+// the rgb components of bgr555 (green_mask = 0xf8, green_shift = 2)
+// or bgr565 (green_mask = 0xfc, green_shift = 3) pixels
+static inline void v_expand_bgr5x5( const ushort* src, int green_mask, int green_shift, int red_shift,
+                                    v_uint8& b, v_uint8& g, v_uint8& r )
+{
+    const v_uint16 mask = vx_setall_u16(0xf8), gmask = vx_setall_u16((ushort)green_mask);
+    v_uint16 v0 = vx_load( src ), v1 = vx_load( src + v_uint16::nlanes );
+    b = v_pack( (v0 << 3) & mask, (v1 << 3) & mask );
+    g = v_pack( (v0 >> green_shift) & gmask, (v1 >> green_shift) & gmask );
+    r = v_pack( (v0 >> red_shift) & mask, (v1 >> red_shift) & mask );
+}
+
+// c = k - ((255 - c)*k >> 8) for the 8-bit components of cmyk pixels
+static inline v_uint8 v_cmyk2rgb( const v_uint8& c, const v_uint16& k0, const v_uint16& k1 )
+{
+    v_uint16 c0, c1;
+    v_expand( vx_setall_u8(255) - c, c0, c1 );
+    return v_pack( k0 - ((c0 * k0) >> 8), k1 - ((c1 * k1) >> 8) );
+}
+#endif
+
 void icvCvt_BGR2Gray_8u_C3C1R( const uchar* rgb, int rgb_step,
                                uchar* gray, int gray_step,
                                CvSize size, int _swap_rb )
@@ -62,7 +105,16 @@ void icvCvt_BGR2Gray_8u_C3C1R( const uchar* rgb, int rgb_step,
     int swap_rb = _swap_rb ? 2 : 0;
     for( ; size.height--; gray += gray_step )
     {
-        for( i = 0; i < size.width; i++, rgb += 3 )
+        i = 0;
+#if CV_SIMD
+        for( ; i <= size.width - v_uint8::nlanes; i += v_uint8::nlanes, rgb += v_uint8::nlanes*3 )
+        {
+            v_uint8 c0, c1, c2;
+            v_load_deinterleave( rgb, c0, c1, c2 );
+            v_store( gray + i, swap_rb ? v_bgr2gray(c2, c1, c0) : v_bgr2gray(c0, c1, c2) );
+        }
+#endif
+        for( ; i < size.width; i++, rgb += 3 )
         {
             int t = descale( rgb[swap_rb]*cB + rgb[1]*cG + rgb[swap_rb^2]*cR, SCALE );
             gray[i] = (uchar)t;
@@ -81,7 +133,19 @@ void icvCvt_BGRA2Gray_16u_CnC1R( const ushort* rgb, int rgb_step,
     int swap_rb = _swap_rb ? 2 : 0;
     for( ; size.height--; gray += gray_step )
     {
-        for( i = 0; i < size.width; i++, rgb += ncn )
+        i = 0;
+#if CV_SIMD
+        for( ; i <= size.width - v_uint16::nlanes; i += v_uint16::nlanes, rgb += v_uint16::nlanes*ncn )
+        {
+            v_uint16 c0, c1, c2, c3;
+            if( ncn == 3 )
+                v_load_deinterleave( rgb, c0, c1, c2 );
+            else
+                v_load_deinterleave( rgb, c0, c1, c2, c3 );
+            v_store( gray + i, swap_rb ? v_bgr2gray(c2, c1, c0) : v_bgr2gray(c0, c1, c2) );
+        }
+#endif
+        for( ; i < size.width; i++, rgb += ncn )
         {
             int t = descale( rgb[swap_rb]*cB + rgb[1]*cG + rgb[swap_rb^2]*cR, SCALE );
             gray[i] = (ushort)t;
@@ -100,7 +164,16 @@ void icvCvt_BGRA2Gray_8u_C4C1R( const uchar* rgba, int rgba_step,
     int swap_rb = _swap_rb ? 2 : 0;
     for( ; size.height--; gray += gray_step )
     {
-        for( i = 0; i < size.width; i++, rgba += 4 )
+        i = 0;
+#if CV_SIMD
+        for( ; i <= size.width - v_uint8::nlanes; i += v_uint8::nlanes, rgba += v_uint8::nlanes*4 )
+        {
+            v_uint8 c0, c1, c2, c3;
+            v_load_deinterleave( rgba, c0, c1, c2, c3 );
+            v_store( gray + i, swap_rb ? v_bgr2gray(c2, c1, c0) : v_bgr2gray(c0, c1, c2) );
+        }
+#endif
+        for( ; i < size.width; i++, rgba += 4 )
         {
             int t = descale( rgba[swap_rb]*cB + rgba[1]*cG + rgba[swap_rb^2]*cR, SCALE );
             gray[i] = (uchar)t;
@@ -117,7 +190,15 @@ void icvCvt_Gray2BGR_8u_C1C3R( const uchar* gray, int gray_step,
     int i;
     for( ; size.height--; gray += gray_step )
     {
-        for( i = 0; i < size.width; i++, bgr += 3 )
+        i = 0;
+#if CV_SIMD
+        for( ; i <= size.width - v_uint8::nlanes; i += v_uint8::nlanes, bgr += v_uint8::nlanes*3 )
+        {
+            v_uint8 v = vx_load( gray + i );
+            v_store_interleave( bgr, v, v, v );
+        }
+#endif
+        for( ; i < size.width; i++, bgr += 3 )
         {
             bgr[0] = bgr[1] = bgr[2] = gray[i];
         }
@@ -132,7 +213,15 @@ void icvCvt_Gray2BGR_16u_C1C3R( const ushort* gray, int gray_step,
     int i;
     for( ; size.height--; gray += gray_step/sizeof(gray[0]) )
     {
-        for( i = 0; i < size.width; i++, bgr += 3 )
+        i = 0;
+#if CV_SIMD
+        for( ; i <= size.width - v_uint16::nlanes; i += v_uint16::nlanes, bgr += v_uint16::nlanes*3 )
+        {
+            v_uint16 v = vx_load( gray + i );
+            v_store_interleave( bgr, v, v, v );
+        }
+#endif
+        for( ; i < size.width; i++, bgr += 3 )
         {
             bgr[0] = bgr[1] = bgr[2] = gray[i];
         }
@@ -149,7 +238,20 @@ void icvCvt_BGRA2BGR_8u_C4C3R( const uchar* bgra, int bgra_step,
     int swap_rb = _swap_rb ? 2 : 0;
     for( ; size.height--; )
     {
-        for( i = 0; i < size.width; i++, bgr += 3, bgra += 4 )
+        i = 0;
+#if CV_SIMD
+        for( ; i <= size.width - v_uint8::nlanes; i += v_uint8::nlanes,
+             bgr += v_uint8::nlanes*3, bgra += v_uint8::nlanes*4 )
+        {
+            v_uint8 c0, c1, c2, c3;
+            v_load_deinterleave( bgra, c0, c1, c2, c3 );
+            if( swap_rb )
+                v_store_interleave( bgr, c2, c1, c0 );
+            else
+                v_store_interleave( bgr, c0, c1, c2 );
+        }
+#endif
+        for( ; i < size.width; i++, bgr += 3, bgra += 4 )
         {
             uchar t0 = bgra[swap_rb], t1 = bgra[1];
             bgr[0] = t0; bgr[1] = t1;
@@ -169,7 +271,20 @@ void icvCvt_BGRA2BGR_16u_C4C3R( const ushort* bgra, int bgra_step,
     int swap_rb = _swap_rb ? 2 : 0;
     for( ; size.height--; )
     {
-        for( i = 0; i < size.width; i++, bgr += 3, bgra += 4 )
+        i = 0;
+#if CV_SIMD
+        for( ; i <= size.width - v_uint16::nlanes; i += v_uint16::nlanes,
+             bgr += v_uint16::nlanes*3, bgra += v_uint16::nlanes*4 )
+        {
+            v_uint16 c0, c1, c2, c3;
+            v_load_deinterleave( bgra, c0, c1, c2, c3 );
+            if( swap_rb )
+                v_store_interleave( bgr, c2, c1, c0 );
+            else
+                v_store_interleave( bgr, c0, c1, c2 );
+        }
+#endif
+        for( ; i < size.width; i++, bgr += 3, bgra += 4 )
         {
             ushort t0 = bgra[swap_rb], t1 = bgra[1];
             bgr[0] = t0; bgr[1] = t1;
@@ -187,7 +302,17 @@ void icvCvt_BGRA2RGBA_8u_C4R( const uchar* bgra, int bgra_step,
     int i;
     for( ; size.height--; )
     {
-        for( i = 0; i < size.width; i++, bgra += 4, rgba += 4 )
+        i = 0;
+#if CV_SIMD
+        for( ; i <= size.width - v_uint8::nlanes; i += v_uint8::nlanes,
+             bgra += v_uint8::nlanes*4, rgba += v_uint8::nlanes*4 )
+        {
+            v_uint8 c0, c1, c2, c3;
+            v_load_deinterleave( bgra, c0, c1, c2, c3 );
+            v_store_interleave( rgba, c2, c1, c0, c3 );
+        }
+#endif
+        for( ; i < size.width; i++, bgra += 4, rgba += 4 )
         {
             uchar t0 = bgra[0], t1 = bgra[1];
             uchar t2 = bgra[2], t3 = bgra[3];
@@ -205,7 +330,17 @@ void icvCvt_BGRA2RGBA_16u_C4R( const ushort* bgra, int bgra_step,
  int i;
  for( ; size.height--; )
  {
-     for( i = 0; i < size.width; i++, bgra += 4, rgba += 4 )
+     i = 0;
+#if CV_SIMD
+     for( ; i <= size.width - v_uint16::nlanes; i += v_uint16::nlanes,
+          bgra += v_uint16::nlanes*4, rgba += v_uint16::nlanes*4 )
+     {
+         v_uint16 c0, c1, c2, c3;
+         v_load_deinterleave( bgra, c0, c1, c2, c3 );
+         v_store_interleave( rgba, c2, c1, c0, c3 );
+     }
+#endif
+     for( ; i < size.width; i++, bgra += 4, rgba += 4 )
      {
          ushort t0 = bgra[0], t1 = bgra[1];
          ushort t2 = bgra[2], t3 = bgra[3];
@@ -225,7 +360,17 @@ void icvCvt_BGR2RGB_8u_C3R( const uchar* bgr, int bgr_step,
     int i;
     for( ; size.height--; )
     {
-        for( i = 0; i < size.width; i++, bgr += 3, rgb += 3 )
+        i = 0;
+#if CV_SIMD
+        for( ; i <= size.width - v_uint8::nlanes; i += v_uint8::nlanes,
+             bgr += v_uint8::nlanes*3, rgb += v_uint8::nlanes*3 )
+        {
+            v_uint8 c0, c1, c2;
+            v_load_deinterleave( bgr, c0, c1, c2 );
+            v_store_interleave( rgb, c2, c1, c0 );
+        }
+#endif
+        for( ; i < size.width; i++, bgr += 3, rgb += 3 )
         {
             uchar t0 = bgr[0], t1 = bgr[1], t2 = bgr[2];
             rgb[2] = t0; rgb[1] = t1; rgb[0] = t2;
@@ -242,7 +387,17 @@ void icvCvt_BGR2RGB_16u_C3R( const ushort* bgr, int bgr_step,
     int i;
     for( ; size.height--; )
     {
-        for( i = 0; i < size.width; i++, bgr += 3, rgb += 3 )
+        i = 0;
+#if CV_SIMD
+        for( ; i <= size.width - v_uint16::nlanes; i += v_uint16::nlanes,
+             bgr += v_uint16::nlanes*3, rgb += v_uint16::nlanes*3 )
+        {
+            v_uint16 c0, c1, c2;
+            v_load_deinterleave( bgr, c0, c1, c2 );
+            v_store_interleave( rgb, c2, c1, c0 );
+        }
+#endif
+        for( ; i < size.width; i++, bgr += 3, rgb += 3 )
         {
             ushort t0 = bgr[0], t1 = bgr[1], t2 = bgr[2];
             rgb[2] = t0; rgb[1] = t1; rgb[0] = t2;
@@ -253,6 +408,28 @@ void icvCvt_BGR2RGB_16u_C3R( const ushort* bgr, int bgr_step,
 }
 
 
+void icvCvt_SwapBytes_16u_C1R( const ushort* src, int src_step,
+                               ushort* dst, int dst_step, CvSize size )
+{
+    int i;
+    for( ; size.height--; src += src_step/sizeof(src[0]), dst += dst_step/sizeof(dst[0]) )
+    {
+        i = 0;
+#if CV_SIMD
+        for( ; i <= size.width - v_uint16::nlanes; i += v_uint16::nlanes )
+        {
+            v_uint16 v = vx_load( src + i );
+            v_store( dst + i, (v << 8) | (v >> 8) );
+        }
+#endif
+        for( ; i < size.width; i++ )
+        {
+            dst[i] = (ushort)((src[i] << 8) | (src[i] >> 8));
+        }
+    }
+}
+
+
 typedef unsigned short ushort;
 
 void icvCvt_BGR5552Gray_8u_C2C1R( const uchar* bgr555, int bgr555_step,
@@ -261,7 +438,16 @@ void icvCvt_BGR5552Gray_8u_C2C1R( const uchar* bgr555, int bgr555_step,
     int i;
     for( ; size.height--; gray += gray_step, bgr555 += bgr555_step )
     {
-        for( i = 0; i < size.width; i++ )
+        i = 0;
+#if CV_SIMD
+        for( ; i <= size.width - v_uint8::nlanes; i += v_uint8::nlanes )
+        {
+            v_uint8 b, g, r;
+            v_expand_bgr5x5( (const ushort*)bgr555 + i, 0xf8, 2, 7, b, g, r );
+            v_store( gray + i, v_bgr2gray(b, g, r) );
+        }
+#endif
+        for( ; i < size.width; i++ )
         {
             int t = descale( ((((ushort*)bgr555)[i] << 3) & 0xf8)*cB +
                              ((((ushort*)bgr555)[i] >> 2) & 0xf8)*cG +
@@ -278,7 +464,16 @@ void icvCvt_BGR5652Gray_8u_C2C1R( const uchar* bgr565, int bgr565_step,
     int i;
     for( ; size.height--; gray += gray_step, bgr565 += bgr565_step )
     {
-        for( i = 0; i < size.width; i++ )
+        i = 0;
+#if CV_SIMD
+        for( ; i <= size.width - v_uint8::nlanes; i += v_uint8::nlanes )
+        {
+            v_uint8 b, g, r;
+            v_expand_bgr5x5( (const ushort*)bgr565 + i, 0xfc, 3, 8, b, g, r );
+            v_store( gray + i, v_bgr2gray(b, g, r) );
+        }
+#endif
+        for( ; i < size.width; i++ )
         {
             int t = descale( ((((ushort*)bgr565)[i] << 3) & 0xf8)*cB +
                              ((((ushort*)bgr565)[i] >> 3) & 0xfc)*cG +
@@ -295,7 +490,16 @@ void icvCvt_BGR5552BGR_8u_C2C3R( const uchar* bgr555, int bgr555_step,
     int i;
     for( ; size.height--; bgr555 += bgr555_step )
     {
-        for( i = 0; i < size.width; i++, bgr += 3 )
+        i = 0;
+#if CV_SIMD
+        for( ; i <= size.width - v_uint8::nlanes; i += v_uint8::nlanes, bgr += v_uint8::nlanes*3 )
+        {
+            v_uint8 b, g, r;
+            v_expand_bgr5x5( (const ushort*)bgr555 + i, 0xf8, 2, 7, b, g, r );
+            v_store_interleave( bgr, b, g, r );
+        }
+#endif
+        for( ; i < size.width; i++, bgr += 3 )
         {
             int t0 = (((ushort*)bgr555)[i] << 3) & 0xf8;
             int t1 = (((ushort*)bgr555)[i] >> 2) & 0xf8;
@@ -313,7 +517,16 @@ void icvCvt_BGR5652BGR_8u_C2C3R( const uchar* bgr565, int bgr565_step,
     int i;
     for( ; size.height--; bgr565 += bgr565_step )
     {
-        for( i = 0; i < size.width; i++, bgr += 3 )
+        i = 0;
+#if CV_SIMD
+        for( ; i <= size.width - v_uint8::nlanes; i += v_uint8::nlanes, bgr += v_uint8::nlanes*3 )
+        {
+            v_uint8 b, g, r;
+            v_expand_bgr5x5( (const ushort*)bgr565 + i, 0xfc, 3, 8, b, g, r );
+            v_store_interleave( bgr, b, g, r );
+        }
+#endif
+        for( ; i < size.width; i++, bgr += 3 )
         {
             int t0 = (((ushort*)bgr565)[i] << 3) & 0xf8;
             int t1 = (((ushort*)bgr565)[i] >> 3) & 0xfc;
@@ -331,7 +544,19 @@ void icvCvt_CMYK2BGR_8u_C4C3R( const uchar* cmyk, int cmyk_step,
     int i;
     for( ; size.height--; )
     {
-        for( i = 0; i < size.width; i++, bgr += 3, cmyk += 4 )
+        i = 0;
+#if CV_SIMD
+        for( ; i <= size.width - v_uint8::nlanes; i += v_uint8::nlanes,
+             bgr += v_uint8::nlanes*3, cmyk += v_uint8::nlanes*4 )
+        {
+            v_uint8 c, m, y, k;
+            v_uint16 k0, k1;
+            v_load_deinterleave( cmyk, c, m, y, k );
+            v_expand( k, k0, k1 );
+            v_store_interleave( bgr, v_cmyk2rgb(y, k0, k1), v_cmyk2rgb(m, k0, k1), v_cmyk2rgb(c, k0, k1) );
+        }
+#endif
+        for( ; i < size.width; i++, bgr += 3, cmyk += 4 )
         {
             int c = cmyk[0], m = cmyk[1], y = cmyk[2], k = cmyk[3];
             c = k - ((255 - c)*k>>8);
@@ -351,7 +576,18 @@ void icvCvt_CMYK2Gray_8u_C4C1R( const uchar* cmyk, int cmyk_step,
     int i;
     for( ; size.height--; )
     {
-        for( i = 0; i < size.width; i++, cmyk += 4 )
+        i = 0;
+#if CV_SIMD
+        for( ; i <= size.width - v_uint8::nlanes; i += v_uint8::nlanes, cmyk += v_uint8::nlanes*4 )
+        {
+            v_uint8 c, m, y, k;
+            v_uint16 k0, k1;
+            v_load_deinterleave( cmyk, c, m, y, k );
+            v_expand( k, k0, k1 );
+            v_store( gray + i, v_bgr2gray(v_cmyk2rgb(y, k0, k1), v_cmyk2rgb(m, k0, k1), v_cmyk2rgb(c, k0, k1)) );
+        }
+#endif
+        for( ; i < size.width; i++, cmyk += 4 )
         {
             int c = cmyk[0], m = cmyk[1], y = cmyk[2], k = cmyk[3];
             c = k - ((255 - c)*k>>8);
@@ -419,6 +655,11 @@ uchar* FillUniColor( uchar* data, uchar*& line_end,
 
         count3 -= (int)(end - data);
 
+#if CV_SIMD
+        const v_uint8 b = vx_setall_u8( clr.b ), g = vx_setall_u8( clr.g ), r = vx_setall_u8( clr.r );
+        for( ; data + v_uint8::nlanes*3 <= end; data += v_uint8::nlanes*3 )
+            v_store_interleave( data, b, g, r );
+#endif
         for( ; data < end; data += 3 )
         {
             WRITE_PIX( data, clr );
@@ -451,9 +692,10 @@ uchar* FillUniGray( uchar* data, uchar*& line_end,
 
         count -= (int)(end - data);
 
-        for( ; data < end; data++ )
+        if( data < end )
         {
-            *data = clr;
+            memset( data, clr, end - data );
+            data = end;
         }
 
         if( data >= line_end )
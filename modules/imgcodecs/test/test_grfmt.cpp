@@ -148,7 +148,7 @@ TEST_P(Imgcodecs_ExtSize, write_imageseq)
         std::vector<int> parameters;
         if (cn == 2)
             continue;
-        if (cn == 4 && ext != ".tiff")
+        if (cn == 4 && ext != ".tiff" && ext != ".qli")
             continue;
         if (cn > 1 && (ext == ".pbm" || ext == ".pgm"))
             continue;
@@ -228,6 +228,9 @@ const string all_exts[] =
 #ifdef HAVE_IMGCODEC_PFM
     ".pfm",
 #endif
+#ifdef HAVE_IMGCODEC_QLI
+    ".qli",
+#endif
 };
 
 vector<Size> all_sizes()
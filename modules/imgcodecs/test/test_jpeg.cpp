@@ -94,6 +94,32 @@ const string exif_files[] =
 INSTANTIATE_TEST_CASE_P(ExifFiles, Imgcodecs_Jpeg_Exif,
                         testing::ValuesIn(exif_files));
 
+TEST(Imgcodecs_Jpeg_Exif, read_header_orientation)
+{
+    Mat image(20, 30, CV_8UC3, Scalar(0, 255, 0));
+    vector<uchar> buf;
+    ASSERT_TRUE(imencode(".jpg", image, buf));
+
+    // APP1 segment with a little-endian TIFF header and an IFD holding Orientation = 6
+    const uchar app1[] = {
+        0xFF, 0xE1, 0x00, 0x22, 'E', 'x', 'i', 'f', 0, 0,
+        'I', 'I', 0x2A, 0x00, 0x08, 0x00, 0x00, 0x00,
+        0x01, 0x00,
+        0x12, 0x01, 0x03, 0x00, 0x01, 0x00, 0x00, 0x00, 0x06, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00
+    };
+    buf.insert(buf.begin() + 2, app1, app1 + sizeof(app1));
+
+    ImageHeader header;
+    ASSERT_TRUE(imdecodeHeader(buf, header));
+    EXPECT_EQ(image.size(), header.size);
+    EXPECT_EQ(CV_8UC3, header.type);
+    EXPECT_EQ(6, header.orientation);
+
+    Mat rotated = imdecode(buf, IMREAD_COLOR);
+    EXPECT_EQ(Size(image.rows, image.cols), rotated.size());
+}
+
 //==================================================================================================
 
 TEST(Imgcodecs_Jpeg, encode_empty)
@@ -178,6 +204,48 @@ TEST(Imgcodecs_Jpeg, encode_decode_rst_jpeg)
     EXPECT_EQ(0, remove(output_normal.c_str()));
 }
 
+TEST(Imgcodecs_Jpeg, imread_region)
+{
+    Mat img(301, 397, CV_8UC3);
+    randu(img, Scalar::all(0), Scalar::all(255));
+    GaussianBlur(img, img, Size(5, 5), 0);
+
+    string filename = cv::tempfile(".jpg");
+    ASSERT_TRUE(cv::imwrite(filename, img));
+
+    const Rect rois[] = { Rect(0, 0, 397, 301), Rect(0, 0, 20, 10), Rect(37, 101, 64, 50),
+                          Rect(350, 250, 47, 51), Rect(200, 5, 300, 20) };
+    const int modes[] = { IMREAD_COLOR, IMREAD_GRAYSCALE, IMREAD_REDUCED_COLOR_2, IMREAD_REDUCED_GRAYSCALE_4 };
+    for (size_t m = 0; m < sizeof(modes) / sizeof(modes[0]); m++)
+    {
+        const int scale = modes[m] == IMREAD_REDUCED_COLOR_2 ? 2 : modes[m] == IMREAD_REDUCED_GRAYSCALE_4 ? 4 : 1;
+        Mat full = cv::imread(filename, modes[m]);
+        ASSERT_FALSE(full.empty());
+        for (size_t i = 0; i < sizeof(rois) / sizeof(rois[0]); i++)
+        {
+            SCOPED_TRACE(cv::format("mode=%d roi=%d", modes[m], (int)i));
+            Rect r = rois[i] & Rect(0, 0, img.cols, img.rows);
+            Rect expected_roi(Point(r.x / scale, r.y / scale),
+                              Point(divUp(r.br().x, scale), divUp(r.br().y, scale)));
+            expected_roi &= Rect(0, 0, full.cols, full.rows);
+
+            Mat region = cv::imreadRegion(filename, rois[i], modes[m]);
+            ASSERT_EQ(expected_roi.size(), region.size());
+            EXPECT_LE(cvtest::norm(full(expected_roi), region, NORM_INF), 1);
+        }
+    }
+
+    EXPECT_TRUE(cv::imreadRegion(filename, Rect(400, 0, 10, 10)).empty());
+
+    std::vector<uchar> buf;
+    ASSERT_TRUE(cv::imencode(".jpg", img, buf));
+    Mat full = cv::imdecode(buf, IMREAD_COLOR);
+    Mat region = cv::imdecodeRegion(buf, Rect(100, 200, 50, 60), IMREAD_COLOR);
+    EXPECT_LE(cvtest::norm(full(Rect(100, 200, 50, 60)), region, NORM_INF), 1);
+
+    EXPECT_EQ(0, remove(filename.c_str()));
+}
+
 #endif // HAVE_JPEG
 
 }} // namespace
@@ -93,6 +93,43 @@ TEST(Imgcodecs_Png, read_color_palette_with_alpha)
     EXPECT_EQ(img.at<Vec3b>(0, 1), Vec3b(0, 0, 255));
 }
 
+typedef testing::TestWithParam<int> Imgcodecs_Png_Threads;
+
+TEST_P(Imgcodecs_Png_Threads, encode)
+{
+    const int type = GetParam();
+    Mat img(300, 377, type);
+    randu(img, Scalar::all(0), Scalar::all(CV_MAT_DEPTH(type) == CV_8U ? 255 : 65535));
+    GaussianBlur(img, img, Size(7, 7), 0); // compressible data
+
+    const int levels[] = { -1, 0, 6, 9 };
+    for (size_t i = 0; i < sizeof(levels) / sizeof(levels[0]); i++)
+    {
+        SCOPED_TRACE(cv::format("level=%d", levels[i]));
+        vector<int> params;
+        if (levels[i] >= 0)
+        {
+            params.push_back(IMWRITE_PNG_COMPRESSION);
+            params.push_back(levels[i]);
+        }
+        vector<uchar> serial;
+        ASSERT_TRUE(imencode(".png", img, serial, params));
+
+        params.push_back(IMWRITE_THREADS);
+        params.push_back(4);
+        vector<uchar> parallel;
+        ASSERT_TRUE(imencode(".png", img, parallel, params));
+
+        EXPECT_PRED_FORMAT2(cvtest::MatComparator(0, 0), img, imdecode(parallel, IMREAD_UNCHANGED));
+        if (levels[i] != 0)
+        {
+            EXPECT_LT(parallel.size(), serial.size() * 11 / 10);
+        }
+    }
+}
+
+INSTANTIATE_TEST_CASE_P(/**/, Imgcodecs_Png_Threads, testing::Values(CV_8UC1, CV_8UC3, CV_8UC4, CV_16UC1, CV_16UC3));
+
 #endif // HAVE_PNG
 
 }} // namespace
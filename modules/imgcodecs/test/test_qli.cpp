@@ -0,0 +1,140 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html
+#include "test_precomp.hpp"
+
+namespace opencv_test { namespace {
+
+#ifdef HAVE_IMGCODEC_QLI
+
+// Smooth gradients with noise, flat areas and a few repeated colors, to use all the operations
+static Mat makeQliImage(const Size& size, int type)
+{
+    const int depth = CV_MAT_DEPTH(type), cn = CV_MAT_CN(type);
+    const int maxVal = depth == CV_8U ? 255 : 65535, scale = depth == CV_8U ? 1 : 37;
+    Mat img(size, type), noise(size, type);
+    for (int y = 0; y < size.height; y++)
+        for (int x = 0; x < size.width; x++)
+            for (int c = 0; c < cn; c++)
+            {
+                // the alpha channel is opaque
+                int v = c == 3 ? maxVal : ((x * 7 + y * 3 + c * 40) % 256) * scale;
+                if (depth == CV_8U)
+                    img.ptr<uchar>(y)[x * cn + c] = saturate_cast<uchar>(v);
+                else
+                    img.ptr<ushort>(y)[x * cn + c] = saturate_cast<ushort>(v);
+            }
+    RNG rng(size.area() + type);
+    const int amplitude = depth == CV_8U ? 4 : 16;
+    rng.fill(noise, RNG::UNIFORM, Scalar::all(0), Scalar(amplitude, amplitude, amplitude, 0));
+    cv::add(img, noise, img);
+    img(Rect(0, 0, size.width / 2, size.height / 3)).setTo(Scalar::all(maxVal / 3));
+    Mat strip = img.row(size.height / 2).clone();
+    strip.copyTo(img.row(size.height - 1));
+    return img;
+}
+
+typedef tuple<perf::MatDepth, int, Size> Qli_Params;
+typedef testing::TestWithParam<Qli_Params> Imgcodecs_Qli_Types;
+
+TEST_P(Imgcodecs_Qli_Types, encode_decode)
+{
+    const int type = CV_MAKETYPE(get<0>(GetParam()), get<1>(GetParam()));
+    const Mat img = makeQliImage(get<2>(GetParam()), type);
+
+    std::vector<uchar> buf;
+    ASSERT_TRUE(imencode(".qli", img, buf));
+    if (img.total() > 1000)
+    {
+        EXPECT_LT(buf.size(), img.total() * img.elemSize());
+    }
+
+    Mat decoded = imdecode(buf, IMREAD_UNCHANGED);
+    EXPECT_PRED_FORMAT2(cvtest::MatComparator(0, 0), img, decoded);
+
+    // the output does not depend on the number of threads
+    std::vector<uchar> buf1;
+    std::vector<int> params;
+    params.push_back(IMWRITE_THREADS);
+    params.push_back(1);
+    ASSERT_TRUE(imencode(".qli", img, buf1, params));
+    EXPECT_TRUE(buf == buf1);
+
+    const string filename = cv::tempfile(".qli");
+    ASSERT_TRUE(imwrite(filename, img));
+    EXPECT_PRED_FORMAT2(cvtest::MatComparator(0, 0), img, imread(filename, IMREAD_UNCHANGED));
+    EXPECT_EQ(0, remove(filename.c_str()));
+}
+
+INSTANTIATE_TEST_CASE_P(/**/, Imgcodecs_Qli_Types,
+                        testing::Combine(
+                            testing::Values(CV_8U, CV_16U),
+                            testing::Values(1, 3, 4),
+                            testing::Values(Size(1, 1), Size(67, 3), Size(320, 1000))));
+
+TEST(Imgcodecs_Qli, convert_on_read)
+{
+    const Mat img = makeQliImage(Size(97, 61), CV_16UC4);
+    std::vector<uchar> buf;
+    ASSERT_TRUE(imencode(".qli", img, buf));
+
+    Mat img8u, expected;
+    img.convertTo(img8u, CV_8U, 1. / 256);
+
+    cvtColor(img8u, expected, COLOR_BGRA2BGR);
+    EXPECT_PRED_FORMAT2(cvtest::MatComparator(0, 0), expected, imdecode(buf, IMREAD_COLOR));
+    cvtColor(img8u, expected, COLOR_BGRA2GRAY);
+    EXPECT_PRED_FORMAT2(cvtest::MatComparator(0, 0), expected, imdecode(buf, IMREAD_GRAYSCALE));
+    cvtColor(img, expected, COLOR_BGRA2BGR);
+    EXPECT_PRED_FORMAT2(cvtest::MatComparator(0, 0), expected, imdecode(buf, IMREAD_COLOR | IMREAD_ANYDEPTH));
+}
+
+TEST(Imgcodecs_Qli, corrupted)
+{
+    const Mat img = makeQliImage(Size(320, 1000), CV_8UC3);
+    std::vector<uchar> buf;
+    ASSERT_TRUE(imencode(".qli", img, buf));
+
+    std::vector<uchar> truncated(buf.begin(), buf.begin() + buf.size() / 2);
+    EXPECT_TRUE(imdecode(truncated, IMREAD_UNCHANGED).empty());
+
+    std::vector<uchar> header(buf.begin(), buf.begin() + 20);
+    EXPECT_TRUE(imdecode(header, IMREAD_UNCHANGED).empty());
+
+    // a reserved operation at the start of the first group of a 3-channel image
+    const int rowsPerGroup = (buf[16] << 24) | (buf[17] << 16) | (buf[18] << 8) | buf[19];
+    const int groups = (img.rows + rowsPerGroup - 1) / rowsPerGroup;
+    std::vector<uchar> invalid = buf;
+    invalid[20 + groups * 4] = 0xfe;
+    EXPECT_TRUE(imdecode(invalid, IMREAD_UNCHANGED).empty());
+
+    std::vector<uchar> wrongChannels = buf;
+    wrongChannels[12] = 5;
+    EXPECT_TRUE(imdecode(wrongChannels, IMREAD_UNCHANGED).empty());
+
+    // rows per group close to INT_MAX, read as a single group
+    std::vector<uchar> hugeGroups = buf;
+    hugeGroups[16] = 0x7f;
+    hugeGroups[17] = hugeGroups[18] = hugeGroups[19] = 0xff;
+    EXPECT_NO_THROW(imdecode(hugeGroups, IMREAD_UNCHANGED));
+
+    // a group size larger than the file is rejected before allocating it
+    std::vector<uchar> hugeSize = buf;
+    hugeSize[20] = hugeSize[21] = hugeSize[22] = hugeSize[23] = 0xff;
+    EXPECT_TRUE(imdecode(hugeSize, IMREAD_UNCHANGED).empty());
+    const string filename = cv::tempfile(".qli");
+    for (int i = 0; i < 2; i++)
+    {
+        const std::vector<uchar>& content = i == 0 ? hugeSize : truncated;
+        FILE* f = fopen(filename.c_str(), "wb");
+        ASSERT_TRUE(f != NULL);
+        ASSERT_EQ(content.size(), fwrite(&content[0], 1, content.size(), f));
+        fclose(f);
+        EXPECT_TRUE(imread(filename, IMREAD_UNCHANGED).empty()) << i;
+    }
+    EXPECT_EQ(0, remove(filename.c_str()));
+}
+
+#endif // HAVE_IMGCODEC_QLI
+
+}} // namespace
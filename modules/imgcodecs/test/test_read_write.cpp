@@ -152,4 +152,441 @@ TEST(Imgcodecs_Image, write_umat)
     EXPECT_EQ(0, remove(dst_name.c_str()));
 }
 
+//==================================================================================================
+
+static vector<vector<uchar> > encodeBatch(vector<Mat>& images)
+{
+    const string batch_exts[] = {
+#ifdef HAVE_PNG
+        ".png",
+#endif
+#ifdef HAVE_JPEG
+        ".jpg",
+#endif
+        ".bmp"
+    };
+    const int N = 8;
+
+    vector<vector<uchar> > bufs(N);
+    images.resize(N);
+    for (int i = 0; i < N; i++)
+    {
+        images[i].create(32 + 8 * i, 48, CV_8UC3);
+        randu(images[i], Scalar::all(0), Scalar::all(255));
+        EXPECT_TRUE(imencode(batch_exts[i % (sizeof(batch_exts) / sizeof(batch_exts[0]))], images[i], bufs[i]));
+    }
+    // Not an image at all
+    bufs.push_back(vector<uchar>(100, (uchar)'x'));
+    return bufs;
+}
+
+TEST(Imgcodecs_Image, imdecodeMany)
+{
+    vector<Mat> images;
+    vector<vector<uchar> > bufs = encodeBatch(images);
+
+    vector<Mat> decoded;
+    EXPECT_EQ((int)images.size(), imdecodeMany(bufs, IMREAD_COLOR, decoded));
+    ASSERT_EQ(bufs.size(), decoded.size());
+    for (size_t i = 0; i < images.size(); i++)
+    {
+        Mat expected = imdecode(bufs[i], IMREAD_COLOR);
+        EXPECT_PRED_FORMAT2(cvtest::MatComparator(0, 0), expected, decoded[i]);
+    }
+    EXPECT_TRUE(decoded.back().empty());
+
+    // Matrices of the same size and type are reused
+    vector<const uchar*> ptrs;
+    for (size_t i = 0; i < images.size(); i++) ptrs.push_back(decoded[i].data);
+    EXPECT_EQ((int)images.size(), imdecodeMany(bufs, IMREAD_COLOR, decoded));
+    for (size_t i = 0; i < images.size(); i++) EXPECT_EQ(ptrs[i], decoded[i].data);
+
+    vector<Mat> gray;
+    EXPECT_EQ((int)images.size(), imdecodeMany(bufs, IMREAD_GRAYSCALE, gray));
+    for (size_t i = 0; i < images.size(); i++)
+    {
+        Mat expected = imdecode(bufs[i], IMREAD_GRAYSCALE);
+        EXPECT_PRED_FORMAT2(cvtest::MatComparator(0, 0), expected, gray[i]);
+    }
+}
+
+TEST(Imgcodecs_Image, imreadMany)
+{
+    vector<Mat> images;
+    vector<vector<uchar> > bufs = encodeBatch(images);
+
+    vector<string> filenames;
+    for (size_t i = 0; i < bufs.size(); i++)
+    {
+        filenames.push_back(cv::tempfile());
+        FILE *f = fopen(filenames.back().c_str(), "wb");
+        ASSERT_TRUE(f != NULL);
+        EXPECT_EQ(bufs[i].size(), fwrite(&bufs[i][0], 1, bufs[i].size(), f));
+        fclose(f);
+    }
+    filenames.push_back(cv::tempfile()); // doesn't exist
+
+    vector<Mat> loaded;
+    EXPECT_EQ((int)images.size(), imreadMany(filenames, IMREAD_UNCHANGED, loaded));
+    ASSERT_EQ(filenames.size(), loaded.size());
+    for (size_t i = 0; i < images.size(); i++)
+    {
+        Mat expected = imread(filenames[i], IMREAD_UNCHANGED);
+        EXPECT_PRED_FORMAT2(cvtest::MatComparator(0, 0), expected, loaded[i]);
+    }
+    EXPECT_TRUE(loaded[loaded.size() - 2].empty());
+    EXPECT_TRUE(loaded.back().empty());
+
+    for (size_t i = 0; i + 1 < filenames.size(); i++)
+        EXPECT_EQ(0, remove(filenames[i].c_str()));
+}
+
+TEST(Imgcodecs_Image, read_mmap)
+{
+    const string batch_exts[] = {
+#ifdef HAVE_PNG
+        ".png",
+#endif
+#ifdef HAVE_TIFF
+        ".tiff",
+#endif
+#ifdef HAVE_JPEG
+        ".jpg",
+#endif
+        ".bmp",
+#ifdef HAVE_IMGCODEC_PXM
+        ".ppm",
+#endif
+#ifdef HAVE_IMGCODEC_SUNRASTER
+        ".ras",
+#endif
+#ifdef HAVE_IMGCODEC_PFM
+        ".pfm",
+#endif
+#ifdef HAVE_IMGCODEC_HDR
+        ".hdr",
+#endif
+    };
+    Mat image(45, 67, CV_8UC3);
+    randu(image, Scalar::all(0), Scalar::all(255));
+    for (size_t i = 0; i < sizeof(batch_exts) / sizeof(batch_exts[0]); i++)
+    {
+        const string ext = batch_exts[i];
+        SCOPED_TRACE(ext);
+        Mat src = image;
+        if (ext == ".pfm" || ext == ".hdr")
+            image.convertTo(src, CV_32F, 1 / 255.0);
+        const string filename = cv::tempfile(ext.c_str());
+        ASSERT_TRUE(imwrite(filename, src));
+
+        const int flags = ext == ".pfm" || ext == ".hdr" ? IMREAD_ANYDEPTH | IMREAD_COLOR : IMREAD_COLOR;
+        Mat expected = imread(filename, flags);
+        ASSERT_FALSE(expected.empty());
+        EXPECT_PRED_FORMAT2(cvtest::MatComparator(0, 0), expected, imread(filename, flags | IMREAD_MMAP));
+
+        vector<uchar> buf;
+        ASSERT_TRUE(imencode(ext, src, buf));
+        EXPECT_PRED_FORMAT2(cvtest::MatComparator(0, 0), expected, imdecode(buf, flags));
+
+        vector<Mat> images;
+        vector<String> filenames(1, filename);
+        EXPECT_EQ(1, imreadMany(filenames, flags | IMREAD_MMAP, images));
+        ASSERT_EQ(1u, images.size());
+        EXPECT_PRED_FORMAT2(cvtest::MatComparator(0, 0), expected, images[0]);
+
+        {
+            ImageRowReader reader(filename, flags | IMREAD_MMAP);
+            Mat band;
+            ASSERT_TRUE(reader.read(band, expected.rows));
+            EXPECT_PRED_FORMAT2(cvtest::MatComparator(0, 0), expected, band);
+        }
+
+        EXPECT_EQ(0, remove(filename.c_str()));
+    }
+}
+
+TEST(Imgcodecs_Image, read_header)
+{
+    const string batch_exts[] = {
+#ifdef HAVE_PNG
+        ".png",
+#endif
+#ifdef HAVE_TIFF
+        ".tiff",
+#endif
+#ifdef HAVE_JPEG
+        ".jpg",
+#endif
+        ".bmp",
+#ifdef HAVE_IMGCODEC_PXM
+        ".pgm",
+#endif
+#ifdef HAVE_IMGCODEC_PFM
+        ".pfm",
+#endif
+#ifdef HAVE_IMGCODEC_HDR
+        ".hdr",
+#endif
+    };
+    for (size_t i = 0; i < sizeof(batch_exts) / sizeof(batch_exts[0]); i++)
+    {
+        const string ext = batch_exts[i];
+        SCOPED_TRACE(ext);
+        const int type = ext == ".pfm" || ext == ".hdr" ? CV_32FC3 : ext == ".pgm" ? CV_8UC1 : CV_8UC3;
+        Mat image(31, 52, type, Scalar::all(1));
+        vector<uchar> buf;
+        ASSERT_TRUE(imencode(ext, image, buf));
+        Mat expected = imdecode(buf, IMREAD_UNCHANGED);
+
+        ImageHeader header;
+        ASSERT_TRUE(imdecodeHeader(buf, header));
+        EXPECT_EQ(expected.size(), header.size);
+        EXPECT_EQ(expected.type(), header.type);
+        EXPECT_EQ(1, header.pages);
+        EXPECT_EQ(1, header.orientation);
+
+        const string filename = cv::tempfile(ext.c_str());
+        ASSERT_TRUE(imwrite(filename, image));
+        ImageHeader fileHeader;
+        ASSERT_TRUE(imreadHeader(filename, fileHeader));
+        EXPECT_EQ(header.size, fileHeader.size);
+        EXPECT_EQ(header.type, fileHeader.type);
+        EXPECT_EQ(1, fileHeader.pages);
+        EXPECT_EQ(0, remove(filename.c_str()));
+    }
+}
+
+#ifdef HAVE_TIFF
+TEST(Imgcodecs_Image, read_header_pages)
+{
+    vector<Mat> pages;
+    pages.push_back(Mat(10, 20, CV_8UC3, Scalar::all(1)));
+    pages.push_back(Mat(30, 40, CV_16UC1, Scalar::all(2)));
+    pages.push_back(Mat(50, 60, CV_8UC1, Scalar::all(3)));
+    const string filename = cv::tempfile(".tiff");
+    ASSERT_TRUE(imwrite(filename, pages));
+
+    ImageHeader header;
+    ASSERT_TRUE(imreadHeader(filename, header));
+    EXPECT_EQ(Size(20, 10), header.size);
+    EXPECT_EQ(CV_8UC3, header.type);
+    EXPECT_EQ(3, header.pages);
+    EXPECT_EQ(0, remove(filename.c_str()));
+}
+#endif
+
+TEST(Imgcodecs_Image, read_header_invalid)
+{
+    ImageHeader header;
+    vector<uchar> buf(100, (uchar)'x');
+    EXPECT_FALSE(imdecodeHeader(buf, header));
+    EXPECT_EQ(-1, header.type);
+    EXPECT_FALSE(imreadHeader(cv::tempfile(".png"), header));
+    EXPECT_EQ(Size(), header.size);
+}
+
+TEST(Imgcodecs_Image, ImageCollection_single_page)
+{
+    Mat image(17, 23, CV_8UC3);
+    randu(image, Scalar::all(0), Scalar::all(255));
+    const string filename = cv::tempfile(".bmp");
+    ASSERT_TRUE(imwrite(filename, image));
+    {
+        ImageCollection collection(filename, IMREAD_COLOR);
+        ASSERT_EQ(1u, collection.size());
+        EXPECT_PRED_FORMAT2(cvtest::MatComparator(0, 0), image, collection[0]);
+        EXPECT_PRED_FORMAT2(cvtest::MatComparator(0, 0), image, *collection.begin());
+        EXPECT_TRUE(++collection.begin() == collection.end());
+    }
+    EXPECT_EQ(0, remove(filename.c_str()));
+
+    ImageCollection missing;
+    EXPECT_FALSE(missing.open(filename));
+    EXPECT_FALSE(missing.isOpened());
+    EXPECT_EQ(0u, missing.size());
+    EXPECT_TRUE(missing.begin() == missing.end());
+}
+
+TEST(Imgcodecs_Image, decode_color_conversions)
+{
+    // widths around the vector sizes, to check both the vector loops and the tails
+    for (int width = 1; width <= 70; width += 3)
+    {
+        SCOPED_TRACE(cv::format("width=%d", width));
+        Mat bgr(3, width, CV_8UC3), bgra(3, width, CV_8UC4), gray(3, width, CV_8UC1);
+        randu(bgr, Scalar::all(0), Scalar::all(255));
+        randu(bgra, Scalar::all(0), Scalar::all(255));
+        randu(gray, Scalar::all(0), Scalar::all(255));
+        Mat expected;
+        vector<uchar> encoded;
+
+        cvtColor(bgr, expected, COLOR_BGR2GRAY);
+        ASSERT_TRUE(imencode(".bmp", bgr, encoded));
+        EXPECT_PRED_FORMAT2(cvtest::MatComparator(1, 0), expected, imdecode(encoded, IMREAD_GRAYSCALE));
+
+        cvtColor(bgra, expected, COLOR_BGRA2GRAY);
+        ASSERT_TRUE(imencode(".bmp", bgra, encoded));
+        EXPECT_PRED_FORMAT2(cvtest::MatComparator(1, 0), expected, imdecode(encoded, IMREAD_GRAYSCALE));
+        cvtColor(bgra, expected, COLOR_BGRA2BGR);
+        EXPECT_PRED_FORMAT2(cvtest::MatComparator(0, 0), expected, imdecode(encoded, IMREAD_COLOR));
+
+        cvtColor(gray, expected, COLOR_GRAY2BGR);
+        ASSERT_TRUE(imencode(".bmp", gray, encoded));
+        EXPECT_PRED_FORMAT2(cvtest::MatComparator(0, 0), expected, imdecode(encoded, IMREAD_COLOR));
+
+#ifdef HAVE_IMGCODEC_PXM
+        Mat bgr16, gray16;
+        bgr.convertTo(bgr16, CV_16U, 257);
+        gray.convertTo(gray16, CV_16U, 257);
+        ASSERT_TRUE(imencode(".ppm", bgr16, encoded));
+        EXPECT_PRED_FORMAT2(cvtest::MatComparator(0, 0), bgr16, imdecode(encoded, IMREAD_UNCHANGED));
+        cvtColor(bgr16, expected, COLOR_BGR2GRAY);
+        EXPECT_PRED_FORMAT2(cvtest::MatComparator(1, 0), expected, imdecode(encoded, IMREAD_GRAYSCALE | IMREAD_ANYDEPTH));
+        ASSERT_TRUE(imencode(".pgm", gray16, encoded));
+        EXPECT_PRED_FORMAT2(cvtest::MatComparator(0, 0), gray16, imdecode(encoded, IMREAD_UNCHANGED));
+        cvtColor(gray16, expected, COLOR_GRAY2BGR);
+        EXPECT_PRED_FORMAT2(cvtest::MatComparator(0, 0), expected, imdecode(encoded, IMREAD_COLOR | IMREAD_ANYDEPTH));
+#endif
+    }
+}
+
+TEST(Imgcodecs_Image, decode_bmp_rle8)
+{
+    // runs shorter and longer than the vector sizes, filled by FillUniColor and FillUniGray
+    const int width = 70, height = 3;
+    Mat palette(1, 256, CV_8UC3);
+    for (int i = 0; i < 256; i++)
+        palette.at<Vec3b>(i) = Vec3b((uchar)i, (uchar)(255 - i), (uchar)(i * 7));
+    Mat expected(height, width, CV_8UC3);
+    vector<uchar> pixels;
+    for (int k = 0; k < height; k++)
+    {
+        // the rows are stored bottom-up
+        const int run = 3 + 25 * k, y = height - 1 - k;
+        expected.row(y).colRange(0, run).setTo(palette.at<Vec3b>(k + 1));
+        expected.row(y).colRange(run, width).setTo(palette.at<Vec3b>(k + 10));
+        const uchar row[] = { (uchar)run, (uchar)(k + 1), (uchar)(width - run), (uchar)(k + 10), 0, 0 };
+        pixels.insert(pixels.end(), row, row + sizeof(row));
+    }
+    pixels.push_back(0);
+    pixels.push_back(1); // end of the bitmap
+
+    const int offset = 14 + 40 + 256 * 4, size = offset + (int)pixels.size();
+    const int header[] = { size, 0, offset, 40, width, height, 1 | (8 << 16), 1 /* BI_RLE8 */,
+                           (int)pixels.size(), 0, 0, 256, 0 };
+    vector<uchar> buf;
+    buf.push_back('B');
+    buf.push_back('M');
+    for (size_t i = 0; i < sizeof(header) / sizeof(header[0]); i++)
+        for (int b = 0; b < 4; b++)
+            buf.push_back((uchar)(header[i] >> (b * 8)));
+    for (int i = 0; i < 256; i++)
+    {
+        const Vec3b c = palette.at<Vec3b>(i);
+        const uchar entry[] = { c[0], c[1], c[2], 0 };
+        buf.insert(buf.end(), entry, entry + 4);
+    }
+    buf.insert(buf.end(), pixels.begin(), pixels.end());
+    ASSERT_EQ((size_t)size, buf.size());
+
+    EXPECT_PRED_FORMAT2(cvtest::MatComparator(0, 0), expected, imdecode(buf, IMREAD_COLOR));
+    Mat gray;
+    cvtColor(expected, gray, COLOR_BGR2GRAY);
+    EXPECT_PRED_FORMAT2(cvtest::MatComparator(1, 0), gray, imdecode(buf, IMREAD_GRAYSCALE));
+}
+
+//==================================================================================================
+
+typedef testing::TestWithParam<Ext> Imgcodecs_ImageRowReader;
+
+TEST_P(Imgcodecs_ImageRowReader, read_bands)
+{
+    const string ext = "." + GetParam();
+    Mat image(97, 61, CV_8UC3);
+    randu(image, Scalar::all(0), Scalar::all(255));
+    GaussianBlur(image, image, Size(5, 5), 0);
+    vector<uchar> buf;
+    ASSERT_TRUE(imencode(ext, image, buf));
+
+    const int flags[] = { IMREAD_COLOR, IMREAD_GRAYSCALE, IMREAD_UNCHANGED };
+    for (size_t i = 0; i < sizeof(flags) / sizeof(flags[0]); i++)
+    {
+        SCOPED_TRACE(cv::format("flags=%d", flags[i]));
+        Mat expected = imdecode(buf, flags[i]);
+        ASSERT_FALSE(expected.empty());
+
+        ImageRowReader reader;
+        ASSERT_TRUE(reader.openBuffer(buf, flags[i]));
+        EXPECT_EQ(expected.size(), reader.size());
+        EXPECT_EQ(expected.type(), reader.type());
+
+        Mat band, decoded;
+        while (reader.read(band, 13))
+        {
+            EXPECT_EQ(expected.cols, band.cols);
+            EXPECT_EQ(decoded.rows + band.rows, reader.nextRow());
+            decoded.push_back(band);
+        }
+        EXPECT_TRUE(reader.isOpened());
+        EXPECT_EQ(expected.rows, reader.nextRow());
+        EXPECT_PRED_FORMAT2(cvtest::MatComparator(0, 0), expected, decoded);
+    }
+
+    const string filename = cv::tempfile(ext.c_str());
+    ASSERT_TRUE(imwrite(filename, image));
+    {
+        ImageRowReader reader(filename);
+        ASSERT_TRUE(reader.isOpened());
+        Mat band;
+        ASSERT_TRUE(reader.read(band, 1000));
+        EXPECT_PRED_FORMAT2(cvtest::MatComparator(0, 0), imread(filename), band);
+        EXPECT_FALSE(reader.read(band, 1));
+        EXPECT_TRUE(band.empty());
+    }
+    EXPECT_EQ(0, remove(filename.c_str()));
+}
+
+INSTANTIATE_TEST_CASE_P(imgcodecs, Imgcodecs_ImageRowReader, testing::ValuesIn(exts));
+
+TEST(Imgcodecs_ImageRowReader, read_bands_16u)
+{
+    const string batch_exts[] = {
+#ifdef HAVE_PNG
+        ".png",
+#endif
+#ifdef HAVE_TIFF
+        ".tiff",
+#endif
+        ".ppm"
+    };
+    Mat image(64, 35, CV_16UC3);
+    randu(image, Scalar::all(0), Scalar::all(65535));
+    for (size_t i = 0; i < sizeof(batch_exts) / sizeof(batch_exts[0]); i++)
+    {
+        SCOPED_TRACE(batch_exts[i]);
+        vector<uchar> buf;
+        ASSERT_TRUE(imencode(batch_exts[i], image, buf));
+
+        ImageRowReader reader;
+        ASSERT_TRUE(reader.openBuffer(buf, IMREAD_UNCHANGED));
+        Mat band, decoded;
+        while (reader.read(band, 10))
+            decoded.push_back(band);
+        EXPECT_PRED_FORMAT2(cvtest::MatComparator(0, 0), image, decoded);
+    }
+}
+
+TEST(Imgcodecs_ImageRowReader, invalid)
+{
+    ImageRowReader reader;
+    EXPECT_FALSE(reader.isOpened());
+    Mat band;
+    EXPECT_FALSE(reader.read(band, 1));
+
+    vector<uchar> buf(100, (uchar)'x');
+    EXPECT_FALSE(reader.openBuffer(buf));
+    EXPECT_FALSE(reader.open(cv::tempfile(".png")));
+    EXPECT_FALSE(reader.isOpened());
+}
+
 }} // namespace
@@ -251,6 +251,267 @@ TEST(Imgcodecs_Tiff, imdecode_no_exception_temporary_file_removed)
     EXPECT_NO_THROW(cv::imdecode(buf, IMREAD_UNCHANGED));
 }
 
+//==================================================================================================
+
+typedef testing::TestWithParam<int> Imgcodecs_Tiff_Region;
+
+TEST_P(Imgcodecs_Tiff_Region, imread_region)
+{
+    const int type = GetParam();
+    Mat img(123, 217, type);
+    randu(img, Scalar::all(0), Scalar::all(CV_MAT_DEPTH(type) == CV_8U ? 255 : 65535));
+
+    std::vector<uchar> buf;
+    ASSERT_TRUE(cv::imencode(".tiff", img, buf));
+    string filename = cv::tempfile(".tiff");
+    FILE* f = fopen(filename.c_str(), "wb");
+    ASSERT_TRUE(f != NULL);
+    ASSERT_EQ(buf.size(), fwrite(&buf[0], 1, buf.size(), f));
+    fclose(f);
+
+    const Rect rois[] = { Rect(0, 0, 217, 123), Rect(0, 0, 1, 1), Rect(15, 40, 100, 33),
+                          Rect(200, 100, 50, 50), Rect(-10, 60, 300, 1) };
+    for (size_t i = 0; i < sizeof(rois) / sizeof(rois[0]); i++)
+    {
+        SCOPED_TRACE(cv::format("roi=%d", (int)i));
+        Rect r = rois[i] & Rect(0, 0, img.cols, img.rows);
+        EXPECT_PRED_FORMAT2(cvtest::MatComparator(0, 0), img(r),
+                            cv::imreadRegion(filename, rois[i], IMREAD_UNCHANGED));
+        EXPECT_PRED_FORMAT2(cvtest::MatComparator(0, 0), img(r),
+                            cv::imdecodeRegion(buf, rois[i], IMREAD_UNCHANGED));
+    }
+
+    EXPECT_TRUE(cv::imreadRegion(filename, Rect(0, 123, 10, 10), IMREAD_UNCHANGED).empty());
+    EXPECT_EQ(0, remove(filename.c_str()));
+}
+
+// Writes an uncompressed little-endian tiled TIFF (imwrite produces strips only)
+static std::vector<uchar> encodeTiledTiff(const Mat& bgr, int tile_width, int tile_height)
+{
+    CV_Assert(bgr.channels() == 1 || bgr.channels() == 3);
+    Mat img;
+    if (bgr.channels() == 3)
+        cvtColor(bgr, img, COLOR_BGR2RGB);
+    else
+        img = bgr;
+
+    const int cn = img.channels(), esz = (int)img.elemSize1();
+    const int tiles_x = (img.cols + tile_width - 1) / tile_width;
+    const int tiles_y = (img.rows + tile_height - 1) / tile_height;
+    const int ntiles = tiles_x * tiles_y;
+    const int tile_size = tile_width * tile_height * cn * esz;
+
+    std::vector<uchar> buf(8, 0);
+    buf[0] = buf[1] = 'I'; buf[2] = 42;
+    // image data, tiles padded with zeros
+    for (int ty = 0; ty < tiles_y; ty++)
+        for (int tx = 0; tx < tiles_x; tx++)
+        {
+            size_t pos = buf.size();
+            buf.resize(pos + tile_size, 0);
+            Rect r = Rect(tx * tile_width, ty * tile_height, tile_width, tile_height) & Rect(0, 0, img.cols, img.rows);
+            for (int y = 0; y < r.height; y++)
+                memcpy(&buf[pos + y * tile_width * cn * esz], img.ptr(r.y + y, r.x), r.width * cn * esz);
+        }
+
+    struct Writer
+    {
+        std::vector<uchar>& b;
+        void put16(size_t pos, int v) { b[pos] = (uchar)v; b[pos + 1] = (uchar)(v >> 8); }
+        void put32(size_t pos, int v) { put16(pos, v & 0xffff); put16(pos + 2, (v >> 16) & 0xffff); }
+        size_t append(size_t n) { size_t pos = b.size(); b.resize(pos + n, 0); return pos; }
+    } w = { buf };
+
+    const size_t bps_pos = w.append(2 * cn);
+    for (int c = 0; c < cn; c++)
+        w.put16(bps_pos + 2 * c, esz * 8);
+    const size_t offsets_pos = w.append(4 * ntiles), counts_pos = w.append(4 * ntiles);
+    for (int i = 0; i < ntiles; i++)
+    {
+        w.put32(offsets_pos + 4 * i, 8 + i * tile_size);
+        w.put32(counts_pos + 4 * i, tile_size);
+    }
+
+    const int SHORT = 3, LONG = 4;
+    const int entries[][4] = {
+        { 256, LONG, 1, img.cols },                       // ImageWidth
+        { 257, LONG, 1, img.rows },                       // ImageLength
+        { 258, SHORT, cn, cn == 1 ? esz * 8 : (int)bps_pos }, // BitsPerSample
+        { 259, SHORT, 1, 1 },                             // Compression: none
+        { 262, SHORT, 1, cn == 1 ? 1 : 2 },               // Photometric: min-is-black, RGB
+        { 277, SHORT, 1, cn },                            // SamplesPerPixel
+        { 284, SHORT, 1, 1 },                             // PlanarConfiguration: contiguous
+        { 322, LONG, 1, tile_width },                     // TileWidth
+        { 323, LONG, 1, tile_height },                    // TileLength
+        { 324, LONG, ntiles, (int)offsets_pos },          // TileOffsets
+        { 325, LONG, ntiles, (int)counts_pos }            // TileByteCounts
+    };
+    const int nentries = (int)(sizeof(entries) / sizeof(entries[0]));
+    const size_t ifd_pos = w.append(2 + 12 * nentries + 4);
+    w.put32(4, (int)ifd_pos);
+    w.put16(ifd_pos, nentries);
+    for (int i = 0; i < nentries; i++)
+    {
+        size_t pos = ifd_pos + 2 + 12 * i;
+        w.put16(pos, entries[i][0]);
+        w.put16(pos + 2, entries[i][1]);
+        w.put32(pos + 4, entries[i][2]);
+        if (entries[i][1] == SHORT && entries[i][2] == 1)
+            w.put16(pos + 8, entries[i][3]);
+        else
+            w.put32(pos + 8, entries[i][3]);
+    }
+    return buf;
+}
+
+TEST_P(Imgcodecs_Tiff_Region, imread_region_tiled)
+{
+    const int type = GetParam();
+    if (CV_MAT_CN(type) == 4)
+        throw SkipTestException("");
+    Mat img(123, 217, type);
+    randu(img, Scalar::all(0), Scalar::all(CV_MAT_DEPTH(type) == CV_8U ? 255 : 65535));
+
+    // 7 x 8 tiles, the last column and row are partial
+    std::vector<uchar> buf = encodeTiledTiff(img, 32, 16);
+    ASSERT_PRED_FORMAT2(cvtest::MatComparator(0, 0), img, cv::imdecode(buf, IMREAD_UNCHANGED));
+
+    const Rect rois[] = { Rect(0, 0, 217, 123), Rect(0, 0, 1, 1), Rect(31, 15, 2, 2),
+                          Rect(15, 40, 100, 33), Rect(200, 100, 50, 50), Rect(64, 16, 32, 16),
+                          Rect(-10, 60, 300, 1), Rect(190, -5, 3, 200) };
+    for (size_t i = 0; i < sizeof(rois) / sizeof(rois[0]); i++)
+    {
+        SCOPED_TRACE(cv::format("roi=%d", (int)i));
+        Rect r = rois[i] & Rect(0, 0, img.cols, img.rows);
+        EXPECT_PRED_FORMAT2(cvtest::MatComparator(0, 0), img(r),
+                            cv::imdecodeRegion(buf, rois[i], IMREAD_UNCHANGED));
+    }
+}
+
+INSTANTIATE_TEST_CASE_P(AllTypes, Imgcodecs_Tiff_Region,
+                        testing::Values(CV_8UC1, CV_8UC3, CV_8UC4, CV_16UC1, CV_16UC3, CV_16UC4));
+
+TEST(Imgcodecs_Tiff, imread_region_32FC1)
+{
+    Mat img(97, 61, CV_32FC1);
+    randu(img, Scalar::all(-1000), Scalar::all(1000));
+
+    std::vector<int> params;
+    params.push_back(TIFFTAG_ROWSPERSTRIP);
+    params.push_back(10);
+    std::vector<uchar> buf;
+    ASSERT_TRUE(cv::imencode(".tiff", img, buf, params));
+
+    const Rect rois[] = { Rect(0, 0, 61, 97), Rect(5, 9, 10, 2), Rect(30, 50, 100, 100) };
+    for (size_t i = 0; i < sizeof(rois) / sizeof(rois[0]); i++)
+    {
+        SCOPED_TRACE(cv::format("roi=%d", (int)i));
+        Rect r = rois[i] & Rect(0, 0, img.cols, img.rows);
+        EXPECT_PRED_FORMAT2(cvtest::MatComparator(0, 0), img(r),
+                            cv::imdecodeRegion(buf, rois[i], IMREAD_UNCHANGED));
+    }
+}
+
+TEST(Imgcodecs_Tiff, ImageRowReader_strips)
+{
+    const int types[] = { CV_8UC3, CV_16UC1 };
+    const int rows_per_strip[] = { 97, 10, 1 }; // a single strip, shorter and longer than the bands
+    const int band_rows[] = { 1, 7, 10, 23, 200 };
+    for (size_t t = 0; t < sizeof(types) / sizeof(types[0]); t++)
+    {
+        Mat img(97, 61, types[t]);
+        randu(img, Scalar::all(0), Scalar::all(CV_MAT_DEPTH(types[t]) == CV_8U ? 255 : 65535));
+        for (size_t s = 0; s < sizeof(rows_per_strip) / sizeof(rows_per_strip[0]); s++)
+        {
+            std::vector<int> params;
+            params.push_back(TIFFTAG_ROWSPERSTRIP);
+            params.push_back(rows_per_strip[s]);
+            std::vector<uchar> buf;
+            ASSERT_TRUE(cv::imencode(".tiff", img, buf, params));
+            for (size_t b = 0; b < sizeof(band_rows) / sizeof(band_rows[0]); b++)
+            {
+                SCOPED_TRACE(cv::format("type=%d rows_per_strip=%d band=%d", types[t], rows_per_strip[s], band_rows[b]));
+                ImageRowReader reader;
+                ASSERT_TRUE(reader.openBuffer(buf, IMREAD_UNCHANGED));
+                Mat band, decoded;
+                while (reader.read(band, band_rows[b]))
+                {
+                    EXPECT_EQ(std::min(band_rows[b], img.rows - decoded.rows), band.rows);
+                    decoded.push_back(band);
+                }
+                EXPECT_PRED_FORMAT2(cvtest::MatComparator(0, 0), img, decoded);
+            }
+        }
+    }
+}
+
+TEST(Imgcodecs_Tiff, ImageCollection)
+{
+    vector<Mat> pages;
+    for (int i = 0; i < 5; i++)
+    {
+        Mat page(20 + i, 30 - i, i % 2 ? CV_8UC3 : CV_8UC1);
+        randu(page, Scalar::all(0), Scalar::all(255));
+        pages.push_back(page);
+    }
+    const string filename = cv::tempfile(".tiff");
+    ASSERT_TRUE(imwrite(filename, pages));
+    {
+        ImageCollection collection(filename, IMREAD_UNCHANGED);
+        ASSERT_TRUE(collection.isOpened());
+        ASSERT_EQ(pages.size(), collection.size());
+
+        int i = 0;
+        for (ImageCollection::iterator it = collection.begin(); it != collection.end(); ++it, i++)
+            EXPECT_PRED_FORMAT2(cvtest::MatComparator(0, 0), pages[i], *it);
+        EXPECT_EQ(5, i);
+
+        // random access, backwards and repeated
+        const int order[] = { 3, 3, 1, 4, 0, 2 };
+        for (size_t k = 0; k < sizeof(order) / sizeof(order[0]); k++)
+        {
+            SCOPED_TRACE(cv::format("page=%d", order[k]));
+            EXPECT_PRED_FORMAT2(cvtest::MatComparator(0, 0), pages[order[k]], collection[order[k]]);
+        }
+        EXPECT_THROW(collection.at(5), cv::Exception);
+
+        ImageCollection color(filename, IMREAD_COLOR);
+        EXPECT_EQ(CV_8UC3, color.at(0).type());
+    }
+    EXPECT_EQ(0, remove(filename.c_str()));
+}
+
+typedef testing::TestWithParam<int> Imgcodecs_Tiff_Threads;
+
+TEST_P(Imgcodecs_Tiff_Threads, encode)
+{
+    const int type = GetParam();
+    Mat img(300, 377, type);
+    randu(img, Scalar::all(0), Scalar::all(CV_MAT_DEPTH(type) == CV_8U ? 255 : 65535));
+
+    const int compressions[] = { COMPRESSION_LZW, COMPRESSION_ADOBE_DEFLATE, COMPRESSION_NONE };
+    for (size_t i = 0; i < sizeof(compressions) / sizeof(compressions[0]); i++)
+    {
+        SCOPED_TRACE(cv::format("compression=%d", compressions[i]));
+        vector<int> params;
+        params.push_back(TIFFTAG_COMPRESSION);
+        params.push_back(compressions[i]);
+        vector<uchar> serial;
+        ASSERT_TRUE(imencode(".tiff", img, serial, params));
+
+        params.push_back(IMWRITE_THREADS);
+        params.push_back(4);
+        vector<uchar> parallel;
+        ASSERT_TRUE(imencode(".tiff", img, parallel, params));
+
+        // the same strips are written in the same order
+        EXPECT_EQ(serial, parallel);
+        EXPECT_PRED_FORMAT2(cvtest::MatComparator(0, 0), img, imdecode(parallel, IMREAD_UNCHANGED));
+    }
+}
+
+INSTANTIATE_TEST_CASE_P(/**/, Imgcodecs_Tiff_Threads, testing::Values(CV_8UC1, CV_8UC3, CV_16UC1, CV_16UC4));
+
 #endif
 
 }} // namespace
@@ -170,6 +170,14 @@ enum VideoCaptureProperties {
        CAP_PROP_SAR_NUM       =40, //!< Sample aspect ratio: num/den (num)
        CAP_PROP_SAR_DEN       =41, //!< Sample aspect ratio: num/den (den)
        CAP_PROP_BACKEND       =42, //!< current backend (enum VideoCaptureAPIs). Read-only property
+       CAP_PROP_READAHEAD_FRAMES =43, //!< Number of frames grabbed and retrieved ahead on a background thread, 0 (default) to grab and retrieve them in VideoCapture::grab() and VideoCapture::retrieve(). Changing it or setting another property (but the position) stops the thread: a video file is sought back to the frame after the last one read, the frames already read ahead from a live source are dropped
+       CAP_PROP_READAHEAD_POLICY =44, //!< What the background thread does when CAP_PROP_READAHEAD_FRAMES frames are waiting (enum VideoCaptureReadAheadPolicies)
+       CAP_PROP_CODEC_PIXEL_FORMAT =45, //!< (read-only) Pixel format of the decoded frames as 4-character code, e.g. NV12, I420 or Y42B, -1 if the format has no code. With CAP_PROP_CONVERT_RGB set to false the FFmpeg backend retrieves the planes of GREY, NV12 and I420 frames (Y in channel 0, UV or U and V in the next ones) without conversion, as views valid until the next grab. Frames of the other formats are still converted to BGR
+       CAP_PROP_KEYFRAME_INDEX =46, //!< (FFmpeg) Keyframe index of the video file: 0 (default) none, 1 built by reading through the packets of the file (not decoding them), 2 also saved next to the file (its name with ".keyframes" appended) and loaded from it while the file doesn't change. With the index CAP_PROP_POS_FRAMES seeks to the keyframe before the frame directly and CAP_PROP_FRAME_COUNT is exact. Setting it fails for the streams
+       CAP_PROP_V4L_MEMORY    =47, //!< (V4L2) Memory of the device buffers and how the frames are retrieved from them (enum VideoCaptureV4LMemory). Setting it restarts the streaming
+       CAP_PROP_PREFETCH_FRAMES =48, //!< (Image sequences) Number of the next images decoded ahead in parallel, 0 (default) to decode every image in VideoCapture::grab(). Seeking with CAP_PROP_POS_FRAMES to one of these images doesn't decode it again
+       CAP_PROP_MJPEG_DECODER =49, //!< (Built-in MJPEG backend) JPEG decoder of the frames (enum VideoCaptureMJPEGDecoders)
+       CAP_PROP_NEXT_KEYFRAME =50, //!< (FFmpeg) With CAP_PROP_KEYFRAME_INDEX: setting it to a frame number looks up the first keyframe at or after that frame, getting it returns the number of this keyframe (CAP_PROP_FRAME_COUNT if there is none). The position doesn't change
 #ifndef CV_DOXYGEN
        CV__CAP_PROP_LATEST
 #endif
@@ -186,13 +194,48 @@ enum VideoCaptureModes {
        CAP_MODE_YUYV = 3  //!< YUYV
      };
 
+/** @brief Policies of the background thread reading frames ahead when its queue is full.
+@sa CAP_PROP_READAHEAD_FRAMES, CAP_PROP_READAHEAD_POLICY
+*/
+enum VideoCaptureReadAheadPolicies {
+       CAP_READAHEAD_BLOCK       = 0, //!< Wait until the application reads a frame (default, no frame is lost)
+       CAP_READAHEAD_DROP_OLDEST = 1  //!< Drop the oldest waiting frame, keeping the latency low for live streams
+     };
+
+/** @brief Memory of the V4L2 device buffers.
+
+With CAP_V4L_MEMORY_MMAP and CAP_V4L_MEMORY_USERPTR a grabbed frame stays in its device buffer.
+With CAP_PROP_CONVERT_RGB set to false the retrieved Mat wraps that buffer instead of a copy,
+and the buffer goes back to the device when the last Mat referring to it is released, even
+after the capture is released. Such Mats shouldn't be kept for long: the device fills
+CAP_PROP_BUFFERSIZE buffers at most, and grab() waits while it has none.
+@sa CAP_PROP_V4L_MEMORY, VideoCapture::setBuffers()
+*/
+enum VideoCaptureV4LMemory {
+       CAP_V4L_MEMORY_COPY    = 0, //!< Memory mapped buffers, the frames are copied or converted out of them (default)
+       CAP_V4L_MEMORY_MMAP    = 1, //!< Memory mapped buffers, holding the frames until they are retrieved or released
+       CAP_V4L_MEMORY_USERPTR = 2  //!< Buffers in the memory of the application, the Mats given to VideoCapture::setBuffers() or allocated by the capture
+     };
+
+/** @brief JPEG decoders of the built-in MJPEG backend, see CAP_PROP_MJPEG_DECODER.
+
+The built-in decoder decodes the restart intervals of a frame in parallel. Without restart intervals
+(as in the streams of the built-in writer) or with one thread it is slower than libjpeg-turbo.
+*/
+enum VideoCaptureMJPEGDecoders {
+       CAP_MJPEG_DECODER_AUTO     = 0, //!< The built-in decoder for the frames with restart intervals if cv::getNumThreads() > 1, cv::imdecode otherwise (default)
+       CAP_MJPEG_DECODER_BUILTIN  = 1, //!< The built-in decoder for the baseline frames, cv::imdecode for the others
+       CAP_MJPEG_DECODER_IMDECODE = 2  //!< cv::imdecode for every frame
+     };
+
 /** @brief %VideoWriter generic properties identifier.
  @sa VideoWriter::get(), VideoWriter::set()
 */
 enum VideoWriterProperties {
   VIDEOWRITER_PROP_QUALITY = 1,    //!< Current quality (0..100%) of the encoded videostream. Can be adjusted dynamically in some codecs.
   VIDEOWRITER_PROP_FRAMEBYTES = 2, //!< (Read-only): Size of just encoded video frame. Note that the encoding order may be different from representation order.
-  VIDEOWRITER_PROP_NSTRIPES = 3    //!< Number of stripes for parallel encoding. -1 for auto detection.
+  VIDEOWRITER_PROP_NSTRIPES = 3,   //!< Number of stripes for parallel encoding. -1 for auto detection.
+  VIDEOWRITER_PROP_ASYNC_FRAMES = 4 //!< Number of frames queued for a background thread converting and encoding them, 0 (default) to encode them in VideoWriter::write(). write() waits when the queue is full
 };
 
 //! @} videoio_flags_base
@@ -809,12 +852,70 @@ public:
     */
     CV_WRAP virtual bool open(const String& filename, int apiPreference);
 
+    /** @brief Opens a video file for decoding it with several instances of the backend in parallel
+
+    @param filename name of the video file
+    @param apiPreference preferred Capture API backends to use, see cv::VideoCaptureAPIs. The
+    backend has to report CAP_PROP_FRAME_COUNT and to seek with CAP_PROP_POS_FRAMES
+    @param decoders number of backend instances opened on the file, each decoding on its own thread
+    @param ordered `true` to read the frames in order, `false` to read them as they are decoded
+    @param partFrames minimum number of frames an instance decodes after a seek, 0 for the
+    default: 64 frames when ordered with a keyframe index, an equal part of the file for each
+    instance otherwise
+    @return `true` if the file has been opened by all the instances
+
+    The frames are split into parts and the instances decode every @p decoders -th part in turn.
+    When the backend builds a keyframe index (CAP_PROP_KEYFRAME_INDEX) the parts start on
+    keyframes, at least @p partFrames frames apart. Otherwise they are @p partFrames frames long
+    and each part starts with a seek which decodes from the keyframe before it, so longer parts
+    spend less on seeking.
+
+    The instances queue the decoded frames: ordered, up to 64 frames each, so this reorder
+    buffer holds at most `64*decoders` frames. An instance with a full queue waits for the
+    frames before its own to be read, so ordered the instances decode at most 64 frames ahead
+    of the reader. Unordered, the number of the frame read last is
+    `get(CAP_PROP_POS_FRAMES) - 1`. The capture can't seek.
+
+    The method first calls VideoCapture::release to close the already opened file or camera.
+    */
+    CV_WRAP bool openSegments(const String& filename, int apiPreference, int decoders,
+                              bool ordered = true, int partFrames = 0);
+
+    /** @brief Gives the capture the buffers the device fills with the frames
+
+    @param buffers continuous Mats of at least the size of the device frames, up to 10 of them
+    are used
+    @return `true` if the streaming restarted with these buffers
+
+    Supported by the V4L2 backend, which switches to CAP_V4L_MEMORY_USERPTR. The buffers are
+    shared with the device for as long as the capture uses them: with CAP_PROP_CONVERT_RGB set
+    to false the retrieved frames wrap them, see cv::VideoCaptureV4LMemory. Empty @p buffers
+    let the capture allocate them.
+    */
+    CV_WRAP bool setBuffers(InputArrayOfArrays buffers);
+
     /** @brief Returns used backend API name
 
      @note Stream should be opened.
      */
     CV_WRAP String getBackendName() const;
 
+    /** @brief Waits until any of the streams has a frame and grabs the frames which are ready.
+
+    @param streams opened video streams
+    @param readyIndex indexes of the streams with a grabbed frame, to fetch with VideoCapture::retrieve()
+    @param timeoutNs maximal time to wait in nanoseconds, 0 to wait without limit
+    @return `true` if a frame was grabbed, `false` on timeout or if the grabbing failed for all
+    the streams (e.g. at their end)
+
+    The primary use of the function is to serve many cameras from one thread. The file descriptors
+    of the V4L cameras and of the streams with CAP_PROP_READAHEAD_FRAMES set are waited on
+    together. The other streams, e.g. the FFmpeg ones without read-ahead, are considered always
+    ready: the function doesn't wait then and grab() may block on them.
+     */
+    static bool waitAny(const std::vector<VideoCapture>& streams, CV_OUT std::vector<int>& readyIndex,
+                        int64 timeoutNs = 0);
+
 protected:
     Ptr<CvCapture> cap;
     Ptr<IVideoCapture> icap;
@@ -0,0 +1,37 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#ifndef OPENCV_VIDEOIO_CAPTURE_SOURCE_PRIVATE_HPP
+#define OPENCV_VIDEOIO_CAPTURE_SOURCE_PRIVATE_HPP
+
+#ifndef __OPENCV_BUILD
+#  error this is a private header which should not be used from outside of the OpenCV library
+#endif
+
+#include "opencv2/videoio.hpp"
+
+namespace cv
+{
+
+/** Frames of a backend implemented outside of the library, such as the fake devices of the
+tests. The wrappers of the captures (CAP_PROP_READAHEAD_FRAMES) are applied to it as to the
+built-in backends.
+*/
+class CV_EXPORTS VideoCaptureSource
+{
+public:
+    virtual ~VideoCaptureSource() {}
+    virtual double get(int) const { return 0; }
+    virtual bool set(int, double) { return false; }
+    virtual bool grab() = 0;
+    virtual bool retrieve(int channel, OutputArray image) = 0;
+};
+
+/** Backend of the source, for a VideoCapture subclass to set as its capture
+*/
+CV_EXPORTS Ptr<IVideoCapture> createSourceCapture(const Ptr<VideoCaptureSource>& source);
+
+} // namespace cv
+
+#endif // OPENCV_VIDEOIO_CAPTURE_SOURCE_PRIVATE_HPP
@@ -0,0 +1,97 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html
+#include "perf_precomp.hpp"
+#include "opencv2/imgcodecs.hpp"
+#include "opencv2/imgproc.hpp"
+#include "opencv2/videoio/container_avi.private.hpp"
+
+namespace opencv_test
+{
+using namespace perf;
+
+// The built-in JPEG decoder of the MJPEG backend against cv::imdecode, on frames with and
+// without restart intervals
+
+static const int frame_count = 30;
+
+static Mat mjpegFrame(int i, Size size)
+{
+    Mat img(size, CV_8UC3), noise(size, CV_8UC3);
+    for (int y = 0; y < size.height; y++)
+    {
+        Vec3b* row = img.ptr<Vec3b>(y);
+        for (int x = 0; x < size.width; x++)
+            row[x] = Vec3b((uchar)(x * 255 / size.width), (uchar)(y * 255 / size.height), (uchar)(i * 8));
+    }
+    circle(img, Point(size.width / 4 + i * 10, size.height / 2), size.height / 6, Scalar(0, 0, 255), -1);
+    RNG rng(i);
+    rng.fill(noise, RNG::UNIFORM, 0, 16);
+    img += noise;
+    return img;
+}
+
+// Encodes the frames with imencode, as the restart interval can't be set on the built-in writer
+static string writeMjpegAvi(Size size, int restart_interval)
+{
+    std::vector<int> params;
+    params.push_back(IMWRITE_JPEG_QUALITY);
+    params.push_back(90);
+    params.push_back(IMWRITE_JPEG_RST_INTERVAL);
+    params.push_back(restart_interval);
+
+    const string filename = cv::tempfile(".avi");
+    AVIWriteContainer out;
+    if (!out.initContainer(filename, 25, size, true))
+        throw SkipTestException("can't write " + filename);
+    out.startWriteAVI(1);
+    out.writeStreamHeader(MJPEG);
+    for (int i = 0; i < frame_count; i++)
+    {
+        std::vector<uchar> jpeg;
+        CV_Assert(imencode(".jpg", mjpegFrame(i, size), jpeg, params));
+        size_t chunkPointer = out.getStreamPos();
+        out.startWriteChunk(out.getAVIIndex(0, dc));
+        out.putStreamBytes(&jpeg[0], (int)jpeg.size());
+        for (size_t pos = jpeg.size(); pos % 4 != 0; pos++)
+            out.putStreamByte(0);
+        out.pushFrameOffset(chunkPointer - out.getMoviPointer());
+        out.pushFrameSize(out.getStreamPos() - chunkPointer - 8);
+        out.endWriteChunk();
+    }
+    out.endWriteChunk(); // end LIST 'movi'
+    out.writeIndex(0, dc);
+    out.finishWriteAVI();
+    return filename;
+}
+
+CV_ENUM(MJPEGDecoder, CAP_MJPEG_DECODER_BUILTIN, CAP_MJPEG_DECODER_IMDECODE, CAP_MJPEG_DECODER_AUTO)
+
+typedef tuple<MJPEGDecoder, int, Size> VideoIO_MJPEG_Decoder_t;
+typedef perf::TestBaseWithParam<VideoIO_MJPEG_Decoder_t> VideoIO_MJPEG_Decoder;
+
+PERF_TEST_P(VideoIO_MJPEG_Decoder, read,
+            testing::Combine(MJPEGDecoder::all(), testing::Values(0, 8), testing::Values(sz720p, sz1080p)))
+{
+    const int decoder = get<0>(GetParam());
+    const int restart_interval = get<1>(GetParam());
+    const Size size = get<2>(GetParam());
+    const string filename = writeMjpegAvi(size, restart_interval);
+
+    VideoCapture cap(filename, CAP_OPENCV_MJPEG);
+    ASSERT_TRUE(cap.isOpened());
+    ASSERT_TRUE(cap.set(CAP_PROP_MJPEG_DECODER, decoder));
+
+    Mat img;
+    TEST_CYCLE_N(frame_count)
+    {
+        ASSERT_TRUE(cap.read(img));
+    }
+    ASSERT_EQ(size, img.size());
+
+    cap.release();
+    remove(filename.c_str());
+    SANITY_CHECK_NOTHING();
+}
+
+} // namespace
@@ -0,0 +1,228 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html
+#include "perf_precomp.hpp"
+#include "opencv2/imgproc.hpp"
+
+#include <ctime>
+
+namespace opencv_test
+{
+using namespace perf;
+
+// Throughput of the backends on synthetic videos written by their own writers. Next to the
+// wall time per frame of the perf statistics, the tests record the frames per second and the
+// CPU time per frame of the whole process, which includes the decoding and encoding threads.
+
+struct VideoCodec
+{
+    const char* name;
+    VideoCaptureAPIs api;
+    char fourcc[5];
+    const char* extension;
+};
+
+static const VideoCodec codecs[] = {
+    { "MJPEG", CAP_OPENCV_MJPEG, "MJPG", ".avi" },
+#ifdef HAVE_FFMPEG
+    { "FFmpeg_H264", CAP_FFMPEG, "avc1", ".mp4" },
+    { "FFmpeg_MPEG4", CAP_FFMPEG, "mp4v", ".mp4" },
+#endif
+};
+
+static const int frame_count = 60;
+
+static const VideoCodec& findCodec(const string& name)
+{
+    for (size_t i = 0; i < sizeof(codecs) / sizeof(codecs[0]); i++)
+        if (name == codecs[i].name)
+            return codecs[i];
+    CV_Error(Error::StsBadArg, name);
+}
+
+static std::vector<string> codecNames()
+{
+    std::vector<string> names;
+    for (size_t i = 0; i < sizeof(codecs) / sizeof(codecs[0]); i++)
+        names.push_back(codecs[i].name);
+    return names;
+}
+
+// Moving shapes over a gradient with some noise, so that neither the intra nor the inter
+// prediction of the codecs is trivial
+static Mat syntheticFrame(int i, Size size)
+{
+    Mat img(size, CV_8UC3);
+    for (int y = 0; y < size.height; y++)
+    {
+        Vec3b* row = img.ptr<Vec3b>(y);
+        for (int x = 0; x < size.width; x++)
+            row[x] = Vec3b((uchar)(x * 255 / size.width), (uchar)(y * 255 / size.height), (uchar)(i * 4));
+    }
+    const int r = size.height / 8;
+    const Point center(r + (i * size.width / frame_count) % (size.width - 2 * r), size.height / 2);
+    circle(img, center, r, Scalar(0, 0, 255), -1, LINE_AA);
+    rectangle(img, Rect(size.width - center.x - r, size.height / 4 - r / 2, 2 * r, r), Scalar(255, 255, 0), -1);
+    Mat noise(size, CV_8UC3);
+    RNG rng(i);
+    rng.fill(noise, RNG::UNIFORM, 0, 16);
+    img += noise;
+    return img;
+}
+
+static std::vector<Mat> syntheticFrames(Size size)
+{
+    std::vector<Mat> frames;
+    for (int i = 0; i < frame_count; i++)
+        frames.push_back(syntheticFrame(i, size));
+    return frames;
+}
+
+// Writes the synthetic video, skips the test if the backend can't encode it
+static string writeSyntheticVideo(const VideoCodec& codec, Size size)
+{
+    const string filename = cv::tempfile(codec.extension);
+    const int fourcc = VideoWriter::fourcc(codec.fourcc[0], codec.fourcc[1], codec.fourcc[2], codec.fourcc[3]);
+    VideoWriter writer(filename, codec.api, fourcc, 30, size);
+    if (!writer.isOpened())
+        throw SkipTestException(cv::format("%s can't encode %s", codec.name, codec.fourcc));
+    for (int i = 0; i < frame_count; i++)
+        writer << syntheticFrame(i, size);
+    return filename;
+}
+
+static VideoCapture openSyntheticVideo(const VideoCodec& codec, const string& filename)
+{
+    VideoCapture cap(filename, codec.api);
+    if (!cap.isOpened())
+    {
+        remove(filename.c_str());
+        throw SkipTestException(cv::format("%s can't decode %s", codec.name, codec.fourcc));
+    }
+    return cap;
+}
+
+// Measures the wall and the CPU time of the frames processed in a test cycle
+class FrameTimer
+{
+public:
+    FrameTimer() : frames_(0), wall_(getTickCount()), cpu_(std::clock()) {}
+
+    void frame() { frames_++; }
+
+    void report() const
+    {
+        if (frames_ == 0)
+            return;
+        const double wall = (getTickCount() - wall_) / getTickFrequency();
+        const double cpu = (double)(std::clock() - cpu_) / CLOCKS_PER_SEC;
+        ::testing::Test::RecordProperty("frames_per_second", cv::format("%.1f", frames_ / wall).c_str());
+        ::testing::Test::RecordProperty("cpu_ms_per_frame", cv::format("%.3f", cpu * 1000 / frames_).c_str());
+    }
+
+private:
+    int frames_;
+    int64 wall_;
+    std::clock_t cpu_;
+};
+
+typedef tuple<string, Size> VideoIO_Throughput_t;
+typedef perf::TestBaseWithParam<VideoIO_Throughput_t> VideoIO_Throughput;
+
+#define VIDEOIO_THROUGHPUT_PARAMS \
+    testing::Combine(testing::ValuesIn(codecNames()), testing::Values(szVGA, sz720p, sz1080p))
+
+PERF_TEST_P(VideoIO_Throughput, write, VIDEOIO_THROUGHPUT_PARAMS)
+{
+    const VideoCodec& codec = findCodec(get<0>(GetParam()));
+    const Size size = get<1>(GetParam());
+    const std::vector<Mat> frames = syntheticFrames(size);
+    const string filename = cv::tempfile(codec.extension);
+    const int fourcc = VideoWriter::fourcc(codec.fourcc[0], codec.fourcc[1], codec.fourcc[2], codec.fourcc[3]);
+    VideoWriter writer(filename, codec.api, fourcc, 30, size);
+    if (!writer.isOpened())
+        throw SkipTestException(cv::format("%s can't encode %s", codec.name, codec.fourcc));
+
+    int i = 0;
+    FrameTimer timer;
+    TEST_CYCLE_N(frame_count)
+    {
+        writer << frames[i++ % frame_count];
+        timer.frame();
+    }
+    // the encoder may buffer frames
+    writer.release();
+    timer.report();
+
+    remove(filename.c_str());
+    SANITY_CHECK_NOTHING();
+}
+
+PERF_TEST_P(VideoIO_Throughput, read, VIDEOIO_THROUGHPUT_PARAMS)
+{
+    const VideoCodec& codec = findCodec(get<0>(GetParam()));
+    const Size size = get<1>(GetParam());
+    const string filename = writeSyntheticVideo(codec, size);
+    VideoCapture cap = openSyntheticVideo(codec, filename);
+
+    Mat img;
+    FrameTimer timer;
+    TEST_CYCLE_N(frame_count)
+    {
+        ASSERT_TRUE(cap.read(img));
+        timer.frame();
+    }
+    timer.report();
+    EXPECT_EQ(size, img.size());
+
+    remove(filename.c_str());
+    SANITY_CHECK_NOTHING();
+}
+
+PERF_TEST_P(VideoIO_Throughput, read_convert, VIDEOIO_THROUGHPUT_PARAMS)
+{
+    const VideoCodec& codec = findCodec(get<0>(GetParam()));
+    const Size size = get<1>(GetParam());
+    const string filename = writeSyntheticVideo(codec, size);
+    VideoCapture cap = openSyntheticVideo(codec, filename);
+
+    // the usual preprocessing of a detector: gray at half the size
+    Mat img, gray, small;
+    FrameTimer timer;
+    TEST_CYCLE_N(frame_count)
+    {
+        ASSERT_TRUE(cap.read(img));
+        cvtColor(img, gray, COLOR_BGR2GRAY);
+        resize(gray, small, Size(), 0.5, 0.5, INTER_AREA);
+        timer.frame();
+    }
+    timer.report();
+
+    remove(filename.c_str());
+    SANITY_CHECK_NOTHING();
+}
+
+PERF_TEST_P(VideoIO_Throughput, seek, VIDEOIO_THROUGHPUT_PARAMS)
+{
+    const VideoCodec& codec = findCodec(get<0>(GetParam()));
+    const Size size = get<1>(GetParam());
+    const string filename = writeSyntheticVideo(codec, size);
+    VideoCapture cap = openSyntheticVideo(codec, filename);
+
+    // random access: a seek and a read per frame
+    RNG rng(0);
+    Mat img;
+    FrameTimer timer;
+    TEST_CYCLE_N(frame_count / 2)
+    {
+        ASSERT_TRUE(cap.set(CAP_PROP_POS_FRAMES, rng.uniform(0, frame_count)));
+        ASSERT_TRUE(cap.read(img));
+        timer.frame();
+    }
+    timer.report();
+
+    remove(filename.c_str());
+    SANITY_CHECK_NOTHING();
+}
+
+} // namespace
@@ -42,14 +42,71 @@
 #include "precomp.hpp"
 
 #include "opencv2/videoio/registry.hpp"
+#include "opencv2/videoio/capture_source.private.hpp"
 #include "videoio_registry.hpp"
 
+#ifndef _WIN32
+#include <errno.h>
+#include <poll.h>
+#endif
+
 namespace cv {
 
 void DefaultDeleter<CvCapture>::operator ()(CvCapture* obj) const { cvReleaseCapture(&obj); }
 void DefaultDeleter<CvVideoWriter>::operator ()(CvVideoWriter* obj) const { cvReleaseVideoWriter(&obj); }
 
 
+static bool retrieveLegacyFrame(CvCapture* cap, int channel, OutputArray image)
+{
+    if (!cap)
+    {
+        image.release();
+        return false;
+    }
+    return cap->retrieveMat(channel, image);
+}
+
+// Exposes a legacy capture through the IVideoCapture interface, so it can be wrapped
+class LegacyCapture CV_FINAL : public IVideoCapture
+{
+public:
+    explicit LegacyCapture(const Ptr<CvCapture>& capture) : cap(capture) {}
+
+    double getProperty(int propId) const CV_OVERRIDE { return cap->getProperty(propId); }
+    bool setProperty(int propId, double value) CV_OVERRIDE { return cvSetCaptureProperty(cap, propId, value) != 0; }
+    bool grabFrame() CV_OVERRIDE { return cvGrabFrame(cap) != 0; }
+    bool retrieveFrame(int channel, OutputArray image) CV_OVERRIDE { return retrieveLegacyFrame(cap, channel, image); }
+    bool isOpened() const CV_OVERRIDE { return true; }  // legacy interface doesn't support closed files
+    int getCaptureDomain() CV_OVERRIDE { return cap->getCaptureDomain(); }
+    int getFrameReadyFd() CV_OVERRIDE { return cap->getFrameReadyFd(); }
+    bool setBuffers(const std::vector<Mat>& buffers) CV_OVERRIDE { return cap->setBuffers(buffers); }
+
+private:
+    Ptr<CvCapture> cap;
+};
+
+// Exposes a source implemented outside of the library through the IVideoCapture interface
+class SourceCapture CV_FINAL : public IVideoCapture
+{
+public:
+    explicit SourceCapture(const Ptr<VideoCaptureSource>& source) : src(source) {}
+
+    double getProperty(int propId) const CV_OVERRIDE { return src->get(propId); }
+    bool setProperty(int propId, double value) CV_OVERRIDE { return src->set(propId, value); }
+    bool grabFrame() CV_OVERRIDE { return src->grab(); }
+    bool retrieveFrame(int channel, OutputArray image) CV_OVERRIDE { return src->retrieve(channel, image); }
+    bool isOpened() const CV_OVERRIDE { return true; }
+
+private:
+    Ptr<VideoCaptureSource> src;
+};
+
+Ptr<IVideoCapture> createSourceCapture(const Ptr<VideoCaptureSource>& source)
+{
+    CV_Assert(!source.empty());
+    return makePtr<SourceCapture>(source);
+}
+
 VideoCapture::VideoCapture()
 {}
 
@@ -110,6 +167,19 @@ bool VideoCapture::open(const String& filename, int apiPreference)
     return false;
 }
 
+bool VideoCapture::openSegments(const String& filename, int apiPreference, int decoders,
+                                bool ordered, int partFrames)
+{
+    CV_TRACE_FUNCTION();
+    CV_CheckGT(decoders, 0, "");
+    CV_CheckGE(partFrames, 0, "");
+
+    if (isOpened()) release();
+
+    icap = createSegmentedCapture(filename, apiPreference, decoders, ordered, partFrames);
+    return !icap.empty();
+}
+
 bool VideoCapture::open(const String& filename)
 {
     CV_TRACE_FUNCTION();
@@ -202,21 +272,7 @@ bool VideoCapture::retrieve(OutputArray image, int channel)
 
     if (!icap.empty())
         return icap->retrieveFrame(channel, image);
-
-    IplImage* _img = cvRetrieveFrame(cap, channel);
-    if( !_img )
-    {
-        image.release();
-        return false;
-    }
-    if(_img->origin == IPL_ORIGIN_TL)
-        cv::cvarrToMat(_img).copyTo(image);
-    else
-    {
-        Mat temp = cv::cvarrToMat(_img);
-        flip(temp, image, 0);
-    }
-    return true;
+    return retrieveLegacyFrame(cap, channel, image);
 }
 
 bool VideoCapture::read(OutputArray image)
@@ -266,15 +322,122 @@ VideoCapture& VideoCapture::operator >> (UMat& image)
     return *this;
 }
 
+static bool grabStream(const Ptr<IVideoCapture>& icap, const Ptr<CvCapture>& cap)
+{
+    return icap ? icap->grabFrame() : cap->grabFrame();
+}
+
+bool VideoCapture::waitAny(const std::vector<VideoCapture>& streams, std::vector<int>& readyIndex, int64 timeoutNs)
+{
+    CV_INSTRUMENT_REGION();
+
+    readyIndex.clear();
+    std::vector<int> fds(streams.size(), -1);
+    for (size_t i = 0; i < streams.size(); i++)
+    {
+        const VideoCapture& stream = streams[i];
+        if (!stream.isOpened())
+            CV_Error_(Error::StsBadArg, ("waitAny: the stream %d is not opened", (int)i));
+        fds[i] = stream.icap ? stream.icap->getFrameReadyFd() : stream.cap->getFrameReadyFd();
+    }
+
+    // the streams without descriptor are always ready
+    for (size_t i = 0; i < streams.size(); i++)
+        if (fds[i] < 0 && grabStream(streams[i].icap, streams[i].cap))
+            readyIndex.push_back((int)i);
+
+#ifndef _WIN32
+    std::vector<pollfd> pollfds;
+    std::vector<int> pollIndex;
+    for (size_t i = 0; i < fds.size(); i++)
+    {
+        if (fds[i] < 0)
+            continue;
+        pollfd pfd = pollfd();
+        pfd.fd = fds[i];
+        pfd.events = POLLIN;
+        pollfds.push_back(pfd);
+        pollIndex.push_back((int)i);
+    }
+    const int64 start = getTickCount();
+    while (!pollfds.empty())
+    {
+        // don't wait when a frame is grabbed already
+        int timeoutMs = -1;
+        if (!readyIndex.empty())
+            timeoutMs = 0;
+        else if (timeoutNs > 0)
+        {
+            const int64 elapsedNs = (int64)((getTickCount() - start) * 1e9 / getTickFrequency());
+            timeoutMs = (int)std::min<int64>(std::max<int64>(timeoutNs - elapsedNs + 999999, 0) / 1000000, INT_MAX);
+        }
+        int r;
+        do
+        {
+            r = poll(&pollfds[0], (nfds_t)pollfds.size(), timeoutMs);
+        } while (r < 0 && errno == EINTR);
+        if (r < 0)
+            CV_Error_(Error::StsError, ("waitAny: poll() failed, errno=%d", errno));
+        if (r == 0)
+            break;
+
+        // errors are reported as ready, the grabbing fails then and the stream is not waited on anymore
+        size_t j = 0;
+        for (size_t i = 0; i < pollfds.size(); i++)
+        {
+            const int idx = pollIndex[i];
+            if (pollfds[i].revents != 0)
+            {
+                if (grabStream(streams[idx].icap, streams[idx].cap))
+                    readyIndex.push_back(idx);
+                else
+                    continue;
+            }
+            pollfds[j] = pollfds[i];
+            pollIndex[j++] = idx;
+        }
+        pollfds.resize(j);
+        pollIndex.resize(j);
+        if (!readyIndex.empty() || timeoutMs == 0)
+            break;
+    }
+    std::sort(readyIndex.begin(), readyIndex.end());
+#endif
+
+    return !readyIndex.empty();
+}
+
 bool VideoCapture::set(int propId, double value)
 {
     CV_CheckNE(propId, (int)CAP_PROP_BACKEND, "Can set read-only property");
 
+    if ((propId == CAP_PROP_READAHEAD_FRAMES || propId == CAP_PROP_READAHEAD_POLICY) &&
+        isOpened() && !isReadAheadCapture(icap))
+    {
+        if (icap.empty())
+        {
+            icap = makePtr<LegacyCapture>(cap);
+            cap.release();
+        }
+        icap = createReadAheadCapture(icap);
+    }
     if (!icap.empty())
         return icap->setProperty(propId, value);
     return cvSetCaptureProperty(cap, propId, value) != 0;
 }
 
+bool VideoCapture::setBuffers(InputArrayOfArrays buffers)
+{
+    CV_TRACE_FUNCTION();
+
+    std::vector<Mat> mats;
+    if (!buffers.empty())
+        buffers.getMatVector(mats);
+    if (!icap.empty())
+        return icap->setBuffers(mats);
+    return cap ? cap->setBuffers(mats) : false;
+}
+
 double VideoCapture::get(int propId) const
 {
     if (propId == CAP_PROP_BACKEND)
@@ -288,6 +451,9 @@ double VideoCapture::get(int propId) const
             return -1.0;
         return (double)api;
     }
+    if ((propId == CAP_PROP_READAHEAD_FRAMES || propId == CAP_PROP_READAHEAD_POLICY) &&
+        !isReadAheadCapture(icap))
+        return 0;
     if (!icap.empty())
         return icap->getProperty(propId);
     return cap ? cap->getProperty(propId) : 0;
@@ -298,6 +464,26 @@ double VideoCapture::get(int propId) const
 
 
 
+static void writeLegacyFrame(CvVideoWriter* writer, const Mat& image)
+{
+    IplImage _img = cvIplImage(image);
+    cvWriteFrame(writer, &_img);
+}
+
+// Exposes a legacy writer through the IVideoWriter interface, so it can be wrapped
+class LegacyWriter CV_FINAL : public IVideoWriter
+{
+public:
+    explicit LegacyWriter(const Ptr<CvVideoWriter>& writer_) : writer(writer_) {}
+
+    bool isOpened() const CV_OVERRIDE { return true; }  // assume it is opened
+    void write(InputArray image) CV_OVERRIDE { writeLegacyFrame(writer, image.getMat()); }
+    int getCaptureDomain() const CV_OVERRIDE { return writer->getCaptureDomain(); }
+
+private:
+    Ptr<CvVideoWriter> writer;
+};
+
 VideoWriter::VideoWriter()
 {}
 
@@ -369,6 +555,15 @@ bool VideoWriter::set(int propId, double value)
 {
     CV_CheckNE(propId, (int)CAP_PROP_BACKEND, "Can set read-only property");
 
+    if (propId == VIDEOWRITER_PROP_ASYNC_FRAMES && isOpened() && !isAsyncWriter(iwriter))
+    {
+        if (iwriter.empty())
+        {
+            iwriter = makePtr<LegacyWriter>(writer);
+            writer.release();
+        }
+        iwriter = createAsyncWriter(iwriter);
+    }
     if (!iwriter.empty())
         return iwriter->setProperty(propId, value);
     return false;
@@ -387,6 +582,8 @@ double VideoWriter::get(int propId) const
             return -1.0;
         return (double)api;
     }
+    if (propId == VIDEOWRITER_PROP_ASYNC_FRAMES && !isAsyncWriter(iwriter))
+        return 0.;
     if (!iwriter.empty())
         return iwriter->getProperty(propId);
     return 0.;
@@ -410,10 +607,7 @@ void VideoWriter::write(const Mat& image)
     if( iwriter )
         iwriter->write(image);
     else
-    {
-        IplImage _img = cvIplImage(image);
-        cvWriteFrame(writer, &_img);
-    }
+        writeLegacyFrame(writer, image);
 }
 
 VideoWriter& VideoWriter::operator << (const Mat& image)
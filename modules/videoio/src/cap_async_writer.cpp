@@ -0,0 +1,193 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#include "precomp.hpp"
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace cv
+{
+
+// Queues the written frames for a background thread, which hands them to the wrapped writer.
+// The queue is a ring of VIDEOWRITER_PROP_ASYNC_FRAMES frame buffers, reused for the frames
+// of the same size and type, so write() only copies the frame. With 0 frames (the default)
+// the frames go to the wrapped writer directly.
+class AsyncWriter CV_FINAL : public IVideoWriter
+{
+public:
+    explicit AsyncWriter(const Ptr<IVideoWriter>& writer)
+        : writer_(writer), head_(0), count_(0), running_(false), stopping_(false), failed_(false)
+    {
+        CV_Assert(!writer_.empty());
+    }
+
+    ~AsyncWriter() CV_OVERRIDE
+    {
+        stop();
+    }
+
+    double getProperty(int propId) const CV_OVERRIDE
+    {
+        if (propId == VIDEOWRITER_PROP_ASYNC_FRAMES)
+            return (double)ring_.size();
+        std::lock_guard<std::mutex> lock(writerMutex_);
+        return writer_->getProperty(propId);
+    }
+
+    bool setProperty(int propId, double value) CV_OVERRIDE
+    {
+        if (propId == VIDEOWRITER_PROP_ASYNC_FRAMES)
+        {
+            if (value < 0)
+                return false;
+            stop();
+            ring_.resize(cvRound(value));
+            return true;
+        }
+        // applies to the frames written after
+        flush();
+        std::lock_guard<std::mutex> lock(writerMutex_);
+        return writer_->setProperty(propId, value);
+    }
+
+    bool isOpened() const CV_OVERRIDE
+    {
+        std::lock_guard<std::mutex> lock(writerMutex_);
+        return writer_->isOpened();
+    }
+
+    void write(InputArray image) CV_OVERRIDE
+    {
+        if (ring_.empty())
+        {
+            writer_->write(image);
+            return;
+        }
+        if (!running_)
+            start();
+
+        size_t slot;
+        {
+            std::unique_lock<std::mutex> lock(queueMutex_);
+            spaceCond_.wait(lock, [this] { return count_ < ring_.size() || failed_; });
+            if (failed_)
+                CV_Error(Error::StsError, "VideoWriter: a queued frame failed to be written");
+            // the slot after the queued frames is not touched by the encoding thread
+            slot = (head_ + count_) % ring_.size();
+        }
+        image.copyTo(ring_[slot]);
+
+        std::lock_guard<std::mutex> lock(queueMutex_);
+        count_++;
+        frameCond_.notify_one();
+    }
+
+    int getCaptureDomain() const CV_OVERRIDE
+    {
+        return writer_->getCaptureDomain();
+    }
+
+private:
+    void start()
+    {
+        CV_Assert(!running_);
+        head_ = count_ = 0;
+        stopping_ = failed_ = false;
+        running_ = true;
+        worker_ = std::thread(&AsyncWriter::run, this);
+    }
+
+    // Waits until the queued frames are written
+    void flush()
+    {
+        if (!running_)
+            return;
+        std::unique_lock<std::mutex> lock(queueMutex_);
+        spaceCond_.wait(lock, [this] { return count_ == 0 || failed_; });
+    }
+
+    void stop()
+    {
+        if (!running_)
+            return;
+        {
+            std::lock_guard<std::mutex> lock(queueMutex_);
+            stopping_ = true;
+            frameCond_.notify_all();
+        }
+        worker_.join();
+        running_ = false;
+    }
+
+    void run()
+    {
+        const size_t size = ring_.size();
+        for (;;)
+        {
+            size_t slot;
+            {
+                std::unique_lock<std::mutex> lock(queueMutex_);
+                frameCond_.wait(lock, [this] { return count_ > 0 || stopping_; });
+                // the queued frames are written before stopping
+                if (count_ == 0)
+                    return;
+                slot = head_;
+            }
+
+            bool ok = true;
+            CV_TRY
+            {
+                std::lock_guard<std::mutex> lock(writerMutex_);
+                writer_->write(ring_[slot]);
+            }
+            CV_CATCH_ALL
+            {
+                CV_LOG_WARNING(NULL, "VIDEOIO: exception while writing a queued frame, dropping the queue");
+                ok = false;
+            }
+
+            std::lock_guard<std::mutex> lock(queueMutex_);
+            if (!ok)
+            {
+                failed_ = true;
+                count_ = 0;
+                spaceCond_.notify_all();
+                return;
+            }
+            head_ = (head_ + 1) % size;
+            count_--;
+            spaceCond_.notify_all();
+        }
+    }
+
+    Ptr<IVideoWriter> writer_;
+
+    std::vector<Mat> ring_;
+    size_t head_;   // oldest queued frame
+    size_t count_;  // number of queued frames
+
+    std::thread worker_;
+    bool running_;
+    bool stopping_;
+    bool failed_;
+
+    std::mutex queueMutex_;            // guards the ring state and the flags
+    mutable std::mutex writerMutex_;   // serializes the calls to the wrapped writer
+    std::condition_variable frameCond_;
+    std::condition_variable spaceCond_;
+};
+
+Ptr<IVideoWriter> createAsyncWriter(const Ptr<IVideoWriter>& writer)
+{
+    return makePtr<AsyncWriter>(writer);
+}
+
+bool isAsyncWriter(const Ptr<IVideoWriter>& writer)
+{
+    return dynamic_cast<AsyncWriter*>(writer.get()) != NULL;
+}
+
+} // namespace cv
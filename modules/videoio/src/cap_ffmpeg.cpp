@@ -52,6 +52,7 @@
 #define icvReleaseCapture_FFMPEG_p cvReleaseCapture_FFMPEG
 #define icvGrabFrame_FFMPEG_p cvGrabFrame_FFMPEG
 #define icvRetrieveFrame_FFMPEG_p cvRetrieveFrame_FFMPEG
+#define icvRetrieveFramePlane_FFMPEG_p cvRetrieveFramePlane_FFMPEG
 #define icvSetCaptureProperty_FFMPEG_p cvSetCaptureProperty_FFMPEG
 #define icvGetCaptureProperty_FFMPEG_p cvGetCaptureProperty_FFMPEG
 #define icvCreateVideoWriter_FFMPEG_p cvCreateVideoWriter_FFMPEG
@@ -68,6 +69,7 @@ static CvCreateFileCapture_Plugin icvCreateFileCapture_FFMPEG_p = 0;
 static CvReleaseCapture_Plugin icvReleaseCapture_FFMPEG_p = 0;
 static CvGrabFrame_Plugin icvGrabFrame_FFMPEG_p = 0;
 static CvRetrieveFrame_Plugin icvRetrieveFrame_FFMPEG_p = 0;
+static CvRetrieveFramePlane_Plugin icvRetrieveFramePlane_FFMPEG_p = 0;
 static CvSetCaptureProperty_Plugin icvSetCaptureProperty_FFMPEG_p = 0;
 static CvGetCaptureProperty_Plugin icvGetCaptureProperty_FFMPEG_p = 0;
 static CvCreateVideoWriter_Plugin icvCreateVideoWriter_FFMPEG_p = 0;
@@ -166,6 +168,9 @@ private:
                 (CvGrabFrame_Plugin)GetProcAddress(icvFFOpenCV, "cvGrabFrame_FFMPEG");
             icvRetrieveFrame_FFMPEG_p =
                 (CvRetrieveFrame_Plugin)GetProcAddress(icvFFOpenCV, "cvRetrieveFrame_FFMPEG");
+            // missing in the plugins built before, the frames are converted then
+            icvRetrieveFramePlane_FFMPEG_p =
+                (CvRetrieveFramePlane_Plugin)GetProcAddress(icvFFOpenCV, "cvRetrieveFramePlane_FFMPEG");
             icvSetCaptureProperty_FFMPEG_p =
                 (CvSetCaptureProperty_Plugin)GetProcAddress(icvFFOpenCV, "cvSetCaptureProperty_FFMPEG");
             icvGetCaptureProperty_FFMPEG_p =
@@ -227,13 +232,35 @@ public:
     {
         return ffmpegCapture ? icvGrabFrame_FFMPEG_p(ffmpegCapture)!=0 : false;
     }
-    virtual bool retrieveFrame(int, cv::OutputArray frame) CV_OVERRIDE
+    virtual bool retrieveFrame(int channel, cv::OutputArray frame) CV_OVERRIDE
     {
         unsigned char* data = 0;
         int step=0, width=0, height=0, cn=0;
 
-        if (!ffmpegCapture ||
-           !icvRetrieveFrame_FFMPEG_p(ffmpegCapture, &data, &step, &width, &height, &cn))
+        if (!ffmpegCapture)
+            return false;
+        if (icvRetrieveFramePlane_FFMPEG_p &&
+            icvGetCaptureProperty_FFMPEG_p(ffmpegCapture, CV_FFMPEG_CAP_PROP_CONVERT_RGB) == 0)
+        {
+            if (!icvRetrieveFramePlane_FFMPEG_p(ffmpegCapture, channel, &data, &step, &width, &height, &cn))
+            {
+                // the pixel formats without plane retrieval are converted to BGR
+                if (channel != 0)
+                    return false;
+                if (!icvRetrieveFrame_FFMPEG_p(ffmpegCapture, &data, &step, &width, &height, &cn))
+                    return false;
+                cv::Mat(height, width, CV_MAKETYPE(CV_8U, cn), data, step).copyTo(frame);
+                return true;
+            }
+            // a view of the decoder's buffer, valid until the next grab
+            cv::Mat plane(height, width, CV_MAKETYPE(CV_8U, cn), data, step);
+            if (frame.kind() == cv::_InputArray::MAT && !frame.fixedType())
+                frame.assign(plane);
+            else
+                plane.copyTo(frame);
+            return true;
+        }
+        if (!icvRetrieveFrame_FFMPEG_p(ffmpegCapture, &data, &step, &width, &height, &cn))
             return false;
         cv::Mat(height, width, CV_MAKETYPE(CV_8U, cn), data, step).copyTo(frame);
         return true;
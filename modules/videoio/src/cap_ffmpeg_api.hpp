@@ -24,8 +24,12 @@ enum
     CV_FFMPEG_CAP_PROP_FPS=5,
     CV_FFMPEG_CAP_PROP_FOURCC=6,
     CV_FFMPEG_CAP_PROP_FRAME_COUNT=7,
+    CV_FFMPEG_CAP_PROP_CONVERT_RGB=16,
     CV_FFMPEG_CAP_PROP_SAR_NUM=40,
-    CV_FFMPEG_CAP_PROP_SAR_DEN=41
+    CV_FFMPEG_CAP_PROP_SAR_DEN=41,
+    CV_FFMPEG_CAP_PROP_CODEC_PIXEL_FORMAT=45,
+    CV_FFMPEG_CAP_PROP_KEYFRAME_INDEX=46,
+    CV_FFMPEG_CAP_PROP_NEXT_KEYFRAME=50
 };
 
 typedef struct CvCapture_FFMPEG CvCapture_FFMPEG;
@@ -38,6 +42,8 @@ OPENCV_FFMPEG_API double cvGetCaptureProperty_FFMPEG(struct CvCapture_FFMPEG* ca
 OPENCV_FFMPEG_API int cvGrabFrame_FFMPEG(struct CvCapture_FFMPEG* cap);
 OPENCV_FFMPEG_API int cvRetrieveFrame_FFMPEG(struct CvCapture_FFMPEG* capture, unsigned char** data,
                                              int* step, int* width, int* height, int* cn);
+OPENCV_FFMPEG_API int cvRetrieveFramePlane_FFMPEG(struct CvCapture_FFMPEG* capture, int plane, unsigned char** data,
+                                                  int* step, int* width, int* height, int* cn);
 OPENCV_FFMPEG_API void cvReleaseCapture_FFMPEG(struct CvCapture_FFMPEG** cap);
 
 OPENCV_FFMPEG_API struct CvVideoWriter_FFMPEG* cvCreateVideoWriter_FFMPEG(const char* filename,
@@ -51,6 +57,8 @@ typedef CvCapture_FFMPEG* (*CvCreateCameraCapture_Plugin)( int index );
 typedef int (*CvGrabFrame_Plugin)( CvCapture_FFMPEG* capture_handle );
 typedef int (*CvRetrieveFrame_Plugin)( CvCapture_FFMPEG* capture_handle, unsigned char** data, int* step,
                                        int* width, int* height, int* cn );
+typedef int (*CvRetrieveFramePlane_Plugin)( CvCapture_FFMPEG* capture_handle, int plane, unsigned char** data,
+                                            int* step, int* width, int* height, int* cn );
 typedef int (*CvSetCaptureProperty_Plugin)( CvCapture_FFMPEG* capture_handle, int prop_id, double value );
 typedef double (*CvGetCaptureProperty_Plugin)( CvCapture_FFMPEG* capture_handle, int prop_id );
 typedef void (*CvReleaseCapture_Plugin)( CvCapture_FFMPEG** capture_handle );
@@ -47,6 +47,9 @@
 #include <assert.h>
 #include <algorithm>
 #include <limits>
+#include <stdio.h>
+#include <string>
+#include <vector>
 
 #define CALC_FFMPEG_VERSION(a,b,c) ( a<<16 | b<<8 | c )
 
@@ -149,6 +152,7 @@ extern "C" {
 #define AV_PIX_FMT_YUV420P PIX_FMT_YUV420P
 #define AV_PIX_FMT_YUV444P PIX_FMT_YUV444P
 #define AV_PIX_FMT_YUVJ420P PIX_FMT_YUVJ420P
+#define AV_PIX_FMT_NV12 PIX_FMT_NV12
 #define AV_PIX_FMT_GRAY16LE PIX_FMT_GRAY16LE
 #define AV_PIX_FMT_GRAY16BE PIX_FMT_GRAY16BE
 #endif
@@ -176,6 +180,13 @@ extern "C" {
 #endif
 #endif
 
+// the keyframe index reads through the seekable inputs only
+#if LIBAVFORMAT_BUILD >= CALC_FFMPEG_VERSION(53, 21, 0)
+#define USE_KEYFRAME_INDEX 1
+#else
+#define USE_KEYFRAME_INDEX 0
+#endif
+
 #if USE_AV_INTERRUPT_CALLBACK
 #define LIBAVFORMAT_INTERRUPT_OPEN_TIMEOUT_MS 30000
 #define LIBAVFORMAT_INTERRUPT_READ_TIMEOUT_MS 30000
@@ -434,6 +445,17 @@ static AVRational _opencv_ffmpeg_get_sample_aspect_ratio(AVStream *stream)
 }
 
 
+// Timestamps of the frames of the video stream and of its keyframes, found by reading
+// through the packets of the file (CV_FFMPEG_CAP_PROP_KEYFRAME_INDEX)
+struct CvKeyframeIndex_FFMPEG
+{
+    int mode;
+    std::vector<int64_t> frames;      // presentation timestamps of all the frames, increasing
+    std::vector<int64_t> keyframes;   // numbers of the keyframes, increasing
+    std::vector<int64_t> seek_ts;     // timestamps to seek to the keyframes
+    int64_t next_keyframe;            // found by the last CV_FFMPEG_CAP_PROP_NEXT_KEYFRAME
+};
+
 struct CvCapture_FFMPEG
 {
     bool open( const char* filename );
@@ -443,6 +465,7 @@ struct CvCapture_FFMPEG
     bool setProperty(int, double);
     bool grabFrame();
     bool retrieveFrame(int, unsigned char** data, int* step, int* width, int* height, int* cn);
+    bool retrievePlane(int plane, unsigned char** data, int* step, int* width, int* height, int* cn);
 
     void init();
 
@@ -450,13 +473,22 @@ struct CvCapture_FFMPEG
     void    seek(double sec);
     bool    slowSeek( int framenumber );
 
+    bool    setKeyframeIndex(int mode);
+    bool    buildKeyframeIndex(CvKeyframeIndex_FFMPEG& index);
+    bool    loadKeyframeIndex(const std::string& path, CvKeyframeIndex_FFMPEG& index);
+    void    saveKeyframeIndex(const std::string& path, const CvKeyframeIndex_FFMPEG& index);
+    bool    seekIndexed(int64_t frame_number);
+    int64_t get_picture_timestamp() const;
+
     int64_t get_total_frames() const;
     double  get_duration_sec() const;
     double  get_fps() const;
     int     get_bitrate() const;
+    unsigned get_pixel_format_fourcc() const;
 
     double  r2d(AVRational r) const;
     int64_t dts_to_frame_number(int64_t dts);
+    int64_t pts_to_frame_number(int64_t pts) const;
     double  dts_to_sec(int64_t dts);
 
     AVFormatContext * ic;
@@ -473,6 +505,11 @@ struct CvCapture_FFMPEG
 
     int64_t frame_number, first_frame_number;
 
+    // the struct is allocated with malloc(), so the index is kept aside
+    CvKeyframeIndex_FFMPEG* keyframe_index;
+    char* source_path;   // the path given to open(), for the index file
+
+    bool convert_rgb;
     double eps_zero;
 /*
    'filename' contains the filename of the videosource,
@@ -499,6 +536,8 @@ void CvCapture_FFMPEG::init()
     picture = 0;
     picture_pts = AV_NOPTS_VALUE_;
     first_frame_number = -1;
+    keyframe_index = 0;
+    source_path = 0;
     memset( &rgb_picture, 0, sizeof(rgb_picture) );
     memset( &frame, 0, sizeof(frame) );
     filename = 0;
@@ -508,6 +547,7 @@ void CvCapture_FFMPEG::init()
 
     avcodec = 0;
     frame_number = 0;
+    convert_rgb = true;
     eps_zero = 0.000025;
 
 #if LIBAVFORMAT_BUILD >= CALC_FFMPEG_VERSION(52, 111, 0)
@@ -581,6 +621,9 @@ void CvCapture_FFMPEG::close()
        av_dict_free(&dict);
 #endif
 
+    delete keyframe_index;
+    free(source_path);
+
     init();
 }
 
@@ -824,6 +867,11 @@ bool CvCapture_FFMPEG::open( const char* _filename )
 
     close();
 
+    const size_t path_size = strlen(_filename) + 1;
+    source_path = (char*)malloc(path_size);
+    if( source_path )
+        memcpy(source_path, _filename, path_size);
+
 #if USE_AV_INTERRUPT_CALLBACK
     /* interrupt callback */
     interrupt_metadata.timeout_after_ms = LIBAVFORMAT_INTERRUPT_OPEN_TIMEOUT_MS;
@@ -1117,6 +1165,54 @@ bool CvCapture_FFMPEG::retrieveFrame(int, unsigned char** data, int* step, int*
 }
 
 
+// Gives out a plane of the decoded picture as is, without conversion and copy.
+// The data stays valid until the next grabFrame().
+bool CvCapture_FFMPEG::retrievePlane(int plane, unsigned char** data, int* step, int* width, int* height, int* cn)
+{
+    if( !video_st || !picture->data[0] || plane < 0 )
+        return false;
+
+    int w = video_st->codec->width, h = video_st->codec->height, channels = 1;
+    switch( video_st->codec->pix_fmt )
+    {
+    case AV_PIX_FMT_GRAY8:
+        if( plane > 0 )
+            return false;
+        break;
+    case AV_PIX_FMT_NV12:
+        if( plane > 1 )
+            return false;
+        if( plane == 1 )
+        {
+            w = (w + 1) / 2;
+            h = (h + 1) / 2;
+            channels = 2;
+        }
+        break;
+    case AV_PIX_FMT_YUV420P:
+    case AV_PIX_FMT_YUVJ420P:
+        if( plane > 2 )
+            return false;
+        if( plane > 0 )
+        {
+            w = (w + 1) / 2;
+            h = (h + 1) / 2;
+        }
+        break;
+    default:
+        return false;
+    }
+
+    *data = picture->data[plane];
+    *step = picture->linesize[plane];
+    *width = w;
+    *height = h;
+    *cn = channels;
+
+    return *data != 0;
+}
+
+
 double CvCapture_FFMPEG::getProperty( int property_id ) const
 {
     if( !video_st ) return 0;
@@ -1147,6 +1243,17 @@ double CvCapture_FFMPEG::getProperty( int property_id ) const
         return _opencv_ffmpeg_get_sample_aspect_ratio(ic->streams[video_stream]).num;
     case CV_FFMPEG_CAP_PROP_SAR_DEN:
         return _opencv_ffmpeg_get_sample_aspect_ratio(ic->streams[video_stream]).den;
+    case CV_FFMPEG_CAP_PROP_CONVERT_RGB:
+        return convert_rgb ? 1 : 0;
+    case CV_FFMPEG_CAP_PROP_CODEC_PIXEL_FORMAT:
+        {
+            unsigned fourcc = get_pixel_format_fourcc();
+            return fourcc ? (double)fourcc : -1;
+        }
+    case CV_FFMPEG_CAP_PROP_KEYFRAME_INDEX:
+        return keyframe_index ? keyframe_index->mode : 0;
+    case CV_FFMPEG_CAP_PROP_NEXT_KEYFRAME:
+        return keyframe_index ? (double)keyframe_index->next_keyframe : 0;
     default:
         break;
     }
@@ -1176,6 +1283,28 @@ int CvCapture_FFMPEG::get_bitrate() const
     return ic->bit_rate;
 }
 
+// The FourCC of the decoded pixel format, 0 if it has none. The formats retrievePlane()
+// supports get the names of their plane layouts, the others the raw video tag of FFmpeg
+unsigned CvCapture_FFMPEG::get_pixel_format_fourcc() const
+{
+    switch( video_st->codec->pix_fmt )
+    {
+    case AV_PIX_FMT_GRAY8:
+        return MKTAG('G', 'R', 'E', 'Y');
+    case AV_PIX_FMT_NV12:
+        return MKTAG('N', 'V', '1', '2');
+    case AV_PIX_FMT_YUV420P:
+    case AV_PIX_FMT_YUVJ420P:
+        return MKTAG('I', '4', '2', '0');
+    default:
+#if LIBAVCODEC_VERSION_MICRO >= 100 && LIBAVCODEC_BUILD >= CALC_FFMPEG_VERSION(55, 0, 100)
+        return avcodec_pix_fmt_to_codec_tag( video_st->codec->pix_fmt );
+#else
+        return 0;
+#endif
+    }
+}
+
 double CvCapture_FFMPEG::get_fps() const
 {
 #if 0 && LIBAVFORMAT_BUILD >= CALC_FFMPEG_VERSION(55, 1, 100) && LIBAVFORMAT_VERSION_MICRO >= 100
@@ -1204,6 +1333,9 @@ double CvCapture_FFMPEG::get_fps() const
 
 int64_t CvCapture_FFMPEG::get_total_frames() const
 {
+    if (keyframe_index)
+        return (int64_t)keyframe_index->frames.size();
+
     int64_t nbf = ic->streams[video_stream]->nb_frames;
 
     if (nbf == 0)
@@ -1219,6 +1351,15 @@ int64_t CvCapture_FFMPEG::dts_to_frame_number(int64_t dts)
     return (int64_t)(get_fps() * sec + 0.5);
 }
 
+// The start time of the stream is a presentation timestamp, the frame of a presentation
+// timestamp is counted from it in the frame duration
+int64_t CvCapture_FFMPEG::pts_to_frame_number(int64_t pts) const
+{
+    AVStream* st = ic->streams[video_stream];
+    const int64_t start = st->start_time != AV_NOPTS_VALUE_ ? st->start_time : 0;
+    return (int64_t)((double)(pts - start) * r2d(st->time_base) * get_fps() + 0.5);
+}
+
 double CvCapture_FFMPEG::dts_to_sec(int64_t dts)
 {
     return (double)(dts - ic->streams[video_stream]->start_time) *
@@ -1227,6 +1368,9 @@ double CvCapture_FFMPEG::dts_to_sec(int64_t dts)
 
 void CvCapture_FFMPEG::seek(int64_t _frame_number)
 {
+    if( keyframe_index && seekIndexed(_frame_number) )
+        return;
+
     _frame_number = std::min(_frame_number, get_total_frames());
     int delta = 16;
 
@@ -1288,6 +1432,270 @@ void CvCapture_FFMPEG::seek(double sec)
     seek((int64_t)(sec * get_fps() + 0.5));
 }
 
+int64_t CvCapture_FFMPEG::get_picture_timestamp() const
+{
+    return picture->pkt_pts != AV_NOPTS_VALUE_ ? picture->pkt_pts : picture->pkt_dts;
+}
+
+// Seeks to the keyframe before the frame and decodes the frames up to it. Returns false
+// to leave the seek to the estimation of seek() when the frames don't match the index.
+bool CvCapture_FFMPEG::seekIndexed(int64_t _frame_number)
+{
+    const CvKeyframeIndex_FFMPEG& index = *keyframe_index;
+    const int64_t count = (int64_t)index.frames.size();
+    _frame_number = std::max(std::min(_frame_number, count), (int64_t)0);
+    // the index holds presentation timestamps, as picture_pts does
+    if( first_frame_number < 0 )
+        first_frame_number = pts_to_frame_number(index.frames[0]);
+
+    // as seek() does, the frame before the position is decoded
+    const int64_t target = _frame_number - 1;
+    size_t k = std::upper_bound(index.keyframes.begin(), index.keyframes.end(),
+                                std::max(target, (int64_t)0)) - index.keyframes.begin();
+    if( k == 0 )
+        return false;
+    k--;
+
+    if( _frame_number == 0 )
+    {
+        if( av_seek_frame(ic, video_stream, index.seek_ts[0], AVSEEK_FLAG_BACKWARD) < 0 )
+            return false;
+        avcodec_flush_buffers(video_st->codec);
+        frame_number = 0;
+        return true;
+    }
+
+    // between the keyframe and the frame already, decoding on is cheaper than seeking
+    bool seeking = !(index.keyframes[k] <= frame_number && frame_number <= target);
+    if( seeking )
+    {
+        if( av_seek_frame(ic, video_stream, index.seek_ts[k], AVSEEK_FLAG_BACKWARD) < 0 )
+            return false;
+        avcodec_flush_buffers(video_st->codec);
+        frame_number = index.keyframes[k];
+    }
+
+    const int64_t target_ts = index.frames[target];
+    int64_t ts;
+    for(;;)
+    {
+        if( !grabFrame() )
+            return false;
+        ts = get_picture_timestamp();
+        if( ts == AV_NOPTS_VALUE_ || (seeking && ts > target_ts) )
+            return false; // the demuxer went past the keyframe
+        seeking = false;
+        if( ts >= target_ts )
+            break;
+    }
+    frame_number = (std::lower_bound(index.frames.begin(), index.frames.end(), ts) - index.frames.begin()) + 1;
+    return true;
+}
+
+bool CvCapture_FFMPEG::buildKeyframeIndex(CvKeyframeIndex_FFMPEG& index)
+{
+#if USE_KEYFRAME_INDEX
+    // the streams can't be read through
+    if( !ic->pb || !ic->pb->seekable )
+        return false;
+
+    AVStream* st = ic->streams[video_stream];
+    int64_t start = st->start_time != AV_NOPTS_VALUE_ ? st->start_time : 0;
+    if( av_seek_frame(ic, video_stream, start, AVSEEK_FLAG_BACKWARD) < 0 )
+        return false;
+
+    std::vector<std::pair<int64_t, int64_t> > keys;
+    AVPacket pkt;
+    memset(&pkt, 0, sizeof(pkt));
+    av_init_packet(&pkt);
+    bool ok = true;
+    // only the packets are read, not decoded
+    while( ok && av_read_frame(ic, &pkt) >= 0 )
+    {
+        if( pkt.stream_index == video_stream )
+        {
+            int64_t ts = pkt.pts != AV_NOPTS_VALUE_ ? pkt.pts : pkt.dts;
+            if( ts == AV_NOPTS_VALUE_ )
+                ok = false;
+            index.frames.push_back(ts);
+            if( pkt.flags & PKT_FLAG_KEY )
+                keys.push_back(std::make_pair(ts, pkt.dts != AV_NOPTS_VALUE_ ? pkt.dts : ts));
+        }
+        _opencv_ffmpeg_av_packet_unref(&pkt);
+    }
+    if( !ok || keys.empty() )
+        return false;
+
+    // the packets come in the decoding order
+    std::sort(index.frames.begin(), index.frames.end());
+    std::sort(keys.begin(), keys.end());
+    for( size_t i = 0; i < keys.size(); i++ )
+    {
+        index.keyframes.push_back(std::lower_bound(index.frames.begin(), index.frames.end(), keys[i].first) -
+                                  index.frames.begin());
+        index.seek_ts.push_back(keys[i].second);
+    }
+    return true;
+#else
+    CV_UNUSED(index);
+    return false;
+#endif
+}
+
+#if USE_KEYFRAME_INDEX
+// The index file starts with the magic and with the values identifying the video:
+// version of the format, file size, duration and time base of the stream. The numbers
+// of the frames and of the keyframes follow, then the arrays of CvKeyframeIndex_FFMPEG.
+// All the values are 64-bit little-endian, so the file can be shared between hosts.
+static const char keyframe_index_magic[8] = { 'C', 'V', 'K', 'F', 'I', 'D', 'X', '1' };
+static const int64_t keyframe_index_version = 2;
+
+static void get_keyframe_index_header(AVFormatContext* ic, int video_stream, int64_t* header)
+{
+    AVStream* st = ic->streams[video_stream];
+    header[0] = keyframe_index_version;
+    header[1] = avio_size(ic->pb);
+    header[2] = st->duration;
+    header[3] = st->time_base.num;
+    header[4] = st->time_base.den;
+}
+
+static bool read_keyframe_index_values(FILE* f, int64_t* values, size_t count)
+{
+    unsigned char buf[8];
+    for( size_t i = 0; i < count; i++ )
+    {
+        if( fread(buf, sizeof(buf), 1, f) != 1 )
+            return false;
+        uint64_t v = 0;
+        for( int k = 7; k >= 0; k-- )
+            v = (v << 8) | buf[k];
+        values[i] = (int64_t)v;
+    }
+    return true;
+}
+
+static bool write_keyframe_index_values(FILE* f, const int64_t* values, size_t count)
+{
+    unsigned char buf[8];
+    for( size_t i = 0; i < count; i++ )
+    {
+        uint64_t v = (uint64_t)values[i];
+        for( int k = 0; k < 8; k++, v >>= 8 )
+            buf[k] = (unsigned char)v;
+        if( fwrite(buf, sizeof(buf), 1, f) != 1 )
+            return false;
+    }
+    return true;
+}
+#endif
+
+bool CvCapture_FFMPEG::loadKeyframeIndex(const std::string& path, CvKeyframeIndex_FFMPEG& index)
+{
+#if USE_KEYFRAME_INDEX
+    if( !ic->pb || !ic->pb->seekable )
+        return false;
+    FILE* f = fopen(path.c_str(), "rb");
+    if( !f )
+        return false;
+
+    char magic[8];
+    int64_t expected[5], header[5], sizes[2];
+    get_keyframe_index_header(ic, video_stream, expected);
+    bool ok = fread(magic, sizeof(magic), 1, f) == 1 && memcmp(magic, keyframe_index_magic, sizeof(magic)) == 0 &&
+              read_keyframe_index_values(f, header, 5) && memcmp(header, expected, sizeof(header)) == 0 &&
+              read_keyframe_index_values(f, sizes, 2) &&
+              sizes[0] > 0 && sizes[0] < (1 << 30) && sizes[1] > 0 && sizes[1] <= sizes[0];
+    if( ok )
+    {
+        index.frames.resize((size_t)sizes[0]);
+        index.keyframes.resize((size_t)sizes[1]);
+        index.seek_ts.resize((size_t)sizes[1]);
+        ok = read_keyframe_index_values(f, &index.frames[0], index.frames.size()) &&
+             read_keyframe_index_values(f, &index.keyframes[0], index.keyframes.size()) &&
+             read_keyframe_index_values(f, &index.seek_ts[0], index.seek_ts.size());
+    }
+    fclose(f);
+
+    for( size_t i = 0; ok && i < index.keyframes.size(); i++ )
+        ok = index.keyframes[i] >= (i > 0 ? index.keyframes[i - 1] + 1 : 0) &&
+             index.keyframes[i] < (int64_t)index.frames.size();
+    if( !ok )
+    {
+        index.frames.clear();
+        index.keyframes.clear();
+        index.seek_ts.clear();
+    }
+    return ok;
+#else
+    CV_UNUSED(path);
+    CV_UNUSED(index);
+    return false;
+#endif
+}
+
+void CvCapture_FFMPEG::saveKeyframeIndex(const std::string& path, const CvKeyframeIndex_FFMPEG& index)
+{
+#if USE_KEYFRAME_INDEX
+    FILE* f = fopen(path.c_str(), "wb");
+    if( !f )
+    {
+        CV_WARN("Could not write the keyframe index");
+        return;
+    }
+    int64_t header[5], sizes[2] = { (int64_t)index.frames.size(), (int64_t)index.keyframes.size() };
+    get_keyframe_index_header(ic, video_stream, header);
+    bool ok = fwrite(keyframe_index_magic, sizeof(keyframe_index_magic), 1, f) == 1 &&
+              write_keyframe_index_values(f, header, 5) &&
+              write_keyframe_index_values(f, sizes, 2) &&
+              write_keyframe_index_values(f, &index.frames[0], index.frames.size()) &&
+              write_keyframe_index_values(f, &index.keyframes[0], index.keyframes.size()) &&
+              write_keyframe_index_values(f, &index.seek_ts[0], index.seek_ts.size());
+    ok = fclose(f) == 0 && ok;
+    if( !ok )
+    {
+        CV_WARN("Could not write the keyframe index");
+        remove(path.c_str());
+    }
+#else
+    CV_UNUSED(path);
+    CV_UNUSED(index);
+#endif
+}
+
+// 0 drops the index, 1 builds it, 2 also saves it next to the file for the next time
+bool CvCapture_FFMPEG::setKeyframeIndex(int mode)
+{
+    if( mode < 0 || mode > 2 )
+        return false;
+    delete keyframe_index;
+    keyframe_index = 0;
+    if( mode == 0 )
+        return true;
+
+    CvKeyframeIndex_FFMPEG* index = new CvKeyframeIndex_FFMPEG();
+    index->mode = mode;
+    const std::string path = std::string(source_path ? source_path : "") + ".keyframes";
+    if( mode == 2 && source_path && loadKeyframeIndex(path, *index) )
+    {
+        keyframe_index = index;
+        return true;
+    }
+
+    const int64_t pos = frame_number;
+    if( buildKeyframeIndex(*index) )
+    {
+        if( mode == 2 && source_path )
+            saveKeyframeIndex(path, *index);
+        keyframe_index = index;
+    }
+    else
+        delete index;
+    // back to the position before the packets were read
+    seek(pos);
+    return keyframe_index != 0;
+}
+
 bool CvCapture_FFMPEG::setProperty( int property_id, double value )
 {
     if( !video_st ) return false;
@@ -1316,6 +1724,21 @@ bool CvCapture_FFMPEG::setProperty( int property_id, double value )
             picture_pts=(int64_t)value;
         }
         break;
+    case CV_FFMPEG_CAP_PROP_CONVERT_RGB:
+        convert_rgb = value != 0;
+        break;
+    case CV_FFMPEG_CAP_PROP_KEYFRAME_INDEX:
+        return setKeyframeIndex((int)value);
+    case CV_FFMPEG_CAP_PROP_NEXT_KEYFRAME:
+        {
+            if( !keyframe_index )
+                return false;
+            const std::vector<int64_t>& keyframes = keyframe_index->keyframes;
+            std::vector<int64_t>::const_iterator it =
+                std::lower_bound(keyframes.begin(), keyframes.end(), (int64_t)std::max(value, 0.));
+            keyframe_index->next_keyframe = it != keyframes.end() ? *it : (int64_t)keyframe_index->frames.size();
+        }
+        break;
     default:
         return false;
     }
@@ -2237,6 +2660,11 @@ int cvRetrieveFrame_FFMPEG(CvCapture_FFMPEG* capture, unsigned char** data, int*
     return capture->retrieveFrame(0, data, step, width, height, cn);
 }
 
+int cvRetrieveFramePlane_FFMPEG(CvCapture_FFMPEG* capture, int plane, unsigned char** data, int* step, int* width, int* height, int* cn)
+{
+    return capture->retrievePlane(plane, data, step, width, height, cn);
+}
+
 CvVideoWriter_FFMPEG* cvCreateVideoWriter_FFMPEG( const char* filename, int fourcc, double fps,
                                                   int width, int height, int isColor )
 {
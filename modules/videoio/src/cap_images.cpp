@@ -52,6 +52,11 @@
 #include "precomp.hpp"
 #include <sys/stat.h>
 
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
 #ifdef NDEBUG
 #define CV_WARN(message)
 #else
@@ -62,6 +67,156 @@
 #define _MAX_PATH 1024
 #endif
 
+namespace cv
+{
+
+// Decodes the images after the one read on worker threads, into a ring of slots holding the
+// frames [pos, pos + size) of the sequence. A frame no worker took yet is decoded by the reading
+// thread instead of waiting. Seeking within the ring keeps the frames decoded, the slots of the
+// other ones are reassigned and a worker finishing a stale frame drops it.
+class ImagePrefetcher
+{
+public:
+    ImagePrefetcher(const char* pattern, unsigned firstframe, unsigned length, int frames)
+        : pattern_(pattern), firstframe_(firstframe), length_(length), slots_(frames), stopping_(false)
+    {
+        CV_Assert(frames > 0);
+        const int workers = std::max(1, std::min(frames, getNumThreads()));
+        for (int i = 0; i < workers; i++)
+            workers_.push_back(std::thread(&ImagePrefetcher::run, this));
+    }
+
+    ~ImagePrefetcher()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+            workCond_.notify_all();
+        }
+        for (size_t i = 0; i < workers_.size(); i++)
+            workers_[i].join();
+    }
+
+    int size() const
+    {
+        return (int)slots_.size();
+    }
+
+    // Image of the frame, empty if it can't be read
+    Mat read(unsigned index)
+    {
+        // the images added to the sequence after opening it aren't prefetched
+        if (index >= length_)
+            return decode(index);
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        schedule(index);
+        Slot& slot = slots_[index % slots_.size()];
+        if (slot.state == QUEUED)
+        {
+            slot.state = DECODING;
+            lock.unlock();
+            Mat image = decode(index);
+            lock.lock();
+            slot.image = image;
+            slot.state = DONE;
+        }
+        doneCond_.wait(lock, [&] { return slot.state == DONE; });
+
+        Mat image = slot.image;
+        slot.image.release();
+        slot.state = EMPTY;
+        schedule(index + 1);
+        return image;
+    }
+
+private:
+    enum { EMPTY, QUEUED, DECODING, DONE };
+
+    struct Slot
+    {
+        Slot() : index(0), state(EMPTY) {}
+
+        unsigned index;
+        int state;
+        Mat image;
+    };
+
+    Mat decode(unsigned index) const
+    {
+        Mat image;
+        CV_TRY
+        {
+            image = imread(format(pattern_.c_str(), firstframe_ + index), IMREAD_UNCHANGED);
+        }
+        CV_CATCH_ALL
+        {
+            image.release();
+        }
+        return image;
+    }
+
+    // Queues the frames of the ring starting at pos which aren't decoded or queued already
+    void schedule(unsigned pos)
+    {
+        const unsigned n = (unsigned)slots_.size();
+        const unsigned end = std::min(pos + n, length_);
+        for (unsigned k = pos; k < end; k++)
+        {
+            Slot& slot = slots_[k % n];
+            if (slot.index == k && slot.state != EMPTY)
+                continue;
+            slot.index = k;
+            slot.state = QUEUED;
+            slot.image.release();
+            queue_.push_back(k);
+        }
+        workCond_.notify_all();
+    }
+
+    void run()
+    {
+        const unsigned n = (unsigned)slots_.size();
+        std::unique_lock<std::mutex> lock(mutex_);
+        for (;;)
+        {
+            workCond_.wait(lock, [this] { return stopping_ || !queue_.empty(); });
+            if (stopping_)
+                return;
+            const unsigned k = queue_.front();
+            queue_.pop_front();
+            Slot& slot = slots_[k % n];
+            if (slot.index != k || slot.state != QUEUED)
+                continue;   // decoded by the reading thread or reassigned by a seek
+            slot.state = DECODING;
+            lock.unlock();
+            Mat image = decode(k);
+            lock.lock();
+            if (slot.index == k && slot.state == DECODING)
+            {
+                slot.image = image;
+                slot.state = DONE;
+                doneCond_.notify_all();
+            }
+        }
+    }
+
+    const std::string pattern_;
+    const unsigned firstframe_;
+    const unsigned length_;
+
+    std::vector<Slot> slots_;
+    std::deque<unsigned> queue_;   // frames for the workers, stale ones are skipped
+    bool stopping_;
+    std::vector<std::thread> workers_;
+
+    std::mutex mutex_;   // guards the slots and the queue
+    std::condition_variable workCond_;
+    std::condition_variable doneCond_;
+};
+
+} // namespace cv
+
 class CvCapture_Images : public CvCapture
 {
 public:
@@ -95,6 +250,10 @@ protected:
 
     IplImage* frame;
     bool grabbedInOpen;
+
+    cv::Ptr<cv::ImagePrefetcher> prefetcher; // with CAP_PROP_PREFETCH_FRAMES
+    cv::Mat prefetched;                      // the frame grabbed from it
+    IplImage prefetchedHeader;
 };
 
 
@@ -105,6 +264,8 @@ void CvCapture_Images::close()
         free(filename);
         filename = NULL;
     }
+    prefetcher.release();
+    prefetched.release();
     currentframe = firstframe = 0;
     length = 0;
     cvReleaseImage( &frame );
@@ -125,6 +286,17 @@ bool CvCapture_Images::grabFrame()
     }
 
     cvReleaseImage(&frame);
+    prefetched.release();
+    if (prefetcher)
+    {
+        prefetched = prefetcher->read(currentframe);
+        if (prefetched.empty())
+            return false;
+        prefetchedHeader = cvIplImage(prefetched);
+        currentframe++;
+        return true;
+    }
+
     frame = cvLoadImage(str, CV_LOAD_IMAGE_UNCHANGED);
     if( frame )
         currentframe++;
@@ -134,7 +306,9 @@ bool CvCapture_Images::grabFrame()
 
 IplImage* CvCapture_Images::retrieveFrame(int)
 {
-    return grabbedInOpen ? NULL : frame;
+    if (grabbedInOpen)
+        return NULL;
+    return prefetched.empty() ? frame : &prefetchedHeader;
 }
 
 double CvCapture_Images::getProperty(int id) const
@@ -151,15 +325,17 @@ double CvCapture_Images::getProperty(int id) const
     case CV_CAP_PROP_POS_AVI_RATIO:
         return (double)currentframe / (double)(length - 1);
     case CV_CAP_PROP_FRAME_WIDTH:
-        return frame ? frame->width : 0;
+        return frame ? frame->width : prefetched.cols;
     case CV_CAP_PROP_FRAME_HEIGHT:
-        return frame ? frame->height : 0;
+        return frame ? frame->height : prefetched.rows;
     case CV_CAP_PROP_FPS:
         CV_WARN("collections of images don't have framerates\n");
         return 1;
     case CV_CAP_PROP_FOURCC:
         CV_WARN("collections of images don't have 4-character codes\n");
         return 0;
+    case cv::CAP_PROP_PREFETCH_FRAMES:
+        return prefetcher ? prefetcher->size() : 0;
     }
     return 0;
 }
@@ -194,6 +370,15 @@ bool CvCapture_Images::setProperty(int id, double value)
         if (currentframe != 0)
             grabbedInOpen = false; // grabbed frame is not valid anymore
         return true;
+    case cv::CAP_PROP_PREFETCH_FRAMES:
+        if(value < 0) {
+            CV_WARN("the number of prefetched frames can't be negative\n");
+            return false;
+        }
+        prefetcher.release();
+        if (cvRound(value) > 0)
+            prefetcher = cv::makePtr<cv::ImagePrefetcher>(filename, firstframe, length, cvRound(value));
+        return true;
     }
     CV_WARN("unknown/unhandled property\n");
     return false;
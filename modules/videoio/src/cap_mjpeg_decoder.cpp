@@ -41,6 +41,7 @@
 
 #include "precomp.hpp"
 #include "opencv2/videoio/container_avi.private.hpp"
+#include "jpeg_decoder.hpp"
 
 namespace cv
 {
@@ -69,6 +70,8 @@ protected:
 
     frame_iterator   m_frame_iterator;
     Mat              m_current_frame;
+    mjpeg::JpegDecoder m_decoder;
+    int              m_decoder_mode;  // VideoCaptureMJPEGDecoders
 
     //frame width/height and fps could be different for
     //each frame/stream. At the moment we suppose that they
@@ -91,6 +94,14 @@ uint64_t MotionJpegCapture::getFramePos() const
 
 bool MotionJpegCapture::setProperty(int property, double value)
 {
+    if(property == CAP_PROP_MJPEG_DECODER)
+    {
+        int mode = cvRound(value);
+        if(mode != CAP_MJPEG_DECODER_AUTO && mode != CAP_MJPEG_DECODER_BUILTIN && mode != CAP_MJPEG_DECODER_IMDECODE)
+            return false;
+        m_decoder_mode = mode;
+        return true;
+    }
     if(property == CAP_PROP_POS_FRAMES)
     {
         if(int(value) == 0)
@@ -130,6 +141,8 @@ double MotionJpegCapture::getProperty(int property) const
             return (double)m_mjpeg_frames.size();
         case CAP_PROP_FORMAT:
             return 0;
+        case CAP_PROP_MJPEG_DECODER:
+            return m_decoder_mode;
         default:
             return 0;
     }
@@ -164,7 +177,14 @@ bool MotionJpegCapture::retrieveFrame(int, OutputArray output_frame)
 
         if(data.size())
         {
-            m_current_frame = imdecode(data, CV_LOAD_IMAGE_ANYDEPTH | CV_LOAD_IMAGE_COLOR | IMREAD_IGNORE_ORIENTATION);
+            // the built-in decoder is faster than libjpeg-turbo when it decodes the restart
+            // intervals in parallel only, the frames it doesn't support go to libjpeg as well
+            const uchar* jpeg = (const uchar*)&data[0];
+            bool builtin = m_decoder_mode == CAP_MJPEG_DECODER_BUILTIN ||
+                (m_decoder_mode == CAP_MJPEG_DECODER_AUTO && getNumThreads() > 1 &&
+                 mjpeg::JpegDecoder::hasRestartInterval(jpeg, data.size()));
+            if(!builtin || !m_decoder.decode(jpeg, data.size(), m_current_frame))
+                m_current_frame = imdecode(data, CV_LOAD_IMAGE_ANYDEPTH | CV_LOAD_IMAGE_COLOR | IMREAD_IGNORE_ORIENTATION);
         }
 
         m_current_frame.copyTo(output_frame);
@@ -181,6 +201,7 @@ MotionJpegCapture::~MotionJpegCapture()
 }
 
 MotionJpegCapture::MotionJpegCapture(const String& filename)
+    : m_decoder_mode(CAP_MJPEG_DECODER_AUTO)
 {
     m_avi_container = makePtr<AVIReadContainer>();
     m_avi_container->initStream(filename);
@@ -41,6 +41,7 @@
 
 #include "precomp.hpp"
 #include "opencv2/videoio/container_avi.private.hpp"
+#include "jpeg_decoder.hpp"
 
 #include <vector>
 #include <deque>
@@ -598,21 +599,21 @@ static const uchar jpegTableK2_T[] =
 // Standard Huffman tables
 
 // ... for luma DCs.
-static const uchar jpegTableK3[] =
+const uchar jpegTableK3[] =
 {
     0, 1, 5, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0,
     0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11
 };
 
 // ... for chroma DCs.
-static const uchar jpegTableK4[] =
+const uchar jpegTableK4[] =
 {
     0, 3, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0,
     0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11
 };
 
 // ... for luma ACs.
-static const uchar jpegTableK5[] =
+const uchar jpegTableK5[] =
 {
     0, 2, 1, 3, 3, 2, 4, 3, 5, 5, 4, 4, 0, 0, 1, 125,
     0x01, 0x02, 0x03, 0x00, 0x04, 0x11, 0x05, 0x12,
@@ -639,7 +640,7 @@ static const uchar jpegTableK5[] =
 };
 
 // ... for chroma ACs
-static const uchar jpegTableK6[] =
+const uchar jpegTableK6[] =
 {
     0, 2, 1, 2, 4, 4, 3, 4, 7, 5, 4, 4, 0, 1, 2, 119,
     0x00, 0x01, 0x02, 0x03, 0x11, 0x04, 0x05, 0x21,
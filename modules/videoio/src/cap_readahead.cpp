@@ -0,0 +1,359 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#include "precomp.hpp"
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace cv
+{
+
+// Grabs and retrieves the frames of the wrapped capture on a background thread, into a ring
+// of CAP_PROP_READAHEAD_FRAMES frames. The frame buffers are swapped between the ring and
+// the application side instead of being copied, so once the ring is warm no frame is
+// allocated. With 0 frames (the default) the calls go to the wrapped capture directly.
+// For VideoCapture::waitAny() a pipe is kept readable while frames wait or the stream ended.
+class ReadAheadCapture CV_FINAL : public IVideoCapture
+{
+public:
+    explicit ReadAheadCapture(const Ptr<IVideoCapture>& capture)
+        : capture_(capture), policy_(CAP_READAHEAD_BLOCK),
+          head_(0), count_(0), running_(false), stopping_(false), finished_(false),
+          posFrames_(0), posMsec_(0)
+    {
+        CV_Assert(!capture_.empty());
+        readyPipe_[0] = readyPipe_[1] = -1;
+    }
+
+    ~ReadAheadCapture() CV_OVERRIDE
+    {
+        stop();
+#ifndef _WIN32
+        if (readyPipe_[0] >= 0)
+        {
+            ::close(readyPipe_[0]);
+            ::close(readyPipe_[1]);
+        }
+#endif
+    }
+
+    double getProperty(int propId) const CV_OVERRIDE
+    {
+        if (propId == CAP_PROP_READAHEAD_FRAMES)
+            return (double)ring_.size();
+        if (propId == CAP_PROP_READAHEAD_POLICY)
+            return policy_;
+        if (running_ && (propId == CAP_PROP_POS_FRAMES || propId == CAP_PROP_POS_MSEC))
+        {
+            // the wrapped capture is ahead, report the position of the frame given out last
+            std::lock_guard<std::mutex> lock(queueMutex_);
+            return propId == CAP_PROP_POS_FRAMES ? posFrames_ : posMsec_;
+        }
+        std::lock_guard<std::mutex> lock(captureMutex_);
+        return capture_->getProperty(propId);
+    }
+
+    bool setProperty(int propId, double value) CV_OVERRIDE
+    {
+        if (propId == CAP_PROP_READAHEAD_FRAMES)
+        {
+            if (value < 0)
+                return false;
+            stopAndRewind();
+            ring_.resize(cvRound(value));
+            return true;
+        }
+        if (propId == CAP_PROP_READAHEAD_POLICY)
+        {
+            const int policy = cvRound(value);
+            if (policy != CAP_READAHEAD_BLOCK && policy != CAP_READAHEAD_DROP_OLDEST)
+                return false;
+            std::lock_guard<std::mutex> lock(queueMutex_);
+            policy_ = policy;
+            spaceCond_.notify_all();
+            return true;
+        }
+        // seeking and changing the device settings invalidate the frames read ahead
+        if (propId == CAP_PROP_POS_FRAMES || propId == CAP_PROP_POS_MSEC || propId == CAP_PROP_POS_AVI_RATIO)
+            stop();
+        else
+            stopAndRewind();
+        std::lock_guard<std::mutex> lock(captureMutex_);
+        return capture_->setProperty(propId, value);
+    }
+
+    bool setBuffers(const std::vector<Mat>& buffers) CV_OVERRIDE
+    {
+        stop();
+        std::lock_guard<std::mutex> lock(captureMutex_);
+        return capture_->setBuffers(buffers);
+    }
+
+    bool grabFrame() CV_OVERRIDE
+    {
+        if (ring_.empty())
+            return capture_->grabFrame();
+        if (!running_)
+            start();
+
+        std::unique_lock<std::mutex> lock(queueMutex_);
+        frameCond_.wait(lock, [this] { return count_ > 0 || finished_; });
+        if (count_ == 0)
+        {
+            current_.release();
+            return false;
+        }
+        Frame& frame = ring_[head_];
+        std::swap(current_, frame.image);
+        posFrames_ = frame.posFrames;
+        posMsec_ = frame.posMsec;
+        head_ = (head_ + 1) % ring_.size();
+        count_--;
+        if (count_ == 0 && !finished_)
+            clearReady();
+        spaceCond_.notify_one();
+        return true;
+    }
+
+    bool retrieveFrame(int channel, OutputArray image) CV_OVERRIDE
+    {
+        if (ring_.empty())
+            return capture_->retrieveFrame(channel, image);
+        // only the default channel is retrieved ahead
+        if (channel != 0 || current_.empty())
+        {
+            image.release();
+            return false;
+        }
+        current_.copyTo(image);
+        return true;
+    }
+
+    bool isOpened() const CV_OVERRIDE
+    {
+        std::lock_guard<std::mutex> lock(captureMutex_);
+        return capture_->isOpened();
+    }
+
+    int getCaptureDomain() CV_OVERRIDE
+    {
+        return capture_->getCaptureDomain();
+    }
+
+    int getFrameReadyFd() CV_OVERRIDE
+    {
+        if (ring_.empty())
+        {
+            std::lock_guard<std::mutex> lock(captureMutex_);
+            return capture_->getFrameReadyFd();
+        }
+#ifndef _WIN32
+        if (readyPipe_[0] < 0)
+        {
+            if (::pipe(readyPipe_) != 0)
+            {
+                readyPipe_[0] = readyPipe_[1] = -1;
+                return -1;
+            }
+            fcntl(readyPipe_[0], F_SETFL, O_NONBLOCK);
+            fcntl(readyPipe_[1], F_SETFL, O_NONBLOCK);
+            std::lock_guard<std::mutex> lock(queueMutex_);
+            if (count_ > 0 || finished_)
+                signalReady();
+        }
+        if (!running_)
+            start();
+        return readyPipe_[0];
+#else
+        return -1;
+#endif
+    }
+
+private:
+    struct Frame
+    {
+        Frame() : posFrames(0), posMsec(0) {}
+
+        Mat image;
+        double posFrames;
+        double posMsec;
+    };
+
+    void start()
+    {
+        CV_Assert(!running_);
+        {
+            std::lock_guard<std::mutex> lock(captureMutex_);
+            posFrames_ = capture_->getProperty(CAP_PROP_POS_FRAMES);
+            posMsec_ = capture_->getProperty(CAP_PROP_POS_MSEC);
+        }
+        head_ = count_ = 0;
+        stopping_ = finished_ = false;
+        running_ = true;
+        worker_ = std::thread(&ReadAheadCapture::run, this);
+    }
+
+    void stop()
+    {
+        if (!running_)
+            return;
+        {
+            std::lock_guard<std::mutex> lock(queueMutex_);
+            stopping_ = true;
+            spaceCond_.notify_all();
+        }
+        worker_.join();
+        running_ = false;
+        head_ = count_ = 0;
+        current_.release();
+        clearReady();
+    }
+
+    // Stops reading ahead. A file is sought back to the frame after the one given out last, so
+    // the frames read ahead are read again; those of a live source are lost.
+    void stopAndRewind()
+    {
+        if (!running_)
+            return;
+        stop();
+        std::lock_guard<std::mutex> lock(captureMutex_);
+        if (capture_->getProperty(CAP_PROP_FRAME_COUNT) > 0 &&
+            !capture_->setProperty(CAP_PROP_POS_FRAMES, posFrames_))
+            CV_LOG_WARNING(NULL, "VIDEOIO: can't seek back to the frames read ahead, they are skipped");
+    }
+
+    // The frames in memory of another allocator, e.g. the buffers of a V4L2 device, are copied:
+    // the ring would hold all the device buffers with CAP_PROP_BUFFERSIZE - 1 frames or more
+    static bool ownsMemory(const Mat& image)
+    {
+        return image.u && (image.u->currAllocator == Mat::getDefaultAllocator() ||
+                           image.u->currAllocator == Mat::getStdAllocator());
+    }
+
+    // The pipe holds data while frames wait or the stream ended, called under queueMutex_
+    void signalReady()
+    {
+#ifndef _WIN32
+        char byte = 0;
+        if (readyPipe_[1] >= 0 && ::write(readyPipe_[1], &byte, 1) != 1)
+            CV_LOG_WARNING(NULL, "VIDEOIO: can't signal the frames read ahead");
+#endif
+    }
+
+    void clearReady()
+    {
+#ifndef _WIN32
+        char buf[16];
+        if (readyPipe_[0] >= 0)
+            while (::read(readyPipe_[0], buf, sizeof(buf)) > 0)
+                ;
+#endif
+    }
+
+    void run()
+    {
+        const size_t size = ring_.size();
+        for (;;)
+        {
+            size_t slot;
+            {
+                std::unique_lock<std::mutex> lock(queueMutex_);
+                spaceCond_.wait(lock, [this, size] {
+                    return stopping_ || count_ < size || policy_ == CAP_READAHEAD_DROP_OLDEST;
+                });
+                if (stopping_)
+                    return;
+                if (count_ == size)
+                {
+                    // the next frame takes its place, the ready state stays
+                    head_ = (head_ + 1) % size;
+                    count_--;
+                }
+                // the slot after the waiting frames is not touched by grabFrame()
+                slot = (head_ + count_) % size;
+            }
+
+            Frame& frame = ring_[slot];
+            bool ok = false;
+            CV_TRY
+            {
+                std::lock_guard<std::mutex> lock(captureMutex_);
+                Mat buffer = frame.image;
+                ok = capture_->grabFrame() && capture_->retrieveFrame(0, frame.image) && !frame.image.empty();
+                if (ok && !ownsMemory(frame.image))
+                {
+                    // a view of the backend's buffer, overwritten by the next grab, or a device
+                    // buffer the device needs back for the next frames (CAP_PROP_V4L_MEMORY)
+                    Mat view = frame.image;
+                    frame.image = buffer;
+                    view.copyTo(frame.image);
+                }
+                if (ok)
+                {
+                    frame.posFrames = capture_->getProperty(CAP_PROP_POS_FRAMES);
+                    frame.posMsec = capture_->getProperty(CAP_PROP_POS_MSEC);
+                }
+            }
+            CV_CATCH_ALL
+            {
+                CV_LOG_WARNING(NULL, "VIDEOIO: exception while reading frames ahead, stopping");
+                ok = false;
+            }
+
+            std::lock_guard<std::mutex> lock(queueMutex_);
+            if (!ok)
+            {
+                if (count_ == 0)
+                    signalReady();
+                finished_ = true;
+                frameCond_.notify_all();
+                return;
+            }
+            if (count_++ == 0)
+                signalReady();
+            frameCond_.notify_one();
+        }
+    }
+
+    Ptr<IVideoCapture> capture_;
+    int policy_;
+
+    std::vector<Frame> ring_;
+    size_t head_;   // oldest waiting frame
+    size_t count_;  // number of waiting frames
+    Mat current_;   // the frame given out by the last grabFrame()
+
+    std::thread worker_;
+    bool running_;
+    bool stopping_;
+    bool finished_;
+    double posFrames_;
+    double posMsec_;
+
+    int readyPipe_[2];
+
+    mutable std::mutex queueMutex_;    // guards the ring state, the position and the flags
+    mutable std::mutex captureMutex_;  // serializes the calls to the wrapped capture
+    std::condition_variable frameCond_;
+    std::condition_variable spaceCond_;
+};
+
+Ptr<IVideoCapture> createReadAheadCapture(const Ptr<IVideoCapture>& capture)
+{
+    return makePtr<ReadAheadCapture>(capture);
+}
+
+bool isReadAheadCapture(const Ptr<IVideoCapture>& capture)
+{
+    return dynamic_cast<ReadAheadCapture*>(capture.get()) != NULL;
+}
+
+} // namespace cv
@@ -0,0 +1,365 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#include "precomp.hpp"
+
+#include <condition_variable>
+#include <algorithm>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+namespace cv
+{
+
+// Decodes a video file with several instances of its backend, each on its own thread. The
+// frames are split into parts and the instance k decodes the parts k, k + decoders,
+// k + 2*decoders..., seeking to each of them. The last part runs to the end of the file, as
+// the frame count of some backends is an estimate.
+//
+// A part starts on a keyframe when the backend has a keyframe index (CAP_PROP_KEYFRAME_INDEX),
+// at least partFrames frames after the start of the part before. Otherwise a seek decodes from
+// the keyframe before the part, so by default each instance decodes one contiguous part.
+//
+// Ordered, every instance queues up to orderedQueueFrames frames, so it decodes ahead while
+// the frames before are read. Unordered, the queues are short and grabFrame() takes the
+// frames of the instances in turn.
+class SegmentedCapture CV_FINAL : public IVideoCapture
+{
+public:
+    SegmentedCapture()
+        : api_(0), ordered_(true), partCount_(0), capacity_(0), frameCount_(0),
+          fps_(0), width_(0), height_(0), fourcc_(0),
+          next_(0), turn_(0), posFrames_(0), posMsec_(0), stopping_(false)
+    {
+    }
+
+    ~SegmentedCapture() CV_OVERRIDE
+    {
+        stop();
+    }
+
+    bool open(const String& filename, int apiPreference, int decoders, bool ordered, int partFrames)
+    {
+        CV_Assert(decoders > 0 && partFrames >= 0);
+        bool indexed = false;
+        for (int k = 0; k < decoders; k++)
+        {
+            Ptr<Decoder> d = makePtr<Decoder>();
+            // the instances after the first one use the backend it got
+            if (!d->capture.open(filename, k == 0 ? apiPreference : api_))
+                return false;
+            // the instances count the frames the same way, with the index or without it
+            if (k == 0)
+                indexed = d->capture.set(CAP_PROP_KEYFRAME_INDEX, 1);
+            else if (indexed && !d->capture.set(CAP_PROP_KEYFRAME_INDEX, 1))
+                return false;
+            if (k == 0)
+            {
+                api_ = cvRound(d->capture.get(CAP_PROP_BACKEND));
+                frameCount_ = cvRound(d->capture.get(CAP_PROP_FRAME_COUNT));
+                fps_ = d->capture.get(CAP_PROP_FPS);
+                width_ = d->capture.get(CAP_PROP_FRAME_WIDTH);
+                height_ = d->capture.get(CAP_PROP_FRAME_HEIGHT);
+                fourcc_ = d->capture.get(CAP_PROP_FOURCC);
+                if (frameCount_ <= 0)
+                {
+                    CV_LOG_WARNING(NULL, "VIDEOIO: the frame count of the video is unknown, it can't be split");
+                    return false;
+                }
+                ordered_ = ordered;
+                splitParts(d->capture, indexed,
+                           partFrames > 0 ? partFrames :
+                           indexed && ordered ? std::min((int)defaultOrderedPartFrames, frameCount_) :
+                           (frameCount_ + decoders - 1) / decoders);
+                capacity_ = ordered ? orderedQueueFrames : unorderedQueueFrames;
+            }
+            // the first part is checked here, so a backend that can't seek fails to open
+            if (k > 0 && k < partCount_ && !d->capture.set(CAP_PROP_POS_FRAMES, starts_[k]))
+            {
+                CV_LOG_WARNING(NULL, "VIDEOIO: the backend can't seek, the video can't be split");
+                return false;
+            }
+            decoders_.push_back(d);
+        }
+
+        for (size_t k = 0; k < decoders_.size(); k++)
+            decoders_[k]->thread = std::thread(&SegmentedCapture::run, this, (int)k);
+        return true;
+    }
+
+    double getProperty(int propId) const CV_OVERRIDE
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        switch (propId)
+        {
+        case CAP_PROP_POS_FRAMES:
+            return posFrames_;
+        case CAP_PROP_POS_MSEC:
+            return posMsec_;
+        case CAP_PROP_FRAME_COUNT:
+            return frameCount_;
+        case CAP_PROP_FPS:
+            return fps_;
+        case CAP_PROP_FRAME_WIDTH:
+            return width_;
+        case CAP_PROP_FRAME_HEIGHT:
+            return height_;
+        case CAP_PROP_FOURCC:
+            return fourcc_;
+        default:
+            // the instances are busy on their threads
+            return 0;
+        }
+    }
+
+    bool setProperty(int, double) CV_OVERRIDE
+    {
+        return false;
+    }
+
+    bool grabFrame() CV_OVERRIDE
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        Frame frame;
+        if (!(ordered_ ? popOrdered(lock, frame) : popUnordered(lock, frame)))
+        {
+            current_.release();
+            return false;
+        }
+        // the buffer of the previous frame goes back to the instances
+        if (!current_.empty())
+            free_.push_back(current_);
+        current_ = frame.image;
+        posFrames_ = (double)(frame.index + 1);
+        posMsec_ = frame.posMsec;
+        spaceCond_.notify_all();
+        return true;
+    }
+
+    bool retrieveFrame(int channel, OutputArray image) CV_OVERRIDE
+    {
+        if (channel != 0 || current_.empty())
+        {
+            image.release();
+            return false;
+        }
+        current_.copyTo(image);
+        return true;
+    }
+
+    bool isOpened() const CV_OVERRIDE
+    {
+        return !decoders_.empty();
+    }
+
+    int getCaptureDomain() CV_OVERRIDE
+    {
+        return api_;
+    }
+
+private:
+    enum { defaultOrderedPartFrames = 64, orderedQueueFrames = 64, unorderedQueueFrames = 4 };
+
+    struct Frame
+    {
+        Frame() : index(0), posMsec(0) {}
+
+        Mat image;
+        int index;
+        double posMsec;
+    };
+
+    struct Decoder
+    {
+        Decoder() : partsDone(0), finished(false) {}
+
+        VideoCapture capture;
+        std::deque<Frame> queue;
+        int partsDone;   // the parts before are queued completely
+        bool finished;
+        std::thread thread;
+    };
+
+    // Parts of at least partFrames frames, from one keyframe to the next with the index
+    void splitParts(VideoCapture& capture, bool indexed, int partFrames)
+    {
+        starts_.clear();
+        for (int start = 0;;)
+        {
+            starts_.push_back(start);
+            int next = start + partFrames;
+            if (indexed && next < frameCount_ && capture.set(CAP_PROP_NEXT_KEYFRAME, next))
+                next = cvRound(capture.get(CAP_PROP_NEXT_KEYFRAME));
+            if (next <= start || next >= frameCount_)
+                break;
+            start = next;
+        }
+        partCount_ = (int)starts_.size();
+    }
+
+    int partOf(int index) const
+    {
+        return std::max((int)(std::upper_bound(starts_.begin(), starts_.end(), index) - starts_.begin()) - 1, 0);
+    }
+
+    bool popOrdered(std::unique_lock<std::mutex>& lock, Frame& frame)
+    {
+        for (;;)
+        {
+            const int part = partOf(next_);
+            Decoder& d = *decoders_[part % decoders_.size()];
+            frameCond_.wait(lock, [&] {
+                return stopping_ || !d.queue.empty() || d.partsDone > part || d.finished;
+            });
+            if (stopping_)
+                return false;
+            if (!d.queue.empty() && partOf(d.queue.front().index) == part)
+            {
+                frame = d.queue.front();
+                d.queue.pop_front();
+                next_ = frame.index + 1;
+                return true;
+            }
+            // the part ended before its last frame
+            if (part == partCount_ - 1)
+                return false;
+            next_ = starts_[part + 1];
+        }
+    }
+
+    bool popUnordered(std::unique_lock<std::mutex>& lock, Frame& frame)
+    {
+        const size_t n = decoders_.size();
+        for (;;)
+        {
+            size_t finished = 0;
+            for (size_t i = 0; i < n; i++)
+            {
+                Decoder& d = *decoders_[(turn_ + i) % n];
+                if (!d.queue.empty())
+                {
+                    frame = d.queue.front();
+                    d.queue.pop_front();
+                    turn_ = (turn_ + i + 1) % n;
+                    return true;
+                }
+                finished += d.finished;
+            }
+            if (finished == n || stopping_)
+                return false;
+            frameCond_.wait(lock);
+        }
+    }
+
+    void run(int k)
+    {
+        Decoder& d = *decoders_[k];
+        const int n = (int)decoders_.size();
+        bool ok = true;
+        for (int part = k; part < partCount_ && ok; part += n)
+        {
+            const int start = starts_[part];
+            const int end = part == partCount_ - 1 ? INT_MAX : starts_[part + 1];
+            CV_TRY
+            {
+                // the first part was sought in open()
+                if (part != k && !d.capture.set(CAP_PROP_POS_FRAMES, start))
+                    break;
+                for (int index = start; index < end; index++)
+                {
+                    Frame frame;
+                    {
+                        std::unique_lock<std::mutex> lock(mutex_);
+                        spaceCond_.wait(lock, [&] { return stopping_ || (int)d.queue.size() < capacity_; });
+                        if (stopping_)
+                        {
+                            ok = false;
+                            break;
+                        }
+                        if (!free_.empty())
+                        {
+                            frame.image = free_.back();
+                            free_.pop_back();
+                        }
+                    }
+                    Mat buffer = frame.image;
+                    if (!d.capture.read(frame.image) || frame.image.empty())
+                        break;
+                    if (!frame.image.u)
+                    {
+                        // a view of the backend's buffer, overwritten by the next read
+                        Mat view = frame.image;
+                        frame.image = buffer;
+                        view.copyTo(frame.image);
+                    }
+                    frame.index = index;
+                    frame.posMsec = d.capture.get(CAP_PROP_POS_MSEC);
+
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    d.queue.push_back(frame);
+                    frameCond_.notify_all();
+                }
+            }
+            CV_CATCH_ALL
+            {
+                CV_LOG_WARNING(NULL, "VIDEOIO: exception while decoding a part of the video, stopping the decoder");
+                ok = false;
+            }
+
+            std::lock_guard<std::mutex> lock(mutex_);
+            d.partsDone = part + 1;
+            frameCond_.notify_all();
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        d.finished = true;
+        frameCond_.notify_all();
+    }
+
+    void stop()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+            spaceCond_.notify_all();
+            frameCond_.notify_all();
+        }
+        for (size_t k = 0; k < decoders_.size(); k++)
+            if (decoders_[k]->thread.joinable())
+                decoders_[k]->thread.join();
+    }
+
+    int api_;
+    bool ordered_;
+    std::vector<int> starts_;   // first frames of the parts
+    int partCount_;
+    int capacity_;    // frames queued by an instance at most
+    int frameCount_;
+    double fps_, width_, height_, fourcc_;
+
+    std::vector<Ptr<Decoder> > decoders_;
+    std::vector<Mat> free_;   // buffers of the frames read before
+    int next_;                // ordered, the frame to give out next
+    size_t turn_;             // unordered, the instance to take a frame from first
+    Mat current_;             // the frame given out by the last grabFrame()
+    double posFrames_;
+    double posMsec_;
+    bool stopping_;
+
+    mutable std::mutex mutex_;   // guards the queues, the buffers and the position
+    std::condition_variable frameCond_;
+    std::condition_variable spaceCond_;
+};
+
+Ptr<IVideoCapture> createSegmentedCapture(const String& filename, int apiPreference,
+                                          int decoders, bool ordered, int partFrames)
+{
+    Ptr<SegmentedCapture> capture = makePtr<SegmentedCapture>();
+    if (!capture->open(filename, apiPreference, decoders, ordered, partFrames))
+        return Ptr<IVideoCapture>();
+    return capture;
+}
+
+} // namespace cv
@@ -265,6 +265,113 @@ struct buffer
     size_t  length;
 };
 
+static bool v4l2_queue_buffer(int deviceHandle, __u32 memory, unsigned index, const buffer& b)
+{
+    v4l2_buffer buf = v4l2_buffer();
+    buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    buf.memory = memory;
+    buf.index = index;
+    if (memory == V4L2_MEMORY_USERPTR) {
+        buf.m.userptr = (unsigned long)b.start;
+        buf.length = (__u32)b.length;
+    }
+
+    if (-1 == ioctl (deviceHandle, VIDIOC_QBUF, &buf)) {
+        perror ("VIDIOC_QBUF");
+        return false;
+    }
+    return true;
+}
+
+/* Device buffers of CAP_V4L_MEMORY_MMAP and CAP_V4L_MEMORY_USERPTR, shared by the capture with
+   the Mats wrapping them. The memory stays valid while any of these Mats is alive. */
+struct V4LBufferPool
+{
+    V4LBufferPool() : deviceHandle(-1), memory(V4L2_MEMORY_MMAP), count(0) {}
+
+    ~V4LBufferPool() {
+        if (memory == V4L2_MEMORY_MMAP) {
+            for (unsigned int i = 0; i < count; ++i) {
+                if (-1 == munmap (buffers[i].start, buffers[i].length))
+                    perror ("munmap");
+            }
+        }
+    }
+
+    /* gives the buffer back to the device, unless the capture stopped streaming */
+    void queue(unsigned index) {
+        AutoLock lock(mutex);
+        if (deviceHandle != -1)
+            v4l2_queue_buffer(deviceHandle, memory, index, buffers[index]);
+    }
+
+    /* called before the device is closed */
+    void detach() {
+        AutoLock lock(mutex);
+        deviceHandle = -1;
+    }
+
+    Mutex mutex;
+    int deviceHandle;
+    __u32 memory;
+    unsigned count;
+    buffer buffers[MAX_V4L_BUFFERS];
+    std::vector<Mat> userBuffers;   // memory of the USERPTR buffers
+};
+
+/* Allocator of the Mats wrapping a device buffer, which is queued again when they are released */
+class V4LBufferAllocator CV_FINAL : public MatAllocator
+{
+public:
+    static const V4LBufferAllocator& instance() {
+        static V4LBufferAllocator allocator;
+        return allocator;
+    }
+
+    /* 1-row Mat of the whole buffer, referring to the pool */
+    Mat wrap(const Ptr<V4LBufferPool>& pool, unsigned index) const {
+        const buffer& b = pool->buffers[index];
+        UMatData* u = new UMatData(this);
+        u->data = u->origdata = (uchar*)b.start;
+        u->size = b.length;
+        u->userdata = new BufferRef(pool, index);
+
+        Mat m(1, (int)b.length, CV_8UC1, b.start);
+        m.u = u;
+        m.addref();
+        return m;
+    }
+
+    /* the Mats wrapping the buffers allocate new data as usual */
+    UMatData* allocate(int dims, const int* sizes, int type, void* data, size_t* step,
+                       AccessFlag flags, UMatUsageFlags usageFlags) const CV_OVERRIDE {
+        return Mat::getStdAllocator()->allocate(dims, sizes, type, data, step, flags, usageFlags);
+    }
+
+    bool allocate(UMatData* u, AccessFlag accessFlags, UMatUsageFlags usageFlags) const CV_OVERRIDE {
+        return Mat::getStdAllocator()->allocate(u, accessFlags, usageFlags);
+    }
+
+    void deallocate(UMatData* u) const CV_OVERRIDE {
+        if (!u)
+            return;
+        CV_Assert(u->urefcount == 0 && u->refcount == 0);
+        BufferRef* ref = (BufferRef*)u->userdata;
+        ref->pool->queue(ref->index);
+        delete ref;
+        delete u;
+    }
+
+private:
+    struct BufferRef
+    {
+        BufferRef(const Ptr<V4LBufferPool>& _pool, unsigned _index) : pool(_pool), index(_index) {}
+
+        Ptr<V4LBufferPool> pool;
+        unsigned index;
+    };
+};
+
 struct CvCaptureCAM_V4L CV_FINAL : public CvCapture
 {
     int getCaptureDomain() /*const*/ CV_OVERRIDE { return cv::CAP_V4L; }
@@ -286,6 +393,12 @@ struct CvCaptureCAM_V4L CV_FINAL : public CvCapture
     bool frame_allocated;
     bool returnFrame;
 
+    int memoryMode;                  // CAP_V4L_MEMORY_*
+    std::vector<Mat> userBuffers;    // given to setBuffers()
+    Ptr<V4LBufferPool> bufferPool;   // without CAP_V4L_MEMORY_COPY
+    Mat heldBuffer;                  // the buffer of the grabbed frame, from bufferPool
+    Mat bayerBuffer;                 // the decompressed SN9C10X frame, not in a device buffer
+
     /* V4L2 variables */
     buffer buffers[MAX_V4L_BUFFERS + 1];
     v4l2_capability cap;
@@ -309,6 +422,9 @@ struct CvCaptureCAM_V4L CV_FINAL : public CvCapture
     virtual bool setProperty(int, double) CV_OVERRIDE;
     virtual bool grabFrame() CV_OVERRIDE;
     virtual IplImage* retrieveFrame(int) CV_OVERRIDE;
+    virtual int getFrameReadyFd() CV_OVERRIDE;
+    virtual bool setBuffers(const std::vector<Mat>&) CV_OVERRIDE;
+    virtual bool retrieveMat(int, OutputArray) CV_OVERRIDE;
 
     Range getRange(int property_id) const {
         switch (property_id) {
@@ -663,19 +779,22 @@ static int _capture_V4L2 (CvCaptureCAM_V4L *capture)
 
     capture->req = v4l2_requestbuffers();
 
+    const bool userptr = capture->memoryMode == CAP_V4L_MEMORY_USERPTR;
     unsigned int buffer_number = capture->bufferSize;
+    if (userptr && !capture->userBuffers.empty())
+        buffer_number = std::min((unsigned int)capture->userBuffers.size(), (unsigned int)MAX_V4L_BUFFERS);
 
 try_again:
 
     capture->req.count = buffer_number;
     capture->req.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
-    capture->req.memory = V4L2_MEMORY_MMAP;
+    capture->req.memory = userptr ? V4L2_MEMORY_USERPTR : V4L2_MEMORY_MMAP;
 
     if (-1 == ioctl (capture->deviceHandle, VIDIOC_REQBUFS, &capture->req))
     {
         if (EINVAL == errno)
         {
-            fprintf (stderr, "%s does not support memory mapping\n", deviceName);
+            fprintf (stderr, "%s does not support %s\n", deviceName, userptr ? "user pointers" : "memory mapping");
         } else {
             perror ("VIDIOC_REQBUFS");
         }
@@ -701,8 +820,35 @@ try_again:
         }
     }
 
+    if (capture->memoryMode != CAP_V4L_MEMORY_COPY)
+    {
+        capture->bufferPool = makePtr<V4LBufferPool>();
+        capture->bufferPool->deviceHandle = capture->deviceHandle;
+        capture->bufferPool->memory = capture->req.memory;
+    }
+
     for (unsigned int n_buffers = 0; n_buffers < capture->req.count; ++n_buffers)
     {
+        if (userptr)
+        {
+            /* memory of the application, or allocated here */
+            const size_t sizeimage = capture->form.fmt.pix.sizeimage;
+            Mat m = n_buffers < capture->userBuffers.size() ? capture->userBuffers[n_buffers] :
+                                                              Mat(1, (int)sizeimage, CV_8UC1);
+            if (m.total() * m.elemSize() < sizeimage) {
+                fprintf (stderr, "VIDEOIO ERROR: V4L2: buffer %u is smaller than the frames (%u bytes)\n",
+                         n_buffers, (unsigned int)sizeimage);
+                icvCloseCAM_V4L (capture);
+                return -1;
+            }
+            capture->bufferPool->userBuffers.push_back(m);
+            capture->bufferPool->buffers[n_buffers].start = m.data;
+            capture->bufferPool->buffers[n_buffers].length = m.total() * m.elemSize();
+            capture->bufferPool->count = n_buffers + 1;
+            capture->buffers[n_buffers] = capture->bufferPool->buffers[n_buffers];
+            continue;
+        }
+
         v4l2_buffer buf = v4l2_buffer();
         buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
         buf.memory = V4L2_MEMORY_MMAP;
@@ -732,7 +878,11 @@ try_again:
             return -1;
         }
 
-        if (n_buffers == 0) {
+        if (capture->bufferPool) {
+            /* unmapped by the pool */
+            capture->bufferPool->buffers[n_buffers] = capture->buffers[n_buffers];
+            capture->bufferPool->count = n_buffers + 1;
+        } else if (n_buffers == 0) {
             capture->buffers[MAX_V4L_BUFFERS].start = malloc( buf.length );
             capture->buffers[MAX_V4L_BUFFERS].length = buf.length;
         }
@@ -819,7 +969,7 @@ static int read_frame_v4l2(CvCaptureCAM_V4L* capture) {
     v4l2_buffer buf = v4l2_buffer();
 
     buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
-    buf.memory = V4L2_MEMORY_MMAP;
+    buf.memory = capture->req.memory;
 
     if (-1 == ioctl (capture->deviceHandle, VIDIOC_DQBUF, &buf)) {
         switch (errno) {
@@ -846,17 +996,23 @@ static int read_frame_v4l2(CvCaptureCAM_V4L* capture) {
 
     assert(buf.index < capture->req.count);
 
-    memcpy(capture->buffers[MAX_V4L_BUFFERS].start,
-            capture->buffers[buf.index].start,
-            capture->buffers[MAX_V4L_BUFFERS].length );
-    capture->bufferIndex = MAX_V4L_BUFFERS;
+    if (capture->bufferPool) {
+        /* the frame stays in the buffer, queued again once no Mat refers to it */
+        capture->heldBuffer = V4LBufferAllocator::instance().wrap(capture->bufferPool, buf.index);
+        capture->bufferIndex = buf.index;
+    } else {
+        memcpy(capture->buffers[MAX_V4L_BUFFERS].start,
+                capture->buffers[buf.index].start,
+                capture->buffers[MAX_V4L_BUFFERS].length );
+        capture->bufferIndex = MAX_V4L_BUFFERS;
+    }
     //printf("got data in buff %d, len=%d, flags=0x%X, seq=%d, used=%d)\n",
     //    buf.index, buf.length, buf.flags, buf.sequence, buf.bytesused);
 
     //set timestamp in capture struct to be timestamp of most recent frame
     capture->timestamp = buf.timestamp;
 
-    if (-1 == ioctl (capture->deviceHandle, VIDIOC_QBUF, &buf))
+    if (!capture->bufferPool && -1 == ioctl (capture->deviceHandle, VIDIOC_QBUF, &buf))
         perror ("VIDIOC_QBUF");
 
     return 1;
@@ -900,7 +1056,7 @@ static int mainloop_v4l2(CvCaptureCAM_V4L* capture) {
     return 0;
 }
 
-static bool icvGrabFrameCAM_V4L(CvCaptureCAM_V4L* capture) {
+static bool icvStartStreamingCAM_V4L(CvCaptureCAM_V4L* capture) {
     if (capture->FirstCapture) {
         /* Some general initialization must take place the first time through */
 
@@ -913,17 +1069,9 @@ static bool icvGrabFrameCAM_V4L(CvCaptureCAM_V4L* capture) {
                     capture->bufferIndex < ((int)capture->req.count);
                     ++capture->bufferIndex)
             {
-
-                v4l2_buffer buf = v4l2_buffer();
-
-                buf.type        = V4L2_BUF_TYPE_VIDEO_CAPTURE;
-                buf.memory      = V4L2_MEMORY_MMAP;
-                buf.index       = (unsigned long)capture->bufferIndex;
-
-                if (-1 == ioctl (capture->deviceHandle, VIDIOC_QBUF, &buf)) {
-                    perror ("VIDIOC_QBUF");
+                if (!v4l2_queue_buffer(capture->deviceHandle, capture->req.memory, capture->bufferIndex,
+                                       capture->buffers[capture->bufferIndex]))
                     return false;
-                }
             }
 
             /* enable the streaming */
@@ -947,6 +1095,15 @@ static bool icvGrabFrameCAM_V4L(CvCaptureCAM_V4L* capture) {
         capture->FirstCapture = 0;
     }
 
+    return true;
+}
+
+static bool icvGrabFrameCAM_V4L(CvCaptureCAM_V4L* capture) {
+    if (!icvStartStreamingCAM_V4L(capture)) return false;
+
+    /* back to the device while waiting, unless a retrieved Mat still refers to it */
+    capture->heldBuffer.release();
+
     if(mainloop_v4l2(capture) != 1) return false;
 
     return true;
@@ -1538,28 +1695,30 @@ static IplImage* icvRetrieveFrameCAM_V4L( CvCaptureCAM_V4L* capture, int) {
         break;
 
     case V4L2_PIX_FMT_SN9C10X:
+        /* the device buffers may be queued or held by the retrieved frames */
+        capture->bayerBuffer.create(capture->form.fmt.pix.height, capture->form.fmt.pix.width, CV_8UC1);
         sonix_decompress_init();
         sonix_decompress(capture->form.fmt.pix.width,
                 capture->form.fmt.pix.height,
                 (unsigned char*)capture->buffers[capture->bufferIndex].start,
-                (unsigned char*)capture->buffers[(capture->bufferIndex+1) % capture->req.count].start);
+                capture->bayerBuffer.data);
 
         bayer2rgb24(capture->form.fmt.pix.width,
                 capture->form.fmt.pix.height,
-                (unsigned char*)capture->buffers[(capture->bufferIndex+1) % capture->req.count].start,
+                capture->bayerBuffer.data,
                 (unsigned char*)capture->frame.imageData);
         break;
 
     case V4L2_PIX_FMT_SGBRG8:
         sgbrg2rgb24(capture->form.fmt.pix.width,
                 capture->form.fmt.pix.height,
-                (unsigned char*)capture->buffers[(capture->bufferIndex+1) % capture->req.count].start,
+                (unsigned char*)capture->buffers[capture->bufferIndex].start,
                 (unsigned char*)capture->frame.imageData);
         break;
     case V4L2_PIX_FMT_RGB24:
         rgb24_to_rgb24(capture->form.fmt.pix.width,
                 capture->form.fmt.pix.height,
-                (unsigned char*)capture->buffers[(capture->bufferIndex+1) % capture->req.count].start,
+                (unsigned char*)capture->buffers[capture->bufferIndex].start,
                 (unsigned char*)capture->frame.imageData);
         break;
     case V4L2_PIX_FMT_Y16:
@@ -1638,6 +1797,7 @@ static double icvGetPropertyCAM_V4L (const CvCaptureCAM_V4L* capture,
             return form.fmt.pix.height;
         case CV_CAP_PROP_FOURCC:
         case CV_CAP_PROP_MODE:
+        case cv::CAP_PROP_CODEC_PIXEL_FORMAT:
             return capture->palette;
         case CV_CAP_PROP_FORMAT:
             return CV_MAKETYPE(IPL2CV_DEPTH(capture->frame.depth), capture->frame.nChannels);
@@ -1645,6 +1805,8 @@ static double icvGetPropertyCAM_V4L (const CvCaptureCAM_V4L* capture,
             return capture->convert_rgb;
         case CV_CAP_PROP_BUFFERSIZE:
             return capture->bufferSize;
+        case cv::CAP_PROP_V4L_MEMORY:
+            return capture->memoryMode;
         }
 
         if(property_id == CV_CAP_PROP_FPS) {
@@ -1845,6 +2007,27 @@ static int icvSetPropertyCAM_V4L( CvCaptureCAM_V4L* capture,
             retval = v4l2_reset(capture);
         }
         break;
+    case cv::CAP_PROP_V4L_MEMORY:
+    {
+        int old_mode = capture->memoryMode;
+        int new_mode = cvRound(value);
+        if (new_mode != CAP_V4L_MEMORY_COPY && new_mode != CAP_V4L_MEMORY_MMAP && new_mode != CAP_V4L_MEMORY_USERPTR) {
+            fprintf(stderr, "V4L: Bad memory type %d\n", new_mode);
+            retval = false;
+            break;
+        }
+        capture->memoryMode = new_mode;
+        if (v4l2_reset(capture)) {
+            if (new_mode != CAP_V4L_MEMORY_USERPTR)
+                capture->userBuffers.clear();
+            retval = true;
+        } else {
+            capture->memoryMode = old_mode;
+            v4l2_reset(capture);
+            retval = false;
+        }
+    }
+    break;
     default:
         retval = icvSetControl(capture, property_id, value);
         break;
@@ -1861,6 +2044,16 @@ static void icvCloseCAM_V4L( CvCaptureCAM_V4L* capture ){
     {
         if (capture->deviceHandle != -1)
         {
+            if (capture->bufferPool)
+            {
+                /* the Mats wrapping the buffers keep them, they aren't queued anymore */
+                capture->bufferPool->detach();
+                capture->heldBuffer.release();
+                capture->bufferPool.release();
+                for (unsigned int n_buffers = 0; n_buffers < MAX_V4L_BUFFERS; ++n_buffers)
+                    capture->buffers[n_buffers].start = 0;
+            }
+
             capture->type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
             if (-1 == ioctl(capture->deviceHandle, VIDIOC_STREAMOFF, &capture->type)) {
                 perror ("Unable to stop the stream");
@@ -1904,6 +2097,55 @@ IplImage* CvCaptureCAM_V4L::retrieveFrame(int)
     return icvRetrieveFrameCAM_V4L( this, 0 );
 }
 
+int CvCaptureCAM_V4L::getFrameReadyFd()
+{
+    // the device becomes readable when a buffer is filled, once the streaming runs
+    return icvStartStreamingCAM_V4L(this) ? deviceHandle : -1;
+}
+
+bool CvCaptureCAM_V4L::retrieveMat(int channel, OutputArray image)
+{
+    if (!bufferPool || convert_rgb)
+        return CvCapture::retrieveMat(channel, image);
+
+    /* wraps the device buffer, it stays out of the device until the Mat is released */
+    IplImage* img = heldBuffer.empty() ? 0 : icvRetrieveFrameCAM_V4L(this, channel);
+    if (!img)
+    {
+        image.release();
+        return false;
+    }
+    Mat view = cvarrToMat(img);
+    view.u = heldBuffer.u;
+    view.addref();
+    image.assign(view);
+    return true;
+}
+
+bool CvCaptureCAM_V4L::setBuffers(const std::vector<Mat>& _buffers)
+{
+    for (size_t i = 0; i < _buffers.size(); i++)
+    {
+        if (_buffers[i].empty() || !_buffers[i].isContinuous())
+        {
+            fprintf(stderr, "VIDEOIO ERROR: V4L2: the buffers have to be continuous Mats\n");
+            return false;
+        }
+    }
+
+    int old_mode = memoryMode;
+    std::vector<Mat> old_buffers;
+    userBuffers.swap(old_buffers);
+    userBuffers = _buffers;
+    memoryMode = CAP_V4L_MEMORY_USERPTR;
+    if (v4l2_reset(this))
+        return true;
+    memoryMode = old_mode;
+    userBuffers.swap(old_buffers);
+    v4l2_reset(this);
+    return false;
+}
+
 double CvCaptureCAM_V4L::getProperty( int propId ) const
 {
     return icvGetPropertyCAM_V4L( this, propId );
@@ -0,0 +1,1054 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#include "precomp.hpp"
+#include "jpeg_decoder.hpp"
+
+#include "opencv2/core/hal/intrin.hpp"
+
+namespace cv
+{
+namespace mjpeg
+{
+
+// natural order of the coefficients in the zigzag order, 16 extra entries for corrupted runs
+static const uchar dezigzag[] =
+{
+     0,  1,  8, 16,  9,  2,  3, 10, 17, 24, 32, 25, 18, 11,  4,  5,
+    12, 19, 26, 33, 40, 48, 41, 34, 27, 20, 13,  6,  7, 14, 21, 28,
+    35, 42, 49, 56, 57, 50, 43, 36, 29, 22, 15, 23, 30, 37, 44, 51,
+    58, 59, 52, 45, 38, 31, 39, 46, 53, 60, 61, 54, 47, 55, 62, 63,
+    63, 63, 63, 63, 63, 63, 63, 63, 63, 63, 63, 63, 63, 63, 63, 63
+};
+
+// constants of the integer IDCT of libjpeg (jidctint.c), FIX(x) = x*(1 << idct_const_bits)
+static const int idct_const_bits = 13;
+static const int idct_pass1_bits = 2;
+static const int FIX_0_298631336 = 2446;
+static const int FIX_0_390180644 = 3196;
+static const int FIX_0_541196100 = 4433;
+static const int FIX_0_765366865 = 6270;
+static const int FIX_0_899976223 = 7373;
+static const int FIX_1_175875602 = 9633;
+static const int FIX_1_501321110 = 12299;
+static const int FIX_1_847759065 = 15137;
+static const int FIX_1_961570560 = 16069;
+static const int FIX_2_053119869 = 16819;
+static const int FIX_2_562915447 = 20995;
+static const int FIX_3_072711026 = 25172;
+
+// YCbCr -> RGB coefficients, fixed point
+static const int ycc_shift = 14;
+static const short ycc_one = 16384;    // 1.0
+static const short ycc_cr_r = 22970;   // 1.402
+static const short ycc_cb_g = -5638;   // -0.344136
+static const short ycc_cr_g = -11700;  // -0.714136
+static const short ycc_cb_b = 29032;   // 1.772
+
+bool JpegDecoder::HuffmanTable::build(const uchar* counts, const uchar* symbols)
+{
+    int i, j, k = 0;
+    for( i = 0; i < 16; i++ )
+        for( j = 0; j < counts[i]; j++ )
+            size[k++] = (uchar)(i + 1);
+    size[k] = 0;
+
+    // canonical codes, increasing with the length
+    int c = 0;
+    k = 0;
+    for( j = 1; j <= 16; j++ )
+    {
+        delta[j] = k - c;
+        if( size[k] == j )
+        {
+            while( size[k] == j )
+                code[k++] = (ushort)c++;
+            if( c - 1 >= (1 << j) )
+                return false;
+        }
+        maxcode[j] = (unsigned)c << (16 - j);
+        c <<= 1;
+    }
+    maxcode[17] = 0xffffffff;
+
+    memset(fast, 255, sizeof(fast));
+    for( i = 0; i < k; i++ )
+    {
+        int s = size[i];
+        if( s <= FAST_BITS )
+        {
+            int first = code[i] << (FAST_BITS - s);
+            for( j = 0; j < (1 << (FAST_BITS - s)); j++ )
+                fast[first + j] = (ushort)i;
+        }
+    }
+    memcpy(values, symbols, k);
+
+    // the AC coefficients with short codes and small values are decoded in one lookup
+    memset(fastAC, 0, sizeof(fastAC));
+    for( i = 0; i < (1 << FAST_BITS); i++ )
+    {
+        if( fast[i] >= 256 )
+            continue;
+        int rs = values[fast[i]], len = size[fast[i]];
+        int run = rs >> 4, magbits = rs & 15;
+        if( magbits == 0 || len + magbits > FAST_BITS )
+            continue;
+        int v = ((i << len) & ((1 << FAST_BITS) - 1)) >> (FAST_BITS - magbits);
+        if( v < (1 << (magbits - 1)) )
+            v -= (1 << magbits) - 1;
+        if( v >= -128 && v <= 127 )
+            fastAC[i] = (short)(v*256 + run*16 + len + magbits);
+    }
+    return true;
+}
+
+// Reads the entropy coded data of a restart interval. The markers were found before and
+// aren't part of the range, so only the stuffed zero bytes are skipped. Past the end the
+// reader gives zeros, overrun() tells if they were used.
+class BitReader
+{
+public:
+    BitReader(const uchar* ptr, const uchar* end)
+        : ptr_(ptr), end_(end), buf_(0), bits_(0), padding_(0) {}
+
+    // leaves 57 bits in the buffer at least
+    inline void fill()
+    {
+        if( end_ - ptr_ >= 8 )
+        {
+            // the whole bytes fitting to the buffer at once, unless a byte is stuffed
+            uint64 v = 0;
+            for( int i = 0; i < 8; i++ )
+                v = (v << 8) | ptr_[i];
+            if( !hasStuffedByte(v) )
+            {
+                int n = (64 - bits_) >> 3;
+                buf_ |= (v >> bits_) & ~(((uint64)1 << (64 - bits_ - n*8)) - 1);
+                ptr_ += n;
+                bits_ += n*8;
+                return;
+            }
+        }
+        while( bits_ <= 56 )
+        {
+            uint64 c = 0;
+            if( ptr_ < end_ )
+            {
+                c = *ptr_++;
+                if( c == 0xFF )
+                    ptr_++;
+            }
+            else
+                padding_ += 8;
+            buf_ |= c << (56 - bits_);
+            bits_ += 8;
+        }
+    }
+
+    inline int decode(const JpegDecoder::HuffmanTable& t)
+    {
+        if( bits_ < 16 )
+            fill();
+        int k = t.fast[buf_ >> (64 - JpegDecoder::HuffmanTable::FAST_BITS)];
+        if( k < 256 )
+        {
+            int s = t.size[k];
+            buf_ <<= s;
+            bits_ -= s;
+            return t.values[k];
+        }
+        unsigned top = (unsigned)(buf_ >> 48);
+        for( k = JpegDecoder::HuffmanTable::FAST_BITS + 1; top >= t.maxcode[k]; k++ )
+            ;
+        if( k == 17 )
+            return -1;
+        int idx = (int)(buf_ >> (64 - k)) + t.delta[k];
+        buf_ <<= k;
+        bits_ -= k;
+        return t.values[idx];
+    }
+
+    inline int peekFastAC(const JpegDecoder::HuffmanTable& t)
+    {
+        if( bits_ < 16 )
+            fill();
+        return t.fastAC[buf_ >> (64 - JpegDecoder::HuffmanTable::FAST_BITS)];
+    }
+
+    inline void skip(int n)
+    {
+        buf_ <<= n;
+        bits_ -= n;
+    }
+
+    // the next n bits as a signed value of the category n
+    inline int receiveExtend(int n)
+    {
+        if( bits_ < n )
+            fill();
+        int v = (int)(buf_ >> (64 - n));
+        buf_ <<= n;
+        bits_ -= n;
+        return v < (1 << (n - 1)) ? v - (1 << n) + 1 : v;
+    }
+
+    bool overrun() const { return padding_ > bits_; }
+
+private:
+    // any of the 8 bytes is 0xFF
+    static inline bool hasStuffedByte(uint64 v)
+    {
+        v = ~v;
+        return ((v - CV_BIG_UINT(0x0101010101010101)) & ~v & CV_BIG_UINT(0x8080808080808080)) != 0;
+    }
+
+    const uchar* ptr_;
+    const uchar* end_;
+    uint64 buf_;
+    int bits_;
+    int padding_;
+};
+
+static bool decodeBlock(BitReader& reader, short* block, const JpegDecoder::HuffmanTable& dc,
+                        const JpegDecoder::HuffmanTable& ac, int& dc_pred)
+{
+    memset(block, 0, 64*sizeof(block[0]));
+
+    int t = reader.decode(dc);
+    if( t < 0 || t > 11 )
+        return false;
+    dc_pred += t ? reader.receiveExtend(t) : 0;
+    block[0] = (short)dc_pred;
+
+    for( int k = 1; k < 64; )
+    {
+        int fast = reader.peekFastAC(ac);
+        if( fast )
+        {
+            k += (fast >> 4) & 15;
+            if( k > 63 )
+                return false;
+            block[dezigzag[k++]] = (short)(fast >> 8);
+            reader.skip(fast & 15);
+            continue;
+        }
+        int rs = reader.decode(ac);
+        if( rs < 0 )
+            return false;
+        int s = rs & 15, r = rs >> 4;
+        if( s == 0 )
+        {
+            if( r != 15 )
+                break;  // end of block
+            k += 16;
+            continue;
+        }
+        k += r;
+        if( k > 63 )
+            return false;
+        block[dezigzag[k++]] = (short)reader.receiveExtend(s);
+    }
+    return true;
+}
+
+// 1D IDCT of 8 values, the integer algorithm of libjpeg, the results descaled by shift
+static inline void idct8(int* s, int shift)
+{
+    int z2 = s[2], z3 = s[6];
+    int z1 = (z2 + z3)*FIX_0_541196100;
+    int tmp2 = z1 - z3*FIX_1_847759065;
+    int tmp3 = z1 + z2*FIX_0_765366865;
+    int tmp0 = (s[0] + s[4]) << idct_const_bits;
+    int tmp1 = (s[0] - s[4]) << idct_const_bits;
+
+    int tmp10 = tmp0 + tmp3, tmp13 = tmp0 - tmp3;
+    int tmp11 = tmp1 + tmp2, tmp12 = tmp1 - tmp2;
+
+    tmp0 = s[7]; tmp1 = s[5]; tmp2 = s[3]; tmp3 = s[1];
+    z1 = tmp0 + tmp3; z2 = tmp1 + tmp2; z3 = tmp0 + tmp2;
+    int z4 = tmp1 + tmp3;
+    int z5 = (z3 + z4)*FIX_1_175875602;
+
+    tmp0 *= FIX_0_298631336; tmp1 *= FIX_2_053119869;
+    tmp2 *= FIX_3_072711026; tmp3 *= FIX_1_501321110;
+    z1 *= -FIX_0_899976223; z2 *= -FIX_2_562915447;
+    z3 = z3*-FIX_1_961570560 + z5;
+    z4 = z4*-FIX_0_390180644 + z5;
+
+    tmp0 += z1 + z3; tmp1 += z2 + z4;
+    tmp2 += z2 + z3; tmp3 += z1 + z4;
+
+    const int round = 1 << (shift - 1);
+    s[0] = (tmp10 + tmp3 + round) >> shift; s[7] = (tmp10 - tmp3 + round) >> shift;
+    s[1] = (tmp11 + tmp2 + round) >> shift; s[6] = (tmp11 - tmp2 + round) >> shift;
+    s[2] = (tmp12 + tmp1 + round) >> shift; s[5] = (tmp12 - tmp1 + round) >> shift;
+    s[3] = (tmp13 + tmp0 + round) >> shift; s[4] = (tmp13 - tmp0 + round) >> shift;
+}
+
+#if CV_SIMD128
+static inline v_int16x8 v_pairs(int a, int b)
+{
+    return v_int16x8((short)a, (short)b, (short)a, (short)b, (short)a, (short)b, (short)a, (short)b);
+}
+
+// a*ca + b*cb, 32-bit
+static inline void v_muladd_pairs(const v_int16x8& a, const v_int16x8& b, const v_int16x8& c,
+                                  v_int32x4& lo, v_int32x4& hi)
+{
+    v_int16x8 ab0, ab1;
+    v_zip(a, b, ab0, ab1);
+    lo = v_dotprod(ab0, c);
+    hi = v_dotprod(ab1, c);
+}
+
+// idct8() of the 8 lanes, the products of the odd and the even inputs paired up
+template<int shift> static inline
+void v_idct8(v_int16x8* s)
+{
+    v_int32x4 tmp0l, tmp0h, tmp1l, tmp1h, tmp2l, tmp2h, tmp3l, tmp3h;
+    v_muladd_pairs(s[2], s[6], v_pairs(FIX_0_541196100 + FIX_0_765366865, FIX_0_541196100), tmp3l, tmp3h);
+    v_muladd_pairs(s[2], s[6], v_pairs(FIX_0_541196100, FIX_0_541196100 - FIX_1_847759065), tmp2l, tmp2h);
+    v_muladd_pairs(s[0], s[4], v_pairs(1 << idct_const_bits, 1 << idct_const_bits), tmp0l, tmp0h);
+    v_muladd_pairs(s[0], s[4], v_pairs(1 << idct_const_bits, -(1 << idct_const_bits)), tmp1l, tmp1h);
+
+    v_int32x4 tmp10l = tmp0l + tmp3l, tmp10h = tmp0h + tmp3h;
+    v_int32x4 tmp13l = tmp0l - tmp3l, tmp13h = tmp0h - tmp3h;
+    v_int32x4 tmp11l = tmp1l + tmp2l, tmp11h = tmp1h + tmp2h;
+    v_int32x4 tmp12l = tmp1l - tmp2l, tmp12h = tmp1h - tmp2h;
+
+    v_int32x4 z3l, z3h, z4l, z4h;
+    v_int16x8 z3 = s[7] + s[3], z4 = s[5] + s[1];
+    v_muladd_pairs(z3, z4, v_pairs(FIX_1_175875602 - FIX_1_961570560, FIX_1_175875602), z3l, z3h);
+    v_muladd_pairs(z3, z4, v_pairs(FIX_1_175875602, FIX_1_175875602 - FIX_0_390180644), z4l, z4h);
+
+    v_muladd_pairs(s[7], s[1], v_pairs(FIX_0_298631336 - FIX_0_899976223, -FIX_0_899976223), tmp0l, tmp0h);
+    v_muladd_pairs(s[7], s[1], v_pairs(-FIX_0_899976223, FIX_1_501321110 - FIX_0_899976223), tmp3l, tmp3h);
+    v_muladd_pairs(s[5], s[3], v_pairs(FIX_2_053119869 - FIX_2_562915447, -FIX_2_562915447), tmp1l, tmp1h);
+    v_muladd_pairs(s[5], s[3], v_pairs(-FIX_2_562915447, FIX_3_072711026 - FIX_2_562915447), tmp2l, tmp2h);
+    tmp0l += z3l; tmp0h += z3h;
+    tmp3l += z4l; tmp3h += z4h;
+    tmp1l += z4l; tmp1h += z4h;
+    tmp2l += z3l; tmp2h += z3h;
+
+    s[0] = v_rshr_pack<shift>(tmp10l + tmp3l, tmp10h + tmp3h);
+    s[7] = v_rshr_pack<shift>(tmp10l - tmp3l, tmp10h - tmp3h);
+    s[1] = v_rshr_pack<shift>(tmp11l + tmp2l, tmp11h + tmp2h);
+    s[6] = v_rshr_pack<shift>(tmp11l - tmp2l, tmp11h - tmp2h);
+    s[2] = v_rshr_pack<shift>(tmp12l + tmp1l, tmp12h + tmp1h);
+    s[5] = v_rshr_pack<shift>(tmp12l - tmp1l, tmp12h - tmp1h);
+    s[3] = v_rshr_pack<shift>(tmp13l + tmp0l, tmp13h + tmp0h);
+    s[4] = v_rshr_pack<shift>(tmp13l - tmp0l, tmp13h - tmp0h);
+}
+
+static inline void v_transpose8x8(v_int16x8* s)
+{
+    v_int16x8 a0, a1, a2, a3, a4, a5, a6, a7;
+    v_zip(s[0], s[1], a0, a1);
+    v_zip(s[2], s[3], a2, a3);
+    v_zip(s[4], s[5], a4, a5);
+    v_zip(s[6], s[7], a6, a7);
+
+    v_int32x4 b0, b1, b2, b3, b4, b5, b6, b7;
+    v_zip(v_reinterpret_as_s32(a0), v_reinterpret_as_s32(a2), b0, b1);
+    v_zip(v_reinterpret_as_s32(a1), v_reinterpret_as_s32(a3), b2, b3);
+    v_zip(v_reinterpret_as_s32(a4), v_reinterpret_as_s32(a6), b4, b5);
+    v_zip(v_reinterpret_as_s32(a5), v_reinterpret_as_s32(a7), b6, b7);
+
+    s[0] = v_reinterpret_as_s16(v_combine_low(b0, b4));
+    s[1] = v_reinterpret_as_s16(v_combine_high(b0, b4));
+    s[2] = v_reinterpret_as_s16(v_combine_low(b1, b5));
+    s[3] = v_reinterpret_as_s16(v_combine_high(b1, b5));
+    s[4] = v_reinterpret_as_s16(v_combine_low(b2, b6));
+    s[5] = v_reinterpret_as_s16(v_combine_high(b2, b6));
+    s[6] = v_reinterpret_as_s16(v_combine_low(b3, b7));
+    s[7] = v_reinterpret_as_s16(v_combine_high(b3, b7));
+}
+#endif
+
+// dequantizes the block and puts the inverse transformed samples to dst
+static void idctBlock(const short* block, const short* qtab, uchar* dst, size_t step)
+{
+    const int pass2_shift = idct_const_bits + idct_pass1_bits + 3;
+#if CV_SIMD128
+    v_int16x8 s[8];
+    // all the coefficients but the DC
+    v_int16x8 ac = v_load(block) & v_int16x8(0, -1, -1, -1, -1, -1, -1, -1);
+    for( int i = 1; i < 8; i++ )
+        ac |= v_load(block + i*8);
+    if( !v_check_all(ac == v_setzero_s16()) )
+    {
+        for( int i = 0; i < 8; i++ )
+            s[i] = v_load(block + i*8)*v_load(qtab + i*8);
+        // the columns, then the rows
+        v_idct8<idct_const_bits - idct_pass1_bits>(s);
+        v_transpose8x8(s);
+        v_idct8<pass2_shift>(s);
+        v_transpose8x8(s);
+
+        const v_int16x8 bias = v_setall_s16(128);
+        for( int i = 0; i < 8; i += 2 )
+        {
+            v_uint8x16 rows = v_pack_u(s[i] + bias, s[i + 1] + bias);
+            v_store_low(dst + i*step, rows);
+            v_store_high(dst + (i + 1)*step, rows);
+        }
+        return;
+    }
+#else
+    int buf[64];
+    int i, j;
+    bool flat = true;
+    for( i = 0; i < 64; i++ )
+    {
+        buf[i] = block[i]*qtab[i];
+        flat = flat && (i == 0 || block[i] == 0);
+    }
+    if( !flat )
+    {
+        for( j = 0; j < 8; j++ )
+        {
+            int col[8];
+            for( i = 0; i < 8; i++ )
+                col[i] = buf[i*8 + j];
+            idct8(col, idct_const_bits - idct_pass1_bits);
+            for( i = 0; i < 8; i++ )
+                buf[i*8 + j] = col[i];
+        }
+        for( i = 0; i < 8; i++ )
+        {
+            int* row = buf + i*8;
+            idct8(row, pass2_shift);
+            for( j = 0; j < 8; j++ )
+                dst[i*step + j] = saturate_cast<uchar>(row[j] + 128);
+        }
+        return;
+    }
+#endif
+    // a flat block, frequent in the chroma and in the smooth areas
+    uchar v = saturate_cast<uchar>(((block[0]*qtab[0] + 4) >> 3) + 128);
+    for( int k = 0; k < 8; k++ )
+        memset(dst + k*step, v, 8);
+}
+
+// Chroma upsampling with the triangle filter of libjpeg ("fancy upsampling").
+// The vertical pass makes the column sums c, with c[-1] = c[0] and c[n] = c[n - 1],
+// the horizontal one gives 2*n samples, (3*c[i] + c[i -+ 1] + bias0/1) >> shift.
+static void columnSums(const uchar* row0, const uchar* row1, int n, int weight0, ushort* c)
+{
+    int i = 0;
+#if CV_SIMD128
+    const v_uint16x8 w0 = v_setall_u16((ushort)weight0);
+    for( ; i <= n - 8; i += 8 )
+    {
+        v_uint16x8 s = v_load_expand(row0 + i)*w0;
+        if( row1 )
+            s += v_load_expand(row1 + i);
+        v_store(c + i, s);
+    }
+#endif
+    for( ; i < n; i++ )
+        c[i] = (ushort)(row0[i]*weight0 + (row1 ? row1[i] : 0));
+    c[-1] = c[0];
+    c[n] = c[n - 1];
+}
+
+static void upsampleH2(const ushort* c, int n, int shift, int bias0, int bias1, uchar* dst)
+{
+    int i = 0;
+#if CV_SIMD128
+    const v_uint16x8 b0 = v_setall_u16((ushort)bias0), b1 = v_setall_u16((ushort)bias1);
+    for( ; i <= n - 8; i += 8 )
+    {
+        v_uint16x8 cur = v_load(c + i), cur3 = (cur << 1) + cur;
+        v_uint16x8 even = (cur3 + v_load(c + i - 1) + b0) >> shift;
+        v_uint16x8 odd = (cur3 + v_load(c + i + 1) + b1) >> shift;
+        v_uint16x8 lo, hi;
+        v_zip(even, odd, lo, hi);
+        v_store(dst + i*2, v_pack(lo, hi));
+    }
+#endif
+    for( ; i < n; i++ )
+    {
+        int cur3 = c[i]*3;
+        dst[i*2] = (uchar)((cur3 + c[i - 1] + bias0) >> shift);
+        dst[i*2 + 1] = (uchar)((cur3 + c[i + 1] + bias1) >> shift);
+    }
+}
+
+// row0 is the source row of the output row, row1 the adjacent one in its direction
+static void upsampleV2(const uchar* row0, const uchar* row1, int n, int bias, uchar* dst)
+{
+    int i = 0;
+#if CV_SIMD128
+    const v_uint16x8 b = v_setall_u16((ushort)bias);
+    for( ; i <= n - 16; i += 16 )
+    {
+        v_uint16x8 a0, a1, c0, c1;
+        v_expand(v_load(row0 + i), a0, a1);
+        v_expand(v_load(row1 + i), c0, c1);
+        v_store(dst + i, v_pack(((a0 << 1) + a0 + c0 + b) >> 2, ((a1 << 1) + a1 + c1 + b) >> 2));
+    }
+#endif
+    for( ; i < n; i++ )
+        dst[i] = (uchar)((row0[i]*3 + row1[i] + bias) >> 2);
+}
+
+#if CV_SIMD128
+static inline void yccToRGB(const v_uint16x8& y, const v_uint16x8& cb, const v_uint16x8& cr,
+                            v_int16x8& r, v_int16x8& g, v_int16x8& b)
+{
+    const v_int16x8 delta = v_setall_s16(128);
+    const v_int16x8 y_cr_r(ycc_one, ycc_cr_r, ycc_one, ycc_cr_r, ycc_one, ycc_cr_r, ycc_one, ycc_cr_r);
+    const v_int16x8 y_cb_b(ycc_one, ycc_cb_b, ycc_one, ycc_cb_b, ycc_one, ycc_cb_b, ycc_one, ycc_cb_b);
+    const v_int16x8 cb_cr_g(ycc_cb_g, ycc_cr_g, ycc_cb_g, ycc_cr_g, ycc_cb_g, ycc_cr_g, ycc_cb_g, ycc_cr_g);
+
+    v_int16x8 sy = v_reinterpret_as_s16(y);
+    v_int16x8 scb = v_reinterpret_as_s16(cb) - delta;
+    v_int16x8 scr = v_reinterpret_as_s16(cr) - delta;
+    v_int16x8 a0, a1;
+    v_int32x4 y0, y1;
+
+    v_zip(sy, scr, a0, a1);
+    r = v_rshr_pack<ycc_shift>(v_dotprod(a0, y_cr_r), v_dotprod(a1, y_cr_r));
+    v_zip(sy, scb, a0, a1);
+    b = v_rshr_pack<ycc_shift>(v_dotprod(a0, y_cb_b), v_dotprod(a1, y_cb_b));
+    v_zip(scb, scr, a0, a1);
+    v_expand(sy, y0, y1);
+    g = v_rshr_pack<ycc_shift>(v_dotprod(a0, cb_cr_g) + v_shl<ycc_shift>(y0),
+                               v_dotprod(a1, cb_cr_g) + v_shl<ycc_shift>(y1));
+}
+#endif
+
+static void yccToBGRRow(const uchar* y, const uchar* cb, const uchar* cr, uchar* dst, int width)
+{
+    int i = 0;
+#if CV_SIMD128
+    for( ; i <= width - 16; i += 16 )
+    {
+        v_uint16x8 y0, y1, cb0, cb1, cr0, cr1;
+        v_expand(v_load(y + i), y0, y1);
+        v_expand(v_load(cb + i), cb0, cb1);
+        v_expand(v_load(cr + i), cr0, cr1);
+
+        v_int16x8 r0, g0, b0, r1, g1, b1;
+        yccToRGB(y0, cb0, cr0, r0, g0, b0);
+        yccToRGB(y1, cb1, cr1, r1, g1, b1);
+        v_store_interleave(dst + i*3, v_pack_u(b0, b1), v_pack_u(g0, g1), v_pack_u(r0, r1));
+    }
+#endif
+    const int round = 1 << (ycc_shift - 1);
+    for( ; i < width; i++ )
+    {
+        int Y = y[i] << ycc_shift, Cb = cb[i] - 128, Cr = cr[i] - 128;
+        dst[i*3] = saturate_cast<uchar>((Y + ycc_cb_b*Cb + round) >> ycc_shift);
+        dst[i*3 + 1] = saturate_cast<uchar>((Y + ycc_cb_g*Cb + ycc_cr_g*Cr + round) >> ycc_shift);
+        dst[i*3 + 2] = saturate_cast<uchar>((Y + ycc_cr_r*Cr + round) >> ycc_shift);
+    }
+}
+
+static void grayToBGRRow(const uchar* y, uchar* dst, int width)
+{
+    int i = 0;
+#if CV_SIMD128
+    for( ; i <= width - 16; i += 16 )
+    {
+        v_uint8x16 v = v_load(y + i);
+        v_store_interleave(dst + i*3, v, v, v);
+    }
+#endif
+    for( ; i < width; i++ )
+        dst[i*3] = dst[i*3 + 1] = dst[i*3 + 2] = y[i];
+}
+
+// Entropy decodes the restart intervals
+class EntropyDecoder : public ParallelLoopBody
+{
+public:
+    EntropyDecoder(std::vector<JpegDecoder::Component>& _components, const std::vector<int>& _scan,
+                   const JpegDecoder::HuffmanTable* const* _dc, const JpegDecoder::HuffmanTable* const* _ac,
+                   int _mcus_per_line, int _mcu_count, int _interval,
+                   const std::vector<const uchar*>& _segments, std::vector<uchar>& _segment_ok)
+        : components(_components), scan(_scan), dc(_dc), ac(_ac), mcus_per_line(_mcus_per_line),
+          mcu_count(_mcu_count), interval(_interval), segments(_segments), segment_ok(_segment_ok)
+    {
+    }
+
+    void operator()( const Range& range ) const CV_OVERRIDE
+    {
+        const int ns = (int)scan.size();
+        for( int k = range.start; k < range.end; k++ )
+        {
+            BitReader reader(segments[k*2], segments[k*2 + 1]);
+            int dc_pred[4] = { 0, 0, 0, 0 };
+            int mcu_end = std::min(mcu_count, (k + 1)*interval);
+            bool ok = true;
+
+            for( int mcu = k*interval; mcu < mcu_end && ok; mcu++ )
+            {
+                int mx = mcu % mcus_per_line, my = mcu / mcus_per_line;
+                for( int s = 0; s < ns && ok; s++ )
+                {
+                    JpegDecoder::Component& c = components[scan[s]];
+                    for( int by = 0; by < c.v && ok; by++ )
+                    {
+                        short* block = &c.coeffs[((size_t)(my*c.v + by)*c.blocksPerLine + mx*c.h)*64];
+                        for( int bx = 0; bx < c.h && ok; bx++, block += 64 )
+                            ok = decodeBlock(reader, block, *dc[s], *ac[s], dc_pred[s]);
+                    }
+                }
+            }
+            segment_ok[k] = ok && !reader.overrun();
+        }
+    }
+
+private:
+    EntropyDecoder& operator=(const EntropyDecoder&);
+
+    std::vector<JpegDecoder::Component>& components;
+    const std::vector<int>& scan;
+    const JpegDecoder::HuffmanTable* const* dc;
+    const JpegDecoder::HuffmanTable* const* ac;
+    const int mcus_per_line;
+    const int mcu_count;
+    const int interval;
+    const std::vector<const uchar*>& segments;
+    std::vector<uchar>& segment_ok;
+};
+
+// Transforms the blocks of the MCU rows into the component planes
+class BlockTransformer : public ParallelLoopBody
+{
+public:
+    BlockTransformer(std::vector<JpegDecoder::Component>& _components, const short (*_qtables)[64])
+        : components(_components), qtables(_qtables)
+    {
+    }
+
+    void operator()( const Range& range ) const CV_OVERRIDE
+    {
+        for( size_t i = 0; i < components.size(); i++ )
+        {
+            JpegDecoder::Component& c = components[i];
+            // the blocks of the padding aren't used
+            int bx_end = (c.width + 7)/8, by_end = std::min((c.height + 7)/8, range.end*c.v);
+            for( int by = range.start*c.v; by < by_end; by++ )
+            {
+                const short* block = &c.coeffs[(size_t)by*c.blocksPerLine*64];
+                uchar* dst = c.plane.ptr(by*8);
+                for( int bx = 0; bx < bx_end; bx++, block += 64 )
+                    idctBlock(block, qtables[c.tq], dst + bx*8, c.plane.step);
+            }
+        }
+    }
+
+private:
+    BlockTransformer& operator=(const BlockTransformer&);
+
+    std::vector<JpegDecoder::Component>& components;
+    const short (*qtables)[64];
+};
+
+// Upsamples the chroma and converts the rows of the MCU rows to BGR
+class ColorConverter : public ParallelLoopBody
+{
+public:
+    ColorConverter(const std::vector<JpegDecoder::Component>& _components, int _hmax, int _vmax, Mat& _img)
+        : components(_components), hmax(_hmax), vmax(_vmax), img(_img)
+    {
+    }
+
+    void operator()( const Range& range ) const CV_OVERRIDE
+    {
+        const int ncomp = (int)components.size();
+        // the upsampled rows may have a sample more than the image
+        const int row_size = img.cols + 16;
+        AutoBuffer<uchar> _buf(row_size*ncomp);
+        AutoBuffer<ushort> _sums(row_size + 2);
+        const uchar* rows[3];
+
+        int y_end = std::min(img.rows, range.end*vmax*8);
+        for( int y = range.start*vmax*8; y < y_end; y++ )
+        {
+            for( int i = 0; i < ncomp; i++ )
+                rows[i] = upsampleRow(components[i], y, _buf.data() + i*row_size, _sums.data() + 1);
+            if( ncomp == 1 )
+                grayToBGRRow(rows[0], img.ptr(y), img.cols);
+            else
+                yccToBGRRow(rows[0], rows[1], rows[2], img.ptr(y), img.cols);
+        }
+    }
+
+private:
+    ColorConverter& operator=(const ColorConverter&);
+
+    const uchar* upsampleRow(const JpegDecoder::Component& c, int y, uchar* buf, ushort* sums) const
+    {
+        bool h2 = c.h < hmax;
+        if( c.v == vmax )
+        {
+            const uchar* src = c.plane.ptr(y);
+            if( !h2 )
+                return src;
+            columnSums(src, 0, c.width, 1, sums);
+            upsampleH2(sums, c.width, 2, 1, 2, buf);
+            return buf;
+        }
+        int cy = y >> 1, odd = y & 1;
+        const uchar* row0 = c.plane.ptr(cy);
+        const uchar* row1 = c.plane.ptr(odd ? std::min(cy + 1, c.height - 1) : std::max(cy - 1, 0));
+        if( !h2 )
+        {
+            upsampleV2(row0, row1, c.width, 1 + odd, buf);
+            return buf;
+        }
+        columnSums(row0, row1, c.width, 3, sums);
+        upsampleH2(sums, c.width, 4, 8, 7, buf);
+        return buf;
+    }
+
+    const std::vector<JpegDecoder::Component>& components;
+    const int hmax;
+    const int vmax;
+    Mat& img;
+};
+
+JpegDecoder::JpegDecoder()
+    : width_(0), height_(0), hmax_(1), vmax_(1), mcusPerLine_(0), mcusPerColumn_(0),
+      restartInterval_(0), adobeRGB_(false)
+{
+    standard_[0][0].build(jpegTableK3, jpegTableK3 + 16);
+    standard_[0][1].build(jpegTableK4, jpegTableK4 + 16);
+    standard_[1][0].build(jpegTableK5, jpegTableK5 + 16);
+    standard_[1][1].build(jpegTableK6, jpegTableK6 + 16);
+    memset(huffmanDefined_, 0, sizeof(huffmanDefined_));
+    memset(qdefined_, 0, sizeof(qdefined_));
+}
+
+bool JpegDecoder::readFrameHeader(const uchar* seg, int len)
+{
+    if( len < 6 || seg[0] != 8 )
+        return false;
+    height_ = (seg[1] << 8) | seg[2];
+    width_ = (seg[3] << 8) | seg[4];
+    int n = seg[5];
+    if( height_ == 0 || width_ == 0 || (n != 1 && n != 3) || len < 6 + n*3 )
+        return false;
+    // components named R, G, B aren't YCbCr
+    if( n == 3 && seg[6] == 'R' && seg[9] == 'G' && seg[12] == 'B' )
+        return false;
+
+    components_.resize(n);
+    hmax_ = vmax_ = 1;
+    for( int i = 0; i < n; i++ )
+    {
+        Component& c = components_[i];
+        const uchar* p = seg + 6 + i*3;
+        c.id = p[0];
+        c.h = p[1] >> 4;
+        c.v = p[1] & 15;
+        c.tq = p[2];
+        if( c.h < 1 || c.h > 4 || c.v < 1 || c.v > 4 || c.tq > 3 )
+            return false;
+        hmax_ = std::max(hmax_, c.h);
+        vmax_ = std::max(vmax_, c.v);
+    }
+    // a single component is coded block by block, whatever its sampling factors
+    if( n == 1 )
+        components_[0].h = components_[0].v = hmax_ = vmax_ = 1;
+
+    mcusPerLine_ = (width_ + hmax_*8 - 1)/(hmax_*8);
+    mcusPerColumn_ = (height_ + vmax_*8 - 1)/(vmax_*8);
+    for( int i = 0; i < n; i++ )
+    {
+        Component& c = components_[i];
+        if( (c.h != hmax_ && c.h*2 != hmax_) || (c.v != vmax_ && c.v*2 != vmax_) )
+            return false;
+        c.width = (width_*c.h + hmax_ - 1)/hmax_;
+        c.height = (height_*c.v + vmax_ - 1)/vmax_;
+        c.blocksPerLine = mcusPerLine_*c.h;
+        c.blocksPerColumn = mcusPerColumn_*c.v;
+    }
+    return true;
+}
+
+bool JpegDecoder::readHuffmanTables(const uchar* seg, int len)
+{
+    while( len > 0 )
+    {
+        if( len < 17 )
+            return false;
+        int tc = seg[0] >> 4, th = seg[0] & 15;
+        int count = 0;
+        for( int i = 0; i < 16; i++ )
+            count += seg[1 + i];
+        if( tc > 1 || th > 3 || count > 256 || len < 17 + count )
+            return false;
+
+        HuffmanTable& t = huffman_[tc][th];
+        if( t.source.size() != (size_t)(16 + count) || memcmp(&t.source[0], seg + 1, 16 + count) != 0 )
+        {
+            t.source.clear();
+            if( !t.build(seg + 1, seg + 17) )
+                return false;
+            t.source.assign(seg + 1, seg + 17 + count);
+        }
+        huffmanDefined_[tc][th] = true;
+        seg += 17 + count;
+        len -= 17 + count;
+    }
+    return true;
+}
+
+bool JpegDecoder::readQuantTables(const uchar* seg, int len)
+{
+    while( len > 0 )
+    {
+        int pq = seg[0] >> 4, tq = seg[0] & 15;
+        // 16-bit tables aren't baseline
+        if( pq != 0 || tq > 3 || len < 65 )
+            return false;
+
+        std::vector<uchar>& source = qsource_[tq];
+        if( source.size() != 64 || memcmp(&source[0], seg + 1, 64) != 0 )
+        {
+            source.assign(seg + 1, seg + 65);
+            for( int k = 0; k < 64; k++ )
+                qtables_[tq][dezigzag[k]] = seg[1 + k];
+        }
+        qdefined_[tq] = true;
+        seg += 65;
+        len -= 65;
+    }
+    return true;
+}
+
+bool JpegDecoder::readScanHeader(const uchar* seg, int len)
+{
+    int n = len > 0 ? seg[0] : 0;
+    // the components in a single scan
+    if( components_.empty() || n != (int)components_.size() || len < 4 + n*2 )
+        return false;
+
+    scan_.assign(n, -1);
+    for( int i = 0; i < n; i++ )
+    {
+        const uchar* p = seg + 1 + i*2;
+        for( int j = 0; j < n; j++ )
+            if( components_[j].id == p[0] && std::find(scan_.begin(), scan_.end(), j) == scan_.end() )
+            {
+                scan_[i] = j;
+                break;
+            }
+        if( scan_[i] < 0 )
+            return false;
+        Component& c = components_[scan_[i]];
+        c.td = p[1] >> 4;
+        c.ta = p[1] & 15;
+        if( c.td > 3 || c.ta > 3 || !qdefined_[c.tq] )
+            return false;
+    }
+    // spectral selection and successive approximation of the sequential mode
+    const uchar* p = seg + 1 + n*2;
+    return p[0] == 0 && p[1] == 63 && p[2] == 0;
+}
+
+bool JpegDecoder::decodeScan(const uchar* ptr, const uchar* end, Mat& img)
+{
+    const int mcu_count = mcusPerLine_*mcusPerColumn_;
+    const int interval = restartInterval_ > 0 ? std::min(restartInterval_, mcu_count) : mcu_count;
+    const int segment_count = (mcu_count + interval - 1)/interval;
+    const int ns = (int)scan_.size();
+
+    // the frames without Huffman tables use the standard ones
+    bool standard = true;
+    for( int i = 0; i < 4; i++ )
+        standard = standard && !huffmanDefined_[0][i] && !huffmanDefined_[1][i];
+    const HuffmanTable* dc[4];
+    const HuffmanTable* ac[4];
+    for( int s = 0; s < ns; s++ )
+    {
+        const Component& c = components_[scan_[s]];
+        if( standard )
+        {
+            if( c.td > 1 || c.ta > 1 )
+                return false;
+            dc[s] = &standard_[0][c.td];
+            ac[s] = &standard_[1][c.ta];
+        }
+        else
+        {
+            if( !huffmanDefined_[0][c.td] || !huffmanDefined_[1][c.ta] )
+                return false;
+            dc[s] = &huffman_[0][c.td];
+            ac[s] = &huffman_[1][c.ta];
+        }
+    }
+
+    // find the restart intervals, the scan ends at the first other marker
+    segments_.clear();
+    segments_.push_back(ptr);
+    const uchar* p = ptr;
+    for( ;; )
+    {
+        p = (const uchar*)memchr(p, 0xFF, end - p);
+        if( !p || p + 1 >= end )
+        {
+            p = end;
+            break;
+        }
+        if( p[1] == 0 )
+        {
+            p += 2;
+            continue;
+        }
+        const uchar* marker = p;
+        while( p + 1 < end && p[1] == 0xFF )
+            p++;
+        if( p + 1 >= end )
+            break;
+        int m = p[1];
+        if( m < 0xD0 || m > 0xD7 || restartInterval_ == 0 )
+        {
+            p = marker;
+            break;
+        }
+        if( (m & 7) != ((int)segments_.size()/2) % 8 )
+            return false;
+        segments_.push_back(marker);
+        segments_.push_back(p + 2);
+        p += 2;
+    }
+    segments_.push_back(p);
+    // the truncated frames are left to imdecode()
+    if( (int)segments_.size() < segment_count*2 )
+        return false;
+
+    for( size_t i = 0; i < components_.size(); i++ )
+    {
+        Component& c = components_[i];
+        c.coeffs.resize((size_t)c.blocksPerLine*c.blocksPerColumn*64);
+        c.plane.create(c.blocksPerColumn*8, c.blocksPerLine*8, CV_8U);
+    }
+
+    segmentOk_.assign(segment_count, 0);
+    parallel_for_(Range(0, segment_count),
+                  EntropyDecoder(components_, scan_, dc, ac, mcusPerLine_, mcu_count, interval,
+                                 segments_, segmentOk_));
+    for( int k = 0; k < segment_count; k++ )
+        if( !segmentOk_[k] )
+            return false;
+
+    parallel_for_(Range(0, mcusPerColumn_), BlockTransformer(components_, qtables_));
+
+    img.create(height_, width_, CV_8UC3);
+    parallel_for_(Range(0, mcusPerColumn_), ColorConverter(components_, hmax_, vmax_, img));
+    return true;
+}
+
+bool JpegDecoder::hasRestartInterval(const uchar* data, size_t size)
+{
+    const uchar* p = data + 2;
+    const uchar* end = data + size;
+    if( size < 4 || data[0] != 0xFF || data[1] != 0xD8 )
+        return false;
+    while( end - p >= 4 && p[0] == 0xFF )
+    {
+        const int marker = p[1];
+        if( marker == 0xFF || marker == 0x01 || (marker >= 0xD0 && marker <= 0xD8) )
+        {
+            p += marker == 0xFF ? 1 : 2;
+            continue;
+        }
+        if( marker == 0xDA || marker == 0xD9 )
+            break;
+        const int len = (p[2] << 8) | p[3];
+        if( marker == 0xDD && len >= 4 && end - p >= 6 )
+            return ((p[4] << 8) | p[5]) != 0;
+        p += 2 + len;
+    }
+    return false;
+}
+
+bool JpegDecoder::decode(const uchar* data, size_t size, Mat& img)
+{
+    CV_TRACE_FUNCTION();
+
+    const uchar* p = data;
+    const uchar* end = data + size;
+    if( size < 4 || p[0] != 0xFF || p[1] != 0xD8 )
+        return false;
+    p += 2;
+
+    memset(huffmanDefined_, 0, sizeof(huffmanDefined_));
+    memset(qdefined_, 0, sizeof(qdefined_));
+    restartInterval_ = 0;
+    adobeRGB_ = false;
+    components_.clear();
+
+    for( ;; )
+    {
+        if( end - p < 4 || p[0] != 0xFF )
+            return false;
+        int marker = p[1];
+        if( marker == 0xFF )
+        {
+            p++;  // fill byte
+            continue;
+        }
+        p += 2;
+        if( marker == 0xD8 || (marker >= 0xD0 && marker <= 0xD7) || marker == 0x01 )
+            continue;
+        if( marker == 0xD9 )
+            return false;
+
+        int len = (p[0] << 8) | p[1];
+        if( len < 2 || len > end - p )
+            return false;
+        const uchar* seg = p + 2;
+        int seg_len = len - 2;
+        p += len;
+
+        switch( marker )
+        {
+        case 0xC0: // baseline
+        case 0xC1: // extended sequential, Huffman coded
+            if( !components_.empty() || !readFrameHeader(seg, seg_len) )
+                return false;
+            break;
+        case 0xC4:
+            if( !readHuffmanTables(seg, seg_len) )
+                return false;
+            break;
+        case 0xDB:
+            if( !readQuantTables(seg, seg_len) )
+                return false;
+            break;
+        case 0xDD:
+            if( seg_len < 2 )
+                return false;
+            restartInterval_ = (seg[0] << 8) | seg[1];
+            break;
+        case 0xEE:
+            // Adobe, the transform 0 means RGB for 3 components
+            if( seg_len >= 12 && memcmp(seg, "Adobe", 5) == 0 )
+                adobeRGB_ = seg[11] == 0;
+            break;
+        case 0xDA:
+            if( adobeRGB_ && components_.size() == 3 )
+                return false;
+            if( !readScanHeader(seg, seg_len) )
+                return false;
+            return decodeScan(p, end, img);
+        default:
+            // progressive, lossless and arithmetic coded frames
+            if( marker >= 0xC2 && marker <= 0xCF )
+                return false;
+            break;  // APPn, COM and the others are skipped
+        }
+    }
+}
+
+}
+}
@@ -0,0 +1,99 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#ifndef __OPENCV_VIDEOIO_JPEG_DECODER_HPP__
+#define __OPENCV_VIDEOIO_JPEG_DECODER_HPP__
+
+#include "precomp.hpp"
+
+namespace cv
+{
+namespace mjpeg
+{
+
+// Standard Huffman tables (ITU T.81 annex K), 16 code counts followed by the values.
+// Defined in cap_mjpeg_encoder.cpp.
+extern const uchar jpegTableK3[]; // luma DCs
+extern const uchar jpegTableK4[]; // chroma DCs
+extern const uchar jpegTableK5[]; // luma ACs
+extern const uchar jpegTableK6[]; // chroma ACs
+
+// Decoder of the baseline JPEG frames of MJPEG streams: sequential, Huffman coded,
+// 8-bit, grayscale or YCbCr with the chroma subsampled by 1 or 2 in each direction.
+// The restart interval segments are entropy decoded in parallel, then the IDCT and the
+// color conversion run in parallel over the rows. The tables and the buffers are kept
+// between the frames, a table defined again with the same contents isn't rebuilt.
+// Frames without Huffman tables (AVI1) use the standard ones.
+class JpegDecoder
+{
+public:
+    JpegDecoder();
+
+    // Decodes the frame into a BGR image. Returns false for the frames using other
+    // JPEG features and for the corrupted ones, which should go to imdecode() instead.
+    bool decode(const uchar* data, size_t size, Mat& img);
+
+    // Whether the frame defines a restart interval before its scan, which the entropy decoding
+    // needs to run in parallel
+    static bool hasRestartInterval(const uchar* data, size_t size);
+
+    struct HuffmanTable
+    {
+        bool build(const uchar* counts, const uchar* values);
+
+        enum { FAST_BITS = 9 };
+        ushort fast[1 << FAST_BITS]; // symbol index for the codes up to FAST_BITS long, or 0xFFFF
+        short fastAC[1 << FAST_BITS]; // value*256 + run*16 + length of the AC coefficients coded
+                                      // in FAST_BITS with their extra bits, or 0
+        uchar values[256];
+        uchar size[257];
+        ushort code[256];
+        unsigned maxcode[18];        // first code longer than the length, left aligned to 16 bits
+        int delta[17];               // symbol index minus code for every length
+        std::vector<uchar> source;   // the DHT contents the table was built from
+    };
+
+    struct Component
+    {
+        int id;
+        int h, v;         // sampling factors
+        int tq;           // quantization table
+        int td, ta;       // DC and AC Huffman tables of the scan
+        int width, height;        // size in samples
+        int blocksPerLine;        // blocks per line and column, padded to whole MCUs
+        int blocksPerColumn;
+        std::vector<short> coeffs;   // the blocks in raster order, 64 coefficients each
+        Mat plane;                   // the samples after the IDCT
+    };
+
+private:
+    bool readFrameHeader(const uchar* seg, int len);
+    bool readHuffmanTables(const uchar* seg, int len);
+    bool readQuantTables(const uchar* seg, int len);
+    bool readScanHeader(const uchar* seg, int len);
+    bool decodeScan(const uchar* ptr, const uchar* end, Mat& img);
+
+    HuffmanTable huffman_[2][4];    // DC and AC tables
+    HuffmanTable standard_[2][2];
+    bool huffmanDefined_[2][4];     // defined by the current frame
+    short qtables_[4][64];          // quantization tables in the natural order
+    std::vector<uchar> qsource_[4];
+    bool qdefined_[4];
+
+    int width_, height_;
+    int hmax_, vmax_;
+    int mcusPerLine_, mcusPerColumn_;
+    int restartInterval_;
+    bool adobeRGB_;
+    std::vector<Component> components_;
+    std::vector<int> scan_;         // components of the scan, in the scan order
+
+    std::vector<const uchar*> segments_;   // begin and end of every restart interval
+    std::vector<uchar> segmentOk_;
+};
+
+}
+}
+
+#endif
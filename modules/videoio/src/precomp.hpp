@@ -94,6 +94,10 @@ struct CvCapture
     virtual bool grabFrame() { return true; }
     virtual IplImage* retrieveFrame(int) { return 0; }
     virtual int getCaptureDomain() { return cv::CAP_ANY; } // Return the type of the capture object: CAP_VFW, etc...
+    virtual int getFrameReadyFd() { return -1; } // See IVideoCapture::getFrameReadyFd()
+    virtual bool setBuffers(const std::vector<cv::Mat>&) { return false; } // See IVideoCapture::setBuffers()
+    // Retrieves the frame as a Mat, copying the IplImage of retrieveFrame() unless overridden
+    virtual bool retrieveMat(int, cv::OutputArray);
 };
 
 /*************************** CvVideoWriter structure ****************************/
@@ -168,6 +172,11 @@ namespace cv
         virtual bool retrieveFrame(int, OutputArray) = 0;
         virtual bool isOpened() const = 0;
         virtual int getCaptureDomain() { return CAP_ANY; } // Return the type of the capture object: CAP_VFW, etc...
+        //! File descriptor which is readable when grabFrame() doesn't wait, -1 if there is none.
+        //! Used by VideoCapture::waitAny(), may start the streaming.
+        virtual int getFrameReadyFd() { return -1; }
+        //! Buffers of the application filled by the device, see VideoCapture::setBuffers()
+        virtual bool setBuffers(const std::vector<Mat>&) { return false; }
     };
 
     class IVideoWriter
@@ -183,6 +192,21 @@ namespace cv
         virtual int getCaptureDomain() const { return cv::CAP_ANY; } // Return the type of the capture object: CAP_FFMPEG, etc...
     };
 
+    //! Wraps the capture into one which grabs and retrieves the frames on a background thread,
+    //! controlled by the CAP_PROP_READAHEAD_FRAMES and CAP_PROP_READAHEAD_POLICY properties
+    Ptr<IVideoCapture> createReadAheadCapture(const Ptr<IVideoCapture>& capture);
+    bool isReadAheadCapture(const Ptr<IVideoCapture>& capture);
+
+    //! Opens the file with several instances of the backend, decoding its parts on their own
+    //! threads (VideoCapture::openSegments()), empty if any of them fails to open it
+    Ptr<IVideoCapture> createSegmentedCapture(const String& filename, int apiPreference,
+                                              int decoders, bool ordered, int partFrames);
+
+    //! Wraps the writer into one which converts and encodes the frames on a background thread,
+    //! controlled by the VIDEOWRITER_PROP_ASYNC_FRAMES property
+    Ptr<IVideoWriter> createAsyncWriter(const Ptr<IVideoWriter>& writer);
+    bool isAsyncWriter(const Ptr<IVideoWriter>& writer);
+
     Ptr<IVideoCapture> createMotionJpegCapture(const String& filename);
     Ptr<IVideoWriter> createMotionJpegWriter(const String& filename, int fourcc, double fps, Size frameSize, bool iscolor);
 
@@ -136,6 +136,24 @@ CV_IMPL IplImage* cvRetrieveFrame(CvCapture* capture, int idx)
     return capture ? capture->retrieveFrame(idx) : 0;
 }
 
+bool CvCapture::retrieveMat(int channel, cv::OutputArray image)
+{
+    IplImage* _img = retrieveFrame(channel);
+    if( !_img )
+    {
+        image.release();
+        return false;
+    }
+    if(_img->origin == IPL_ORIGIN_TL)
+        cv::cvarrToMat(_img).copyTo(image);
+    else
+    {
+        Mat temp = cv::cvarrToMat(_img);
+        flip(temp, image, 0);
+    }
+    return true;
+}
+
 CV_IMPL double cvGetCaptureProperty(CvCapture* capture, int id)
 {
     return capture ? capture->getProperty(id) : 0;
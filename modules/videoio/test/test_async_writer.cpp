@@ -0,0 +1,84 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#include "test_precomp.hpp"
+
+namespace opencv_test { namespace {
+
+typedef testing::TestWithParam<VideoCaptureAPIs> Videoio_AsyncWriter;
+
+static string writerFilename(VideoCaptureAPIs api, const string& base)
+{
+    return api == CAP_IMAGES ? base + "_%02d.bmp" : base + ".avi";
+}
+
+static void writeVideo(VideoCaptureAPIs api, const string& file, int asyncFrames, int frame_count)
+{
+    const Size size(320, 240);
+    // the image sequence writer doesn't take a codec
+    const int fourcc = api == CAP_IMAGES ? 0 : VideoWriter::fourcc('M', 'J', 'P', 'G');
+    VideoWriter writer(file, api, fourcc, 25, size);
+    ASSERT_TRUE(writer.isOpened());
+    EXPECT_EQ(0, writer.get(VIDEOWRITER_PROP_ASYNC_FRAMES));
+    if (asyncFrames > 0)
+    {
+        ASSERT_TRUE(writer.set(VIDEOWRITER_PROP_ASYNC_FRAMES, asyncFrames));
+        EXPECT_EQ(asyncFrames, writer.get(VIDEOWRITER_PROP_ASYNC_FRAMES));
+        EXPECT_EQ(api, writer.get(CAP_PROP_BACKEND));
+    }
+    Mat img(size, CV_8UC3);
+    for (int i = 0; i < frame_count; i++)
+    {
+        // the frame is reused, the queue keeps its own copy
+        img.setTo(Scalar::all(0));
+        generateFrame(i, frame_count, img);
+        writer << img;
+        if (api == CAP_OPENCV_MJPEG && i == frame_count / 2)
+        {
+            ASSERT_TRUE(writer.set(VIDEOWRITER_PROP_QUALITY, 50));
+        }
+    }
+    // release() writes the queued frames
+}
+
+static std::vector<Mat> readVideo(VideoCaptureAPIs api, const string& file)
+{
+    std::vector<Mat> frames;
+    VideoCapture cap(file, api);
+    Mat img;
+    while (cap.read(img))
+        frames.push_back(img.clone());
+    return frames;
+}
+
+TEST_P(Videoio_AsyncWriter, write)
+{
+    const VideoCaptureAPIs api = GetParam();
+    const int frame_count = 20;
+    const string base = cv::tempfile();
+    const string syncFile = writerFilename(api, base + "_sync");
+    const string asyncFile = writerFilename(api, base + "_async");
+
+    ASSERT_NO_FATAL_FAILURE(writeVideo(api, syncFile, 0, frame_count));
+    ASSERT_NO_FATAL_FAILURE(writeVideo(api, asyncFile, 3, frame_count));
+
+    std::vector<Mat> expected = readVideo(api, syncFile);
+    std::vector<Mat> actual = readVideo(api, asyncFile);
+    ASSERT_EQ(frame_count, (int)expected.size());
+    ASSERT_EQ(expected.size(), actual.size());
+    for (size_t i = 0; i < expected.size(); i++)
+        EXPECT_EQ(0, cvtest::norm(expected[i], actual[i], NORM_INF)) << "frame " << i;
+
+    for (int i = 0; i < (api == CAP_IMAGES ? frame_count : 1); i++)
+    {
+        remove((api == CAP_IMAGES ? cv::format(syncFile.c_str(), i) : syncFile).c_str());
+        remove((api == CAP_IMAGES ? cv::format(asyncFile.c_str(), i) : asyncFile).c_str());
+    }
+}
+
+static VideoCaptureAPIs async_writer_apis[] = { CAP_OPENCV_MJPEG, CAP_IMAGES };
+
+INSTANTIATE_TEST_CASE_P(videoio, Videoio_AsyncWriter, testing::ValuesIn(async_writer_apis));
+
+}} // namespace
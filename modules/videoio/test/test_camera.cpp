@@ -38,4 +38,63 @@ TEST(DISABLED_VideoIO_Camera, basic)
     capture.release();
 }
 
+TEST(DISABLED_VideoIO_Camera, v4l_memory_mmap)
+{
+    VideoCapture capture(0, CAP_V4L2);
+    ASSERT_TRUE(capture.isOpened());
+    ASSERT_TRUE(capture.set(CAP_PROP_V4L_MEMORY, CAP_V4L_MEMORY_MMAP));
+    EXPECT_EQ(CAP_V4L_MEMORY_MMAP, capture.get(CAP_PROP_V4L_MEMORY));
+    ASSERT_TRUE(capture.set(CAP_PROP_CONVERT_RGB, 0));
+    const int buffers = cvRound(capture.get(CAP_PROP_BUFFERSIZE));
+    ASSERT_GT(buffers, 1);
+
+    // the device keeps filling the buffers not held by the frames
+    std::vector<Mat> frames(buffers - 1);
+    for (int i = 0; i < 100; i++)
+    {
+        SCOPED_TRACE(cv::format("frame=%d", i));
+        Mat& frame = frames[i % frames.size()];
+        const uchar* previous = frame.data;
+        ASSERT_TRUE(capture.read(frame));
+        if (i >= (int)frames.size())
+        {
+            EXPECT_NE(previous, frame.data);
+        }
+    }
+
+    // the frames stay valid
+    capture.release();
+    for (size_t i = 0; i < frames.size(); i++)
+        EXPECT_FALSE(frames[i].empty());
+}
+
+TEST(DISABLED_VideoIO_Camera, v4l_memory_userptr)
+{
+    VideoCapture capture(0, CAP_V4L2);
+    ASSERT_TRUE(capture.isOpened());
+    const size_t frameBytes = 4 * cvRound(capture.get(CAP_PROP_FRAME_WIDTH)) * cvRound(capture.get(CAP_PROP_FRAME_HEIGHT));
+    std::vector<Mat> buffers(4);
+    for (size_t i = 0; i < buffers.size(); i++)
+        buffers[i].create(1, (int)frameBytes, CV_8UC1);
+    ASSERT_TRUE(capture.setBuffers(buffers));
+    EXPECT_EQ(CAP_V4L_MEMORY_USERPTR, capture.get(CAP_PROP_V4L_MEMORY));
+    ASSERT_TRUE(capture.set(CAP_PROP_CONVERT_RGB, 0));
+
+    Mat frame;
+    for (int i = 0; i < 100; i++)
+    {
+        SCOPED_TRACE(cv::format("frame=%d", i));
+        ASSERT_TRUE(capture.read(frame));
+        bool inBuffer = false;
+        for (size_t j = 0; j < buffers.size(); j++)
+            inBuffer |= frame.data == buffers[j].data;
+        EXPECT_TRUE(inBuffer);
+    }
+
+    // converted from the buffers
+    ASSERT_TRUE(capture.set(CAP_PROP_CONVERT_RGB, 1));
+    ASSERT_TRUE(capture.read(frame));
+    EXPECT_EQ(CV_8UC3, frame.type());
+}
+
 }} // namespace
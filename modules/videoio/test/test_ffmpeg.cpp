@@ -443,5 +443,219 @@ TEST(Videoio_Video_parallel_writers_and_readers, accuracy)
         delete *i;
 }
 
+TEST(Videoio_Video, ffmpeg_native_planes)
+{
+    const string filename = cv::tempfile(".avi");
+    const Size size(320, 240);
+    const int frame_count = 10;
+    {
+        VideoWriter writer(filename, CAP_FFMPEG, VideoWriter::fourcc('I', '4', '2', '0'), 25, size);
+        ASSERT_TRUE(writer.isOpened());
+        for (int i = 0; i < frame_count; i++)
+        {
+            Mat img(size, CV_8UC3, Scalar::all(0));
+            generateFrame(i, frame_count, img);
+            writer << img;
+        }
+    }
+
+    VideoCapture bgr(filename, CAP_FFMPEG), yuv(filename, CAP_FFMPEG);
+    ASSERT_TRUE(bgr.isOpened());
+    ASSERT_TRUE(yuv.isOpened());
+    EXPECT_EQ(VideoWriter::fourcc('I', '4', '2', '0'), (int)yuv.get(CAP_PROP_CODEC_PIXEL_FORMAT));
+    ASSERT_TRUE(yuv.set(CAP_PROP_CONVERT_RGB, 0));
+    EXPECT_EQ(0, yuv.get(CAP_PROP_CONVERT_RGB));
+
+    for (int i = 0; i < frame_count; i++)
+    {
+        Mat img, y, u, v;
+        ASSERT_TRUE(bgr.read(img));
+        ASSERT_TRUE(yuv.grab());
+        ASSERT_TRUE(yuv.retrieve(y, 0));
+        ASSERT_TRUE(yuv.retrieve(u, 1));
+        ASSERT_TRUE(yuv.retrieve(v, 2));
+        EXPECT_FALSE(yuv.retrieve(img, 3));
+
+        ASSERT_EQ(CV_8UC1, y.type());
+        ASSERT_EQ(size, y.size());
+        ASSERT_EQ(CV_8UC1, u.type());
+        ASSERT_EQ(Size(size.width / 2, size.height / 2), u.size());
+        ASSERT_EQ(u.size(), v.size());
+        // the planes are not copied
+        EXPECT_TRUE(y.u == NULL);
+
+        // luma in the limited range of BT.601
+        Mat gray;
+        cvtColor(img, gray, COLOR_BGR2GRAY);
+        gray.convertTo(gray, CV_8U, 219. / 255, 16);
+        EXPECT_GE(cvtest::PSNR(gray, y), 30.) << "frame " << i;
+    }
+
+    remove(filename.c_str());
+}
+
+TEST(Videoio_Video, ffmpeg_native_planes_bgr_fallback)
+{
+    // FFV1 frames are decoded as BGRA, which has no plane retrieval
+    const string filename = cv::tempfile(".avi");
+    const Size size(320, 240);
+    const int frame_count = 5;
+    {
+        VideoWriter writer(filename, CAP_FFMPEG, VideoWriter::fourcc('F', 'F', 'V', '1'), 25, size);
+        if (!writer.isOpened())
+            throw SkipTestException("FFV1 encoder is not available");
+        for (int i = 0; i < frame_count; i++)
+        {
+            Mat img(size, CV_8UC3, Scalar::all(0));
+            generateFrame(i, frame_count, img);
+            writer << img;
+        }
+    }
+
+    VideoCapture bgr(filename, CAP_FFMPEG), cap(filename, CAP_FFMPEG);
+    ASSERT_TRUE(bgr.isOpened());
+    ASSERT_TRUE(cap.isOpened());
+    const int format = (int)cap.get(CAP_PROP_CODEC_PIXEL_FORMAT);
+    EXPECT_NE(VideoWriter::fourcc('I', '4', '2', '0'), format);
+    EXPECT_NE(VideoWriter::fourcc('N', 'V', '1', '2'), format);
+    ASSERT_TRUE(cap.set(CAP_PROP_CONVERT_RGB, 0));
+
+    for (int i = 0; i < frame_count; i++)
+    {
+        Mat expected, img;
+        ASSERT_TRUE(bgr.read(expected));
+        ASSERT_TRUE(cap.grab());
+        ASSERT_TRUE(cap.retrieve(img, 0));
+        EXPECT_FALSE(cap.retrieve(img, 1));
+        ASSERT_TRUE(cap.retrieve(img, 0));
+        EXPECT_EQ(0, cvtest::norm(expected, img, NORM_INF)) << "frame " << i;
+    }
+
+    remove(filename.c_str());
+}
+
+TEST(Videoio_Video, ffmpeg_keyframe_index)
+{
+    const string filename = cv::tempfile(".avi");
+    const string indexname = filename + ".keyframes";
+    const Size size(320, 240);
+    const int frame_count = 60; // the writer puts a keyframe every 12 frames
+    {
+        VideoWriter writer(filename, CAP_FFMPEG, VideoWriter::fourcc('F', 'M', 'P', '4'), 25, size);
+        ASSERT_TRUE(writer.isOpened());
+        for (int i = 0; i < frame_count; i++)
+        {
+            Mat img(size, CV_8UC3, Scalar::all(0));
+            generateFrame(i, frame_count, img);
+            writer << img;
+        }
+    }
+
+    std::vector<Mat> frames;
+    {
+        VideoCapture cap(filename, CAP_FFMPEG);
+        ASSERT_TRUE(cap.isOpened());
+        Mat img;
+        while (cap.read(img))
+            frames.push_back(img.clone());
+    }
+    ASSERT_EQ(frame_count, (int)frames.size());
+
+    std::vector<int> positions;
+    for (int i = 0; i < frame_count; i += 5)
+        positions.push_back(i);
+    positions.push_back(frame_count - 1);
+    RNG rng(1);
+    for (size_t i = 0; i < positions.size(); i++)
+        std::swap(positions[i], positions[rng.uniform(0, (int)positions.size())]);
+
+    // built, then loaded from the file
+    for (int pass = 0; pass < 2; pass++)
+    {
+        SCOPED_TRACE(pass == 0 ? "built" : "loaded");
+        VideoCapture cap(filename, CAP_FFMPEG);
+        ASSERT_TRUE(cap.isOpened());
+        EXPECT_EQ(0, cap.get(CAP_PROP_KEYFRAME_INDEX));
+        ASSERT_TRUE(cap.set(CAP_PROP_KEYFRAME_INDEX, 2));
+        EXPECT_EQ(2, cap.get(CAP_PROP_KEYFRAME_INDEX));
+        EXPECT_EQ(frame_count, cap.get(CAP_PROP_FRAME_COUNT));
+        FILE* f = fopen(indexname.c_str(), "rb");
+        EXPECT_TRUE(f != NULL);
+        if (f)
+        {
+            // the magic, then the version as 64-bit little-endian whatever the host
+            const uchar expected[16] = { 'C', 'V', 'K', 'F', 'I', 'D', 'X', '1', 2, 0, 0, 0, 0, 0, 0, 0 };
+            uchar header[16] = { 0 };
+            EXPECT_EQ(1u, fread(header, sizeof(header), 1, f));
+            EXPECT_EQ(0, memcmp(header, expected, sizeof(header)));
+            fclose(f);
+        }
+
+        Mat img;
+        ASSERT_TRUE(cap.read(img));
+        EXPECT_EQ(0, cvtest::norm(frames[0], img, NORM_INF));
+        for (size_t i = 0; i < positions.size(); i++)
+        {
+            const int pos = positions[i];
+            ASSERT_TRUE(cap.set(CAP_PROP_POS_FRAMES, pos));
+            EXPECT_EQ(pos, cap.get(CAP_PROP_POS_FRAMES));
+            ASSERT_TRUE(cap.read(img));
+            EXPECT_EQ(0, cvtest::norm(frames[pos], img, NORM_INF)) << "frame " << pos;
+        }
+    }
+
+    remove(indexname.c_str());
+    remove(filename.c_str());
+}
+
+TEST(Videoio_Video, ffmpeg_segments_on_keyframes)
+{
+    const string filename = cv::tempfile(".avi");
+    const Size size(320, 240);
+    const int frame_count = 60; // the writer puts a keyframe every 12 frames
+    {
+        VideoWriter writer(filename, CAP_FFMPEG, VideoWriter::fourcc('F', 'M', 'P', '4'), 25, size);
+        ASSERT_TRUE(writer.isOpened());
+        for (int i = 0; i < frame_count; i++)
+        {
+            Mat img(size, CV_8UC3, Scalar::all(0));
+            generateFrame(i, frame_count, img);
+            writer << img;
+        }
+    }
+
+    std::vector<Mat> frames;
+    {
+        VideoCapture cap(filename, CAP_FFMPEG);
+        ASSERT_TRUE(cap.isOpened());
+        EXPECT_FALSE(cap.set(CAP_PROP_NEXT_KEYFRAME, 1));
+        ASSERT_TRUE(cap.set(CAP_PROP_KEYFRAME_INDEX, 1));
+        const int keyframes[][2] = { { 0, 0 }, { 1, 12 }, { 12, 12 }, { 13, 24 }, { 49, 60 } };
+        for (size_t i = 0; i < sizeof(keyframes) / sizeof(keyframes[0]); i++)
+        {
+            ASSERT_TRUE(cap.set(CAP_PROP_NEXT_KEYFRAME, keyframes[i][0]));
+            EXPECT_EQ(keyframes[i][1], cap.get(CAP_PROP_NEXT_KEYFRAME)) << "frame " << keyframes[i][0];
+        }
+        Mat img;
+        while (cap.read(img))
+            frames.push_back(img.clone());
+    }
+    ASSERT_EQ(frame_count, (int)frames.size());
+
+    // parts of 5 frames at least, starting on the frames 0, 12, 24...
+    VideoCapture cap;
+    ASSERT_TRUE(cap.openSegments(filename, CAP_FFMPEG, 3, true, 5));
+    Mat img;
+    for (int i = 0; i < frame_count; i++)
+    {
+        ASSERT_TRUE(cap.read(img)) << "frame " << i;
+        EXPECT_EQ(i + 1, cap.get(CAP_PROP_POS_FRAMES));
+        EXPECT_EQ(0, cvtest::norm(frames[i], img, NORM_INF)) << "frame " << i;
+    }
+    EXPECT_FALSE(cap.read(img));
+    cap.release();
+    remove(filename.c_str());
+}
+
 #endif
 }} // namespace
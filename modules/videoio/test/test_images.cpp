@@ -0,0 +1,71 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#include "test_precomp.hpp"
+
+namespace opencv_test { namespace {
+
+typedef testing::TestWithParam<int> Videoio_Images_Prefetch;
+
+TEST_P(Videoio_Images_Prefetch, read_and_seek)
+{
+    const int prefetch = GetParam();
+    const int frame_count = 24;
+    const Size size(160, 120);
+    const string pattern = cv::tempfile() + "_%02d.png";
+    std::vector<Mat> reference;
+    for (int i = 0; i < frame_count; i++)
+    {
+        Mat img(size, CV_8UC3, Scalar::all(0));
+        generateFrame(i, frame_count, img);
+        ASSERT_TRUE(imwrite(cv::format(pattern.c_str(), i), img));
+        reference.push_back(img);
+    }
+
+    VideoCapture cap(pattern, CAP_IMAGES);
+    ASSERT_TRUE(cap.isOpened());
+    EXPECT_EQ(0, cap.get(CAP_PROP_PREFETCH_FRAMES));
+    ASSERT_TRUE(cap.set(CAP_PROP_PREFETCH_FRAMES, prefetch));
+    EXPECT_EQ(prefetch, cap.get(CAP_PROP_PREFETCH_FRAMES));
+    EXPECT_FALSE(cap.set(CAP_PROP_PREFETCH_FRAMES, -1));
+
+    Mat img;
+    for (int i = 0; i < frame_count / 2; i++)
+    {
+        ASSERT_TRUE(cap.read(img)) << "frame " << i;
+        EXPECT_EQ(0, cvtest::norm(reference[i], img, NORM_INF)) << "frame " << i;
+    }
+    EXPECT_EQ(size.width, cap.get(CAP_PROP_FRAME_WIDTH));
+
+    // within the prefetched frames, back, far ahead and to the end
+    const int seeks[] = { frame_count / 2 + 2, 3, frame_count - 4, 5, 6, 0 };
+    for (size_t s = 0; s < sizeof(seeks) / sizeof(seeks[0]); s++)
+    {
+        ASSERT_TRUE(cap.set(CAP_PROP_POS_FRAMES, seeks[s]));
+        for (int i = seeks[s]; i < std::min(seeks[s] + 4, frame_count); i++)
+        {
+            ASSERT_TRUE(cap.read(img)) << "frame " << i;
+            EXPECT_EQ(i + 1, cap.get(CAP_PROP_POS_FRAMES));
+            EXPECT_EQ(0, cvtest::norm(reference[i], img, NORM_INF)) << "frame " << i;
+        }
+    }
+    ASSERT_TRUE(cap.set(CAP_PROP_POS_FRAMES, frame_count - 1));
+    ASSERT_TRUE(cap.read(img));
+    EXPECT_EQ(0, cvtest::norm(reference[frame_count - 1], img, NORM_INF));
+    EXPECT_FALSE(cap.read(img));
+
+    // back to decoding in grab()
+    ASSERT_TRUE(cap.set(CAP_PROP_PREFETCH_FRAMES, 0));
+    ASSERT_TRUE(cap.set(CAP_PROP_POS_FRAMES, 7));
+    ASSERT_TRUE(cap.read(img));
+    EXPECT_EQ(0, cvtest::norm(reference[7], img, NORM_INF));
+
+    cap.release();
+    for (int i = 0; i < frame_count; i++)
+        remove(cv::format(pattern.c_str(), i).c_str());
+}
+
+INSTANTIATE_TEST_CASE_P(videoio, Videoio_Images_Prefetch, testing::Values(1, 4, 30));
+
+}} // namespace
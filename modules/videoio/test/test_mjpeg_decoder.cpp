@@ -0,0 +1,161 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#include "test_precomp.hpp"
+#include "opencv2/videoio/container_avi.private.hpp"
+
+namespace opencv_test { namespace {
+
+// Writes the JPEG images as the frames of an MJPEG AVI file
+static void writeJpegAvi(const string& filename, const std::vector<std::vector<uchar> >& frames,
+                         Size size, bool iscolor)
+{
+    AVIWriteContainer out;
+    ASSERT_TRUE(out.initContainer(filename, 25, size, iscolor));
+    out.startWriteAVI(1);
+    out.writeStreamHeader(MJPEG);
+    for (size_t i = 0; i < frames.size(); i++)
+    {
+        size_t chunkPointer = out.getStreamPos();
+        out.startWriteChunk(out.getAVIIndex(0, dc));
+        out.putStreamBytes(&frames[i][0], (int)frames[i].size());
+        for (size_t pos = frames[i].size(); pos % 4 != 0; pos++)
+            out.putStreamByte(0);
+        out.pushFrameOffset(chunkPointer - out.getMoviPointer());
+        out.pushFrameSize(out.getStreamPos() - chunkPointer - 8);
+        out.endWriteChunk();
+    }
+    out.endWriteChunk(); // end LIST 'movi'
+    out.writeIndex(0, dc);
+    out.finishWriteAVI();
+}
+
+static Mat generateImage(int i, int frame_count, Size size, bool iscolor)
+{
+    Mat img(size, CV_8UC3, Scalar::all(0)), noise(size, CV_8UC3);
+    generateFrame(i, frame_count, img);
+    RNG rng(i);
+    rng.fill(noise, RNG::UNIFORM, 0, 32);
+    img += noise;
+    if (!iscolor)
+        cvtColor(img, img, COLOR_BGR2GRAY);
+    return img;
+}
+
+// Removes the DHT segments, as in the AVI1 streams
+static std::vector<uchar> removeHuffmanTables(const std::vector<uchar>& jpeg)
+{
+    std::vector<uchar> result(jpeg.begin(), jpeg.begin() + 2);
+    size_t pos = 2;
+    while (pos + 4 <= jpeg.size() && jpeg[pos] == 0xFF && jpeg[pos + 1] != 0xDA)
+    {
+        size_t len = 2 + (jpeg[pos + 2] << 8) + jpeg[pos + 3];
+        if (jpeg[pos + 1] != 0xC4)
+            result.insert(result.end(), jpeg.begin() + pos, jpeg.begin() + pos + len);
+        pos += len;
+    }
+    result.insert(result.end(), jpeg.begin() + pos, jpeg.end());
+    return result;
+}
+
+enum { MJPEG_DHT, MJPEG_NO_DHT, MJPEG_PROGRESSIVE };
+
+typedef tuple<Size, int, bool, int> MJPEGDecoderParams;
+typedef testing::TestWithParam<MJPEGDecoderParams> Videoio_MJPEG_Decoder;
+
+TEST_P(Videoio_MJPEG_Decoder, compare_with_imdecode)
+{
+    const Size size = get<0>(GetParam());
+    const int restart_interval = get<1>(GetParam());
+    const bool iscolor = get<2>(GetParam());
+    const int mode = get<3>(GetParam());
+    const int frame_count = 5;
+    const string filename = cv::tempfile(".avi");
+
+    std::vector<int> params;
+    params.push_back(IMWRITE_JPEG_QUALITY);
+    params.push_back(90);
+    params.push_back(IMWRITE_JPEG_RST_INTERVAL);
+    params.push_back(restart_interval);
+    params.push_back(IMWRITE_JPEG_PROGRESSIVE);
+    params.push_back(mode == MJPEG_PROGRESSIVE);
+
+    std::vector<std::vector<uchar> > frames(frame_count);
+    std::vector<Mat> expected(frame_count);
+    for (int i = 0; i < frame_count; i++)
+    {
+        ASSERT_TRUE(imencode(".jpg", generateImage(i, frame_count, size, iscolor), frames[i], params));
+        expected[i] = imdecode(frames[i], IMREAD_COLOR);
+        if (mode == MJPEG_NO_DHT)
+            frames[i] = removeHuffmanTables(frames[i]);
+    }
+    ASSERT_NO_FATAL_FAILURE(writeJpegAvi(filename, frames, size, iscolor));
+
+    VideoCapture cap(filename, CAP_OPENCV_MJPEG);
+    ASSERT_TRUE(cap.isOpened());
+    // by default the frames without restart intervals go to libjpeg
+    ASSERT_TRUE(cap.set(CAP_PROP_MJPEG_DECODER, CAP_MJPEG_DECODER_BUILTIN));
+    Mat img;
+    for (int i = 0; i < frame_count; i++)
+    {
+        ASSERT_TRUE(cap.read(img));
+        ASSERT_EQ(CV_8UC3, img.type());
+        ASSERT_EQ(size, img.size());
+        // the IDCT is the one of libjpeg, the color conversion rounds a bit differently
+        EXPECT_LE(cvtest::norm(expected[i], img, NORM_INF), iscolor ? 1 : 0) << "frame " << i;
+        EXPECT_LE(cvtest::norm(expected[i], img, NORM_L1) / img.total(), 0.1) << "frame " << i;
+    }
+    EXPECT_FALSE(cap.read(img));
+    remove(filename.c_str());
+}
+
+INSTANTIATE_TEST_CASE_P(videoio, Videoio_MJPEG_Decoder, testing::Combine(
+    testing::Values(Size(320, 240), Size(203, 117)),
+    testing::Values(0, 1, 7),
+    testing::Bool(),
+    testing::Values(MJPEG_DHT, MJPEG_NO_DHT, MJPEG_PROGRESSIVE)
+));
+
+TEST(Videoio_MJPEG_Decoder, written_stream)
+{
+    // the frames of the built-in writer, also read by libjpeg through the container
+    const string filename = cv::tempfile(".avi");
+    const int frame_count = 10;
+    const Size size(352, 288);
+    {
+        VideoWriter writer(filename, CAP_OPENCV_MJPEG, VideoWriter::fourcc('M', 'J', 'P', 'G'), 25, size);
+        ASSERT_TRUE(writer.isOpened());
+        for (int i = 0; i < frame_count; i++)
+            writer << generateImage(i, frame_count, size, true);
+    }
+
+    AVIReadContainer in;
+    in.initStream(filename);
+    frame_list frames;
+    ASSERT_TRUE(in.parseRiff(frames));
+    ASSERT_EQ((size_t)frame_count, frames.size());
+
+    const int modes[] = { CAP_MJPEG_DECODER_AUTO, CAP_MJPEG_DECODER_BUILTIN, CAP_MJPEG_DECODER_IMDECODE };
+    for (size_t m = 0; m < sizeof(modes) / sizeof(modes[0]); m++)
+    {
+        SCOPED_TRACE(cv::format("decoder=%d", modes[m]));
+        VideoCapture cap(filename, CAP_OPENCV_MJPEG);
+        ASSERT_TRUE(cap.isOpened());
+        EXPECT_EQ(CAP_MJPEG_DECODER_AUTO, cap.get(CAP_PROP_MJPEG_DECODER));
+        EXPECT_FALSE(cap.set(CAP_PROP_MJPEG_DECODER, 3));
+        ASSERT_TRUE(cap.set(CAP_PROP_MJPEG_DECODER, modes[m]));
+        EXPECT_EQ(modes[m], cap.get(CAP_PROP_MJPEG_DECODER));
+        Mat img;
+        for (frame_iterator it = frames.begin(); it != frames.end(); ++it)
+        {
+            ASSERT_TRUE(cap.read(img));
+            Mat expected = imdecode(in.readFrame(it), IMREAD_COLOR);
+            EXPECT_LE(cvtest::norm(expected, img, NORM_INF), 1);
+            EXPECT_LE(cvtest::norm(expected, img, NORM_L1) / img.total(), 0.1);
+        }
+    }
+    remove(filename.c_str());
+}
+
+}} // namespace
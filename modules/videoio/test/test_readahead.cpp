@@ -0,0 +1,326 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#include "test_precomp.hpp"
+#include "opencv2/videoio/capture_source.private.hpp"
+
+#include <atomic>
+#include <thread>
+
+namespace opencv_test { namespace {
+
+// Writes a short synthetic video and keeps its decoded frames as the reference
+class Videoio_ReadAhead : public testing::TestWithParam<VideoCaptureAPIs>
+{
+protected:
+    void SetUp() CV_OVERRIDE
+    {
+        api = GetParam();
+        const int frame_count = 20;
+        const Size size(320, 240);
+        if (api == CAP_IMAGES)
+            file = cv::tempfile() + "_%02d.bmp";
+        else
+            file = cv::tempfile(".avi");
+        VideoWriter writer;
+        if (api != CAP_IMAGES)
+        {
+            writer.open(file, api, VideoWriter::fourcc('M', 'J', 'P', 'G'), 25, size);
+            ASSERT_TRUE(writer.isOpened());
+        }
+        for (int i = 0; i < frame_count; i++)
+        {
+            Mat img(size, CV_8UC3, Scalar::all(0));
+            generateFrame(i, frame_count, img);
+            if (api == CAP_IMAGES)
+                ASSERT_TRUE(imwrite(cv::format(file.c_str(), i), img));
+            else
+                writer << img;
+        }
+        writer.release();
+
+        VideoCapture cap(file, api);
+        ASSERT_TRUE(cap.isOpened());
+        Mat img;
+        while (cap.read(img))
+            reference.push_back(img.clone());
+        ASSERT_EQ(frame_count, (int)reference.size());
+    }
+
+    void TearDown() CV_OVERRIDE
+    {
+        for (size_t i = 0; i < (api == CAP_IMAGES ? reference.size() : 1); i++)
+            remove((api == CAP_IMAGES ? cv::format(file.c_str(), (int)i) : file).c_str());
+    }
+
+    VideoCaptureAPIs api;
+    string file;
+    std::vector<Mat> reference;
+};
+
+TEST_P(Videoio_ReadAhead, read)
+{
+    VideoCapture cap(file, api);
+    ASSERT_TRUE(cap.isOpened());
+    EXPECT_EQ(0, cap.get(CAP_PROP_READAHEAD_FRAMES));
+    ASSERT_TRUE(cap.set(CAP_PROP_READAHEAD_FRAMES, 4));
+    EXPECT_EQ(4, cap.get(CAP_PROP_READAHEAD_FRAMES));
+    EXPECT_EQ(CAP_READAHEAD_BLOCK, cap.get(CAP_PROP_READAHEAD_POLICY));
+    EXPECT_EQ(api, cap.get(CAP_PROP_BACKEND));
+    EXPECT_EQ(reference.size(), cap.get(CAP_PROP_FRAME_COUNT));
+
+    Mat img;
+    for (size_t i = 0; i < reference.size(); i++)
+    {
+        ASSERT_TRUE(cap.read(img)) << "frame " << i;
+        EXPECT_EQ(0, cvtest::norm(reference[i], img, NORM_INF)) << "frame " << i;
+    }
+    EXPECT_FALSE(cap.read(img));
+    EXPECT_TRUE(img.empty());
+    EXPECT_FALSE(cap.read(img));
+}
+
+TEST_P(Videoio_ReadAhead, position_and_seek)
+{
+    VideoCapture cap(file, api);
+    ASSERT_TRUE(cap.isOpened());
+    ASSERT_TRUE(cap.set(CAP_PROP_READAHEAD_FRAMES, 3));
+
+    Mat img;
+    for (int i = 0; i < 5; i++)
+        ASSERT_TRUE(cap.read(img));
+    // the frames read ahead don't count
+    EXPECT_EQ(5, cap.get(CAP_PROP_POS_FRAMES));
+
+    ASSERT_TRUE(cap.set(CAP_PROP_POS_FRAMES, 12));
+    ASSERT_TRUE(cap.read(img));
+    EXPECT_EQ(0, cvtest::norm(reference[12], img, NORM_INF));
+    EXPECT_EQ(13, cap.get(CAP_PROP_POS_FRAMES));
+
+    ASSERT_TRUE(cap.set(CAP_PROP_POS_FRAMES, 2));
+    ASSERT_TRUE(cap.read(img));
+    EXPECT_EQ(0, cvtest::norm(reference[2], img, NORM_INF));
+
+    // switching the read-ahead off gives the frames back to the application thread
+    ASSERT_TRUE(cap.set(CAP_PROP_READAHEAD_FRAMES, 0));
+    ASSERT_TRUE(cap.set(CAP_PROP_POS_FRAMES, 7));
+    ASSERT_TRUE(cap.read(img));
+    EXPECT_EQ(0, cvtest::norm(reference[7], img, NORM_INF));
+}
+
+TEST_P(Videoio_ReadAhead, set_property_keeps_position)
+{
+    VideoCapture cap(file, api);
+    ASSERT_TRUE(cap.isOpened());
+    ASSERT_TRUE(cap.set(CAP_PROP_READAHEAD_FRAMES, 4));
+
+    Mat img;
+    for (int i = 0; i < 5; i++)
+        ASSERT_TRUE(cap.read(img));
+    // the frames read ahead are read again, whether the backend takes the property or not
+    cap.set(CAP_PROP_CONVERT_RGB, 1);
+    ASSERT_TRUE(cap.read(img));
+    EXPECT_EQ(0, cvtest::norm(reference[5], img, NORM_INF));
+    EXPECT_EQ(6, cap.get(CAP_PROP_POS_FRAMES));
+
+    ASSERT_TRUE(cap.set(CAP_PROP_READAHEAD_FRAMES, 2));
+    ASSERT_TRUE(cap.read(img));
+    EXPECT_EQ(0, cvtest::norm(reference[6], img, NORM_INF));
+    EXPECT_EQ(7, cap.get(CAP_PROP_POS_FRAMES));
+}
+
+TEST_P(Videoio_ReadAhead, drop_oldest)
+{
+    VideoCapture cap(file, api);
+    ASSERT_TRUE(cap.isOpened());
+    ASSERT_TRUE(cap.set(CAP_PROP_READAHEAD_POLICY, CAP_READAHEAD_DROP_OLDEST));
+    ASSERT_TRUE(cap.set(CAP_PROP_READAHEAD_FRAMES, 2));
+    EXPECT_FALSE(cap.set(CAP_PROP_READAHEAD_POLICY, 5));
+    EXPECT_EQ(CAP_READAHEAD_DROP_OLDEST, cap.get(CAP_PROP_READAHEAD_POLICY));
+
+    // a slow reader gets the frames in order, possibly with gaps, and the last one
+    Mat img;
+    int last = 0, count = 0;
+    while (cap.read(img))
+    {
+        const int pos = cvRound(cap.get(CAP_PROP_POS_FRAMES));
+        ASSERT_GT(pos, last);
+        ASSERT_LE(pos, (int)reference.size());
+        EXPECT_EQ(0, cvtest::norm(reference[pos - 1], img, NORM_INF)) << "frame " << pos - 1;
+        last = pos;
+        count++;
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    EXPECT_EQ((int)reference.size(), last);
+    EXPECT_LE(count, (int)reference.size());
+}
+
+TEST_P(Videoio_ReadAhead, waitAny)
+{
+    // the streams with read-ahead are waited on, the others are always ready
+    std::vector<VideoCapture> streams(3);
+    for (size_t i = 0; i < streams.size(); i++)
+    {
+        ASSERT_TRUE(streams[i].open(file, api));
+        if (i > 0)
+        {
+            ASSERT_TRUE(streams[i].set(CAP_PROP_READAHEAD_FRAMES, (double)i));
+        }
+    }
+
+    std::vector<int> frames(streams.size(), 0), ready;
+    Mat img;
+    for (int iter = 0; iter < 1000 && VideoCapture::waitAny(streams, ready, 1000000000); iter++)
+    {
+        ASSERT_FALSE(ready.empty());
+        for (size_t i = 0; i < ready.size(); i++)
+        {
+            const int idx = ready[i];
+            ASSERT_TRUE(streams[idx].retrieve(img));
+            ASSERT_LT(frames[idx], (int)reference.size());
+            EXPECT_EQ(0, cvtest::norm(reference[frames[idx]], img, NORM_INF)) << "stream " << idx;
+            frames[idx]++;
+        }
+    }
+    for (size_t i = 0; i < streams.size(); i++)
+        EXPECT_EQ((int)reference.size(), frames[i]) << "stream " << i;
+    EXPECT_FALSE(VideoCapture::waitAny(streams, ready, 1000000));
+    EXPECT_TRUE(ready.empty());
+
+    streams.push_back(VideoCapture());
+    EXPECT_THROW(VideoCapture::waitAny(streams, ready), cv::Exception);
+}
+
+static VideoCaptureAPIs readahead_apis[] = { CAP_OPENCV_MJPEG, CAP_IMAGES };
+
+INSTANTIATE_TEST_CASE_P(videoio, Videoio_ReadAhead, testing::ValuesIn(readahead_apis));
+
+// Frees the buffer of the fake device once no Mat wraps it
+class DeviceBufferAllocator : public MatAllocator
+{
+public:
+    UMatData* allocate(int dims, const int* sizes, int type, void* data, size_t* step,
+                       AccessFlag flags, UMatUsageFlags usageFlags) const CV_OVERRIDE
+    {
+        return Mat::getStdAllocator()->allocate(dims, sizes, type, data, step, flags, usageFlags);
+    }
+
+    bool allocate(UMatData* u, AccessFlag accessFlags, UMatUsageFlags usageFlags) const CV_OVERRIDE
+    {
+        return Mat::getStdAllocator()->allocate(u, accessFlags, usageFlags);
+    }
+
+    void deallocate(UMatData* u) const CV_OVERRIDE
+    {
+        if (!u)
+            return;
+        *(std::atomic<bool>*)u->userdata = false;
+        delete u;
+    }
+};
+
+// A live source with 3 buffers, each held by the retrieved frames wrapping it as with
+// CAP_V4L_MEMORY_MMAP. Without a free buffer the grab fails, where a device would wait.
+class FakeDevice : public VideoCaptureSource
+{
+public:
+    enum { bufferCount = 3 };
+
+    explicit FakeDevice(int frameCount) : frameCount_(frameCount), grabbed_(0)
+    {
+        for (int i = 0; i < bufferCount; i++)
+        {
+            memory_[i].create(1, 64, CV_8UC1);
+            held_[i] = false;
+        }
+    }
+
+    double get(int propId) const CV_OVERRIDE
+    {
+        if (propId == CAP_PROP_POS_FRAMES)
+            return grabbed_;
+        if (propId == CAP_PROP_BUFFERSIZE)
+            return bufferCount;
+        return 0;
+    }
+
+    bool grab() CV_OVERRIDE
+    {
+        // the buffer of the previous frame goes back to the device, unless a frame wraps it
+        current_.release();
+        if (grabbed_ == frameCount_)
+            return false;
+        for (int i = 0; i < bufferCount; i++)
+        {
+            if (held_[i])
+                continue;
+            memory_[i].setTo(grabbed_++);
+            current_ = wrap(i);
+            return true;
+        }
+        return false;
+    }
+
+    bool retrieve(int channel, OutputArray image) CV_OVERRIDE
+    {
+        if (channel != 0 || current_.empty())
+        {
+            image.release();
+            return false;
+        }
+        image.assign(current_);
+        return true;
+    }
+
+private:
+    Mat wrap(int i)
+    {
+        static DeviceBufferAllocator allocator;
+        UMatData* u = new UMatData(&allocator);
+        u->data = u->origdata = memory_[i].data;
+        u->size = memory_[i].total();
+        u->userdata = &held_[i];
+        held_[i] = true;
+
+        Mat m(memory_[i].size(), CV_8UC1, memory_[i].data);
+        m.u = u;
+        m.addref();
+        return m;
+    }
+
+    int frameCount_;
+    int grabbed_;
+    Mat memory_[bufferCount];
+    std::atomic<bool> held_[bufferCount];
+    Mat current_;
+};
+
+class FakeDeviceCapture : public VideoCapture
+{
+public:
+    explicit FakeDeviceCapture(const Ptr<VideoCaptureSource>& source)
+    {
+        icap = createSourceCapture(source);
+    }
+};
+
+TEST(Videoio_ReadAhead, device_buffers)
+{
+    const int frame_count = 10;
+    FakeDeviceCapture cap(makePtr<FakeDevice>(frame_count));
+    ASSERT_TRUE(cap.isOpened());
+    // the ring doesn't keep the device buffers, it would hold all of them
+    ASSERT_TRUE(cap.set(CAP_PROP_READAHEAD_FRAMES, FakeDevice::bufferCount));
+
+    Mat img;
+    for (int i = 0; i < frame_count; i++)
+    {
+        ASSERT_TRUE(cap.read(img)) << "frame " << i;
+        EXPECT_EQ(i, img.at<uchar>(0, 0)) << "frame " << i;
+        EXPECT_EQ(i + 1, cap.get(CAP_PROP_POS_FRAMES));
+    }
+    EXPECT_FALSE(cap.read(img));
+}
+
+}} // namespace
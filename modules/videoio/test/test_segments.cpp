@@ -0,0 +1,112 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#include "test_precomp.hpp"
+
+namespace opencv_test { namespace {
+
+// decoders, ordered, part frames
+typedef tuple<VideoCaptureAPIs, int, bool, int> SegmentsParams;
+typedef testing::TestWithParam<SegmentsParams> Videoio_Segments;
+
+TEST_P(Videoio_Segments, read)
+{
+    const VideoCaptureAPIs api = get<0>(GetParam());
+    const int decoders = get<1>(GetParam());
+    const bool ordered = get<2>(GetParam());
+    const int partFrames = get<3>(GetParam());
+    const int frame_count = 30;
+    const Size size(160, 120);
+    const string file = api == CAP_IMAGES ? cv::tempfile() + "_%02d.bmp" : cv::tempfile(".avi");
+    {
+        const int fourcc = api == CAP_IMAGES ? 0 : VideoWriter::fourcc('M', 'J', 'P', 'G');
+        VideoWriter writer(file, api, fourcc, 25, size);
+        ASSERT_TRUE(writer.isOpened());
+        for (int i = 0; i < frame_count; i++)
+        {
+            Mat img(size, CV_8UC3, Scalar::all(0));
+            generateFrame(i, frame_count, img);
+            writer << img;
+        }
+    }
+
+    std::vector<Mat> reference;
+    {
+        VideoCapture cap(file, api);
+        ASSERT_TRUE(cap.isOpened());
+        Mat img;
+        while (cap.read(img))
+            reference.push_back(img.clone());
+    }
+    ASSERT_EQ(frame_count, (int)reference.size());
+
+    VideoCapture cap;
+    ASSERT_TRUE(cap.openSegments(file, api, decoders, ordered, partFrames));
+    EXPECT_EQ(api, cap.get(CAP_PROP_BACKEND));
+    EXPECT_EQ(frame_count, cap.get(CAP_PROP_FRAME_COUNT));
+    EXPECT_EQ(size.width, cap.get(CAP_PROP_FRAME_WIDTH));
+    EXPECT_FALSE(cap.set(CAP_PROP_POS_FRAMES, 0));
+
+    std::vector<int> read_count(frame_count, 0);
+    Mat img;
+    for (int i = 0; i < frame_count; i++)
+    {
+        ASSERT_TRUE(cap.read(img)) << "frame " << i;
+        const int index = cvRound(cap.get(CAP_PROP_POS_FRAMES)) - 1;
+        ASSERT_GE(index, 0);
+        ASSERT_LT(index, frame_count);
+        if (ordered)
+        {
+            EXPECT_EQ(i, index);
+        }
+        read_count[index]++;
+        EXPECT_EQ(0, cvtest::norm(reference[index], img, NORM_INF)) << "frame " << index;
+    }
+    EXPECT_FALSE(cap.read(img));
+    for (int i = 0; i < frame_count; i++)
+        EXPECT_EQ(1, read_count[i]) << "frame " << i;
+
+    cap.release();
+    for (int i = 0; i < (api == CAP_IMAGES ? frame_count : 1); i++)
+        remove((api == CAP_IMAGES ? cv::format(file.c_str(), i) : file).c_str());
+}
+
+static VideoCaptureAPIs segments_apis[] = { CAP_OPENCV_MJPEG, CAP_IMAGES };
+
+INSTANTIATE_TEST_CASE_P(videoio, Videoio_Segments, testing::Combine(
+    testing::ValuesIn(segments_apis),
+    testing::Values(1, 3),
+    testing::Bool(),
+    testing::Values(0, 7)
+));
+
+TEST(Videoio_Segments, release_while_decoding)
+{
+    const string file = cv::tempfile(".avi");
+    const Size size(160, 120);
+    const int frame_count = 40;
+    {
+        VideoWriter writer(file, CAP_OPENCV_MJPEG, VideoWriter::fourcc('M', 'J', 'P', 'G'), 25, size);
+        ASSERT_TRUE(writer.isOpened());
+        for (int i = 0; i < frame_count; i++)
+        {
+            Mat img(size, CV_8UC3, Scalar::all(0));
+            generateFrame(i, frame_count, img);
+            writer << img;
+        }
+    }
+
+    VideoCapture cap;
+    EXPECT_FALSE(cap.openSegments(file + ".missing", CAP_OPENCV_MJPEG, 2));
+    EXPECT_FALSE(cap.isOpened());
+    ASSERT_TRUE(cap.openSegments(file, CAP_OPENCV_MJPEG, 4, true, 4));
+    Mat img;
+    ASSERT_TRUE(cap.read(img));
+    // the decoders blocked on their full queues are stopped
+    cap.release();
+    EXPECT_FALSE(cap.isOpened());
+    remove(file.c_str());
+}
+
+}} // namespace